@@ -0,0 +1,2172 @@
+/******************************************************************************
+* File Name:   acquisition.c
+*
+* Description: This file contains the SAR ADC acquisition. The two SAR ADCs
+*              are triggered simultaneously by TCPWM0 and report the end of
+*              scan through one combined SAR0 interrupt. In FIFO mode the results are
+*              collected in the SAR FIFOs and the CPU is woken up once per
+*              block of sample pairs. In DMA mode the results are moved to
+*              memory by DMA without any CPU involvement per sample. Each
+*              SAR can scan several channels per trigger; the results of all
+*              channels are scaled into a channel-major block for a
+*              processing callback. Named profiles set the averaging and
+*              the acquisition time of both SARs together.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "acquisition.h"
+#include "sar_dma.h"
+#include "sample_queue.h"
+#include "profiler.h"
+#include "timebase.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* TCPWM Counter 0 */
+#define TCPWM_CNT_NUM   (0UL)
+
+/* SAR channel of both SARs that feeds the product */
+#define SAR_CHANNEL     (0UL)
+
+/* Peripheral clock divider of the SAR clock (8-bit divider 0) */
+#define SAR_CLOCK_DIVIDER   (0UL)
+
+/* Sample time register used by the channel */
+#define SAR_SAMPLE_TIME     (0UL)
+
+/* Range of the acquisition time in SAR clocks */
+#define SAR_MIN_ACQ_CLOCKS  (2ULL)
+#define SAR_MAX_ACQ_CLOCKS  (1023ULL)
+
+/* SAR clocks of one 12-bit conversion after the acquisition time */
+#define SAR_CONVERSION_CLOCKS   (14UL)
+
+/* ENOB of a single conversion in tenths of a bit, from a typical SINAD of 64 dB */
+#define SAR_BASE_ENOB_X10       (103UL)
+
+/* Resolution of the results. Averaged results are shifted back to 12 bits,
+   which bounds the ENOB gained by averaging. */
+#define SAR_RESULT_BITS         (12UL)
+
+/* Number of status polls to wait for the End-Of-Scan of SAR1 after SAR0 */
+#define SAR1_EOS_TIMEOUT    (100UL)
+
+/* Range of the 12-bit two's complement results */
+#define SAR_MIN_RESULT      (-2048)
+#define SAR_MAX_RESULT      (2047)
+
+/* Highest trigger rate, from the interval of ACQ_MIN_PERIOD. The TCPWM
+   counter overflows every period + 1 clocks. */
+#if (ACQ_DEEP_SLEEP != 0U)
+#define ACQ_MAX_TRIGGER_RATE    (ACQ_TRIGGER_CLOCK_HZ / ACQ_MIN_PERIOD)
+#else
+#define ACQ_MAX_TRIGGER_RATE    (ACQ_TRIGGER_CLOCK_HZ / (ACQ_MIN_PERIOD + 1UL))
+#endif
+
+/* Number of results stored in the SAR FIFO */
+#define SAR_FIFO_DEPTH  (64UL)
+
+/* Channels enabled in the SAR configuration */
+#define SAR_CHANNEL_MASK    ((1UL << ACQ_NUM_CHANNELS) - 1UL)
+
+#if ((ACQ_NUM_CHANNELS < 1UL) || (ACQ_NUM_CHANNELS > 16UL))
+#error "ACQ_NUM_CHANNELS must be between 1 and 16"
+#endif
+
+#if ((ACQUISITION_MODE == ACQ_MODE_DMA) && (ACQ_NUM_CHANNELS != 1UL))
+#error "DMA mode supports a single channel per SAR"
+#endif
+
+#if ((ACQUISITION_MODE == ACQ_MODE_EOS_INTERRUPT) && (ACQ_QUEUE_SIZE > ACQ_CHANNEL_BLOCK_SCANS))
+#error "ACQ_QUEUE_SIZE must not exceed ACQ_CHANNEL_BLOCK_SCANS"
+#endif
+
+#if ((ACQ_DEEP_SLEEP != 0U) && (ACQUISITION_MODE != ACQ_MODE_FIFO))
+#error "Deep sleep acquisition requires the FIFO mode"
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* SAR settings of an acquisition profile */
+typedef struct
+{
+    const char *name;
+    bool averaging;                             /* Averaging enabled on every channel */
+    cy_en_sar_sample_ctrl_avg_cnt_t avg_count;  /* Conversions averaged per result */
+    uint32_t acq_time_ns;                       /* Acquisition time */
+} acq_profile_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Initializes and enables both SARs with the current configuration */
+static void sar_configure(void);
+
+/* Stops the trigger and waits for the scan in progress */
+static void acquisition_pause(void);
+
+/* Restarts the trigger stopped by acquisition_pause() */
+static void acquisition_resume(void);
+
+/* Stops the trigger of both SARs */
+static void trigger_stop(void);
+
+/* Restarts the trigger of both SARs from zero with trigger_period */
+static void trigger_restart(void);
+
+/* Frequency of the clock of both SARs */
+static uint32_t sar_clock_hz(void);
+
+/* Converts an acquisition time to SAR clocks, 0 if out of range */
+static uint32_t acq_time_to_clocks(uint32_t acq_time_ns);
+
+/* Highest trigger rate that completes every scan with the given settings */
+static uint32_t scan_max_rate(uint32_t averages, uint32_t acq_clocks);
+
+/* Reads the sample pairs acquired since the previous call */
+static uint32_t acquisition_read_block(const sample_pair_t **pairs);
+
+/* Adds a block of sample pairs to the noise measurement */
+static void noise_accumulate(const sample_pair_t *pairs, uint32_t count);
+
+/* Scales the results of one channel of one scan into the channel block */
+static void channel_block_store(uint32_t channel, uint32_t scan, int16_t counts0, int16_t counts1);
+
+#if (ACQUISITION_MODE != ACQ_MODE_EOS_INTERRUPT)
+/* Timestamps a block of evenly spaced scans from the time of one of them */
+static void timestamps_spread(uint32_t count, uint32_t anchor, uint64_t anchor_time);
+#endif
+
+/* Counts the triggers missing between the timestamps of a block */
+static void timestamps_check(uint32_t count);
+
+/* Converts microvolts to the counts of channel 0 of a SAR */
+static int16_t uv_to_counts(const SAR_Type *base, int32_t uv);
+
+/* Clears and enables the comparator interrupts of the compared channels if the monitor is enabled */
+static void monitor_unmask(void);
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+/* Ends the hold of the DMA blocks */
+static void monitor_resume(void);
+#endif
+
+/* Records the comparator events of one SAR and disables their interrupts */
+static void monitor_take_sar_events(SAR_Type *base, uint32_t range_event, uint32_t sat_event);
+
+/* SAR0 Interrupt Handler */
+static void sar0_interrupt(void);
+
+/* SAR1 Interrupt Handler, for the comparator events only */
+static void sar1_interrupt(void);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* SAR0 interrupt configuration structure */
+/* Source is set to SAR0 and Priority as 7 */
+const cy_stc_sysint_t SAR0_IRQ_cfg = {
+    .intrSrc = (IRQn_Type) pass_interrupt_sar_0_IRQn,
+    .intrPriority = 7UL
+};
+
+/* SAR1 interrupt configuration structure, same priority as SAR0 */
+const cy_stc_sysint_t SAR1_IRQ_cfg = {
+    .intrSrc = (IRQn_Type) pass_interrupt_sar_1_IRQn,
+    .intrPriority = 7UL
+};
+
+/* SAR configurations, based on the configuration of the device configurator */
+static cy_stc_sar_config_t sar0_config;
+static cy_stc_sar_config_t sar1_config;
+static cy_stc_sar_channel_config_t sar0_channels[ACQ_NUM_CHANNELS];
+static cy_stc_sar_channel_config_t sar1_channels[ACQ_NUM_CHANNELS];
+
+/* Acquisition profiles. The averaged results keep the 12-bit range, so the
+   rest of the application is independent of the profile. */
+static const acq_profile_t acq_profiles[ACQ_PROFILE_COUNT] = {
+    { "fast",     false, CY_SAR_AVG_CNT_2,   250UL  },
+    { "balanced", true,  CY_SAR_AVG_CNT_4,   1000UL },
+    { "high-res", true,  CY_SAR_AVG_CNT_256, 1000UL }
+};
+
+/* Profile in use */
+static uint32_t current_profile = ACQ_PROFILE_CUSTOM;
+
+/* Noise measurement of channel 0 */
+static uint32_t noise_scans = 0UL;
+static bool noise_ready = false;
+static int64_t noise_sum[ACQ_NUM_SARS];
+static uint64_t noise_sum_squares[ACQ_NUM_SARS];
+
+/* Period of the trigger counter */
+static uint32_t trigger_period;
+
+/* Scans returned by acquisition_get_block() since startup */
+static uint32_t scans_read = 0UL;
+
+/* Trigger times of the sample pairs of the last block */
+static uint64_t block_timestamps[ACQ_CHANNEL_BLOCK_SCANS];
+
+/* Timestamp of the previous sample pair, valid until the trigger restarts */
+static uint64_t last_timestamp = 0ULL;
+static bool last_timestamp_valid = false;
+
+/* Triggers without a sample pair */
+static uint32_t timestamp_gaps = 0UL;
+
+/* Window comparators of both SARs, with the limits in counts of each SAR */
+static bool monitor_enabled = false;
+static uint32_t monitor_channels[ACQ_NUM_SARS];
+static uint32_t monitor_cond[ACQ_NUM_SARS];
+static int16_t monitor_low[ACQ_NUM_SARS];
+static int16_t monitor_high[ACQ_NUM_SARS];
+
+/* Conditions of the SAR comparators, indexed by ACQ_RANGE_ condition */
+static const cy_en_sar_range_detect_condition_t monitor_range_conds[ACQ_RANGE_COUNT] = {
+    CY_SAR_RANGE_COND_BELOW,
+    CY_SAR_RANGE_COND_INSIDE,
+    CY_SAR_RANGE_COND_ABOVE,
+    CY_SAR_RANGE_COND_OUTSIDE
+};
+
+/* Comparator events raised by the SAR interrupts */
+static volatile uint32_t monitor_events = 0UL;
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+/* Whether the DMA blocks are held until the next comparator event, and
+   whether the next block is the first one read since the hold */
+static volatile bool monitor_holding = false;
+static volatile bool monitor_resumed = false;
+#endif
+
+/* Scaling of every channel of both SARs, microvolts by default */
+static channel_scale_t channel_scale[ACQ_NUM_CHANNELS][ACQ_NUM_SARS];
+
+/* Processing callback of the channel blocks */
+static acquisition_channel_callback_t channel_callback = NULL;
+
+/* Scaled results of the last block, filled only if a callback is registered */
+static channel_block_t channel_block;
+
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+/* FIFO configuration applied to both SARs */
+static const cy_stc_sar_fifo_config_t sar_fifo_config = {
+    .chanId = false,
+    .clrTrIntrOnRead = false,
+    .level = ACQ_FIFO_LEVEL,
+    .trOut = false
+};
+
+/* Sample pairs of channel 0 drained from the FIFOs */
+static sample_pair_t fifo_block[SAR_FIFO_DEPTH / ACQ_NUM_CHANNELS];
+
+/* Flag to check FIFO level interrupt from SAR0 */
+static volatile bool fifo_level_set = false;
+
+/* Overflows of the FIFO of either SAR */
+static volatile uint32_t fifo_overflows = 0UL;
+
+/* FIFO level interrupts raised before the previous block was read */
+static volatile uint32_t fifo_level_collapses = 0UL;
+
+/* Trigger time of the scan that raised the FIFO level interrupt */
+static volatile uint64_t fifo_level_time = 0ULL;
+
+#if (ACQ_DEEP_SLEEP != 0U)
+/* Common SAR configuration with the PASS timer as simultaneous trigger */
+static cy_stc_sar_common_config_t sar_common_config;
+
+/* Deep sleep clock of the PASS, the undivided MF clock, used by both SARs */
+static const cy_stc_sysanalog_deep_sleep_config_t pass_deep_sleep_config = {
+    .clkSel = CY_SYSANALOG_DEEPSLEEP_SRC_MFCLK,
+    .clkDiv = CY_SYSANALOG_DEEPSLEEP_CLK_NO_DIV
+};
+
+/* PASS timer on the low-frequency clock, which runs in deep sleep */
+static const cy_stc_sysanalog_timer_config_t pass_timer_config = {
+    .clockSel = CY_SYSANALOG_TIMER_CLK_LF,
+    .period = ACQ_DEEP_SLEEP_PERIOD
+};
+#endif
+#elif (ACQUISITION_MODE == ACQ_MODE_DMA)
+/* FIFO configuration applied to both SARs. Every result raises the FIFO
+ * trigger output, which requests one DMA transfer. Reading the result
+ * clears the trigger.
+ */
+static const cy_stc_sar_fifo_config_t sar_fifo_config = {
+    .chanId = false,
+    .clrTrIntrOnRead = true,
+    .level = 1UL,
+    .trOut = true
+};
+#else
+/* Queue of sample pairs from the End-Of-Scan interrupts to the main loop */
+static sample_entry_t eos_queue_storage[ACQ_QUEUE_SIZE];
+static sample_queue_t eos_queue;
+
+/* Entries and sample pairs removed from the queue by the main loop */
+static sample_entry_t eos_entries[ACQ_QUEUE_SIZE];
+static sample_pair_t eos_block[ACQ_QUEUE_SIZE];
+
+/* Index of the current scan */
+static uint32_t eos_scan = 0UL;
+
+/* End-Of-Scan interrupts served after the results of a scan were overwritten */
+static volatile uint32_t result_overwrites = 0UL;
+
+/* Scans dropped because SAR1 did not complete within SAR1_EOS_TIMEOUT polls */
+static volatile uint32_t eos_timeouts = 0UL;
+#endif
+
+/*******************************************************************************
+* Function Name: acquisition_init
+********************************************************************************
+* Summary:
+* This function initializes SAR0 and SAR1, their interrupt or DMA, and the
+* TCPWM counter that triggers them. With ACQ_DEEP_SLEEP, the SARs run from the
+* deep sleep clock of the PASS and are triggered by the PASS timer instead.
+* AREF must be enabled before this function is called.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_init(void)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+    uint32_t channel;
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    /* The MF clock keeps running in deep sleep and clocks both SARs */
+    Cy_SysClk_MfoEnable(true);
+    Cy_SysClk_ClkMfEnable();
+
+    result = Cy_SysAnalog_DeepSleepInit(PASS, &pass_deep_sleep_config);
+    if (CY_SYSANALOG_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Trigger both SARs from the PASS timer instead of the TCPWM counter */
+    sar_common_config = pass_0_saradc_0_config;
+    sar_common_config.simultTrigSource = CY_SAR_TIMER;
+
+    result = Cy_SAR_CommonInit(PASS, &sar_common_config);
+#else
+    /* Initialize common resources for SAR ADCs. */
+    /* Common resources include simultaneous trigger parameters, scan count
+       and power up delay. This is configured in the device configurator. */
+    result = Cy_SAR_CommonInit(PASS, &pass_0_saradc_0_config);
+#endif
+    if (CY_SAR_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    sar0_config = pass_0_saradc_0_sar_0_config;
+    sar1_config = pass_0_saradc_0_sar_1_config;
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    sar0_config.clock = CY_SAR_CLK_DEEPSLEEP;
+    sar1_config.clock = CY_SAR_CLK_DEEPSLEEP;
+#endif
+
+    /* Take copies of the channel configurations, which the profiles modify */
+    for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+    {
+        sar0_channels[channel] = *pass_0_saradc_0_sar_0_config.channelConfig[channel];
+        sar1_channels[channel] = *pass_0_saradc_0_sar_1_config.channelConfig[channel];
+        sar0_config.channelConfig[channel] = &sar0_channels[channel];
+        sar1_config.channelConfig[channel] = &sar1_channels[channel];
+    }
+
+    /* The scans of both SARs must cover channels 0 to ACQ_NUM_CHANNELS - 1 */
+    if ((SAR_CHANNEL_MASK != sar0_config.chanEn) || (SAR_CHANNEL_MASK != sar1_config.chanEn))
+    {
+        CY_ASSERT(0);
+    }
+
+#if (ACQUISITION_MODE != ACQ_MODE_EOS_INTERRUPT)
+    /* Enable the FIFO on top of the configuration of the device configurator */
+    sar0_config.fifoCfgPtr = &sar_fifo_config;
+    sar1_config.fifoCfgPtr = &sar_fifo_config;
+#endif
+
+    /* Initialize and enable SAR0 and SAR1 */
+    sar_configure();
+
+    /* Scale every channel to microvolts with its calibration */
+    for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+    {
+        processing_channel_scale_init(&channel_scale[channel][0],
+            Cy_SAR_CountsTo_uVolts(SAR0, channel, 0),
+            Cy_SAR_CountsTo_uVolts(SAR0, channel, (int16_t)CALIB_SPAN_COUNTS));
+        processing_channel_scale_init(&channel_scale[channel][1],
+            Cy_SAR_CountsTo_uVolts(SAR1, channel, 0),
+            Cy_SAR_CountsTo_uVolts(SAR1, channel, (int16_t)CALIB_SPAN_COUNTS));
+    }
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+    sar_dma_init(SAR0, SAR1);
+#elif (ACQUISITION_MODE == ACQ_MODE_EOS_INTERRUPT)
+    sample_queue_init(&eos_queue, eos_queue_storage, ACQ_QUEUE_SIZE);
+#endif
+
+    /* The SAR interrupts also carry the events of the window comparator,
+       so they are used in every acquisition mode */
+    (void)Cy_SysInt_Init(&SAR0_IRQ_cfg, sar0_interrupt);
+    (void)Cy_SysInt_Init(&SAR1_IRQ_cfg, sar1_interrupt);
+
+    /* Enable the SAR interrupts */
+    NVIC_EnableIRQ(SAR0_IRQ_cfg.intrSrc);
+    NVIC_EnableIRQ(SAR1_IRQ_cfg.intrSrc);
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    /* Initialize the PASS timer, which is enabled by acquisition_start() */
+    result = Cy_SysAnalog_TimerInit(PASS, &pass_timer_config);
+    if (CY_SYSANALOG_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    trigger_period = pass_timer_config.period;
+#else
+    /* Start the time base of the timestamps */
+    timebase_init();
+
+    /* Initialize TCPWM Counter */
+    result = Cy_TCPWM_Counter_Init(TCPWM0, TCPWM_CNT_NUM, &tcpwm_0_group_0_cnt_0_config);
+    if(CY_TCPWM_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Enable the initialized counter */
+    Cy_TCPWM_Counter_Enable(TCPWM0, TCPWM_CNT_NUM);
+
+    trigger_period = tcpwm_0_group_0_cnt_0_config.period;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_start
+********************************************************************************
+* Summary:
+* This function starts the TCPWM counter, or the PASS timer, that triggers
+* both SARs.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_start(void)
+{
+    trigger_restart();
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_period
+********************************************************************************
+* Summary:
+* This function changes the period of the 32-bit TCPWM counter, or of the
+* PASS timer, that triggers both SARs. The trigger is stopped, so no trigger
+* occurs while the period is changed, and then restarted from zero. A scan in
+* progress is not affected.
+*
+* Parameters:
+*  period: New period in trigger clocks, at least acquisition_get_min_period()
+*
+* Return:
+*  bool: true if the period was changed, false if it is out of range
+*
+*******************************************************************************/
+bool acquisition_set_period(uint32_t period)
+{
+    if (period < acquisition_get_min_period())
+    {
+        return false;
+    }
+
+    trigger_stop();
+    trigger_period = period;
+    trigger_restart();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_period
+********************************************************************************
+* Summary:
+* This function returns the period of the trigger of both SARs.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Period in trigger clocks
+*
+*******************************************************************************/
+uint32_t acquisition_get_period(void)
+{
+    return trigger_period;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_min_period
+********************************************************************************
+* Summary:
+* This function returns the shortest trigger period that leaves enough time
+* for a complete scan of all channels, including averaging, with the current
+* SAR settings. It is never below ACQ_MIN_PERIOD.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Minimum period in trigger clocks
+*
+*******************************************************************************/
+uint32_t acquisition_get_min_period(void)
+{
+    uint32_t averages = sar0_channels[SAR_CHANNEL].avgEn ? (2UL << (uint32_t)sar0_config.avgCnt) : 1UL;
+    uint32_t max_rate = scan_max_rate(averages, sar0_config.acqTime[SAR_SAMPLE_TIME]);
+    uint32_t period = (ACQ_TRIGGER_CLOCK_HZ + max_rate - 1UL) / max_rate;
+
+#if (ACQ_DEEP_SLEEP == 0U)
+    /* The TCPWM counter overflows every period + 1 clocks */
+    period--;
+#endif
+
+    return (period < ACQ_MIN_PERIOD) ? ACQ_MIN_PERIOD : period;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_acq_time
+********************************************************************************
+* Summary:
+* This function changes the acquisition time of the channel sampled by both
+* SARs. The SARs are reinitialized between two scans: the trigger counter is
+* stopped, the scan in progress is completed, and the counter is restarted
+* with its current period, or with the minimum period if the scan became
+* longer than the current period. Results waiting in the SAR FIFOs are
+* discarded.
+*
+* Parameters:
+*  acq_time_ns: New acquisition time in nanoseconds
+*
+* Return:
+*  bool: true if the acquisition time was changed, false if it is out of range
+*
+*******************************************************************************/
+bool acquisition_set_acq_time(uint32_t acq_time_ns)
+{
+    uint32_t sar_clocks = acq_time_to_clocks(acq_time_ns);
+
+    if (0UL == sar_clocks)
+    {
+        return false;
+    }
+
+    acquisition_pause();
+
+    sar0_config.acqTime[SAR_SAMPLE_TIME] = (uint16_t)sar_clocks;
+    sar1_config.acqTime[SAR_SAMPLE_TIME] = (uint16_t)sar_clocks;
+    sar_configure();
+    current_profile = ACQ_PROFILE_CUSTOM;
+
+    acquisition_resume();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_acq_time
+********************************************************************************
+* Summary:
+* This function returns the acquisition time of the channel sampled by both
+* SARs.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Acquisition time in nanoseconds
+*
+*******************************************************************************/
+uint32_t acquisition_get_acq_time(void)
+{
+    return (uint32_t)(((uint64_t)sar0_config.acqTime[SAR_SAMPLE_TIME] * 1000000000ULL)
+                      / sar_clock_hz());
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_profile
+********************************************************************************
+* Summary:
+* This function applies an acquisition profile: the averaging of every
+* channel, the number of averaged conversions and the acquisition time are
+* changed on both SARs together. The SARs are reinitialized between two scans
+* as in acquisition_set_acq_time(), and the trigger period is extended if the
+* scans of the profile do not fit in it.
+*
+* Parameters:
+*  profile: ACQ_PROFILE_FAST, ACQ_PROFILE_BALANCED or ACQ_PROFILE_HIGH_RES
+*
+* Return:
+*  bool: true if the profile was applied, false if it is unknown or its
+*  acquisition time cannot be set with the SAR clock
+*
+*******************************************************************************/
+bool acquisition_set_profile(uint32_t profile)
+{
+    const acq_profile_t *settings;
+    uint32_t sar_clocks;
+    uint32_t channel;
+
+    if (profile >= ACQ_PROFILE_COUNT)
+    {
+        return false;
+    }
+
+    settings = &acq_profiles[profile];
+    sar_clocks = acq_time_to_clocks(settings->acq_time_ns);
+    if (0UL == sar_clocks)
+    {
+        return false;
+    }
+
+    acquisition_pause();
+
+    for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+    {
+        sar0_channels[channel].avgEn = settings->averaging;
+        sar1_channels[channel].avgEn = settings->averaging;
+    }
+
+    sar0_config.avgCnt = settings->avg_count;
+    sar1_config.avgCnt = settings->avg_count;
+    sar0_config.avgMode = CY_SAR_AVG_MODE_SEQUENTIAL_FIXED;
+    sar1_config.avgMode = CY_SAR_AVG_MODE_SEQUENTIAL_FIXED;
+    sar0_config.acqTime[SAR_SAMPLE_TIME] = (uint16_t)sar_clocks;
+    sar1_config.acqTime[SAR_SAMPLE_TIME] = (uint16_t)sar_clocks;
+    sar_configure();
+    current_profile = profile;
+
+    acquisition_resume();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_profile
+********************************************************************************
+* Summary:
+* This function returns the acquisition profile in use.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Profile, or ACQ_PROFILE_CUSTOM if no profile was applied or the
+*  acquisition time was changed since
+*
+*******************************************************************************/
+uint32_t acquisition_get_profile(void)
+{
+    return current_profile;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_profile_info
+********************************************************************************
+* Summary:
+* This function describes an acquisition profile. The highest trigger rate
+* includes the averaged conversions of every channel, and is bounded by
+* ACQ_MIN_PERIOD. The ENOB is estimated from the typical ENOB of a single
+* conversion, improved by half a bit per doubling of the number of averaged
+* conversions, up to the 12-bit resolution of the results.
+* acquisition_measure_noise() measures the ENOB obtained on the board.
+*
+* Parameters:
+*  profile: ACQ_PROFILE_FAST, ACQ_PROFILE_BALANCED or ACQ_PROFILE_HIGH_RES
+*  info: Description to fill
+*
+* Return:
+*  bool: true if the profile exists
+*
+*******************************************************************************/
+bool acquisition_get_profile_info(uint32_t profile, acq_profile_info_t *info)
+{
+    const acq_profile_t *settings;
+    uint32_t doublings;
+    uint32_t sar_clocks;
+
+    if (profile >= ACQ_PROFILE_COUNT)
+    {
+        return false;
+    }
+
+    settings = &acq_profiles[profile];
+    doublings = settings->averaging ? ((uint32_t)settings->avg_count + 1UL) : 0UL;
+    sar_clocks = acq_time_to_clocks(settings->acq_time_ns);
+
+    info->name = settings->name;
+    info->averages = 1UL << doublings;
+    info->acq_time_ns = settings->acq_time_ns;
+    info->max_rate = scan_max_rate(info->averages, (0UL != sar_clocks) ? sar_clocks : SAR_MAX_ACQ_CLOCKS);
+    if (info->max_rate > ACQ_MAX_TRIGGER_RATE)
+    {
+        info->max_rate = ACQ_MAX_TRIGGER_RATE;
+    }
+    info->enob_x10 = SAR_BASE_ENOB_X10 + (5UL * doublings);
+    if (info->enob_x10 > (SAR_RESULT_BITS * 10UL))
+    {
+        info->enob_x10 = SAR_RESULT_BITS * 10UL;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_sample_rate
+********************************************************************************
+* Summary:
+* This function returns the effective sample rate: the number of sample pairs
+* per second produced with the current trigger period. Each sample pair is
+* the result of all conversions averaged by the current settings.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Sample pairs per second
+*
+*******************************************************************************/
+uint32_t acquisition_get_sample_rate(void)
+{
+    return ACQ_TRIGGER_CLOCK_HZ / acquisition_get_interval();
+}
+
+/*******************************************************************************
+* Function Name: acq_time_to_clocks
+********************************************************************************
+* Summary:
+* This function converts an acquisition time to SAR clocks, rounded up.
+*
+* Parameters:
+*  acq_time_ns: Acquisition time in nanoseconds
+*
+* Return:
+*  uint32_t: Acquisition time in SAR clocks, 0 if it cannot be set
+*
+*******************************************************************************/
+static uint32_t acq_time_to_clocks(uint32_t acq_time_ns)
+{
+    uint64_t sar_clocks = (((uint64_t)acq_time_ns * sar_clock_hz()) + 999999999ULL) / 1000000000ULL;
+
+    if ((sar_clocks < SAR_MIN_ACQ_CLOCKS) || (sar_clocks > SAR_MAX_ACQ_CLOCKS))
+    {
+        return 0UL;
+    }
+
+    return (uint32_t)sar_clocks;
+}
+
+/*******************************************************************************
+* Function Name: scan_max_rate
+********************************************************************************
+* Summary:
+* This function returns the highest trigger rate at which a scan of all
+* channels, each with its averaged conversions, completes before the next
+* trigger.
+*
+* Parameters:
+*  averages: Conversions per result
+*  acq_clocks: Acquisition time in SAR clocks
+*
+* Return:
+*  uint32_t: Trigger rate in Hz, at least 1
+*
+*******************************************************************************/
+static uint32_t scan_max_rate(uint32_t averages, uint32_t acq_clocks)
+{
+    uint32_t scan_clocks = ACQ_NUM_CHANNELS * averages * (acq_clocks + SAR_CONVERSION_CLOCKS);
+    uint32_t rate = sar_clock_hz() / scan_clocks;
+
+    return (0UL != rate) ? rate : 1UL;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_pause
+********************************************************************************
+* Summary:
+* This function stops the trigger and waits until both SARs completed the
+* scan in progress, so that the SARs can be reconfigured.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void acquisition_pause(void)
+{
+    trigger_stop();
+
+    while ((0UL != (SAR0->STATUS & SAR_STATUS_BUSY_Msk)) ||
+           (0UL != (SAR1->STATUS & SAR_STATUS_BUSY_Msk)))
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: acquisition_resume
+********************************************************************************
+* Summary:
+* This function restarts the trigger stopped by acquisition_pause(). If the
+* reconfigured scan no longer fits in the trigger period, the period is
+* extended to the minimum period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void acquisition_resume(void)
+{
+    if (trigger_period < acquisition_get_min_period())
+    {
+        trigger_period = acquisition_get_min_period();
+    }
+
+    trigger_restart();
+}
+
+/*******************************************************************************
+* Function Name: trigger_stop
+********************************************************************************
+* Summary:
+* This function stops the TCPWM counter, or the PASS timer, that triggers both
+* SARs. A scan in progress is not affected.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void trigger_stop(void)
+{
+#if (ACQ_DEEP_SLEEP != 0U)
+    Cy_SysAnalog_TimerDisable(PASS);
+#else
+    Cy_TCPWM_TriggerStopOrKill_Single(TCPWM0, TCPWM_CNT_NUM);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: trigger_restart
+********************************************************************************
+* Summary:
+* This function loads trigger_period into the TCPWM counter, or the PASS
+* timer, and starts it from zero.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void trigger_restart(void)
+{
+    /* The next interval between timestamps is not a trigger period */
+    last_timestamp_valid = false;
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    /* Disabling the timer resets its count */
+    Cy_SysAnalog_TimerDisable(PASS);
+    Cy_SysAnalog_TimerSetPeriod(PASS, trigger_period);
+    Cy_SysAnalog_TimerEnable(PASS);
+#else
+    Cy_TCPWM_Counter_SetPeriod(TCPWM0, TCPWM_CNT_NUM, trigger_period);
+    Cy_TCPWM_Counter_SetCounter(TCPWM0, TCPWM_CNT_NUM, 0UL);
+    Cy_TCPWM_TriggerStart_Single(TCPWM0, TCPWM_CNT_NUM);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sar_clock_hz
+********************************************************************************
+* Summary:
+* This function returns the frequency of the clock of both SARs: the MF clock
+* in deep sleep acquisition, the peripheral clock divider otherwise.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: SAR clock in Hz
+*
+*******************************************************************************/
+static uint32_t sar_clock_hz(void)
+{
+#if (ACQ_DEEP_SLEEP != 0U)
+    return Cy_SysClk_ClkMfGetFrequency();
+#else
+    return Cy_SysClk_PeriphGetFrequency(CY_SYSCLK_DIV_8_BIT, SAR_CLOCK_DIVIDER);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sar_configure
+********************************************************************************
+* Summary:
+* This function initializes SAR0 and SAR1 with sar0_config and sar1_config,
+* enables them and sets their interrupt masks for the acquisition mode. The
+* SARs must be idle.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sar_configure(void)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+
+    Cy_SAR_Disable(SAR0);
+    Cy_SAR_Disable(SAR1);
+
+    /* Initialize SAR0 and SAR1 */
+    result = Cy_SAR_Init(SAR0, &sar0_config);
+    if (CY_SAR_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_SAR_Init(SAR1, &sar1_config);
+    if (CY_SAR_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Enable SAR block */
+    Cy_SAR_Enable(SAR0);
+    Cy_SAR_Enable(SAR1);
+
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+    /* Both FIFOs are filled by the same simultaneous trigger, so the level
+       interrupt of SAR0 alone marks a complete block of sample pairs */
+    Cy_SAR_SetInterruptMask(SAR0, CY_SAR_INTR_FIFO_LEVEL | CY_SAR_INTR_FIFO_OVERFLOW);
+    Cy_SAR_SetInterruptMask(SAR1, CY_SAR_INTR_FIFO_OVERFLOW);
+#elif (ACQUISITION_MODE == ACQ_MODE_DMA)
+    /* The SAR results are moved by DMA; no SAR interrupt is used */
+    Cy_SAR_SetInterruptMask(SAR0, 0UL);
+    Cy_SAR_SetInterruptMask(SAR1, 0UL);
+#else
+    /* Both SARs are started by the same simultaneous trigger, so the
+       End-Of-Scan interrupt of SAR0 alone services the pair */
+    Cy_SAR_SetInterruptMask(SAR0, CY_SAR_INTR_EOS);
+    Cy_SAR_SetInterruptMask(SAR1, 0UL);
+#endif
+
+    /* The range and saturation interrupts are masked by Cy_SAR_Init() */
+    monitor_unmask();
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_product_calib
+********************************************************************************
+* Summary:
+* This function derives the constants of the fixed-point product from the
+* counts to microvolts conversion of SAR0 and SAR1. It must be called after
+* acquisition_init() and again whenever the SAR offset or gain is changed.
+*
+* Parameters:
+*  calib: Product constants to initialize
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_get_product_calib(product_calib_t *calib)
+{
+    processing_product_calib_init(calib,
+        Cy_SAR_CountsTo_uVolts(SAR0, SAR_CHANNEL, 0),
+        Cy_SAR_CountsTo_uVolts(SAR0, SAR_CHANNEL, (int16_t)CALIB_SPAN_COUNTS),
+        Cy_SAR_CountsTo_uVolts(SAR1, SAR_CHANNEL, 0),
+        Cy_SAR_CountsTo_uVolts(SAR1, SAR_CHANNEL, (int16_t)CALIB_SPAN_COUNTS));
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_block
+********************************************************************************
+* Summary:
+* This function returns the sample pairs acquired since the previous call.
+* In End-Of-Scan interrupt mode, all sample pairs queued by the SAR0 interrupt
+* are returned. In FIFO mode, all complete scans in the SAR FIFOs are returned once
+* the FIFO level interrupt occurred. In DMA mode, the half of the DMA buffer
+* that was completed last is returned.
+*
+* The returned block stays valid until the next call of this function. In
+* DMA mode, it stays valid for the time taken to fill the other half of the
+* DMA buffer.
+*
+* The returned sample pairs are those of channel 0. If a channel callback is
+* registered, the results of all channels are also scaled into the channel
+* block, which is passed to the callback by acquisition_process_channels().
+*
+* Parameters:
+*  pairs: Location to store the address of the first sample pair
+*
+* Return:
+*  uint32_t: Number of sample pairs in the block, 0 if none is ready
+*
+*******************************************************************************/
+uint32_t acquisition_get_block(const sample_pair_t **pairs)
+{
+    uint32_t count = acquisition_read_block(pairs);
+
+    timestamps_check(count);
+    scans_read += count;
+
+    if (0UL != noise_scans)
+    {
+        noise_accumulate(*pairs, count);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_read_block
+********************************************************************************
+* Summary:
+* This function reads the sample pairs acquired since the previous call in
+* the acquisition mode. See acquisition_get_block().
+*
+* Parameters:
+*  pairs: Location to store the address of the first sample pair
+*
+* Return:
+*  uint32_t: Number of sample pairs in the block, 0 if none is ready
+*
+*******************************************************************************/
+static uint32_t acquisition_read_block(const sample_pair_t **pairs)
+{
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+    cy_stc_sar_fifo_read_t fifo_data;
+    int16_t counts0;
+    uint32_t count;
+    uint32_t scan;
+    uint32_t channel;
+
+    if (!fifo_level_set)
+    {
+        return 0UL;
+    }
+
+    /* Clear the flag */
+    fifo_level_set = false;
+
+    /* SAR1 may still be completing the last scan of the block, so only the
+       complete scans present in both FIFOs are read. The FIFOs hold the
+       results of each scan in channel order. */
+    count = Cy_SAR_FifoGetDataCount(SAR0);
+    if (Cy_SAR_FifoGetDataCount(SAR1) < count)
+    {
+        count = Cy_SAR_FifoGetDataCount(SAR1);
+    }
+    count /= ACQ_NUM_CHANNELS;
+
+    /* Drain the FIFOs */
+    for (scan = 0UL; scan < count; scan++)
+    {
+        for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+        {
+            Cy_SAR_FifoRead(SAR0, &fifo_data);
+            counts0 = (int16_t)fifo_data.value;
+            Cy_SAR_FifoRead(SAR1, &fifo_data);
+
+            if (SAR_CHANNEL == channel)
+            {
+                fifo_block[scan].sar0 = counts0;
+                fifo_block[scan].sar1 = (int16_t)fifo_data.value;
+            }
+            channel_block_store(channel, scan, counts0, (int16_t)fifo_data.value);
+        }
+    }
+
+    /* The level was reached by scan ACQ_FIFO_LEVEL / ACQ_NUM_CHANNELS of the block */
+#if (ACQ_DEEP_SLEEP != 0U)
+    timestamps_spread(count, 0UL, (uint64_t)scans_read * acquisition_get_interval());
+#else
+    timestamps_spread(count, (ACQ_FIFO_LEVEL / ACQ_NUM_CHANNELS) - 1UL, fifo_level_time);
+#endif
+
+    channel_block.scans = count;
+    *pairs = fifo_block;
+    return count;
+#elif (ACQUISITION_MODE == ACQ_MODE_DMA)
+    uint32_t scan;
+
+    *pairs = sar_dma_get_block();
+    if (NULL == *pairs)
+    {
+        return 0UL;
+    }
+
+    for (scan = 0UL; scan < ACQ_DMA_BLOCK_PAIRS; scan++)
+    {
+        channel_block_store(SAR_CHANNEL, scan, (*pairs)[scan].sar0, (*pairs)[scan].sar1);
+    }
+
+    timestamps_spread(ACQ_DMA_BLOCK_PAIRS, ACQ_DMA_BLOCK_PAIRS - 1UL, sar_dma_get_block_time());
+
+    /* The halves filled while the blocks were held were not read. Their
+       scans are counted from the trigger times, instead of as gaps. */
+    if (monitor_resumed)
+    {
+        monitor_resumed = false;
+        if (last_timestamp_valid && (block_timestamps[0] > last_timestamp))
+        {
+            scan = (uint32_t)((block_timestamps[0] - last_timestamp + (acquisition_get_interval() / 2UL)) /
+                              acquisition_get_interval());
+            if (scan > 1UL)
+            {
+                scans_read += scan - 1UL;
+            }
+        }
+        last_timestamp_valid = false;
+    }
+
+    channel_block.scans = ACQ_DMA_BLOCK_PAIRS;
+    return ACQ_DMA_BLOCK_PAIRS;
+#else
+    uint32_t count;
+    uint32_t scan;
+    uint32_t channel;
+
+    /* Take every scan queued since the previous call */
+    count = sample_queue_pop(&eos_queue, eos_entries, ACQ_QUEUE_SIZE);
+    for (scan = 0UL; scan < count; scan++)
+    {
+        eos_block[scan] = eos_entries[scan].pairs[SAR_CHANNEL];
+        block_timestamps[scan] = eos_entries[scan].timestamp;
+
+        for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+        {
+            channel_block_store(channel, scan, eos_entries[scan].pairs[channel].sar0,
+                                eos_entries[scan].pairs[channel].sar1);
+        }
+    }
+
+    channel_block.scans = count;
+    *pairs = eos_block;
+    return count;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_measure_noise
+********************************************************************************
+* Summary:
+* This function starts a noise measurement of channel 0 of both SARs over the
+* next ACQ_NOISE_SCANS scans. The inputs must be constant during the
+* measurement. A measurement in progress is restarted.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_measure_noise(void)
+{
+    uint32_t sar;
+
+    for (sar = 0UL; sar < ACQ_NUM_SARS; sar++)
+    {
+        noise_sum[sar] = 0;
+        noise_sum_squares[sar] = 0ULL;
+    }
+
+    noise_ready = false;
+    noise_scans = ACQ_NOISE_SCANS;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_noise
+********************************************************************************
+* Summary:
+* This function returns the result of the noise measurement started by
+* acquisition_measure_noise(), once. The ENOB is derived from the RMS noise
+* and the quantization noise of the 12-bit results:
+*
+* ENOB = 12 - log2(sqrt(12 * rms^2 + 1))
+*
+* Parameters:
+*  noise: Result to fill
+*
+* Return:
+*  bool: true if a measurement completed since the previous call
+*
+*******************************************************************************/
+bool acquisition_get_noise(acq_noise_t *noise)
+{
+    double variance;
+    uint32_t sar;
+
+    if (!noise_ready)
+    {
+        return false;
+    }
+
+    noise_ready = false;
+
+    for (sar = 0UL; sar < ACQ_NUM_SARS; sar++)
+    {
+        /* The sums are exact, so the variance is calculated without cancellation */
+        variance = (double)(((int64_t)ACQ_NOISE_SCANS * (int64_t)noise_sum_squares[sar])
+                            - (noise_sum[sar] * noise_sum[sar]))
+                   / ((double)ACQ_NOISE_SCANS * (double)ACQ_NOISE_SCANS);
+
+        noise->mean[sar] = (float)((double)noise_sum[sar] / (double)ACQ_NOISE_SCANS);
+        noise->rms[sar] = (float)sqrt(variance);
+        noise->enob[sar] = (float)((double)SAR_RESULT_BITS - (0.5 * log2((12.0 * variance) + 1.0)));
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: noise_accumulate
+********************************************************************************
+* Summary:
+* This function adds the sample pairs of a block to the sums of the noise
+* measurement, up to the number of scans still to measure.
+*
+* Parameters:
+*  pairs: Sample pairs of channel 0
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void noise_accumulate(const sample_pair_t *pairs, uint32_t count)
+{
+    uint32_t index;
+
+    if (count > noise_scans)
+    {
+        count = noise_scans;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        noise_sum[0] += pairs[index].sar0;
+        noise_sum[1] += pairs[index].sar1;
+        noise_sum_squares[0] += (uint64_t)((int32_t)pairs[index].sar0 * pairs[index].sar0);
+        noise_sum_squares[1] += (uint64_t)((int32_t)pairs[index].sar1 * pairs[index].sar1);
+    }
+
+    noise_scans -= count;
+    if (0UL == noise_scans)
+    {
+        noise_ready = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: channel_block_store
+********************************************************************************
+* Summary:
+* This function scales the results of one channel of both SARs and stores
+* them in the channel block. Nothing is stored if no channel callback is
+* registered.
+*
+* Parameters:
+*  channel: SAR channel of the results
+*  scan: Index of the scan in the block
+*  counts0: Result of SAR0
+*  counts1: Result of SAR1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void channel_block_store(uint32_t channel, uint32_t scan, int16_t counts0, int16_t counts1)
+{
+    if (NULL != channel_callback)
+    {
+        channel_block.value[channel][0][scan] = processing_scale_counts(&channel_scale[channel][0], counts0);
+        channel_block.value[channel][1][scan] = processing_scale_counts(&channel_scale[channel][1], counts1);
+    }
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_channel_callback
+********************************************************************************
+* Summary:
+* This function registers the processing callback of the channel blocks. The
+* callback is called from acquisition_process_channels(), in the context of
+* the main loop.
+*
+* Parameters:
+*  callback: Processing callback, or NULL to stop scaling the channels
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_set_channel_callback(acquisition_channel_callback_t callback)
+{
+    channel_block.scans = 0UL;
+    channel_callback = callback;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_channel_scale
+********************************************************************************
+* Summary:
+* This function replaces the scaling of one channel of one SAR, for example
+* to report a current from the voltage across a shunt. The default scaling
+* is the calibrated input in microvolts.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  channel: SAR channel, below ACQ_NUM_CHANNELS
+*  scale: New channel scale
+*
+* Return:
+*  bool: true if the scale was changed, false if sar or channel is out of range
+*
+*******************************************************************************/
+bool acquisition_set_channel_scale(uint32_t sar, uint32_t channel, const channel_scale_t *scale)
+{
+    if ((sar >= ACQ_NUM_SARS) || (channel >= ACQ_NUM_CHANNELS))
+    {
+        return false;
+    }
+
+    channel_scale[channel][sar] = *scale;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_channel_scale
+********************************************************************************
+* Summary:
+* This function returns the scaling of one channel of one SAR.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  channel: SAR channel, below ACQ_NUM_CHANNELS
+*  scale: Location to store the channel scale
+*
+* Return:
+*  bool: true if the scale was returned, false if sar or channel is out of range
+*
+*******************************************************************************/
+bool acquisition_get_channel_scale(uint32_t sar, uint32_t channel, channel_scale_t *scale)
+{
+    if ((sar >= ACQ_NUM_SARS) || (channel >= ACQ_NUM_CHANNELS))
+    {
+        return false;
+    }
+
+    *scale = channel_scale[channel][sar];
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_process_channels
+********************************************************************************
+* Summary:
+* This function passes the channel block filled by the last call of
+* acquisition_get_block() to the processing callback, once.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_process_channels(void)
+{
+    if ((NULL != channel_callback) && (0UL != channel_block.scans))
+    {
+        channel_callback(&channel_block);
+        channel_block.scans = 0UL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_overruns
+********************************************************************************
+* Summary:
+* This function returns the number of sample pairs lost because the main loop
+* did not take them from the queue in time. Only the End-Of-Scan interrupt
+* mode uses the queue, the other modes return 0.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of lost sample pairs
+*
+*******************************************************************************/
+uint32_t acquisition_get_overruns(void)
+{
+#if (ACQUISITION_MODE == ACQ_MODE_EOS_INTERRUPT)
+    return eos_queue.overruns;
+#else
+    return 0UL;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_scans
+********************************************************************************
+* Summary:
+* This function returns the number of scans returned by
+* acquisition_get_block() since startup. Multiplied by the trigger period, it
+* measures the time elapsed without a timer that runs in deep sleep. The
+* value wraps around.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of scans
+*
+*******************************************************************************/
+uint32_t acquisition_get_scans(void)
+{
+    return scans_read;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_losses
+********************************************************************************
+* Summary:
+* This function returns the number of sample pairs lost at each stage of the
+* acquisition since startup. The SAR result overwrites, the FIFO overflows,
+* and the flag collapses count interrupts, each of which means at least one
+* lost scan; a collapse in DMA mode loses a half of the buffer. The results
+* moved by DMA are not checked for overwrites. A scan dropped for an
+* End-Of-Scan timeout of SAR1 is also a trigger gap.
+*
+* Parameters:
+*  losses: Location to store the counters
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_get_losses(acq_losses_t *losses)
+{
+    losses->result_overwrites = 0UL;
+    losses->eos_timeouts = 0UL;
+    losses->fifo_overflows = 0UL;
+    losses->flag_collapses = 0UL;
+    losses->queue_overruns = acquisition_get_overruns();
+    losses->trigger_gaps = timestamp_gaps;
+
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+    losses->fifo_overflows = fifo_overflows;
+    losses->flag_collapses = fifo_level_collapses;
+#elif (ACQUISITION_MODE == ACQ_MODE_DMA)
+    losses->flag_collapses = sar_dma_get_collapses();
+#else
+    losses->result_overwrites = result_overwrites;
+    losses->eos_timeouts = eos_timeouts;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_timestamps
+********************************************************************************
+* Summary:
+* This function returns the trigger times of the sample pairs of the last
+* block returned by acquisition_get_block(), in trigger clocks since startup.
+* In End-Of-Scan interrupt mode, every pair is timestamped by the interrupt.
+* In FIFO and DMA modes, one pair per block is timestamped by the interrupt
+* and the others are spaced by the trigger period. In deep sleep
+* acquisition, the time base is stopped and the timestamps are derived from
+* the number of scans.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  const uint64_t *: Timestamps, one per sample pair of the block
+*
+*******************************************************************************/
+const uint64_t *acquisition_get_timestamps(void)
+{
+    return block_timestamps;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_trigger_time
+********************************************************************************
+* Summary:
+* This function returns the time of the latest trigger of the SARs: the time
+* base minus the clocks counted by the trigger counter since its last
+* overflow. Called from the interrupt of a scan, it is the trigger time of
+* that scan, as long as the interrupt is served within one trigger period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Trigger time in trigger clocks since startup
+*
+*******************************************************************************/
+uint64_t acquisition_get_trigger_time(void)
+{
+#if (ACQ_DEEP_SLEEP != 0U)
+    return (uint64_t)scans_read * acquisition_get_interval();
+#else
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    uint64_t now = timebase_now();
+    uint32_t elapsed = Cy_TCPWM_Counter_GetCounter(TCPWM0, TCPWM_CNT_NUM);
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return now - elapsed;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_interval
+********************************************************************************
+* Summary:
+* This function returns the number of trigger clocks between two triggers. The
+* TCPWM counter counts from 0 to its period, so it overflows every period + 1
+* clocks; the PASS timer is programmed with the number of clocks.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Interval in trigger clocks
+*
+*******************************************************************************/
+uint32_t acquisition_get_interval(void)
+{
+#if (ACQ_DEEP_SLEEP != 0U)
+    return trigger_period;
+#else
+    return trigger_period + 1UL;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: acquisition_get_gaps
+********************************************************************************
+* Summary:
+* This function returns the number of triggers that produced no sample pair,
+* counted where two consecutive timestamps are more than one and a half
+* trigger periods apart. In End-Of-Scan interrupt mode, the pairs dropped
+* because the queue was full are also counted by acquisition_get_overruns().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of missing triggers
+*
+*******************************************************************************/
+uint32_t acquisition_get_gaps(void)
+{
+    return timestamp_gaps;
+}
+
+#if (ACQUISITION_MODE != ACQ_MODE_EOS_INTERRUPT)
+/*******************************************************************************
+* Function Name: timestamps_spread
+********************************************************************************
+* Summary:
+* This function timestamps the pairs of a block of consecutive scans from the
+* trigger time of one of them, spaced by the trigger period.
+*
+* Parameters:
+*  count: Number of sample pairs of the block
+*  anchor: Index of the pair whose trigger time is known
+*  anchor_time: Trigger time of that pair
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void timestamps_spread(uint32_t count, uint32_t anchor, uint64_t anchor_time)
+{
+    uint64_t interval = acquisition_get_interval();
+    uint32_t scan;
+
+    for (scan = 0UL; scan < count; scan++)
+    {
+        block_timestamps[scan] = (anchor_time + ((uint64_t)scan * interval)) - ((uint64_t)anchor * interval);
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: timestamps_check
+********************************************************************************
+* Summary:
+* This function compares each timestamp of a block with the previous one and
+* counts the triggers missing in between.
+*
+* Parameters:
+*  count: Number of sample pairs of the block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void timestamps_check(uint32_t count)
+{
+    uint64_t interval = acquisition_get_interval();
+    uint64_t delta;
+    uint32_t scan;
+
+    for (scan = 0UL; scan < count; scan++)
+    {
+        /* A late DMA completion interrupt can time a block after the
+           first pairs of the next one; that is not a missing trigger */
+        if (last_timestamp_valid && (block_timestamps[scan] > last_timestamp))
+        {
+            delta = block_timestamps[scan] - last_timestamp;
+            if ((2ULL * delta) > (3ULL * interval))
+            {
+                timestamp_gaps += (uint32_t)(((delta + (interval / 2ULL)) / interval) - 1ULL);
+            }
+        }
+
+        last_timestamp = block_timestamps[scan];
+        last_timestamp_valid = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: acquisition_set_monitor
+********************************************************************************
+* Summary:
+* This function configures the window comparator of one SAR. The limits are
+* converted to the counts of the SAR with its calibration. The hardware
+* compares every result of the selected channels with the limits of the SAR,
+* and a result that meets the condition, or a saturated conversion, raises an
+* interrupt once the monitor is enabled. A single threshold is the BELOW or
+* ABOVE condition. The pending events are discarded, and the acquisition is
+* not interrupted.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  window: Channels, condition and limits of the comparator
+*
+* Return:
+*  bool: true if the window was applied, false if a parameter is invalid or
+*        the window is empty
+*
+*******************************************************************************/
+bool acquisition_set_monitor(uint32_t sar, const acq_window_t *window)
+{
+    SAR_Type *base;
+    cy_stc_sar_config_t *config;
+
+    if ((sar >= ACQ_NUM_SARS) || (window->cond >= ACQ_RANGE_COUNT) ||
+        (0UL != (window->channels & ~SAR_CHANNEL_MASK)) || (window->low_uv >= window->high_uv))
+    {
+        return false;
+    }
+
+    base = (0UL == sar) ? SAR0 : SAR1;
+    config = (0UL == sar) ? &sar0_config : &sar1_config;
+
+    monitor_channels[sar] = window->channels;
+    monitor_cond[sar] = window->cond;
+    monitor_low[sar] = uv_to_counts(base, window->low_uv);
+    monitor_high[sar] = uv_to_counts(base, window->high_uv);
+
+    /* Keep the window in the configuration applied by sar_configure() */
+    config->rangeThresLow = (uint32_t)(uint16_t)monitor_low[sar];
+    config->rangeThresHigh = (uint32_t)(uint16_t)monitor_high[sar];
+    config->rangeCond = monitor_range_conds[window->cond];
+
+    Cy_SAR_SetLowLimit(base, config->rangeThresLow);
+    Cy_SAR_SetHighLimit(base, config->rangeThresHigh);
+    Cy_SAR_SetRangeCond(base, config->rangeCond);
+
+    acquisition_rearm_monitor();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_enable_monitor
+********************************************************************************
+* Summary:
+* This function enables or disables the range and saturation interrupts of
+* the channels compared by both SARs. The pending events are discarded.
+*
+* Parameters:
+*  enabled: true to enable the comparator interrupts
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_enable_monitor(bool enabled)
+{
+    monitor_enabled = enabled;
+    acquisition_rearm_monitor();
+}
+
+/*******************************************************************************
+* Function Name: acquisition_in_window
+********************************************************************************
+* Summary:
+* This function applies the condition of the comparator of one SAR to a
+* result of channel 0, as set by acquisition_set_monitor(). A result of a
+* channel that is not compared never meets it.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  counts: Result of channel 0
+*
+* Return:
+*  bool: true if the result would raise a range event
+*
+*******************************************************************************/
+bool acquisition_in_window(uint32_t sar, int16_t counts)
+{
+    if ((sar >= ACQ_NUM_SARS) || (0UL == (monitor_channels[sar] & (1UL << SAR_CHANNEL))))
+    {
+        return false;
+    }
+
+    switch (monitor_cond[sar])
+    {
+        case ACQ_RANGE_BELOW:
+            return (counts < monitor_low[sar]);
+        case ACQ_RANGE_INSIDE:
+            return (counts >= monitor_low[sar]) && (counts < monitor_high[sar]);
+        case ACQ_RANGE_ABOVE:
+            return (counts >= monitor_high[sar]);
+        default:
+            return (counts < monitor_low[sar]) || (counts >= monitor_high[sar]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: acquisition_take_events
+********************************************************************************
+* Summary:
+* This function returns the events of the window comparator raised since the
+* previous call and clears them.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: ACQ_EVENT_ bits
+*
+*******************************************************************************/
+uint32_t acquisition_take_events(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t events = monitor_events;
+
+    monitor_events = 0UL;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return events;
+}
+
+/*******************************************************************************
+* Function Name: acquisition_rearm_monitor
+********************************************************************************
+* Summary:
+* This function discards the pending comparator events and enables the
+* comparator interrupts again, or keeps them disabled if the monitor is
+* disabled. In DMA mode, an enabled monitor also holds the DMA blocks: the
+* CPU is no longer woken up by the acquisition, and the DMA buffer keeps the
+* latest sample pairs until a comparator event returns them, see
+* sar_dma_hold(). A hold longer than the wrap of the time base, about 71
+* minutes, shifts the trigger times of the capture, see timebase_now().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void acquisition_rearm_monitor(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    monitor_unmask();
+    monitor_events = 0UL;
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+    /* Only an event can end the hold, so at least one channel is compared */
+    if (monitor_enabled && (0UL != (monitor_channels[0] | monitor_channels[1])))
+    {
+        sar_dma_hold();
+        monitor_holding = true;
+    }
+    else
+    {
+        monitor_resume();
+    }
+#endif
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+/*******************************************************************************
+* Function Name: monitor_resume
+********************************************************************************
+* Summary:
+* This function ends the hold of the DMA blocks, if any. The half of the DMA
+* buffer completed before the current one is returned first, as the history
+* before the event.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void monitor_resume(void)
+{
+    if (monitor_holding)
+    {
+        monitor_holding = false;
+        monitor_resumed = true;
+        sar_dma_resume();
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: monitor_unmask
+********************************************************************************
+* Summary:
+* This function clears the range and saturation interrupts of all channels of
+* both SARs and enables those of the compared channels if the monitor is
+* enabled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void monitor_unmask(void)
+{
+    uint32_t mask0 = monitor_enabled ? monitor_channels[0] : 0UL;
+    uint32_t mask1 = monitor_enabled ? monitor_channels[1] : 0UL;
+
+    Cy_SAR_ClearRangeInterrupt(SAR0, SAR_CHANNEL_MASK);
+    Cy_SAR_ClearRangeInterrupt(SAR1, SAR_CHANNEL_MASK);
+    Cy_SAR_ClearSatInterrupt(SAR0, SAR_CHANNEL_MASK);
+    Cy_SAR_ClearSatInterrupt(SAR1, SAR_CHANNEL_MASK);
+
+    Cy_SAR_SetRangeInterruptMask(SAR0, mask0);
+    Cy_SAR_SetRangeInterruptMask(SAR1, mask1);
+    Cy_SAR_SetSatInterruptMask(SAR0, mask0);
+    Cy_SAR_SetSatInterruptMask(SAR1, mask1);
+}
+
+/*******************************************************************************
+* Function Name: uv_to_counts
+********************************************************************************
+* Summary:
+* This function converts a voltage to the result of channel 0 of a SAR, with
+* the calibration of the SAR, rounded and limited to the 12-bit range.
+*
+* Parameters:
+*  base: SAR0 or SAR1
+*  uv: Voltage in microvolts
+*
+* Return:
+*  int16_t: Result in counts
+*
+*******************************************************************************/
+static int16_t uv_to_counts(const SAR_Type *base, int32_t uv)
+{
+    int64_t uv_zero = Cy_SAR_CountsTo_uVolts(base, SAR_CHANNEL, 0);
+    int64_t uv_span = (int64_t)Cy_SAR_CountsTo_uVolts(base, SAR_CHANNEL, (int16_t)CALIB_SPAN_COUNTS) - uv_zero;
+    int64_t numerator = ((int64_t)uv - uv_zero) * (int64_t)CALIB_SPAN_COUNTS;
+    int64_t counts;
+
+    /* Round to the nearest count */
+    if (numerator >= 0)
+    {
+        counts = (numerator + (uv_span / 2)) / uv_span;
+    }
+    else
+    {
+        counts = (numerator - (uv_span / 2)) / uv_span;
+    }
+
+    if (counts < SAR_MIN_RESULT)
+    {
+        counts = SAR_MIN_RESULT;
+    }
+    else if (counts > SAR_MAX_RESULT)
+    {
+        counts = SAR_MAX_RESULT;
+    }
+
+    return (int16_t)counts;
+}
+
+/*******************************************************************************
+* Function Name: sar0_interrupt
+********************************************************************************
+* Summary:
+* This function is the handler for SAR0 interrupt. It records the events of
+* the window comparator of SAR0. In End-Of-Scan interrupt mode, it services
+* both SARs: it reads the results of all channels of SAR0 and SAR1 and queues
+* them as one scan. In DMA mode, only the comparator events are handled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sar0_interrupt(void)
+{
+#if (ACQUISITION_MODE != ACQ_MODE_DMA)
+    uint32_t entry_time = profiler_now();
+#endif
+#if (ACQUISITION_MODE == ACQ_MODE_EOS_INTERRUPT)
+    sample_entry_t entry;
+    uint32_t timeout = SAR1_EOS_TIMEOUT;
+    uint32_t channel;
+#endif
+
+    monitor_take_sar_events(SAR0, ACQ_EVENT_RANGE_SAR0, ACQ_EVENT_SAT_SAR0);
+
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+    /* Check if the FIFO holds a complete block. If yes, set fifo_level_set flag to true */
+    if (Cy_SAR_GetInterruptStatus(SAR0) & CY_SAR_INTR_FIFO_LEVEL)
+    {
+#if (ACQ_DEEP_SLEEP == 0U)
+        fifo_level_time = acquisition_get_trigger_time();
+#endif
+        if (fifo_level_set)
+        {
+            fifo_level_collapses++;
+        }
+        fifo_level_set = true;
+    }
+
+    /* The FIFO was full when a scan completed, so its results were lost */
+    if (Cy_SAR_GetInterruptStatus(SAR0) & CY_SAR_INTR_FIFO_OVERFLOW)
+    {
+        fifo_overflows++;
+    }
+
+    /* Clear the interrupts */
+    Cy_SAR_ClearInterrupt(SAR0, CY_SAR_INTR_FIFO_LEVEL | CY_SAR_INTR_FIFO_OVERFLOW);
+#elif (ACQUISITION_MODE == ACQ_MODE_EOS_INTERRUPT)
+    /* Check if End-Of-Scan trigger has occurred. If yes, queue the sample pair */
+    if (Cy_SAR_GetInterruptStatus(SAR0) & CY_SAR_INTR_EOS)
+    {
+        /* SAR1 runs the same scan from the same trigger and clock, so its
+           End-Of-Scan is already set or follows within a few cycles */
+        while ((0UL == (Cy_SAR_GetInterruptStatus(SAR1) & CY_SAR_INTR_EOS)) && (timeout > 0UL))
+        {
+            timeout--;
+        }
+
+        if (0UL == timeout)
+        {
+            /* The results of SAR1 still belong to the previous scan, so the
+               pair is dropped and counted instead of mixing two scans */
+            eos_timeouts++;
+            eos_scan++;
+        }
+        else
+        {
+            /* Retrieve values from SAR result registers */
+            for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+            {
+                entry.pairs[channel].sar0 = Cy_SAR_GetResult16(SAR0, channel);
+                entry.pairs[channel].sar1 = Cy_SAR_GetResult16(SAR1, channel);
+            }
+            entry.scan = eos_scan++;
+            entry.timestamp = acquisition_get_trigger_time();
+
+            /* A full queue counts an overrun instead of merging scans */
+            (void)sample_queue_push(&eos_queue, &entry);
+        }
+
+        /* An End-Of-Scan still pending when the next scan completed means
+           that the results of at least one scan were overwritten */
+        if (0UL != ((Cy_SAR_GetInterruptStatus(SAR0) | Cy_SAR_GetInterruptStatus(SAR1)) & CY_SAR_INTR_OVERFLOW))
+        {
+            result_overwrites++;
+        }
+
+        Cy_SAR_ClearInterrupt(SAR1, CY_SAR_INTR_EOS | CY_SAR_INTR_OVERFLOW);
+    }
+
+    /* Clear the interrupts */
+    Cy_SAR_ClearInterrupt(SAR0, CY_SAR_INTR);
+#endif
+
+#if (ACQUISITION_MODE != ACQ_MODE_DMA)
+    profiler_mark_eos(entry_time);
+    profiler_record(PROFILER_ISR, profiler_now() - entry_time);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sar1_interrupt
+********************************************************************************
+* Summary:
+* This function is the handler for SAR1 interrupt. The results of SAR1 are
+* read with those of SAR0, so it only records the events of the window
+* comparator of SAR1 and, in FIFO mode, the overflows of its FIFO.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sar1_interrupt(void)
+{
+    monitor_take_sar_events(SAR1, ACQ_EVENT_RANGE_SAR1, ACQ_EVENT_SAT_SAR1);
+
+#if (ACQUISITION_MODE == ACQ_MODE_FIFO)
+    if (Cy_SAR_GetInterruptStatus(SAR1) & CY_SAR_INTR_FIFO_OVERFLOW)
+    {
+        fifo_overflows++;
+        Cy_SAR_ClearInterrupt(SAR1, CY_SAR_INTR_FIFO_OVERFLOW);
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: monitor_take_sar_events
+********************************************************************************
+* Summary:
+* This function records the range and saturation events of the channels of a
+* SAR and disables their interrupts, so that an input that stays outside the
+* window raises a single interrupt. acquisition_rearm_monitor() enables them
+* again. In DMA mode, an event ends the hold of the DMA blocks, so the CPU
+* collects the pairs before and after it.
+*
+* Parameters:
+*  base: SAR0 or SAR1
+*  range_event: Event bit of a range interrupt of this SAR
+*  sat_event: Event bit of a saturation interrupt of this SAR
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void monitor_take_sar_events(SAR_Type *base, uint32_t range_event, uint32_t sat_event)
+{
+    uint32_t range = Cy_SAR_GetRangeInterruptStatusMasked(base);
+    uint32_t saturation = Cy_SAR_GetSatInterruptStatusMasked(base);
+
+    if (0UL != range)
+    {
+        Cy_SAR_SetRangeInterruptMask(base, 0UL);
+        Cy_SAR_ClearRangeInterrupt(base, range);
+        monitor_events |= range_event;
+    }
+
+    if (0UL != saturation)
+    {
+        Cy_SAR_SetSatInterruptMask(base, 0UL);
+        Cy_SAR_ClearSatInterrupt(base, saturation);
+        monitor_events |= sat_event;
+    }
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+    if ((0UL != range) || (0UL != saturation))
+    {
+        monitor_resume();
+    }
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,327 @@
+/******************************************************************************
+* File Name:   acquisition.h
+*
+* Description: This file contains the declarations of the SAR ADC
+*              acquisition functions.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ACQUISITION_H_
+#define ACQUISITION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "processing.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Acquisition modes */
+/* One End-Of-Scan interrupt of SAR0 per scan, whose handler reads both SARs
+   into a sample queue. The main loop takes every queued scan per wakeup. */
+#define ACQ_MODE_EOS_INTERRUPT      (0U)
+/* Results are collected in the SAR FIFOs and read in blocks */
+#define ACQ_MODE_FIFO               (1U)
+/* Results are moved by DMA into a ping-pong buffer */
+#define ACQ_MODE_DMA                (2U)
+
+/* Acquisition mode used by the application. Can be overridden in the
+ * DEFINES variable of the Makefile.
+ */
+#ifndef ACQUISITION_MODE
+#define ACQUISITION_MODE            (ACQ_MODE_EOS_INTERRUPT)
+#endif
+
+/* Number of sample pairs in the SAR FIFOs that wakes up the CPU. The FIFO
+ * of each SAR holds 64 results, so half of it is left for the time taken
+ * to wake up and drain the FIFOs.
+ */
+#ifndef ACQ_FIFO_LEVEL
+#define ACQ_FIFO_LEVEL              (32UL)
+#endif
+
+/* Deep sleep acquisition, FIFO mode only. When enabled, the SARs are clocked
+ * by the deep sleep clock of the PASS and triggered by the PASS timer from
+ * the 32.768 kHz low-frequency clock, so they keep filling their FIFOs while
+ * the CPU is in deep sleep. The CPU wakes up once per ACQ_FIFO_LEVEL sample
+ * pairs. Can be overridden in the DEFINES variable of the Makefile.
+ */
+#ifndef ACQ_DEEP_SLEEP
+#define ACQ_DEEP_SLEEP              (0U)
+#endif
+
+#if (ACQ_DEEP_SLEEP != 0U)
+/* Clock of the PASS timer that triggers the SARs */
+#define ACQ_TRIGGER_CLOCK_HZ        (32768UL)
+
+/* Trigger period set at startup, about 100 Hz */
+#define ACQ_DEEP_SLEEP_PERIOD       (328UL)
+
+/* Minimum trigger period in PASS timer clocks (32.768 kHz) */
+#ifndef ACQ_MIN_PERIOD
+#define ACQ_MIN_PERIOD              (2UL)
+#endif
+#else
+/* Clock of the TCPWM counter that triggers the SARs */
+#define ACQ_TRIGGER_CLOCK_HZ        (1000000UL)
+
+/* Minimum trigger period in TCPWM counter clocks (1 MHz). It must leave
+ * enough time for a complete scan, including averaging.
+ */
+#ifndef ACQ_MIN_PERIOD
+#define ACQ_MIN_PERIOD              (20UL)
+#endif
+#endif
+
+/* Number of sample pairs the End-Of-Scan interrupts can queue while the main
+ * loop is busy. Must be a power of two.
+ */
+#ifndef ACQ_QUEUE_SIZE
+#define ACQ_QUEUE_SIZE              (64UL)
+#endif
+
+/* Number of sample pairs in each half of the DMA ping-pong buffer. One DMA
+ * descriptor transfers at most 256 elements.
+ */
+#ifndef ACQ_DMA_BLOCK_PAIRS
+#define ACQ_DMA_BLOCK_PAIRS         (128UL)
+#endif
+
+/* Number of channels scanned by each SAR on every trigger, from 1 to 16.
+ * Channel 0 of both SARs feeds the product, all channels are passed to the
+ * channel callback. It must match the channels enabled for SAR0 and SAR1 in
+ * the device configurator. In FIFO mode, ACQ_FIFO_LEVEL should be a multiple
+ * of it. DMA mode supports a single channel.
+ */
+#ifndef ACQ_NUM_CHANNELS
+#define ACQ_NUM_CHANNELS            (1UL)
+#endif
+
+/* Acquisition profiles, applied to both SARs together */
+#define ACQ_PROFILE_FAST            (0UL)   /* No averaging, short acquisition time */
+#define ACQ_PROFILE_BALANCED        (1UL)   /* 4 conversions averaged per result */
+#define ACQ_PROFILE_HIGH_RES        (2UL)   /* 256 conversions averaged per result */
+#define ACQ_PROFILE_COUNT           (3UL)
+
+/* Settings of the device configurator, or changed by acquisition_set_acq_time() */
+#define ACQ_PROFILE_CUSTOM          (ACQ_PROFILE_COUNT)
+
+/* Number of scans of a noise measurement */
+#ifndef ACQ_NOISE_SCANS
+#define ACQ_NOISE_SCANS             (1024UL)
+#endif
+
+/* Number of SARs sampled simultaneously */
+#define ACQ_NUM_SARS                (2UL)
+
+/* Conditions of the window comparator of a SAR, see acquisition_set_monitor() */
+#define ACQ_RANGE_BELOW             (0UL)   /* result < low */
+#define ACQ_RANGE_INSIDE            (1UL)   /* low <= result < high */
+#define ACQ_RANGE_ABOVE             (2UL)   /* result >= high */
+#define ACQ_RANGE_OUTSIDE           (3UL)   /* result < low or result >= high */
+#define ACQ_RANGE_COUNT             (4UL)
+
+/* Events of the window comparators, see acquisition_set_monitor() */
+#define ACQ_EVENT_RANGE_SAR0        (1UL << 0)  /* SAR0 result meets the condition */
+#define ACQ_EVENT_RANGE_SAR1        (1UL << 1)  /* SAR1 result meets the condition */
+#define ACQ_EVENT_SAT_SAR0          (1UL << 2)  /* SAR0 conversion saturated */
+#define ACQ_EVENT_SAT_SAR1          (1UL << 3)  /* SAR1 conversion saturated */
+
+/* Largest number of scans in one channel block */
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+#define ACQ_CHANNEL_BLOCK_SCANS     (ACQ_DMA_BLOCK_PAIRS)
+#else
+#define ACQ_CHANNEL_BLOCK_SCANS     (64UL)
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Scaled results of a block of scans of all channels. The block is stored
+ * channel-major: the results of one channel of one SAR are contiguous, in
+ * the order of the scans.
+ */
+typedef struct
+{
+    uint32_t scans;         /* Number of scans in the block */
+    int32_t value[ACQ_NUM_CHANNELS][ACQ_NUM_SARS][ACQ_CHANNEL_BLOCK_SCANS];
+} channel_block_t;
+
+/* Description of an acquisition profile */
+typedef struct
+{
+    const char *name;       /* Name of the profile */
+    uint32_t averages;      /* Conversions averaged per result */
+    uint32_t acq_time_ns;   /* Acquisition time in nanoseconds */
+    uint32_t max_rate;      /* Highest trigger rate in Hz that completes every scan */
+    uint32_t enob_x10;      /* Estimated ENOB in tenths of a bit */
+} acq_profile_info_t;
+
+/* Noise of channel 0 of both SARs measured with a constant input */
+typedef struct
+{
+    float mean[ACQ_NUM_SARS];   /* Mean result in counts */
+    float rms[ACQ_NUM_SARS];    /* RMS noise in counts */
+    float enob[ACQ_NUM_SARS];   /* ENOB derived from the RMS noise */
+} acq_noise_t;
+
+/* Sample pairs lost at each stage of the acquisition since startup. Each
+ * counter only applies to the acquisition modes noted, the others are 0.
+ */
+typedef struct
+{
+    uint32_t result_overwrites; /* Scans overwritten in the SAR result registers (EOS) */
+    uint32_t fifo_overflows;    /* Overflows of the FIFO of either SAR (FIFO) */
+    uint32_t flag_collapses;    /* Blocks signaled again before being read (FIFO, DMA), or overwritten while processed (DMA) */
+    uint32_t queue_overruns;    /* Sample pairs lost to a full queue (EOS) */
+    uint32_t trigger_gaps;      /* Triggers without a sample pair (all) */
+    uint32_t eos_timeouts;      /* Sample pairs dropped without the End-Of-Scan of SAR1 (EOS) */
+} acq_losses_t;
+
+/* Window comparator of one SAR. The SAR has one pair of limits and one
+ * condition, shared by the channels compared with them.
+ */
+typedef struct
+{
+    uint32_t channels;      /* Channels compared, bit n for channel n, 0 for none */
+    uint32_t cond;          /* ACQ_RANGE_ condition that raises an event */
+    int32_t low_uv;         /* Low limit in microvolts */
+    int32_t high_uv;        /* High limit in microvolts, above the low limit */
+} acq_window_t;
+
+/* Processing callback, called with every channel block */
+typedef void (*acquisition_channel_callback_t)(const channel_block_t *block);
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Initializes SAR0, SAR1, their interrupts and the trigger counter */
+void acquisition_init(void);
+
+/* Starts the periodic hardware trigger of the SARs */
+void acquisition_start(void);
+
+/* Changes the trigger period, in trigger clocks */
+bool acquisition_set_period(uint32_t period);
+
+/* Returns the trigger period, in trigger clocks */
+uint32_t acquisition_get_period(void);
+
+/* Returns the shortest trigger period that completes every scan */
+uint32_t acquisition_get_min_period(void);
+
+/* Changes the acquisition time of both SARs, in nanoseconds */
+bool acquisition_set_acq_time(uint32_t acq_time_ns);
+
+/* Returns the acquisition time of both SARs, in nanoseconds */
+uint32_t acquisition_get_acq_time(void);
+
+/* Applies an acquisition profile to both SARs */
+bool acquisition_set_profile(uint32_t profile);
+
+/* Returns the acquisition profile in use */
+uint32_t acquisition_get_profile(void);
+
+/* Describes an acquisition profile */
+bool acquisition_get_profile_info(uint32_t profile, acq_profile_info_t *info);
+
+/* Returns the number of sample pairs per second with the current settings */
+uint32_t acquisition_get_sample_rate(void);
+
+/* Starts a noise measurement over the next ACQ_NOISE_SCANS scans */
+void acquisition_measure_noise(void);
+
+/* Returns the result of the noise measurement once it is complete */
+bool acquisition_get_noise(acq_noise_t *noise);
+
+/* Derives the constants of the fixed-point product from the SAR calibration */
+void acquisition_get_product_calib(product_calib_t *calib);
+
+/* Returns the sample pairs acquired since the previous call */
+uint32_t acquisition_get_block(const sample_pair_t **pairs);
+
+/* Registers the processing callback of the channel blocks, NULL to remove it */
+void acquisition_set_channel_callback(acquisition_channel_callback_t callback);
+
+/* Replaces the scaling of one channel of one SAR */
+bool acquisition_set_channel_scale(uint32_t sar, uint32_t channel, const channel_scale_t *scale);
+
+/* Returns the scaling of one channel of one SAR */
+bool acquisition_get_channel_scale(uint32_t sar, uint32_t channel, channel_scale_t *scale);
+
+/* Passes the channel block of the last block of sample pairs to the callback */
+void acquisition_process_channels(void);
+
+/* Number of sample pairs lost because the main loop was late */
+uint32_t acquisition_get_overruns(void);
+
+/* Number of scans returned by acquisition_get_block() since startup */
+uint32_t acquisition_get_scans(void);
+
+/* Returns the trigger times of the sample pairs of the last block, in trigger clocks */
+const uint64_t *acquisition_get_timestamps(void);
+
+/* Returns the time of the latest trigger, in trigger clocks since startup */
+uint64_t acquisition_get_trigger_time(void);
+
+/* Returns the number of trigger clocks between two sample pairs */
+uint32_t acquisition_get_interval(void);
+
+/* Number of triggers without a sample pair, detected from the timestamps */
+uint32_t acquisition_get_gaps(void);
+
+/* Returns the loss counters of all stages of the acquisition */
+void acquisition_get_losses(acq_losses_t *losses);
+
+/* Configures the window comparator of one SAR */
+bool acquisition_set_monitor(uint32_t sar, const acq_window_t *window);
+
+/* Enables or disables the comparator interrupts of both SARs */
+void acquisition_enable_monitor(bool enabled);
+
+/* Returns true if a result of channel 0 of one SAR meets the condition of its comparator */
+bool acquisition_in_window(uint32_t sar, int16_t counts);
+
+/* Returns and clears the comparator events raised since the previous call */
+uint32_t acquisition_take_events(void);
+
+/* Re-enables the comparator interrupts disabled by an event */
+void acquisition_rearm_monitor(void);
+
+#endif /* ACQUISITION_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,177 @@
+/******************************************************************************
+* File Name:   benchmark.c
+*
+* Description: This file contains the benchmarks of the signal processing.
+*              They run in the main loop on synthetic data and report their
+*              results on the telemetry output.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "benchmark.h"
+#include "acquisition.h"
+#include "processing.h"
+#include "profiler.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Constants of the linear congruential generator of the synthetic results */
+#define BENCH_LCG_MULTIPLIER        (1664525UL)
+#define BENCH_LCG_INCREMENT         (1013904223UL)
+
+/* Mask of a 12-bit SAR result */
+#define BENCH_COUNTS_MASK           (0x0FFFUL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Converts a number of sample pairs processed in a duration to pairs per second */
+static uint32_t bench_rate(uint32_t pairs, uint32_t ticks);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Synthetic sample pairs and the CTDAC codes calculated from them */
+static sample_pair_t bench_pairs[BENCH_MAX_BLOCK];
+static uint16_t bench_codes[BENCH_MAX_BLOCK];
+
+/*******************************************************************************
+* Function Name: benchmark_product_kernel
+********************************************************************************
+* Summary:
+* This function measures the number of sample pairs per second converted to
+* CTDAC codes by processing_block_to_dac() for block sizes from
+* BENCH_MIN_BLOCK to BENCH_MAX_BLOCK, and by processing_counts_to_dac_code()
+* called once per pair for comparison. Every block size processes
+* BENCH_PAIRS_PER_SIZE pairs of random 12-bit results. Codes that differ
+* between the two calculations are counted. The acquisition keeps running,
+* so its interrupts are included in the measurement.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void benchmark_product_kernel(void)
+{
+    product_calib_t calib;
+    uint32_t random = 1UL;
+    uint32_t mismatches = 0UL;
+    uint32_t block_size;
+    uint32_t repeat;
+    uint32_t index;
+    uint32_t start;
+    uint32_t block_ticks;
+    uint32_t pair_ticks;
+
+    acquisition_get_product_calib(&calib);
+
+    for (index = 0UL; index < BENCH_MAX_BLOCK; index++)
+    {
+        random = (random * BENCH_LCG_MULTIPLIER) + BENCH_LCG_INCREMENT;
+        bench_pairs[index].sar0 = (int16_t)((random >> 8U) & BENCH_COUNTS_MASK);
+        bench_pairs[index].sar1 = (int16_t)((random >> 20U) & BENCH_COUNTS_MASK);
+    }
+
+    (void)telemetry_printf("Product kernel (pairs/s):\r\n");
+
+    for (block_size = BENCH_MIN_BLOCK; block_size <= BENCH_MAX_BLOCK; block_size *= 2UL)
+    {
+        start = profiler_now();
+        for (repeat = 0UL; repeat < (BENCH_PAIRS_PER_SIZE / block_size); repeat++)
+        {
+            processing_block_to_dac(&calib, bench_pairs, bench_codes, block_size);
+        }
+        block_ticks = profiler_now() - start;
+
+        for (index = 0UL; index < block_size; index++)
+        {
+            if ((uint32_t)bench_codes[index] != processing_counts_to_dac_code(&calib,
+                bench_pairs[index].sar0, bench_pairs[index].sar1))
+            {
+                mismatches++;
+            }
+        }
+
+        start = profiler_now();
+        for (repeat = 0UL; repeat < (BENCH_PAIRS_PER_SIZE / block_size); repeat++)
+        {
+            for (index = 0UL; index < block_size; index++)
+            {
+                bench_codes[index] = (uint16_t)processing_counts_to_dac_code(&calib,
+                    bench_pairs[index].sar0, bench_pairs[index].sar1);
+            }
+        }
+        pair_ticks = profiler_now() - start;
+
+        (void)telemetry_printf("%6lu: block %10lu, per pair %10lu\r\n", (unsigned long)block_size,
+                               (unsigned long)bench_rate(BENCH_PAIRS_PER_SIZE, block_ticks),
+                               (unsigned long)bench_rate(BENCH_PAIRS_PER_SIZE, pair_ticks));
+    }
+
+    (void)telemetry_printf("Mismatched codes: %lu\r\n", (unsigned long)mismatches);
+}
+
+/*******************************************************************************
+* Function Name: bench_rate
+********************************************************************************
+* Summary:
+* This function converts a number of sample pairs processed in a duration to
+* a number of sample pairs per second.
+*
+* Parameters:
+*  pairs: Number of sample pairs
+*  ticks: Duration in profiler ticks
+*
+* Return:
+*  uint32_t: Sample pairs per second
+*
+*******************************************************************************/
+static uint32_t bench_rate(uint32_t pairs, uint32_t ticks)
+{
+    if (0UL == ticks)
+    {
+        return 0UL;
+    }
+
+    return (uint32_t)(((uint64_t)pairs * profiler_ticks_per_second()) / ticks);
+}
+
+/* [] END OF FILE */
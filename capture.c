@@ -0,0 +1,345 @@
+/******************************************************************************
+* File Name:   capture.c
+*
+* Description: This file packs the sample pairs into chunks of the
+*              columnar capture format, with optional delta coding.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "capture.h"
+#include "crc16.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Offsets of the header fields */
+#define CAPTURE_FLAGS_OFFSET        (5UL)
+#define CAPTURE_COUNT_OFFSET        (6UL)
+#define CAPTURE_INDEX_OFFSET        (8UL)
+#define CAPTURE_TIME_OFFSET         (12UL)
+#define CAPTURE_INTERVAL_OFFSET     (20UL)
+#define CAPTURE_RANGE_OFFSET        (24UL)
+#define CAPTURE_LENGTH_OFFSET       (32UL)
+
+/* Number of columns, one per SAR */
+#define CAPTURE_COLUMNS             (2UL)
+
+/* Range of a difference coded in one byte */
+#define CAPTURE_DELTA_MIN           (-127L)
+#define CAPTURE_DELTA_MAX           (127L)
+
+#if ((CAPTURE_PAD_SIZE + CAPTURE_CHUNK_SIZE) > TELEMETRY_BUFFER_SIZE)
+#error "A chunk must fit in the telemetry buffer"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+#if (CAPTURE_DELTA != 0U)
+/* Size of a column with delta coding */
+static uint32_t capture_delta_size(const int16_t *column, uint32_t count);
+#endif
+
+/* Writes a column, delta coded or not, and returns its size */
+static uint32_t capture_write_column(uint8_t *buffer, const int16_t *column, uint32_t count, bool delta);
+
+/* Stores a little endian value of up to 8 bytes */
+static void capture_put_le(uint8_t *buffer, uint64_t value, uint32_t size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Columns of the chunk being filled */
+static int16_t capture_columns[CAPTURE_COLUMNS][CAPTURE_CHUNK_PAIRS];
+static uint32_t capture_pairs = 0UL;
+
+/* Index, trigger time and interval of the first sample pair of the chunk */
+static uint32_t capture_first_index = 0UL;
+static uint64_t capture_first_time = 0ULL;
+static uint32_t capture_interval = 0UL;
+
+/* Index of the next sample pair added to the capture */
+static uint32_t capture_index = 0UL;
+
+/* Chunk being sent, after room for its pad byte */
+static uint8_t capture_buffer[CAPTURE_PAD_SIZE + CAPTURE_CHUNK_SIZE];
+
+/*******************************************************************************
+* Function Name: capture_put
+********************************************************************************
+* Summary:
+* This function adds a block of sample pairs, spaced by the given interval,
+* to the current chunk. Every time the chunk holds CAPTURE_CHUNK_PAIRS pairs,
+* it is sent. The chunk is sent early if the block does not continue it.
+*
+* Parameters:
+*  pairs: Sample pairs to add
+*  count: Number of sample pairs
+*  time: Trigger time of the first sample pair
+*  interval: Trigger clocks between two sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void capture_put(const sample_pair_t *pairs, uint32_t count, uint64_t time, uint32_t interval)
+{
+    uint32_t index;
+
+    if ((0UL != capture_pairs) && ((interval != capture_interval) ||
+        (time != (capture_first_time + ((uint64_t)capture_pairs * interval)))))
+    {
+        capture_flush();
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        if (0UL == capture_pairs)
+        {
+            capture_first_index = capture_index;
+            capture_first_time = time + ((uint64_t)index * interval);
+            capture_interval = interval;
+        }
+
+        capture_columns[0][capture_pairs] = pairs[index].sar0;
+        capture_columns[1][capture_pairs] = pairs[index].sar1;
+        capture_pairs++;
+        capture_index++;
+
+        if (CAPTURE_CHUNK_PAIRS == capture_pairs)
+        {
+            capture_flush();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: capture_flush
+********************************************************************************
+* Summary:
+* This function sends the sample pairs collected in the current chunk, with
+* delta coded columns if CAPTURE_DELTA is set and they are smaller. The
+* chunk follows a pad byte when the telemetry output has an odd length. A
+* chunk that does not fit in the telemetry buffer is dropped and counted by
+* the telemetry.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void capture_flush(void)
+{
+    uint32_t column;
+    uint32_t index;
+    uint32_t length = 0UL;
+    uint32_t pad;
+    uint8_t *chunk = &capture_buffer[CAPTURE_PAD_SIZE];
+    uint16_t crc;
+    int16_t minimum;
+    int16_t maximum;
+    bool delta = false;
+
+    if (0UL == capture_pairs)
+    {
+        return;
+    }
+
+#if (CAPTURE_DELTA != 0U)
+    delta = ((capture_delta_size(capture_columns[0], capture_pairs) +
+              capture_delta_size(capture_columns[1], capture_pairs)) <
+             (CAPTURE_COLUMNS * capture_pairs * sizeof(int16_t)));
+#endif
+
+    chunk[0] = CAPTURE_MAGIC0;
+    chunk[1] = CAPTURE_MAGIC1;
+    chunk[2] = CAPTURE_MAGIC2;
+    chunk[3] = CAPTURE_MAGIC3;
+    chunk[4] = CAPTURE_VERSION;
+    chunk[CAPTURE_FLAGS_OFFSET] = delta ? CAPTURE_FLAG_DELTA : 0U;
+    capture_put_le(&chunk[CAPTURE_COUNT_OFFSET], capture_pairs, 2UL);
+    capture_put_le(&chunk[CAPTURE_INDEX_OFFSET], capture_first_index, 4UL);
+    capture_put_le(&chunk[CAPTURE_TIME_OFFSET], capture_first_time, 8UL);
+    capture_put_le(&chunk[CAPTURE_INTERVAL_OFFSET], capture_interval, 4UL);
+
+    for (column = 0UL; column < CAPTURE_COLUMNS; column++)
+    {
+        minimum = capture_columns[column][0];
+        maximum = capture_columns[column][0];
+        for (index = 1UL; index < capture_pairs; index++)
+        {
+            if (capture_columns[column][index] < minimum)
+            {
+                minimum = capture_columns[column][index];
+            }
+            if (capture_columns[column][index] > maximum)
+            {
+                maximum = capture_columns[column][index];
+            }
+        }
+        capture_put_le(&chunk[CAPTURE_RANGE_OFFSET + (column * 4UL)], (uint16_t)minimum, 2UL);
+        capture_put_le(&chunk[CAPTURE_RANGE_OFFSET + (column * 4UL) + 2UL], (uint16_t)maximum, 2UL);
+
+        length += capture_write_column(&chunk[CAPTURE_HEADER_SIZE + length],
+                                       capture_columns[column], capture_pairs, delta);
+    }
+    capture_put_le(&chunk[CAPTURE_LENGTH_OFFSET], length, 4UL);
+
+    /* The magic is not covered by the CRC */
+    crc = crc16_update(CRC16_INIT, &chunk[4], (CAPTURE_HEADER_SIZE - 4UL) + length);
+    capture_put_le(&chunk[CAPTURE_HEADER_SIZE + length], crc, CAPTURE_CRC_SIZE);
+
+    /* The chunk starts at an even offset of the output, so that its int16
+       columns are aligned wherever the text before it ends */
+    pad = telemetry_get_offset() % 2UL;
+    capture_buffer[0] = CAPTURE_PAD;
+    (void)telemetry_write(&capture_buffer[CAPTURE_PAD_SIZE - pad],
+                          pad + CAPTURE_HEADER_SIZE + length + CAPTURE_CRC_SIZE);
+
+    capture_pairs = 0UL;
+}
+
+#if (CAPTURE_DELTA != 0U)
+/*******************************************************************************
+* Function Name: capture_delta_size
+********************************************************************************
+* Summary:
+* This function returns the size of a column with delta coding: 2 bytes for
+* the first result, then 1 byte per difference, or 3 bytes for a result whose
+* difference does not fit in one byte.
+*
+* Parameters:
+*  column: Results of the column
+*  count: Number of results
+*
+* Return:
+*  uint32_t: Size in bytes
+*
+*******************************************************************************/
+static uint32_t capture_delta_size(const int16_t *column, uint32_t count)
+{
+    uint32_t size = sizeof(int16_t);
+    uint32_t index;
+    int32_t difference;
+
+    for (index = 1UL; index < count; index++)
+    {
+        difference = (int32_t)column[index] - (int32_t)column[index - 1UL];
+        size += ((difference >= CAPTURE_DELTA_MIN) && (difference <= CAPTURE_DELTA_MAX)) ? 1UL : 3UL;
+    }
+
+    return size;
+}
+#endif /* (CAPTURE_DELTA != 0U) */
+
+/*******************************************************************************
+* Function Name: capture_write_column
+********************************************************************************
+* Summary:
+* This function writes the results of a column as int16 or delta coded.
+*
+* Parameters:
+*  buffer: Location of the column
+*  column: Results of the column
+*  count: Number of results
+*  delta: true for delta coding
+*
+* Return:
+*  uint32_t: Size of the column in bytes
+*
+*******************************************************************************/
+static uint32_t capture_write_column(uint8_t *buffer, const int16_t *column, uint32_t count, bool delta)
+{
+    uint32_t size = 0UL;
+    uint32_t index;
+    int32_t difference;
+
+    for (index = 0UL; index < count; index++)
+    {
+        difference = (0UL == index) ? (CAPTURE_DELTA_MAX + 1L) :
+                     ((int32_t)column[index] - (int32_t)column[index - 1UL]);
+
+        if (delta && (difference >= CAPTURE_DELTA_MIN) && (difference <= CAPTURE_DELTA_MAX))
+        {
+            buffer[size] = (uint8_t)(int8_t)difference;
+            size++;
+        }
+        else
+        {
+            /* The first result of a delta column has no escape */
+            if (delta && (0UL != index))
+            {
+                buffer[size] = CAPTURE_DELTA_ESCAPE;
+                size++;
+            }
+            capture_put_le(&buffer[size], (uint16_t)column[index], 2UL);
+            size += 2UL;
+        }
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+* Function Name: capture_put_le
+********************************************************************************
+* Summary:
+* This function stores a value of up to 8 bytes in little endian order.
+*
+* Parameters:
+*  buffer: Location of the value
+*  value: Value to store
+*  size: Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void capture_put_le(uint8_t *buffer, uint64_t value, uint32_t size)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < size; index++)
+    {
+        buffer[index] = (uint8_t)(value >> (8UL * index));
+    }
+}
+
+/* [] END OF FILE */
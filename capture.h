@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name:   capture.h
+*
+* Description: This file contains the declarations of the chunked
+*              columnar capture format of the sample pairs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* A capture is a sequence of chunks. Multi-byte fields are little endian.
+ *
+ *  Offset  Size     Field
+ *  0       4        Magic, CAPTURE_MAGIC0 to CAPTURE_MAGIC3 ("SARC")
+ *  4       1        Version, CAPTURE_VERSION
+ *  5       1        Flags, CAPTURE_FLAG_DELTA if the columns are delta coded
+ *  6       2        Number of sample pairs N
+ *  8       4        Index of the first sample pair in the capture
+ *  12      8        Trigger time of the first sample pair, in trigger clocks
+ *  20      4        Trigger clocks between two sample pairs
+ *  24      2        Smallest SAR0 result of the chunk
+ *  26      2        Largest SAR0 result of the chunk
+ *  28      2        Smallest SAR1 result of the chunk
+ *  30      2        Largest SAR1 result of the chunk
+ *  32      4        Length L of the columns in bytes
+ *  36      L        Column of the N SAR0 results, then column of the N SAR1 results
+ *  36 + L  2        CRC-16/CCITT-FALSE of bytes 4 to 35 + L
+ *
+ * Without CAPTURE_FLAG_DELTA, each column holds N int16 results. With it,
+ * each column holds the first result as int16, then one byte per following
+ * result: the difference to the previous result as int8, or
+ * CAPTURE_DELTA_ESCAPE followed by the result as int16 if the difference
+ * does not fit. The smaller coding is chosen for each chunk.
+ *
+ * The trigger time of pair n of a chunk is the time of its first pair plus n
+ * times the interval. A chunk is closed early when the interval changes or a
+ * block of sample pairs does not follow the previous one. The trigger times
+ * of the chunks show the triggers without a sample pair, and their first
+ * indexes show the chunks dropped by the telemetry. Responses to
+ * commands are sent as text between the chunks; a reader skips the bytes
+ * that do not start a chunk with a valid CRC.
+ *
+ * Every chunk starts at an even offset of the output, after a CAPTURE_PAD
+ * byte when the text or the chunk before it has an odd length. The int16
+ * columns of a chunk without CAPTURE_FLAG_DELTA are then 2-byte aligned in a
+ * file saved from the start of the output, and can be read in place. The
+ * delta coded columns must be decoded, so set CAPTURE_DELTA to 0 for
+ * captures read in place.
+ */
+#define CAPTURE_MAGIC0              (0x53U)
+#define CAPTURE_MAGIC1              (0x41U)
+#define CAPTURE_MAGIC2              (0x52U)
+#define CAPTURE_MAGIC3              (0x43U)
+#define CAPTURE_VERSION             (1U)
+#define CAPTURE_FLAG_DELTA          (0x01U)
+#define CAPTURE_DELTA_ESCAPE        (0x80U)
+#define CAPTURE_PAD                 (0x00U)
+
+/* Size of the pad byte before a chunk at an odd offset */
+#define CAPTURE_PAD_SIZE            (1UL)
+
+/* Size of the chunk fields around the columns */
+#define CAPTURE_HEADER_SIZE         (36UL)
+#define CAPTURE_CRC_SIZE            (2UL)
+
+/* Number of sample pairs of a full chunk */
+#ifndef CAPTURE_CHUNK_PAIRS
+#define CAPTURE_CHUNK_PAIRS         (128UL)
+#endif
+
+/* Set to 0 to always send the int16 columns, which a reader uses in place */
+#ifndef CAPTURE_DELTA
+#define CAPTURE_DELTA               (1U)
+#endif
+
+/* Size of a full chunk without delta coding */
+#define CAPTURE_CHUNK_SIZE          (CAPTURE_HEADER_SIZE + (CAPTURE_CHUNK_PAIRS * 4UL) + CAPTURE_CRC_SIZE)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Adds a block of evenly spaced sample pairs, sending every complete chunk */
+void capture_put(const sample_pair_t *pairs, uint32_t count, uint64_t time, uint32_t interval);
+
+/* Sends the sample pairs collected so far as a shorter chunk */
+void capture_flush(void);
+
+#endif /* CAPTURE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,751 @@
+/******************************************************************************
+* File Name:   command.c
+*
+* Description: This file contains the command interface over the debug UART.
+*              Commands are read without waiting, so they are executed between
+*              two blocks of sample pairs. Single character commands are
+*              executed immediately, commands with an argument when Enter
+*              is received.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "command.h"
+#include "acquisition.h"
+#include "decimator.h"
+#include "benchmark.h"
+#include "meter.h"
+#include "correlator.h"
+#include "spectrum.h"
+#include "sample_stream.h"
+#include "profiler.h"
+#include "power.h"
+#include "monitor.h"
+#include "telemetry.h"
+#include "stats.h"
+#include "replay.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Executes a command with its argument */
+static void command_execute(uint8_t command, uint32_t argument);
+
+/* Reports the acquisition profiles */
+static void command_report_profiles(void);
+
+/* Reports the result of a delay measurement */
+static void command_report_correlation(const corr_result_t *result);
+
+/* Reports the result of a spectrum analysis */
+static void command_report_spectrum(const spectrum_result_t *result);
+
+/* Queues the bins of the spectrum while the telemetry has room */
+static void command_dump_bins(void);
+
+/* Queues the capture of the last monitor event while the telemetry has room */
+static void command_dump_event(void);
+
+/* Reports the counters of a replay once it is complete */
+static void command_report_replay(void);
+
+/* Rate of the sample pairs after the decimation filter */
+static uint32_t command_output_rate(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Command waiting for its argument, 0 if none */
+static uint8_t pending_command = 0U;
+
+/* Argument received so far and its number of digits */
+static uint32_t pending_argument = 0UL;
+static uint32_t pending_digits = 0UL;
+
+/* Noise measurement in progress */
+static bool noise_pending = false;
+
+/* Next bin of the spectrum to report, equal to the number of bins when done */
+static uint32_t dump_bin = 0UL;
+static uint32_t dump_bins = 0UL;
+
+/* A replay was started and is not reported yet */
+static bool replay_running = false;
+
+/* SAR whose monitor window is set by the window commands */
+static uint32_t monitor_sar = 0UL;
+
+/* Names of the conditions of the monitor window, indexed by ACQ_RANGE_ condition */
+static const char *const monitor_cond_names[ACQ_RANGE_COUNT] = { "below", "inside", "above", "outside" };
+
+/* Monitor event being reported and its next sample pair */
+static monitor_event_t dump_event;
+static bool dump_event_active = false;
+static uint32_t dump_pair = 0UL;
+
+/*******************************************************************************
+* Function Name: command_process
+********************************************************************************
+* Summary:
+* This function reads the characters received on the debug UART and executes
+* the corresponding commands. It returns immediately if nothing was received.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void command_process(void)
+{
+    uint8_t character;
+    acq_noise_t noise;
+    corr_result_t correlation;
+    spectrum_result_t spectrum;
+
+    /* The result is taken only when both lines fit, since it is reported once */
+    if (noise_pending && (telemetry_get_free() >= (2UL * TELEMETRY_MAX_MESSAGE)) &&
+        acquisition_get_noise(&noise))
+    {
+        noise_pending = false;
+        (void)telemetry_printf("SAR0 noise: mean %.1f, rms %.2f counts, ENOB %.1f\r\n",
+                               (double)noise.mean[0], (double)noise.rms[0], (double)noise.enob[0]);
+        (void)telemetry_printf("SAR1 noise: mean %.1f, rms %.2f counts, ENOB %.1f\r\n",
+                               (double)noise.mean[1], (double)noise.rms[1], (double)noise.enob[1]);
+    }
+
+    if (correlator_get_result(&correlation))
+    {
+        command_report_correlation(&correlation);
+    }
+
+    if (spectrum_get_result(&spectrum))
+    {
+        command_report_spectrum(&spectrum);
+    }
+
+    command_dump_bins();
+    command_dump_event();
+    command_report_replay();
+
+    while (cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0UL)
+    {
+        if (CY_RSLT_SUCCESS != cyhal_uart_getc(&cy_retarget_io_uart_obj, &character, 0UL))
+        {
+            break;
+        }
+
+        if (replay_is_receiving())
+        {
+            /* The trace takes every byte until its end */
+            replay_feed(character);
+        }
+        else if (0U != pending_command)
+        {
+            /* Collect the decimal argument until Enter */
+            if ((character >= (uint8_t)'0') && (character <= (uint8_t)'9') &&
+                (pending_digits < COMMAND_MAX_DIGITS))
+            {
+                pending_argument = (pending_argument * 10UL) + (uint32_t)(character - (uint8_t)'0');
+                pending_digits++;
+            }
+            else if (((character == (uint8_t)'\r') || (character == (uint8_t)'\n')) &&
+                     (pending_digits > 0UL))
+            {
+                command_execute(pending_command, pending_argument);
+                pending_command = 0U;
+            }
+            else
+            {
+                (void)telemetry_printf("Invalid argument\r\n");
+                pending_command = 0U;
+            }
+        }
+        else if ((character == (uint8_t)COMMAND_PERIOD) || (character == (uint8_t)COMMAND_ACQ_TIME) ||
+                 (character == (uint8_t)COMMAND_PROFILE_SELECT) || (character == (uint8_t)COMMAND_METER_WINDOW) ||
+                 (character == (uint8_t)COMMAND_CORRELATE) || (character == (uint8_t)COMMAND_SPECTRUM) ||
+                 (character == (uint8_t)COMMAND_MONITOR_SAR) || (character == (uint8_t)COMMAND_MONITOR_LOW) ||
+                 (character == (uint8_t)COMMAND_MONITOR_HIGH) || (character == (uint8_t)COMMAND_MONITOR_COND) ||
+                 (character == (uint8_t)COMMAND_MONITOR_CHANNELS) || (character == (uint8_t)COMMAND_REPLAY))
+        {
+            pending_command = character;
+            pending_argument = 0UL;
+            pending_digits = 0UL;
+        }
+        else
+        {
+            command_execute(character, 0UL);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_execute
+********************************************************************************
+* Summary:
+* This function executes one command and queues its response on the
+* telemetry output.
+*
+* Parameters:
+*  command: Command character
+*  argument: Decimal argument, 0 for commands without argument
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_execute(uint8_t command, uint32_t argument)
+{
+    acq_profile_info_t info;
+    monitor_window_t window;
+    uint32_t sar;
+
+    (void)monitor_get_window(monitor_sar, &window);
+
+    switch (command)
+    {
+        case COMMAND_PROFILE:
+            profiler_report(false);
+            break;
+
+        case COMMAND_HISTOGRAM:
+            profiler_report(true);
+            break;
+
+        case COMMAND_PROFILE_RESET:
+            profiler_reset();
+            (void)telemetry_printf("Profile cleared\r\n");
+            break;
+
+        case COMMAND_PERIOD:
+            if (!acquisition_set_period(argument))
+            {
+                (void)telemetry_printf("Period must be at least %lu\r\n",
+                                       (unsigned long)acquisition_get_min_period());
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_ACQ_TIME:
+            if (!acquisition_set_acq_time(argument))
+            {
+                (void)telemetry_printf("Acquisition time out of range\r\n");
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_PROFILE_SELECT:
+            if (!acquisition_set_profile(argument))
+            {
+                (void)telemetry_printf("Unknown profile\r\n");
+                command_report_profiles();
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_SETTINGS:
+            (void)telemetry_printf("Period: %lu clocks (%lu Hz), acquisition time: %lu ns\r\n",
+                                   (unsigned long)acquisition_get_period(),
+                                   (unsigned long)acquisition_get_sample_rate(),
+                                   (unsigned long)acquisition_get_acq_time());
+            if (acquisition_get_profile_info(acquisition_get_profile(), &info))
+            {
+                (void)telemetry_printf("Profile: %s, %lu averages, estimated ENOB %lu.%lu\r\n",
+                                       info.name, (unsigned long)info.averages,
+                                       (unsigned long)(info.enob_x10 / 10UL), (unsigned long)(info.enob_x10 % 10UL));
+            }
+            else
+            {
+                (void)telemetry_printf("Profile: custom\r\n");
+            }
+            if (decimator_is_enabled())
+            {
+                (void)telemetry_printf("Decimation: 1/%lu, output %lu Hz\r\n", (unsigned long)DECIM_RATIO,
+                                       (unsigned long)(acquisition_get_sample_rate() / DECIM_RATIO));
+            }
+            else
+            {
+                (void)telemetry_printf("Decimation: off\r\n");
+            }
+            (void)telemetry_printf("Power meter: %s, window %lu pairs\r\n",
+                                   meter_is_enabled() ? "on" : "off", (unsigned long)meter_get_window());
+            (void)telemetry_printf("Event monitor: %s, window commands set SAR%lu\r\n",
+                                   monitor_is_enabled() ? "on" : "off", (unsigned long)monitor_sar);
+            for (sar = 0UL; sar < ACQ_NUM_SARS; sar++)
+            {
+                (void)monitor_get_window(sar, &window);
+                (void)telemetry_printf("SAR%lu window: channels 0x%lx, %s %ld to %ld mV\r\n",
+                                       (unsigned long)sar, (unsigned long)window.channels,
+                                       monitor_cond_names[window.cond], (long)window.low_mv, (long)window.high_mv);
+            }
+            break;
+
+        case COMMAND_KERNEL_BENCHMARK:
+            benchmark_product_kernel();
+            break;
+
+        case COMMAND_METER:
+            meter_set_enabled(!meter_is_enabled());
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_METER_WINDOW:
+            if (!meter_set_window(argument))
+            {
+                (void)telemetry_printf("Window must be %lu to %lu pairs\r\n",
+                                       (unsigned long)METER_MIN_WINDOW, (unsigned long)METER_MAX_WINDOW);
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_CORRELATE:
+            /* The FFT work buffer holds one capture at a time */
+            spectrum_stop();
+            dump_bins = 0UL;
+            if (correlator_start(argument))
+            {
+                (void)telemetry_printf("Measuring delay over %lu pairs\r\n", (unsigned long)argument);
+            }
+            else
+            {
+                (void)telemetry_printf("Window must be %lu to %lu pairs\r\n",
+                                       (unsigned long)CORR_MIN_WINDOW, (unsigned long)CORR_MAX_WINDOW);
+            }
+            break;
+
+        case COMMAND_SPECTRUM:
+            correlator_stop();
+            dump_bins = 0UL;
+            if (spectrum_start(argument))
+            {
+                (void)telemetry_printf("Analyzing %lu pairs\r\n", (unsigned long)argument);
+            }
+            else
+            {
+                (void)telemetry_printf("Points must be a power of two from %lu to %lu\r\n",
+                                       (unsigned long)SPECTRUM_MIN_POINTS, (unsigned long)SPECTRUM_MAX_POINTS);
+            }
+            break;
+
+        case COMMAND_SPECTRUM_BINS:
+            if (0UL == spectrum_get_bins())
+            {
+                (void)telemetry_printf("No spectrum\r\n");
+            }
+            dump_bin = 0UL;
+            dump_bins = spectrum_get_bins();
+            break;
+
+        case COMMAND_MONITOR:
+            /* Toggling discards the capture being reported */
+            dump_event_active = false;
+            monitor_set_enabled(!monitor_is_enabled());
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_MONITOR_SAR:
+            if (argument < ACQ_NUM_SARS)
+            {
+                monitor_sar = argument;
+            }
+            else
+            {
+                (void)telemetry_printf("The SAR must be 0 or 1\r\n");
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_MONITOR_LOW:
+        case COMMAND_MONITOR_HIGH:
+        case COMMAND_MONITOR_COND:
+        case COMMAND_MONITOR_CHANNELS:
+            if (COMMAND_MONITOR_LOW == command)
+            {
+                window.low_mv = (int32_t)argument;
+            }
+            else if (COMMAND_MONITOR_HIGH == command)
+            {
+                window.high_mv = (int32_t)argument;
+            }
+            else if (COMMAND_MONITOR_COND == command)
+            {
+                window.cond = argument;
+            }
+            else
+            {
+                window.channels = argument;
+            }
+
+            /* A new window arms the monitor again, which discards the
+               capture being reported */
+            if ((argument <= ((uint32_t)INT32_MAX / 1000UL)) && monitor_set_window(monitor_sar, &window))
+            {
+                dump_event_active = false;
+            }
+            else if (COMMAND_MONITOR_COND == command)
+            {
+                (void)telemetry_printf("Conditions: 0 below, 1 inside, 2 above, 3 outside\r\n");
+            }
+            else if (COMMAND_MONITOR_CHANNELS == command)
+            {
+                (void)telemetry_printf("Channels: bit n for channel n, below %lu\r\n",
+                                       (unsigned long)(1UL << ACQ_NUM_CHANNELS));
+            }
+            else
+            {
+                (void)telemetry_printf("The low limit must be below the high limit\r\n");
+            }
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_POWER:
+            power_report();
+            break;
+
+        case COMMAND_STATS:
+            stats_report();
+            break;
+
+        case COMMAND_REPLAY:
+            if (argument > (uint32_t)REPLAY_REAL_TIME)
+            {
+                (void)telemetry_printf("Replay mode must be 0 (full speed) or 1 (real time)\r\n");
+                break;
+            }
+            replay_start((replay_mode_t)argument);
+            replay_running = true;
+            (void)telemetry_printf("Replaying the trace received on the UART, ESC to end\r\n");
+            break;
+
+        case COMMAND_DECIMATION:
+            decimator_set_enabled(!decimator_is_enabled());
+            command_execute(COMMAND_SETTINGS, 0UL);
+            break;
+
+        case COMMAND_NOISE:
+            acquisition_measure_noise();
+            noise_pending = true;
+            (void)telemetry_printf("Measuring noise over %lu scans\r\n", (unsigned long)ACQ_NOISE_SCANS);
+            break;
+
+        default:
+            /* Ignore unknown commands and line endings */
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_report_profiles
+********************************************************************************
+* Summary:
+* This function queues the list of acquisition profiles with their highest
+* sample rate and estimated ENOB.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_report_profiles(void)
+{
+    acq_profile_info_t info;
+    uint32_t profile;
+
+    for (profile = 0UL; profile < ACQ_PROFILE_COUNT; profile++)
+    {
+        (void)acquisition_get_profile_info(profile, &info);
+        (void)telemetry_printf("o%lu: %-8s %3lu averages, %4lu ns, up to %lu Hz, ENOB %lu.%lu\r\n",
+                               (unsigned long)profile, info.name, (unsigned long)info.averages,
+                               (unsigned long)info.acq_time_ns, (unsigned long)info.max_rate,
+                               (unsigned long)(info.enob_x10 / 10UL), (unsigned long)(info.enob_x10 % 10UL));
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_report_correlation
+********************************************************************************
+* Summary:
+* This function queues the delay of SAR1 after SAR0 in samples and in us at
+* the current output rate, and the phase at the strongest frequency when
+* the FFT path was used.
+*
+* Parameters:
+*  result: Result of the delay measurement
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_report_correlation(const corr_result_t *result)
+{
+    uint32_t rate = command_output_rate();
+
+    (void)telemetry_printf("Delay over %lu pairs: %.3f samples, %.2f us, correlation %.3f\r\n",
+                           (unsigned long)result->window, (double)result->delay,
+                           (0UL != rate) ? (((double)result->delay * 1000000.0) / (double)rate) : 0.0,
+                           (double)result->coefficient);
+
+    if (result->fft)
+    {
+        (void)telemetry_printf("Phase at %.1f Hz: %.1f degrees\r\n",
+                               (double)result->frequency * (double)rate, (double)result->phase);
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_report_spectrum
+********************************************************************************
+* Summary:
+* This function queues the fundamental, the THD, the SNR, the SINAD, and the
+* ENOB of both inputs.
+*
+* Parameters:
+*  result: Result of the spectrum analysis
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_report_spectrum(const spectrum_result_t *result)
+{
+    double bin_width = (double)command_output_rate() / (double)result->points;
+    uint32_t sar;
+
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        (void)telemetry_printf("SAR%lu: %.1f Hz at %.2f dBFS, THD %.1f dB, SNR %.1f dB, SINAD %.1f dB, ENOB %.2f\r\n",
+                               (unsigned long)sar, (double)result->sar[sar].frequency * bin_width,
+                               (double)result->sar[sar].amplitude, (double)result->sar[sar].thd,
+                               (double)result->sar[sar].snr, (double)result->sar[sar].sinad,
+                               (double)result->sar[sar].enob);
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_dump_bins
+********************************************************************************
+* Summary:
+* This function queues the magnitudes of the bins requested by the
+* COMMAND_SPECTRUM_BINS command, as text lines or as STREAM_FRAME_SPECTRUM
+* records depending on TELEMETRY_FORMAT. It stops when the telemetry buffer
+* is half full and continues on the next call, so the other messages are
+* not dropped.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_dump_bins(void)
+{
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    uint8_t record[SPECTRUM_RECORD_SIZE];
+    uint32_t length;
+#else
+    double bin_width;
+#endif
+
+    /* A new capture releases the bins */
+    if (dump_bins != spectrum_get_bins())
+    {
+        dump_bins = 0UL;
+    }
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    while ((dump_bin < dump_bins) && (telemetry_get_free() > (TELEMETRY_BUFFER_SIZE / 2UL)))
+    {
+        length = spectrum_pack_bins(dump_bin, record);
+        sample_stream_send(STREAM_FRAME_SPECTRUM, record, length);
+        dump_bin += SPECTRUM_RECORD_BINS;
+    }
+#else
+    bin_width = (double)command_output_rate() / (double)(2UL * dump_bins);
+    while ((dump_bin < dump_bins) && (telemetry_get_free() > (TELEMETRY_BUFFER_SIZE / 2UL)))
+    {
+        (void)telemetry_printf("%4lu %10.1f Hz %8.2f %8.2f dBFS\r\n", (unsigned long)dump_bin,
+                               (double)dump_bin * bin_width, (double)spectrum_get_magnitude(0UL, dump_bin),
+                               (double)spectrum_get_magnitude(1UL, dump_bin));
+        dump_bin++;
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: command_dump_event
+********************************************************************************
+* Summary:
+* This function reports the capture of the last monitor event: a header line
+* and one line per sample pair in counts, numbered from the trigger, or an
+* event record followed by sample frames in binary format. Like the spectrum
+* bins, the pairs are queued only while the telemetry buffer is less than
+* half full. The monitor is released once the capture is queued.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_dump_event(void)
+{
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    uint8_t record[MONITOR_RECORD_SIZE];
+    uint32_t count;
+#endif
+
+    if (!dump_event_active)
+    {
+        if (!monitor_get_event(&dump_event))
+        {
+            return;
+        }
+        dump_event_active = true;
+        dump_pair = 0UL;
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+        /* Start the capture on a frame boundary */
+        sample_stream_flush();
+        monitor_pack_event(&dump_event, record);
+        sample_stream_send(STREAM_FRAME_EVENT, record, MONITOR_RECORD_SIZE);
+#else
+        (void)telemetry_printf("Event:%s%s%s%s at scan %lu, %lu pairs before and %lu after\r\n",
+                               (0UL != (dump_event.events & ACQ_EVENT_RANGE_SAR0)) ? " SAR0 window" : "",
+                               (0UL != (dump_event.events & ACQ_EVENT_RANGE_SAR1)) ? " SAR1 window" : "",
+                               (0UL != (dump_event.events & ACQ_EVENT_SAT_SAR0)) ? " SAR0 saturated" : "",
+                               (0UL != (dump_event.events & ACQ_EVENT_SAT_SAR1)) ? " SAR1 saturated" : "",
+                               (unsigned long)dump_event.scan, (unsigned long)dump_event.pre,
+                               (unsigned long)(dump_event.pairs - dump_event.pre));
+#endif
+    }
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    while ((dump_pair < dump_event.pairs) && (telemetry_get_free() > (TELEMETRY_BUFFER_SIZE / 2UL)))
+    {
+        count = dump_event.pairs - dump_pair;
+        if (count > STREAM_FRAME_PAIRS)
+        {
+            count = STREAM_FRAME_PAIRS;
+        }
+        sample_stream_put(&dump_event.capture[dump_pair], count);
+        dump_pair += count;
+    }
+#else
+    while ((dump_pair < dump_event.pairs) && (telemetry_get_free() > (TELEMETRY_BUFFER_SIZE / 2UL)))
+    {
+        (void)telemetry_printf("%5ld %6d %6d\r\n", (long)dump_pair - (long)dump_event.pre,
+                               (int)dump_event.capture[dump_pair].sar0, (int)dump_event.capture[dump_pair].sar1);
+        dump_pair++;
+    }
+#endif
+
+    if (dump_pair >= dump_event.pairs)
+    {
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+        sample_stream_flush();
+#endif
+        dump_event_active = false;
+        monitor_release();
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_report_replay
+********************************************************************************
+* Summary:
+* This function reports the counters of a replay once the end of the trace
+* was received and all its sample pairs were processed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void command_report_replay(void)
+{
+    replay_stats_t stats;
+
+    if (!replay_running || replay_is_active())
+    {
+        return;
+    }
+
+    replay_get_stats(&stats);
+    if (telemetry_printf("Replay: %lu pairs, %lu frames, %lu CRC errors, %lu missing, %lu overflows\r\n",
+                         (unsigned long)stats.pairs, (unsigned long)stats.frames,
+                         (unsigned long)stats.crc_errors, (unsigned long)stats.sequence_gaps,
+                         (unsigned long)stats.overflows))
+    {
+        replay_running = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: command_output_rate
+********************************************************************************
+* Summary:
+* This function returns the rate of the sample pairs seen by the processing
+* after the main loop, which is reduced by the decimation filter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Rate in Hz
+*
+*******************************************************************************/
+static uint32_t command_output_rate(void)
+{
+    uint32_t rate = acquisition_get_sample_rate();
+
+    if (decimator_is_enabled())
+    {
+        rate /= DECIM_RATIO;
+    }
+
+    return rate;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name:   command.h
+*
+* Description: This file contains the declarations of the command interface
+*              over the debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Single character commands */
+#define COMMAND_PROFILE             ('p')   /* Report the profile */
+#define COMMAND_HISTOGRAM           ('h')   /* Report the profile with histograms */
+#define COMMAND_PROFILE_RESET       ('c')   /* Clear the profile */
+#define COMMAND_SETTINGS            ('s')   /* Report the acquisition settings */
+#define COMMAND_NOISE               ('n')   /* Measure the noise of channel 0 */
+#define COMMAND_DECIMATION          ('d')   /* Toggle the decimation filter */
+#define COMMAND_KERNEL_BENCHMARK    ('k')   /* Benchmark the product kernel */
+#define COMMAND_METER               ('m')   /* Toggle the power meter */
+#define COMMAND_SPECTRUM_BINS       ('b')   /* Report the bins of the last spectrum */
+#define COMMAND_POWER               ('u')   /* Report the CPU wakeups and duty cycle */
+#define COMMAND_MONITOR             ('e')   /* Toggle the event monitor */
+#define COMMAND_STATS               ('t')   /* Report the sample loss statistics */
+
+/* Commands followed by a decimal argument and Enter */
+#define COMMAND_PERIOD              ('r')   /* Set the trigger period in counter clocks */
+#define COMMAND_ACQ_TIME            ('a')   /* Set the acquisition time in ns */
+#define COMMAND_PROFILE_SELECT      ('o')   /* Apply an acquisition profile */
+#define COMMAND_METER_WINDOW        ('w')   /* Set the power meter window in sample pairs */
+#define COMMAND_CORRELATE           ('x')   /* Measure the delay over a window in sample pairs */
+#define COMMAND_SPECTRUM            ('f')   /* Analyze the spectrum of a block of sample pairs */
+#define COMMAND_MONITOR_SAR         ('j')   /* Select the SAR set by the monitor window commands, 0 or 1 */
+#define COMMAND_MONITOR_LOW         ('l')   /* Set the low limit of the monitor window in mV */
+#define COMMAND_MONITOR_HIGH        ('g')   /* Set the high limit of the monitor window in mV */
+#define COMMAND_MONITOR_COND        ('i')   /* Set the monitor condition: 0 below, 1 inside, 2 above, 3 outside */
+#define COMMAND_MONITOR_CHANNELS    ('q')   /* Set the channels compared by the monitor, bit n for channel n */
+#define COMMAND_REPLAY              ('v')   /* Replay a trace, 0 at full speed or 1 in real time */
+
+/* Maximum number of digits of an argument */
+#define COMMAND_MAX_DIGITS          (10UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Executes the commands received since the previous call */
+void command_process(void);
+
+#endif /* COMMAND_H_ */
+
+/* [] END OF FILE */
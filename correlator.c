@@ -0,0 +1,560 @@
+/******************************************************************************
+* File Name:   correlator.c
+*
+* Description: This file contains the cross-correlation of SAR0 and SAR1. A
+*              window of sample pairs is captured in the FFT work buffer and
+*              correlated either directly, over a limited range of delays,
+*              or through the FFT for large windows. The delay is refined
+*              between samples by parabolic interpolation of the peak.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include "correlator.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Left shift of the SAR results in the FFT input, leaving headroom for the
+   sum of the two halves when the spectra are separated */
+#define CORR_FFT_INPUT_SHIFT        (16U)
+
+/* Largest magnitude of a cross-spectrum value after normalization */
+#define CORR_SPECTRUM_BITS          (30U)
+
+/* Degrees per radian */
+#define CORR_DEGREES                (57.29577951308232)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Correlates the captured window */
+static void correlator_run(void);
+
+/* Correlates the centered window over CORR_MAX_LAG delays */
+static void correlator_direct(void);
+
+/* Correlates the centered window through the FFT */
+static void correlator_fft(void);
+
+/* Offset of the peak from three values around it, -0.5 to 0.5 */
+static float correlator_interpolate(int64_t before, int64_t peak, int64_t after);
+
+/* Sum of x[n] * y[n + lag] over the centered window, scaled to the window */
+static int64_t correlator_lag(int32_t lag);
+
+/* Correlation of the inverse FFT at one delay, scaled to the window */
+static int64_t correlator_fft_lag(int32_t lag, uint32_t size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Capture in progress */
+static bool corr_active = false;
+static uint32_t corr_window = 0UL;
+static uint32_t corr_count = 0UL;
+
+/* Result of the last correlation */
+static corr_result_t corr_result;
+static bool corr_result_ready = false;
+
+/*******************************************************************************
+* Function Name: correlator_start
+********************************************************************************
+* Summary:
+* This function starts the capture of a window of sample pairs in
+* fft_buffer. The capture in progress, if any, is restarted.
+*
+* Parameters:
+*  window: Number of sample pairs, CORR_MIN_WINDOW to CORR_MAX_WINDOW
+*
+* Return:
+*  bool: true if the capture started, false if the window is out of range
+*
+*******************************************************************************/
+bool correlator_start(uint32_t window)
+{
+    if ((window < CORR_MIN_WINDOW) || (window > CORR_MAX_WINDOW))
+    {
+        return false;
+    }
+
+    corr_window = window;
+    corr_count = 0UL;
+    corr_result_ready = false;
+    corr_active = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: correlator_stop
+********************************************************************************
+* Summary:
+* This function stops the capture in progress, releasing fft_buffer.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void correlator_stop(void)
+{
+    corr_active = false;
+}
+
+/*******************************************************************************
+* Function Name: correlator_process
+********************************************************************************
+* Summary:
+* This function adds sample pairs to the capture. When the window is
+* complete, it is correlated in the caller's context and the capture stops.
+*
+* Parameters:
+*  pairs: Sample pairs
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void correlator_process(const sample_pair_t *pairs, uint32_t count)
+{
+    uint32_t index;
+
+    if (!corr_active)
+    {
+        return;
+    }
+
+    for (index = 0UL; (index < count) && (corr_count < corr_window); index++)
+    {
+        fft_buffer[corr_count].re = pairs[index].sar0;
+        fft_buffer[corr_count].im = pairs[index].sar1;
+        corr_count++;
+    }
+
+    if (corr_count == corr_window)
+    {
+        corr_active = false;
+        correlator_run();
+    }
+}
+
+/*******************************************************************************
+* Function Name: correlator_get_result
+********************************************************************************
+* Summary:
+* This function returns the result of the last correlation, once.
+*
+* Parameters:
+*  result: Result to fill
+*
+* Return:
+*  bool: true if a correlation completed since the previous call
+*
+*******************************************************************************/
+bool correlator_get_result(corr_result_t *result)
+{
+    if (!corr_result_ready)
+    {
+        return false;
+    }
+
+    *result = corr_result;
+    corr_result_ready = false;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: correlator_run
+********************************************************************************
+* Summary:
+* This function removes the mean of both inputs, so that the DC components
+* do not bias the peak, and correlates the window with the direct or the
+* FFT path.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void correlator_run(void)
+{
+    int64_t sum0 = 0;
+    int64_t sum1 = 0;
+    int32_t mean0;
+    int32_t mean1;
+    uint32_t index;
+
+    for (index = 0UL; index < corr_window; index++)
+    {
+        sum0 += fft_buffer[index].re;
+        sum1 += fft_buffer[index].im;
+    }
+
+    mean0 = (int32_t)(sum0 / (int64_t)corr_window);
+    mean1 = (int32_t)(sum1 / (int64_t)corr_window);
+
+    for (index = 0UL; index < corr_window; index++)
+    {
+        fft_buffer[index].re -= mean0;
+        fft_buffer[index].im -= mean1;
+    }
+
+    corr_result.window = corr_window;
+    corr_result.frequency = 0.0f;
+    corr_result.phase = 0.0f;
+
+    if (corr_window >= CORR_FFT_WINDOW)
+    {
+        correlator_fft();
+    }
+    else
+    {
+        correlator_direct();
+    }
+
+    corr_result_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: correlator_direct
+********************************************************************************
+* Summary:
+* This function calculates the correlation for every delay up to
+* CORR_MAX_LAG samples in both directions, in 64-bit integers, and locates
+* its largest value. Each delay is normalized by the number of samples that
+* overlap, which falls with the delay, so that the peak and the parabolic
+* fit around it are not pulled towards zero delay.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void correlator_direct(void)
+{
+    int32_t max_lag = CORR_MAX_LAG;
+    int32_t lag;
+    int32_t peak_lag = 0;
+    int64_t value;
+    int64_t peak = INT64_MIN;
+    int64_t sum = 0;
+    int64_t energy0 = 0;
+    int64_t energy1 = 0;
+    uint32_t first;
+    uint32_t last;
+    uint32_t index;
+
+    if (max_lag >= (int32_t)corr_window)
+    {
+        max_lag = (int32_t)corr_window - 1L;
+    }
+
+    for (lag = -max_lag; lag <= max_lag; lag++)
+    {
+        value = correlator_lag(lag);
+        if (value > peak)
+        {
+            peak = value;
+            peak_lag = lag;
+        }
+    }
+
+    corr_result.fft = false;
+    corr_result.delay = (float)peak_lag;
+    if ((peak_lag > -max_lag) && (peak_lag < max_lag))
+    {
+        corr_result.delay += correlator_interpolate(correlator_lag(peak_lag - 1L), peak,
+                                                    correlator_lag(peak_lag + 1L));
+    }
+
+    /* Coefficient over the samples that overlap at the peak */
+    first = (peak_lag < 0) ? (uint32_t)(-peak_lag) : 0UL;
+    last = (peak_lag > 0) ? (corr_window - (uint32_t)peak_lag) : corr_window;
+    for (index = first; index < last; index++)
+    {
+        value = fft_buffer[(uint32_t)((int32_t)index + peak_lag)].im;
+        sum += (int64_t)fft_buffer[index].re * value;
+        energy0 += (int64_t)fft_buffer[index].re * fft_buffer[index].re;
+        energy1 += value * value;
+    }
+    corr_result.coefficient = ((energy0 > 0) && (energy1 > 0))
+        ? (float)((double)sum / sqrt((double)energy0 * (double)energy1)) : 0.0f;
+}
+
+/*******************************************************************************
+* Function Name: correlator_fft
+********************************************************************************
+* Summary:
+* This function calculates the correlation for every delay of the window
+* through the FFT. Both inputs are transformed together, SAR0 as the real
+* and SAR1 as the imaginary part, into M = 2^k >= 2 * window points with zero
+* padding. Their spectra X and Y are separated from the symmetry of the
+* result, and the inverse FFT of the cross-spectrum conj(X) * Y is the
+* correlation. The cross-spectrum is normalized to CORR_SPECTRUM_BITS before
+* the inverse FFT to keep its precision. As in the direct path, each delay is
+* scaled from the samples that overlap to the whole window before the peak is
+* searched. Only the delays up to half the window are searched, so that the
+* scaling at most doubles a delay and the few products of the longest delays
+* cannot outweigh the peak. The phase is the argument of the strongest
+* cross-spectrum bin.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void correlator_fft(void)
+{
+    uint32_t log2_size = 1UL;
+    uint32_t size;
+    uint32_t index;
+    uint32_t mirror;
+    uint32_t peak_bin = 1UL;
+    uint32_t shift = 0U;
+    int32_t largest = 0;
+    int32_t peak_lag = 0;
+    int32_t max_lag = (int32_t)(corr_window / 2UL);
+    int32_t lag;
+    int64_t x_re;
+    int64_t x_im;
+    int64_t y_re;
+    int64_t y_im;
+    int64_t c_re;
+    int64_t c_im;
+    int64_t peak = INT64_MIN;
+    int64_t value;
+    uint64_t magnitude;
+    uint64_t peak_magnitude = 0ULL;
+    double power0 = 0.0;
+    double power1 = 0.0;
+    double peak_re = 0.0;
+    double peak_im = 0.0;
+
+    while ((1UL << log2_size) < (2UL * corr_window))
+    {
+        log2_size++;
+    }
+    size = 1UL << log2_size;
+
+    for (index = 0UL; index < size; index++)
+    {
+        if (index < corr_window)
+        {
+            fft_buffer[index].re *= (int32_t)(1L << CORR_FFT_INPUT_SHIFT);
+            fft_buffer[index].im *= (int32_t)(1L << CORR_FFT_INPUT_SHIFT);
+        }
+        else
+        {
+            fft_buffer[index].re = 0;
+            fft_buffer[index].im = 0;
+        }
+    }
+
+    (void)fft_forward(fft_buffer, log2_size);
+
+    /* The products of the spectra must fit in 32 bits */
+    for (index = 0UL; index < size; index++)
+    {
+        largest |= (fft_buffer[index].re < 0) ? -fft_buffer[index].re : fft_buffer[index].re;
+        largest |= (fft_buffer[index].im < 0) ? -fft_buffer[index].im : fft_buffer[index].im;
+    }
+    while ((largest >> (shift / 2U)) >= (int32_t)(1L << ((CORR_SPECTRUM_BITS - 2U) / 2U)))
+    {
+        shift += 2U;
+    }
+
+    for (index = 0UL; index <= (size / 2UL); index++)
+    {
+        mirror = (size - index) & (size - 1UL);
+
+        /* X = (Z[k] + conj(Z[M - k])) / 2, Y = (Z[k] - conj(Z[M - k])) / 2j */
+        x_re = ((int64_t)fft_buffer[index].re + fft_buffer[mirror].re) / 2;
+        x_im = ((int64_t)fft_buffer[index].im - fft_buffer[mirror].im) / 2;
+        y_re = ((int64_t)fft_buffer[index].im + fft_buffer[mirror].im) / 2;
+        y_im = ((int64_t)fft_buffer[mirror].re - fft_buffer[index].re) / 2;
+
+        /* conj(X) * Y */
+        c_re = ((x_re * y_re) + (x_im * y_im)) >> shift;
+        c_im = ((x_re * y_im) - (x_im * y_re)) >> shift;
+
+        /* Parseval sums, both halves of the spectrum */
+        power0 += (double)((x_re * x_re) + (x_im * x_im)) * (((0UL == index) || (mirror == index)) ? 1.0 : 2.0);
+        power1 += (double)((y_re * y_re) + (y_im * y_im)) * (((0UL == index) || (mirror == index)) ? 1.0 : 2.0);
+
+        magnitude = (uint64_t)((c_re * c_re) + (c_im * c_im));
+        if ((0UL != index) && (mirror != index) && (magnitude > peak_magnitude))
+        {
+            peak_magnitude = magnitude;
+            peak_bin = index;
+            peak_re = (double)c_re;
+            peak_im = (double)c_im;
+        }
+
+        /* The correlation is real, so the cross-spectrum is conjugate symmetric */
+        fft_buffer[index].re = (int32_t)c_re;
+        fft_buffer[index].im = (int32_t)c_im;
+        fft_buffer[mirror].re = (int32_t)c_re;
+        fft_buffer[mirror].im = (int32_t)-c_im;
+    }
+
+    (void)fft_inverse(fft_buffer, log2_size);
+
+    /* Negative delays are at the end of the buffer */
+    for (lag = -max_lag; lag <= max_lag; lag++)
+    {
+        value = correlator_fft_lag(lag, size);
+        if (value > peak)
+        {
+            peak = value;
+            peak_lag = lag;
+        }
+    }
+
+    corr_result.fft = true;
+    corr_result.delay = (float)peak_lag;
+    if ((peak_lag > -max_lag) && (peak_lag < max_lag))
+    {
+        corr_result.delay += correlator_interpolate(correlator_fft_lag(peak_lag - 1L, size), peak,
+                                                    correlator_fft_lag(peak_lag + 1L, size));
+    }
+
+    /* r = sum * 2^-shift / M^2 and power = sum(x^2) * 2^(2 * input shift) / M,
+       with the sum over the samples that overlap at the peak */
+    value = fft_buffer[(uint32_t)peak_lag & (size - 1UL)].re;
+    corr_result.coefficient = ((power0 > 0.0) && (power1 > 0.0))
+        ? (float)(((double)value * (double)size * (double)(1ULL << shift)) / sqrt(power0 * power1))
+        : 0.0f;
+    corr_result.frequency = (float)peak_bin / (float)size;
+    corr_result.phase = (float)(atan2(peak_im, peak_re) * CORR_DEGREES);
+}
+
+/*******************************************************************************
+* Function Name: correlator_interpolate
+********************************************************************************
+* Summary:
+* This function fits a parabola through the correlation at the peak and at
+* the delays on both sides, and returns the position of its vertex.
+*
+* Parameters:
+*  before: Correlation one sample before the peak
+*  peak: Correlation at the peak
+*  after: Correlation one sample after the peak
+*
+* Return:
+*  float: Offset of the vertex from the peak, -0.5 to 0.5 samples
+*
+*******************************************************************************/
+static float correlator_interpolate(int64_t before, int64_t peak, int64_t after)
+{
+    double curvature = (double)before - (2.0 * (double)peak) + (double)after;
+
+    if (curvature >= 0.0)
+    {
+        return 0.0f;
+    }
+
+    return (float)((0.5 * ((double)before - (double)after)) / curvature);
+}
+
+/*******************************************************************************
+* Function Name: correlator_lag
+********************************************************************************
+* Summary:
+* This function calculates the correlation of the centered window for one
+* delay over the samples that overlap, and scales it from the overlap to the
+* whole window. At zero delay, it is the plain sum of the products.
+*
+* Parameters:
+*  lag: Delay of SAR1 in samples, less than the window in magnitude
+*
+* Return:
+*  int64_t: Sum of x[n] * y[n + lag] times window / (window - |lag|)
+*
+*******************************************************************************/
+static int64_t correlator_lag(int32_t lag)
+{
+    int64_t sum = 0;
+    uint32_t first = (lag < 0) ? (uint32_t)(-lag) : 0UL;
+    uint32_t last = (lag > 0) ? (corr_window - (uint32_t)lag) : corr_window;
+    uint32_t index;
+
+    for (index = first; index < last; index++)
+    {
+        sum += (int64_t)fft_buffer[index].re * fft_buffer[(uint32_t)((int32_t)index + lag)].im;
+    }
+
+    /* At most 2^22 per product and 2^11 products, so the scaling cannot overflow */
+    return (sum * (int64_t)corr_window) / (int64_t)(last - first);
+}
+
+/*******************************************************************************
+* Function Name: correlator_fft_lag
+********************************************************************************
+* Summary:
+* This function returns the correlation computed by the inverse FFT for one
+* delay, scaled from the samples that overlap to the whole window like
+* correlator_lag().
+*
+* Parameters:
+*  lag: Delay of SAR1 in samples, less than the window in magnitude
+*  size: Number of points of the FFT
+*
+* Return:
+*  int64_t: Correlation times window / (window - |lag|)
+*
+*******************************************************************************/
+static int64_t correlator_fft_lag(int32_t lag, uint32_t size)
+{
+    int64_t value = fft_buffer[(uint32_t)lag & (size - 1UL)].re;
+    uint32_t overlap = corr_window - (uint32_t)((lag < 0) ? -lag : lag);
+
+    return (value * (int64_t)corr_window) / (int64_t)overlap;
+}
+
+/* [] END OF FILE */
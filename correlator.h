@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name:   correlator.h
+*
+* Description: This file contains the declarations of the cross-correlation
+*              of SAR0 and SAR1, which measures the delay and the phase
+*              between the two inputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CORRELATOR_H_
+#define CORRELATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "processing.h"
+#include "fft.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Range of the capture window, in sample pairs. The FFT path pads the
+ * window with as many zeros, so the correlation is not circular.
+ */
+#define CORR_MIN_WINDOW             (64UL)
+#define CORR_MAX_WINDOW             (FFT_MAX_SIZE / 2UL)
+
+/* Windows from this size use the FFT path */
+#ifndef CORR_FFT_WINDOW
+#define CORR_FFT_WINDOW             (256UL)
+#endif
+
+/* Largest delay searched by the direct path, in samples */
+#define CORR_MAX_LAG                (32L)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Result of one correlation */
+typedef struct
+{
+    uint32_t window;        /* Number of sample pairs */
+    bool fft;               /* true if calculated by the FFT path */
+    float delay;            /* Delay of SAR1 after SAR0 in samples, interpolated */
+    float coefficient;      /* Normalized correlation at the delay, -1 to 1 */
+    float frequency;        /* Strongest common frequency in cycles per sample, FFT path only */
+    float phase;            /* Phase of SAR1 relative to SAR0 at that frequency in degrees, FFT path only */
+} corr_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the capture of a window of sample pairs */
+bool correlator_start(uint32_t window);
+
+/* Stops the capture in progress */
+void correlator_stop(void);
+
+/* Adds sample pairs to the capture and correlates the complete window */
+void correlator_process(const sample_pair_t *pairs, uint32_t count);
+
+/* Returns the result of the last correlation, once */
+bool correlator_get_result(corr_result_t *result);
+
+#endif /* CORRELATOR_H_ */
+
+/* [] END OF FILE */
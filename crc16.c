@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name:   crc16.c
+*
+* Description: This file contains the CRC-16/CCITT-FALSE of the sample stream
+*              frames and the capture chunks. It has no other dependency,
+*              so that the host tools can check the CRC without the telemetry.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "crc16.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* CRC-16/CCITT-FALSE (polynomial 0x1021) table, one entry per nibble */
+static const uint16_t crc16_table[16] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU
+};
+
+/*******************************************************************************
+* Function Name: crc16_update
+********************************************************************************
+* Summary:
+* This function updates a CRC-16/CCITT-FALSE (polynomial 0x1021, initial
+* value 0xFFFF, no reflection) with a buffer, one nibble at a time.
+*
+* Parameters:
+*  crc: CRC of the preceding data, CRC16_INIT for the first buffer
+*  data: Data to add to the CRC
+*  length: Length of the data in bytes
+*
+* Return:
+*  uint16_t: Updated CRC
+*
+*******************************************************************************/
+uint16_t crc16_update(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < length; index++)
+    {
+        crc = (uint16_t)((crc << 4U) ^ crc16_table[(crc >> 12U) ^ (data[index] >> 4U)]);
+        crc = (uint16_t)((crc << 4U) ^ crc16_table[(crc >> 12U) ^ (data[index] & 0x0FU)]);
+    }
+
+    return crc;
+}
+
+/* [] END OF FILE */
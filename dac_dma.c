@@ -0,0 +1,434 @@
+/******************************************************************************
+* File Name:   dac_dma.c
+*
+* Description: This file contains the DMA output path of the CTDAC. The main
+*              loop queues the codes in a ring buffer, and a DMA channel paced
+*              by a TCPWM counter writes one code per period to the buffered
+*              value register of the CTDAC, so the output timing does not
+*              depend on the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "dac_dma.h"
+
+#if (DAC_OUTPUT_MODE == DAC_MODE_DMA)
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Index mask of the ring buffer */
+#define DAC_RING_MASK               (DAC_RING_SIZE - 1UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* DMA Interrupt Handler */
+static void dac_dma_interrupt(void);
+
+/* Free running index of the next code moved by the DMA */
+static uint32_t dac_dma_position(void);
+
+/* Restarts the queue DAC_LATENCY codes ahead of the DMA */
+static void dac_dma_resync(uint32_t position);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* DMA interrupt configuration structure */
+/* Source is set to the CTDAC DMA channel and Priority as 7 */
+const cy_stc_sysint_t DAC_DMA_IRQ_cfg = {
+    .intrSrc = (IRQn_Type) cpuss_interrupts_dw0_2_IRQn,
+    .intrPriority = 7UL
+};
+
+/* Ring buffer of codes, read by the DMA row by row */
+static uint16_t dac_ring[DAC_RING_SIZE];
+
+/* One descriptor going through the whole ring, chained to itself */
+static cy_stc_dma_descriptor_t dac_descriptor;
+
+/* Number of times the DMA went through the whole ring */
+static volatile uint32_t dac_wraps = 0UL;
+
+/* Free running indices of the next code to write and of the last position
+   of the DMA */
+static uint32_t dac_write_index = 0UL;
+static uint32_t dac_read_index = 0UL;
+
+/* Last code queued, repeated when the queue is restarted */
+static uint16_t dac_last_code;
+
+/* Period of the pacing counter, 0 until it is started */
+static uint32_t dac_period = 0UL;
+
+/* Codes output again and codes dropped */
+static uint32_t dac_underruns = 0UL;
+static uint32_t dac_overflows = 0UL;
+
+/*******************************************************************************
+* Function Name: dac_dma_init
+********************************************************************************
+* Summary:
+* This function initializes the CTDAC in buffered write mode, so that a
+* value written by the DMA is applied on the next CTDAC clock, fills the
+* ring buffer with the initial code, and enables the DMA channel. The
+* pacing counter is started by dac_dma_track().
+*
+* Parameters:
+*  base: Base address of the CTDAC
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dac_dma_init(CTDAC_Type *base)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+    cy_stc_ctdac_config_t ctdac_config = pass_0_ctdac_0_config;
+    cy_stc_tcpwm_counter_config_t counter_config = tcpwm_0_group_0_cnt_0_config;
+    uint32_t index;
+
+    cy_stc_dma_descriptor_config_t descriptor_config = {
+        .retrigger = CY_DMA_RETRIG_4CYC,
+        .interruptType = CY_DMA_DESCR,
+        .triggerOutType = CY_DMA_DESCR,
+        .channelState = CY_DMA_CHANNEL_ENABLED,
+        .triggerInType = CY_DMA_1ELEMENT,
+        .dataSize = CY_DMA_HALFWORD,
+        .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .dstTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+        .descriptorType = CY_DMA_2D_TRANSFER,
+        .srcAddress = dac_ring,
+        .dstAddress = (void *)&base->CTDAC_VAL_NXT,
+        .srcXincr = 1L,
+        .dstXincr = 0L,
+        .xCount = DAC_RING_ROW_SIZE,
+        .srcYincr = (int32_t)DAC_RING_ROW_SIZE,
+        .dstYincr = 0L,
+        .yCount = DAC_RING_ROWS,
+        .nextDescriptor = &dac_descriptor
+    };
+
+    cy_stc_dma_channel_config_t channel_config = {
+        .descriptor = &dac_descriptor,
+        .preemptable = false,
+        .priority = 2UL,
+        .enable = false,
+        .bufferable = false
+    };
+
+    /* Buffered writes, on top of the design.modus configuration */
+    ctdac_config.updateMode = CY_CTDAC_UPDATE_BUFFERED_WRITE;
+    result = Cy_CTDAC_Init(base, &ctdac_config);
+    if (CY_CTDAC_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    dac_last_code = (uint16_t)ctdac_config.value;
+    for (index = 0UL; index < DAC_RING_SIZE; index++)
+    {
+        dac_ring[index] = dac_last_code;
+    }
+    dac_write_index = DAC_LATENCY;
+
+    /* The pacing counter uses the clock and settings of the SAR trigger counter */
+    result = Cy_SysClk_PeriphAssignDivider(DAC_TCPWM_CLOCK, DAC_TCPWM_DIVIDER_TYPE, DAC_TCPWM_DIVIDER_NUM);
+    if (CY_SYSCLK_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_TCPWM_Counter_Init(TCPWM0, DAC_TCPWM_CNT_NUM, &counter_config);
+    if (CY_TCPWM_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+    Cy_TCPWM_Counter_Enable(TCPWM0, DAC_TCPWM_CNT_NUM);
+
+    /* Route the overflow of the counter to the DMA channel */
+    result = Cy_TrigMux_Connect(DAC_DMA_TRIG_IN, DAC_DMA_TRIG_OUT, false, TRIGGER_TYPE_EDGE);
+    if (CY_TRIGMUX_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_DMA_Descriptor_Init(&dac_descriptor, &descriptor_config);
+    if (CY_DMA_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_DMA_Channel_Init(DW0, DAC_DMA_CHANNEL, &channel_config);
+    if (CY_DMA_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Interrupt once per pass through the ring */
+    Cy_DMA_Channel_SetInterruptMask(DW0, DAC_DMA_CHANNEL, CY_DMA_INTR_MASK);
+
+    (void)Cy_SysInt_Init(&DAC_DMA_IRQ_cfg, dac_dma_interrupt);
+    NVIC_EnableIRQ(DAC_DMA_IRQ_cfg.intrSrc);
+
+    Cy_DMA_Channel_Enable(DW0, DAC_DMA_CHANNEL);
+    Cy_DMA_Enable(DW0);
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_track
+********************************************************************************
+* Summary:
+* This function sets the period of the pacing counter to ratio periods of
+* the SAR trigger counter, so that the codes are output at the rate they
+* are produced. It is called from the main loop and only reprograms the
+* counter when the period or the ratio changed, restarting the queue.
+*
+* Parameters:
+*  period: Period of the SAR trigger counter in counter clocks
+*  ratio: Number of triggers per code, the decimation ratio
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dac_dma_track(uint32_t period, uint32_t ratio)
+{
+    /* A counter period of P takes P + 1 clocks */
+    uint32_t dac_counter_period = ((period + 1UL) * ratio) - 1UL;
+
+    if (dac_counter_period == dac_period)
+    {
+        return;
+    }
+
+    Cy_TCPWM_TriggerStopOrKill_Single(TCPWM0, DAC_TCPWM_CNT_NUM);
+    Cy_TCPWM_Counter_SetPeriod(TCPWM0, DAC_TCPWM_CNT_NUM, dac_counter_period);
+    Cy_TCPWM_Counter_SetCounter(TCPWM0, DAC_TCPWM_CNT_NUM, 0UL);
+    dac_period = dac_counter_period;
+
+    dac_dma_resync(dac_dma_position());
+
+    Cy_TCPWM_TriggerStart_Single(TCPWM0, DAC_TCPWM_CNT_NUM);
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_write
+********************************************************************************
+* Summary:
+* This function queues codes behind the ones waiting for the DMA. If the
+* DMA went past the queued codes, it has output old codes again; they are
+* counted and the queue restarts DAC_LATENCY codes ahead of the DMA. Codes
+* that do not fit in the ring buffer are dropped and counted.
+*
+* Parameters:
+*  codes: CTDAC codes
+*  count: Number of codes
+*
+* Return:
+*  uint32_t: Number of codes queued
+*
+*******************************************************************************/
+uint32_t dac_dma_write(const uint16_t *codes, uint32_t count)
+{
+    uint32_t position = dac_dma_position();
+    uint32_t space;
+    uint32_t index;
+
+    if ((int32_t)(dac_write_index - position) < 0)
+    {
+        dac_underruns += position - dac_write_index;
+        dac_dma_resync(position);
+    }
+
+    space = DAC_RING_SIZE - (dac_write_index - position);
+    if (count > space)
+    {
+        dac_overflows += count - space;
+        count = space;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        dac_ring[(dac_write_index + index) & DAC_RING_MASK] = codes[index];
+    }
+
+    if (0UL != count)
+    {
+        dac_last_code = codes[count - 1UL];
+    }
+    dac_write_index += count;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_get_underruns
+********************************************************************************
+* Summary:
+* This function returns the number of codes output again since startup
+* because the main loop did not queue the next codes in time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of repeated codes
+*
+*******************************************************************************/
+uint32_t dac_dma_get_underruns(void)
+{
+    return dac_underruns;
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_get_overflows
+********************************************************************************
+* Summary:
+* This function returns the number of codes dropped since startup because
+* the ring buffer was full.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of dropped codes
+*
+*******************************************************************************/
+uint32_t dac_dma_get_overflows(void)
+{
+    return dac_overflows;
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_position
+********************************************************************************
+* Summary:
+* This function calculates the free running index of the next code moved
+* by the DMA from the number of passes through the ring and the loop indices
+* of the channel. The indices are read until they are consistent. If the
+* DMA wrapped around and its interrupt did not run yet, the index would go
+* back, so it is advanced by one pass instead.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Free running index in the ring buffer
+*
+*******************************************************************************/
+static uint32_t dac_dma_position(void)
+{
+    uint32_t wraps;
+    uint32_t row;
+    uint32_t column;
+    uint32_t position;
+
+    do
+    {
+        wraps = dac_wraps;
+        row = Cy_DMA_Channel_GetCurrentYloopIndex(DW0, DAC_DMA_CHANNEL);
+        column = Cy_DMA_Channel_GetCurrentXloopIndex(DW0, DAC_DMA_CHANNEL);
+    } while ((wraps != dac_wraps) || (row != Cy_DMA_Channel_GetCurrentYloopIndex(DW0, DAC_DMA_CHANNEL)));
+
+    position = (wraps * DAC_RING_SIZE) + (row * DAC_RING_ROW_SIZE) + column;
+    if ((int32_t)(position - dac_read_index) < 0)
+    {
+        position += DAC_RING_SIZE;
+    }
+    dac_read_index = position;
+
+    return position;
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_resync
+********************************************************************************
+* Summary:
+* This function fills the next DAC_LATENCY codes of the DMA with the last
+* code queued, so the output holds its value, and queues the next codes
+* after them.
+*
+* Parameters:
+*  position: Free running index of the next code moved by the DMA
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void dac_dma_resync(uint32_t position)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < DAC_LATENCY; index++)
+    {
+        dac_ring[(position + index) & DAC_RING_MASK] = dac_last_code;
+    }
+
+    dac_write_index = position + DAC_LATENCY;
+}
+
+/*******************************************************************************
+* Function Name: dac_dma_interrupt
+********************************************************************************
+* Summary:
+* This function is the handler for the completion interrupt of the CTDAC
+* DMA channel. It counts the passes through the ring buffer.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void dac_dma_interrupt(void)
+{
+    if (CY_DMA_INTR_CAUSE_COMPLETION == Cy_DMA_Channel_GetStatus(DW0, DAC_DMA_CHANNEL))
+    {
+        dac_wraps++;
+    }
+
+    /* Clear the interrupt */
+    Cy_DMA_Channel_ClearInterrupt(DW0, DAC_DMA_CHANNEL);
+}
+
+#endif /* (DAC_OUTPUT_MODE == DAC_MODE_DMA) */
+
+/* [] END OF FILE */
@@ -0,0 +1,123 @@
+/******************************************************************************
+* File Name:   dac_dma.h
+*
+* Description: This file contains the declarations of the DMA output path of
+*              the CTDAC, which clocks the CTDAC codes out of a ring buffer
+*              at a fixed rate.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DAC_DMA_H_
+#define DAC_DMA_H_
+
+#include "cy_pdl.h"
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* CTDAC output modes */
+/* The main loop writes each code to the CTDAC */
+#define DAC_MODE_DIRECT             (0U)
+/* The codes are queued in a ring buffer and moved to the CTDAC by DMA */
+#define DAC_MODE_DMA                (1U)
+
+/* CTDAC output mode used by the application. Can be overridden in the
+ * DEFINES variable of the Makefile.
+ */
+#ifndef DAC_OUTPUT_MODE
+#define DAC_OUTPUT_MODE             (DAC_MODE_DIRECT)
+#endif
+
+/* The pacing counter runs from the clock of the TCPWM trigger, which deep
+ * sleep acquisition replaces with the PASS timer.
+ */
+#if ((DAC_OUTPUT_MODE == DAC_MODE_DMA) && (ACQ_DEEP_SLEEP != 0U))
+#error "The DMA output mode cannot be used with deep sleep acquisition"
+#endif
+
+/* DMA (DW0) channel that moves the codes, after the channels of the SARs */
+#define DAC_DMA_CHANNEL             (2UL)
+
+/* TCPWM counter that paces the DMA. It is clocked by the same divider as
+ * the counter that triggers the SARs, so both run at exactly related rates.
+ */
+#define DAC_TCPWM_CNT_NUM           (1UL)
+#define DAC_TCPWM_CLOCK             (PCLK_TCPWM0_CLOCKS1)
+#define DAC_TCPWM_DIVIDER_TYPE      (CY_SYSCLK_DIV_8_BIT)
+#define DAC_TCPWM_DIVIDER_NUM       (2UL)
+
+/* Trigger line from the overflow of the counter to the DMA channel */
+#define DAC_DMA_TRIG_IN             (TRIG_IN_MUX_0_TCPWM0_TR_OVERFLOW1)
+#define DAC_DMA_TRIG_OUT            (TRIG_OUT_MUX_0_PDMA0_TR_IN2)
+
+/* Ring buffer of codes. One DMA descriptor transfers at most 256 elements
+ * per row, so the ring is made of DAC_RING_ROWS rows of 256 codes.
+ */
+#define DAC_RING_ROW_SIZE           (256UL)
+#define DAC_RING_ROWS               (4UL)
+#define DAC_RING_SIZE               (DAC_RING_ROW_SIZE * DAC_RING_ROWS)
+
+/* Number of codes queued ahead of the DMA after startup or an underrun. It
+ * is the delay from the product to the output, and must cover the longest
+ * time the main loop takes to deliver the next block.
+ */
+#ifndef DAC_LATENCY
+#define DAC_LATENCY                 (2UL * ACQ_CHANNEL_BLOCK_SCANS)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Initializes the CTDAC in buffered mode, the pacing counter and the DMA */
+void dac_dma_init(CTDAC_Type *base);
+
+/* Outputs one code every ratio triggers of the SARs */
+void dac_dma_track(uint32_t period, uint32_t ratio);
+
+/* Queues codes for output, returns the number queued */
+uint32_t dac_dma_write(const uint16_t *codes, uint32_t count);
+
+/* Number of codes output again because the ring buffer ran empty */
+uint32_t dac_dma_get_underruns(void);
+
+/* Number of codes dropped because the ring buffer was full */
+uint32_t dac_dma_get_overflows(void);
+
+#endif /* DAC_DMA_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,343 @@
+/******************************************************************************
+* File Name:   decimator.c
+*
+* Description: This file contains the decimation filter of the sample pairs:
+*              a third-order CIC filter decimates each SAR input by
+*              DECIM_RATIO and a 16-tap FIR filter compensates the droop of
+*              the CIC filter in the passband. The filter uses fixed-point
+*              arithmetic only and the dual 16-bit multiply-accumulate of
+*              the Cortex-M4 DSP extension when it is available.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "decimator.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#define DECIM_USE_DSP   (1)
+#else
+#define DECIM_USE_DSP   (0)
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of integrator and comb stages of the CIC filter */
+#define CIC_ORDER           (3UL)
+
+/* Fractional bits kept between the CIC and the FIR filter. The FIR input is
+   then at most 14 bits, so that the 32-bit accumulator of the FIR filter
+   cannot overflow: the sum of the magnitudes of its coefficients is 1.83. */
+#define FIR_EXTRA_BITS      (2UL)
+
+/* The gain of the CIC filter is DECIM_RATIO ^ CIC_ORDER */
+#define CIC_SHIFT           ((CIC_ORDER * DECIM_RATIO_SHIFT) - FIR_EXTRA_BITS)
+
+/* Number of taps of the compensation filter, a multiple of 2 */
+#define FIR_TAPS            (16UL)
+
+/* The delays of the CIC filter, 3 * 7 / 2 input pairs, and of the
+   symmetric FIR filter, 15 / 2 decimated pairs, make the group delay */
+#if (DECIM_DELAY_HALF_PAIRS != ((CIC_ORDER * (DECIM_RATIO - 1UL)) + ((FIR_TAPS - 1UL) * DECIM_RATIO)))
+#error "DECIM_DELAY_HALF_PAIRS does not match the filters"
+#endif
+
+/* The coefficients are Q15 */
+#define FIR_COEF_SHIFT      (15UL)
+#define FIR_OUTPUT_SHIFT    (FIR_COEF_SHIFT + FIR_EXTRA_BITS)
+
+/* Range of the decimated samples. The FIR filter overshoots a full scale
+   step, but the output must stay within the 12-bit range of the SAR results
+   that the product, the DAC and the sample stream expect. */
+#define DECIM_MIN_RESULT    (-2048L)
+#define DECIM_MAX_RESULT    (2047L)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Filter state of one SAR input */
+typedef struct
+{
+    uint32_t integrator[CIC_ORDER];     /* Integrators, wrapping modulo 2^32 */
+    uint32_t comb[CIC_ORDER];           /* Previous input of each comb */
+    int16_t history[2UL * FIR_TAPS];    /* FIR delay line, stored twice */
+} decim_channel_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Runs the combs and the FIR filter for one decimated sample */
+static int16_t decim_output(decim_channel_t *channel);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Compensation filter at the decimated rate: flat within +/-0.3 dB up to
+   0.2 and attenuating the CIC output by more than 33 dB from 0.3 of the
+   decimated sample rate, with a DC gain of exactly 1 */
+static const int16_t fir_coefficients[FIR_TAPS] = {
+    -611, -465, 1265, 1344, -2391, -3552, 4835, 15959,
+    15959, 4835, -3552, -2391, 1344, 1265, -465, -611
+};
+
+/* State of the filters of SAR0 and SAR1 */
+static decim_channel_t decim_channels[ACQ_NUM_SARS];
+
+/* Number of input pairs since the last decimated pair */
+static uint32_t decim_phase = 0UL;
+
+/* Position of the newest sample in the FIR delay lines */
+static uint32_t fir_position = 0UL;
+
+/* Filter enable */
+static bool decim_enabled = false;
+
+/*******************************************************************************
+* Function Name: load_pair
+********************************************************************************
+* Summary:
+* This function loads two consecutive 16-bit values as one 32-bit word, the
+* first value in the lower half. The address does not need to be aligned.
+*
+* Parameters:
+*  values: First value
+*
+* Return:
+*  uint32_t: Packed values
+*
+*******************************************************************************/
+static inline uint32_t load_pair(const int16_t *values)
+{
+    uint32_t pair;
+
+    (void)memcpy(&pair, values, sizeof(pair));
+    return pair;
+}
+
+/*******************************************************************************
+* Function Name: mac_pair
+********************************************************************************
+* Summary:
+* This function adds the products of the lower and of the upper halves of
+* two packed pairs to an accumulator, with a single SMLAD instruction when the
+* DSP extension is available.
+*
+* Parameters:
+*  samples: Packed pair of samples
+*  coefficients: Packed pair of coefficients
+*  accumulator: Sum of the products so far
+*
+* Return:
+*  int32_t: Updated sum
+*
+*******************************************************************************/
+static inline int32_t mac_pair(uint32_t samples, uint32_t coefficients, int32_t accumulator)
+{
+#if (DECIM_USE_DSP == 1)
+    return (int32_t)__SMLAD(samples, coefficients, (uint32_t)accumulator);
+#else
+    return accumulator
+           + ((int32_t)(int16_t)(samples & 0xFFFFUL) * (int32_t)(int16_t)(coefficients & 0xFFFFUL))
+           + ((int32_t)(int16_t)(samples >> 16U) * (int32_t)(int16_t)(coefficients >> 16U));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: decimator_set_enabled
+********************************************************************************
+* Summary:
+* This function enables or disables the decimation filter. The state of the
+* filter is cleared, so the first outputs after enabling it show the step
+* response of the filter.
+*
+* Parameters:
+*  enabled: true to filter the sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void decimator_set_enabled(bool enabled)
+{
+    (void)memset(decim_channels, 0, sizeof(decim_channels));
+    decim_phase = 0UL;
+    fir_position = 0UL;
+    decim_enabled = enabled;
+}
+
+/*******************************************************************************
+* Function Name: decimator_is_enabled
+********************************************************************************
+* Summary:
+* This function returns the state of the decimation filter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if the filter is enabled
+*
+*******************************************************************************/
+bool decimator_is_enabled(void)
+{
+    return decim_enabled;
+}
+
+/*******************************************************************************
+* Function Name: decimator_process
+********************************************************************************
+* Summary:
+* This function filters a block of sample pairs and returns one sample pair
+* for every DECIM_RATIO input pairs. The integrators run for every input
+* pair; the combs and the FIR filter only run at the decimated rate. The
+* filter state is kept from one block to the next, so blocks of any size
+* can be passed. The output is in SAR counts, like the input.
+*
+* Decimated pair k is completed by input pair first_input + k * DECIM_RATIO,
+* and represents the input DECIM_DELAY_HALF_PAIRS / 2 pairs before it.
+*
+* Parameters:
+*  input: Sample pairs to filter
+*  count: Number of input sample pairs
+*  output: Decimated sample pairs, room for DECIM_MAX_OUTPUT(count) pairs
+*  first_input: Location to store the index of the input pair that completes
+*               the first decimated pair, if any
+*
+* Return:
+*  uint32_t: Number of decimated sample pairs
+*
+*******************************************************************************/
+uint32_t decimator_process(const sample_pair_t *input, uint32_t count, sample_pair_t *output, uint32_t *first_input)
+{
+    decim_channel_t *channel0 = &decim_channels[0];
+    decim_channel_t *channel1 = &decim_channels[1];
+    uint32_t output_count = 0UL;
+    uint32_t index;
+
+    /* The phase carries over from the previous block */
+    *first_input = DECIM_RATIO - 1UL - decim_phase;
+
+    for (index = 0UL; index < count; index++)
+    {
+        /* Integrators. The wrap around modulo 2^32 cancels in the combs. */
+        channel0->integrator[0] += (uint32_t)(int32_t)input[index].sar0;
+        channel0->integrator[1] += channel0->integrator[0];
+        channel0->integrator[2] += channel0->integrator[1];
+
+        channel1->integrator[0] += (uint32_t)(int32_t)input[index].sar1;
+        channel1->integrator[1] += channel1->integrator[0];
+        channel1->integrator[2] += channel1->integrator[1];
+
+        decim_phase++;
+        if (DECIM_RATIO == decim_phase)
+        {
+            decim_phase = 0UL;
+
+            /* The newest sample moves down the delay lines */
+            fir_position = (0UL == fir_position) ? (FIR_TAPS - 1UL) : (fir_position - 1UL);
+
+            output[output_count].sar0 = decim_output(channel0);
+            output[output_count].sar1 = decim_output(channel1);
+            output_count++;
+        }
+    }
+
+    return output_count;
+}
+
+/*******************************************************************************
+* Function Name: decim_output
+********************************************************************************
+* Summary:
+* This function runs the combs of the CIC filter on the integrator output,
+* stores the result in the FIR delay line and calculates the FIR output. The
+* delay line is stored twice, so the FIR_TAPS newest samples are always
+* contiguous and the taps are calculated two at a time.
+*
+* Parameters:
+*  channel: Filter state of one SAR input
+*
+* Return:
+*  int16_t: Decimated sample in SAR counts, from -2048 to 2047
+*
+*******************************************************************************/
+static int16_t decim_output(decim_channel_t *channel)
+{
+    const int16_t *samples;
+    uint32_t value = channel->integrator[CIC_ORDER - 1UL];
+    uint32_t previous;
+    int32_t accumulator = 0;
+    int32_t result;
+    uint32_t stage;
+    uint32_t tap;
+
+    /* Combs */
+    for (stage = 0UL; stage < CIC_ORDER; stage++)
+    {
+        previous = value;
+        value -= channel->comb[stage];
+        channel->comb[stage] = previous;
+    }
+
+    /* Remove the gain of the CIC filter, keeping FIR_EXTRA_BITS */
+    result = ((int32_t)value + (1L << (CIC_SHIFT - 1UL))) >> CIC_SHIFT;
+    channel->history[fir_position] = (int16_t)result;
+    channel->history[fir_position + FIR_TAPS] = (int16_t)result;
+
+    /* Compensation filter, newest sample first */
+    samples = &channel->history[fir_position];
+    for (tap = 0UL; tap < FIR_TAPS; tap += 2UL)
+    {
+        accumulator = mac_pair(load_pair(&samples[tap]), load_pair(&fir_coefficients[tap]), accumulator);
+    }
+
+    /* Back to SAR counts with rounding, saturated to the SAR range */
+    result = (accumulator + (1L << (FIR_OUTPUT_SHIFT - 1UL))) >> FIR_OUTPUT_SHIFT;
+    if (result > DECIM_MAX_RESULT)
+    {
+        result = DECIM_MAX_RESULT;
+    }
+    else if (result < DECIM_MIN_RESULT)
+    {
+        result = DECIM_MIN_RESULT;
+    }
+
+    return (int16_t)result;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name:   decimator.h
+*
+* Description: This file contains the declarations of the decimation filter
+*              applied to the sample pairs before the product.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Decimation ratio, as a power of two. The coefficients of the compensation
+ * filter in decimator.c are designed for this ratio.
+ */
+#define DECIM_RATIO_SHIFT           (3UL)
+#define DECIM_RATIO                 (1UL << DECIM_RATIO_SHIFT)
+
+/* Largest number of sample pairs produced from a block of count pairs */
+#define DECIM_MAX_OUTPUT(count)     (((count) / DECIM_RATIO) + 1UL)
+
+/* Group delay of the CIC and compensation filters, in halves of the input
+ * sample period: a decimated sample pair represents the input 70.5 pairs
+ * before the one that completes it.
+ */
+#define DECIM_DELAY_HALF_PAIRS      (141UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Enables or disables the filter, clearing its state */
+void decimator_set_enabled(bool enabled);
+
+/* Returns true if the filter is enabled */
+bool decimator_is_enabled(void);
+
+/* Filters and decimates a block of sample pairs */
+uint32_t decimator_process(const sample_pair_t *input, uint32_t count, sample_pair_t *output, uint32_t *first_input);
+
+#endif /* DECIMATOR_H_ */
+
+/* [] END OF FILE */
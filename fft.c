@@ -0,0 +1,308 @@
+/******************************************************************************
+* File Name:   fft.c
+*
+* Description: This file contains a radix-2 complex FFT in Q31 fixed point.
+*              Each stage halves the data, so the result is scaled by 1/N
+*              and cannot overflow. The twiddle factors are taken from a
+*              quarter-wave sine table.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include "fft.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of entries of the quarter-wave sine table */
+#define FFT_QUARTER                 (FFT_MAX_SIZE / 4UL)
+
+/* 2 * pi */
+#define FFT_TWO_PI                  (6.283185307179586)
+
+/* Largest Q31 value */
+#define FFT_Q31_MAX                 (2147483647.0)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Reorders the data in bit-reversed index order */
+static void fft_bit_reverse(fft_complex_t *data, uint32_t log2_size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+fft_complex_t fft_buffer[FFT_MAX_SIZE];
+
+/* sin(2 * pi * index / FFT_MAX_SIZE) for index 0 to FFT_MAX_SIZE / 4, Q31 */
+static int32_t fft_sine[FFT_QUARTER + 1UL];
+
+/*******************************************************************************
+* Function Name: fft_init
+********************************************************************************
+* Summary:
+* This function calculates the quarter-wave sine table. It is called once,
+* so it uses the double-precision sine of the C library.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void fft_init(void)
+{
+    uint32_t index;
+
+    for (index = 0UL; index <= FFT_QUARTER; index++)
+    {
+        fft_sine[index] = (int32_t)lround(sin((FFT_TWO_PI * (double)index) / (double)FFT_MAX_SIZE)
+                                          * FFT_Q31_MAX);
+    }
+}
+
+/*******************************************************************************
+* Function Name: fft_sin
+********************************************************************************
+* Summary:
+* This function returns sin(2 * pi * index / FFT_MAX_SIZE) from the quarter
+* wave table.
+*
+* Parameters:
+*  index: Angle in units of 2 * pi / FFT_MAX_SIZE, any value
+*
+* Return:
+*  int32_t: Sine, Q31
+*
+*******************************************************************************/
+int32_t fft_sin(uint32_t index)
+{
+    index &= (FFT_MAX_SIZE - 1UL);
+
+    if (index <= FFT_QUARTER)
+    {
+        return fft_sine[index];
+    }
+    else if (index <= (2UL * FFT_QUARTER))
+    {
+        return fft_sine[(2UL * FFT_QUARTER) - index];
+    }
+    else if (index <= (3UL * FFT_QUARTER))
+    {
+        return -fft_sine[index - (2UL * FFT_QUARTER)];
+    }
+    else
+    {
+        return -fft_sine[FFT_MAX_SIZE - index];
+    }
+}
+
+/*******************************************************************************
+* Function Name: fft_cos
+********************************************************************************
+* Summary:
+* This function returns cos(2 * pi * index / FFT_MAX_SIZE) from the quarter
+* wave table.
+*
+* Parameters:
+*  index: Angle in units of 2 * pi / FFT_MAX_SIZE, any value
+*
+* Return:
+*  int32_t: Cosine, Q31
+*
+*******************************************************************************/
+int32_t fft_cos(uint32_t index)
+{
+    return fft_sin(index + FFT_QUARTER);
+}
+
+/*******************************************************************************
+* Function Name: fft_forward
+********************************************************************************
+* Summary:
+* This function calculates the FFT of N = 2^log2_size complex values in
+* place, decimating in time. Every butterfly halves its outputs, so the
+* result is the DFT scaled by 1/N and no intermediate value can overflow.
+* The result is in natural order.
+*
+* Parameters:
+*  data: N complex values, replaced by their scaled DFT
+*  log2_size: Base 2 logarithm of N, FFT_MIN_LOG2 to FFT_MAX_LOG2
+*
+* Return:
+*  bool: true if the FFT was calculated, false if the size is out of range
+*
+*******************************************************************************/
+bool fft_forward(fft_complex_t *data, uint32_t log2_size)
+{
+    uint32_t size = 1UL << log2_size;
+    uint32_t half;
+    uint32_t stride;
+    uint32_t group;
+    uint32_t index;
+    int32_t w_re;
+    int32_t w_im;
+    int32_t t_re;
+    int32_t t_im;
+    fft_complex_t *a;
+    fft_complex_t *b;
+
+    if ((log2_size < FFT_MIN_LOG2) || (log2_size > FFT_MAX_LOG2))
+    {
+        return false;
+    }
+
+    fft_bit_reverse(data, log2_size);
+
+    for (half = 1UL; half < size; half *= 2UL)
+    {
+        /* Twiddle step of this stage in units of the sine table */
+        stride = FFT_MAX_SIZE / (2UL * half);
+
+        for (index = 0UL; index < half; index++)
+        {
+            /* w = exp(-j * 2 * pi * index / (2 * half)) */
+            w_re = fft_cos(index * stride);
+            w_im = -fft_sin(index * stride);
+
+            for (group = index; group < size; group += 2UL * half)
+            {
+                a = &data[group];
+                b = &data[group + half];
+
+                /* t = w * b, Q31 */
+                t_re = (int32_t)((((int64_t)b->re * w_re) - ((int64_t)b->im * w_im)) >> 31);
+                t_im = (int32_t)((((int64_t)b->re * w_im) + ((int64_t)b->im * w_re)) >> 31);
+
+                /* Halved butterfly */
+                b->re = (int32_t)(((int64_t)a->re - t_re) >> 1);
+                b->im = (int32_t)(((int64_t)a->im - t_im) >> 1);
+                a->re = (int32_t)(((int64_t)a->re + t_re) >> 1);
+                a->im = (int32_t)(((int64_t)a->im + t_im) >> 1);
+            }
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: fft_inverse
+********************************************************************************
+* Summary:
+* This function calculates the inverse FFT of N = 2^log2_size complex values
+* in place, as the conjugate of the forward FFT of the conjugate. The result
+* is scaled by 1/N like the forward FFT, so a forward and an inverse FFT
+* together scale the data by 1/N^2.
+*
+* Parameters:
+*  data: N complex values, replaced by their scaled inverse DFT
+*  log2_size: Base 2 logarithm of N, FFT_MIN_LOG2 to FFT_MAX_LOG2
+*
+* Return:
+*  bool: true if the FFT was calculated, false if the size is out of range
+*
+*******************************************************************************/
+bool fft_inverse(fft_complex_t *data, uint32_t log2_size)
+{
+    uint32_t size = 1UL << log2_size;
+    uint32_t index;
+
+    if ((log2_size < FFT_MIN_LOG2) || (log2_size > FFT_MAX_LOG2))
+    {
+        return false;
+    }
+
+    for (index = 0UL; index < size; index++)
+    {
+        data[index].im = -data[index].im;
+    }
+
+    (void)fft_forward(data, log2_size);
+
+    for (index = 0UL; index < size; index++)
+    {
+        data[index].im = -data[index].im;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: fft_bit_reverse
+********************************************************************************
+* Summary:
+* This function swaps every value with the value at the bit-reversed index.
+*
+* Parameters:
+*  data: N complex values
+*  log2_size: Base 2 logarithm of N
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void fft_bit_reverse(fft_complex_t *data, uint32_t log2_size)
+{
+    uint32_t size = 1UL << log2_size;
+    uint32_t index;
+    uint32_t reversed = 0UL;
+    uint32_t bit;
+    fft_complex_t swap;
+
+    for (index = 0UL; index < size; index++)
+    {
+        if (index < reversed)
+        {
+            swap = data[index];
+            data[index] = data[reversed];
+            data[reversed] = swap;
+        }
+
+        /* Increment the reversed index from its most significant bit */
+        bit = size >> 1U;
+        while ((0UL != bit) && (0UL != (reversed & bit)))
+        {
+            reversed &= ~bit;
+            bit >>= 1U;
+        }
+        reversed |= bit;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name:   fft.h
+*
+* Description: This file contains the declarations of the fixed-point FFT.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FFT_H_
+#define FFT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Largest FFT size, as a power of two */
+#define FFT_MAX_LOG2                (12UL)
+#define FFT_MAX_SIZE                (1UL << FFT_MAX_LOG2)
+
+/* Smallest FFT size, as a power of two */
+#define FFT_MIN_LOG2                (2UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Complex Q31 value */
+typedef struct
+{
+    int32_t re;
+    int32_t im;
+} fft_complex_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Work buffer of FFT_MAX_SIZE values, shared by the users of the FFT. Only
+ * one of them may use it at a time.
+ */
+extern fft_complex_t fft_buffer[FFT_MAX_SIZE];
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Calculates the twiddle factors */
+void fft_init(void);
+
+/* In-place forward FFT, scaled by 1/N */
+bool fft_forward(fft_complex_t *data, uint32_t log2_size);
+
+/* In-place inverse FFT, scaled by 1/N */
+bool fft_inverse(fft_complex_t *data, uint32_t log2_size);
+
+/* Sine of 2 * pi * index / FFT_MAX_SIZE, Q31 */
+int32_t fft_sin(uint32_t index);
+
+/* Cosine of 2 * pi * index / FFT_MAX_SIZE, Q31 */
+int32_t fft_cos(uint32_t index);
+
+#endif /* FFT_H_ */
+
+/* [] END OF FILE */
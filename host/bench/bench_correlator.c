@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name:   bench_correlator.c
+*
+* Description: This file contains the host benchmark of the cross-correlation
+*              engine. It measures the time of one correlation for every
+*              window size and prints it as JSON with the path that calculated
+*              it. Built with a larger CORR_FFT_WINDOW, it times the direct
+*              path over the larger windows as well.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "correlator.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Sample pairs correlated per window size */
+#define BENCH_PAIRS         (1UL << 20U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sample_pair_t bench_pairs[CORR_MAX_WINDOW];
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+* This function times the capture and the correlation of windows of one size.
+*
+* Parameters:
+*  window: Number of sample pairs
+*  result: Result of the last correlation
+*
+* Return:
+*  double: Time per correlation in microseconds
+*
+*******************************************************************************/
+static double bench_run(uint32_t window, corr_result_t *result)
+{
+    struct timespec start;
+    struct timespec end;
+    uint32_t repeats = BENCH_PAIRS / window;
+    uint32_t repeat;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (repeat = 0UL; repeat < repeats; repeat++)
+    {
+        (void)correlator_start(window);
+        correlator_process(bench_pairs, window);
+        (void)correlator_get_result(result);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return ((((double)end.tv_sec - (double)start.tv_sec) * 1.0e6) +
+            (((double)end.tv_nsec - (double)start.tv_nsec) / 1.0e3)) / (double)repeats;
+}
+
+int main(void)
+{
+    corr_result_t result;
+    uint32_t window;
+    uint32_t index;
+    uint32_t seed = 1UL;
+    int32_t smooth = 0;
+    double time;
+
+    /* Low-pass filtered noise on SAR0, delayed by 3 samples on SAR1 */
+    for (index = 0UL; index < CORR_MAX_WINDOW; index++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        smooth += ((int32_t)((seed >> 16U) & 0xFFFUL) - 2048L - smooth) / 4L;
+        bench_pairs[index].sar0 = (int16_t)smooth;
+        bench_pairs[(index + 3UL) % CORR_MAX_WINDOW].sar1 = (int16_t)smooth;
+    }
+
+    fft_init();
+    for (window = CORR_MIN_WINDOW; window <= CORR_MAX_WINDOW; window *= 2UL)
+    {
+        time = bench_run(window, &result);
+        printf("{\"benchmark\":\"correlator\",\"window\":%lu,\"path\":\"%s\",\"us\":%.2f,"
+               "\"ns_per_pair\":%.2f,\"delay\":%.3f}\n",
+               (unsigned long)window, result.fft ? "fft" : "direct", time,
+               (time * 1.0e3) / (double)window, (double)result.delay);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
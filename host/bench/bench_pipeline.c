@@ -0,0 +1,402 @@
+/******************************************************************************
+* File Name:   bench_pipeline.c
+*
+* Description: This file contains the host benchmark of the sample path
+*              of the main loop on the simulator. For every simulator and
+*              processing chain, it doubles the trigger rate until the
+*              firmware loses a sample pair, and reports the End-Of-Scan
+*              to CTDAC latency and the CPU headroom of each rate as JSON,
+*              with the highest sustained rate. The firmware is charged a
+*              fixed virtual time per driver call, so the results do not
+*              depend on the host.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Clock of the trigger counter, which overflows every period + 1 clocks */
+#define BENCH_TRIGGER_HZ        (1000000UL)
+
+/* Rates of the sweep. The highest one has the shortest period of the bench
+   simulators, built with ACQ_MIN_PERIOD 2, with the fast profile. */
+#define BENCH_MIN_RATE          (1000UL)
+#define BENCH_MAX_RATE          (333333UL)
+
+/* Commands sent at startup before the period: the fast profile */
+#define BENCH_PROFILE           "o0\\\\r"
+
+/* Period set after the measurement, slow enough for the UART to send the
+   losses reported by the 't' command */
+#define BENCH_REPORT_PERIOD     (9999UL)
+
+/* Inputs of both SARs */
+#define BENCH_INPUTS            "--sar0 sine:50:1.0:1.5 --sar1 sine:50:0.5:1.5"
+
+/* Default virtual time of each driver call, and measured virtual time at
+   each rate */
+#define BENCH_CALL_NS           (100.0)
+#define BENCH_SECONDS           (1.0)
+
+/* Longest output line and command line */
+#define BENCH_LINE_SIZE         (1024)
+#define BENCH_COMMAND_SIZE      (2048)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Processing chain selected by commands of the firmware */
+typedef struct
+{
+    const char *name;
+    const char *commands;
+} bench_chain_t;
+
+/* Results of one rate */
+typedef struct
+{
+    unsigned long scans;
+    unsigned long sim_losses;       /* Triggers lost by the SARs, FIFO and DMA */
+    unsigned long losses;           /* Losses of the firmware, -1 if not reported */
+    unsigned long latencies;
+    unsigned long long p50;
+    unsigned long long p99;
+    unsigned long long max;
+    double headroom;
+} bench_result_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const bench_chain_t bench_chains[] = {
+    { "product", "" },
+    { "decimated", "d" },
+};
+
+/* Directory of the output files of the simulator */
+static const char *bench_directory;
+
+/* Cost model of the firmware: virtual time of each driver call and, only
+   if set, virtual time per host time spent between the calls */
+static double bench_call_ns = BENCH_CALL_NS;
+static double bench_cpu_scale = 0.0;
+
+/*******************************************************************************
+* Function Name: bench_field
+********************************************************************************
+* Summary:
+* This function reads an unsigned number that follows a key in a line.
+*
+* Parameters:
+*  line: Line to search
+*  key: Key, including its quotes and colon
+*
+* Return:
+*  unsigned long long: Number, 0 if the key is missing
+*
+*******************************************************************************/
+static unsigned long long bench_field(const char *line, const char *key)
+{
+    const char *field = strstr(line, key);
+
+    return (NULL == field) ? 0ULL : strtoull(field + strlen(key), NULL, 10);
+}
+
+/*******************************************************************************
+* Function Name: bench_losses
+********************************************************************************
+* Summary:
+* This function reads the sample pairs lost by the firmware from the last
+* report of the 't' command: SAR result overwrites, FIFO overflows, flag
+* collapses, queue overruns and SAR1 timeouts. Trigger gaps follow from
+* these losses, and also appear when the period changes in the middle of a
+* block. Dropped telemetry messages are not sample losses.
+*
+* Parameters:
+*  path: UART output of the simulator
+*
+* Return:
+*  unsigned long: Lost sample pairs, ULONG_MAX if not reported
+*
+*******************************************************************************/
+static unsigned long bench_losses(const char *path)
+{
+    char line[BENCH_LINE_SIZE];
+    unsigned long first[3];
+    unsigned long second[3];
+    bool have_first = false;
+    bool have_second = false;
+    FILE *file;
+
+    file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return (unsigned long)-1;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        if (3 == sscanf(line, "SAR result overwrites: %lu FIFO overflows: %lu Flag collapses: %lu",
+                        &first[0], &first[1], &first[2]))
+        {
+            have_first = true;
+        }
+        if (3 == sscanf(line, "Queue overruns: %lu Trigger gaps: %lu SAR1 timeouts: %lu",
+                        &second[0], &second[1], &second[2]))
+        {
+            have_second = true;
+        }
+    }
+    (void)fclose(file);
+
+    if (!(have_first && have_second))
+    {
+        return (unsigned long)-1;
+    }
+
+    return first[0] + first[1] + first[2] + second[0] + second[2];
+}
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+* This function runs a simulator at one trigger rate. The fast profile, the
+* commands of the chain and the period are sent at startup and applied at
+* the first wakeup,
+* before the settle time. The summary of the simulator covers the virtual
+* time measured from the settle time. The trigger then slows down, so that
+* the report of the 't' command reaches the UART.
+*
+* Parameters:
+*  simulator: Path of the simulator
+*  settle: Virtual time at which the measurement starts
+*  chain: Processing chain
+*  period: Trigger period in trigger clocks
+*  result: Results of the rate
+*
+* Return:
+*  bool: true if the simulator succeeded
+*
+*******************************************************************************/
+static bool bench_run(const char *simulator, double settle, const bench_chain_t *chain, unsigned long period,
+                      bench_result_t *result)
+{
+    char command[BENCH_COMMAND_SIZE];
+    char path[BENCH_LINE_SIZE];
+    char line[BENCH_LINE_SIZE];
+    double end = settle + BENCH_SECONDS;
+    FILE *file;
+    int length;
+
+    length = snprintf(command, sizeof(command),
+                      "%s --seconds %.3f --call-ns %g --cpu-scale %g " BENCH_INPUTS
+                      " --send 0:" BENCH_PROFILE "r%lu\\\\r%s --send %.3f:r%lu\\\\r --send %.3f:t --window %.3f:%.3f"
+                      " --uart-out %s/bench_pipeline.uart --report %s/bench_pipeline.json > /dev/null",
+                      simulator, end + 4.0, bench_call_ns, bench_cpu_scale, period, chain->commands, end,
+                      BENCH_REPORT_PERIOD, end + 1.0, settle, end, bench_directory, bench_directory);
+    if ((length < 0) || ((size_t)length >= sizeof(command)) || (0 != system(command)))
+    {
+        return false;
+    }
+
+    (void)snprintf(path, sizeof(path), "%s/bench_pipeline.json", bench_directory);
+    file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return false;
+    }
+    if (NULL == fgets(line, sizeof(line), file))
+    {
+        (void)fclose(file);
+        return false;
+    }
+    (void)fclose(file);
+
+    result->scans = (unsigned long)bench_field(line, "\"scans\":[");
+    result->sim_losses = (unsigned long)(bench_field(line, "\"triggers_lost\":") +
+                                         bench_field(line, "\"fifo_overflows\":") +
+                                         bench_field(line, "\"dma_triggers_lost\":"));
+    result->latencies = (unsigned long)bench_field(line, "\"count\":");
+    result->p50 = bench_field(line, "\"p50\":");
+    result->p99 = bench_field(line, "\"p99\":");
+    result->max = bench_field(line, "\"max\":");
+    result->headroom = 0.0;
+    if (NULL != strstr(line, "\"sleep_ratio\":"))
+    {
+        result->headroom = strtod(strstr(line, "\"sleep_ratio\":") + strlen("\"sleep_ratio\":"), NULL);
+    }
+
+    (void)snprintf(path, sizeof(path), "%s/bench_pipeline.uart", bench_directory);
+    result->losses = bench_losses(path);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: bench_sweep
+********************************************************************************
+* Summary:
+* This function doubles the trigger rate of a simulator and chain from
+* BENCH_MIN_RATE until a sample pair is lost, and prints the results of each
+* rate and the highest sustained rate as JSON lines.
+*
+* Parameters:
+*  simulator: Path of the simulator
+*  settle: Virtual time at which the measurement starts
+*  chain: Processing chain
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_sweep(const char *simulator, double settle, const bench_chain_t *chain)
+{
+    const char *name = strrchr(simulator, '/');
+    bench_result_t result;
+    unsigned long max_rate = 0UL;
+    unsigned long rate;
+    unsigned long period;
+    unsigned long expected;
+    bool sustained = true;
+
+    name = (NULL == name) ? simulator : (name + 1);
+
+    for (rate = BENCH_MIN_RATE; sustained && (rate <= BENCH_MAX_RATE); rate *= 2UL)
+    {
+        period = (BENCH_TRIGGER_HZ / rate) - 1UL;
+        rate = BENCH_TRIGGER_HZ / (period + 1UL);
+        if (!bench_run(simulator, settle, chain, period, &result))
+        {
+            fprintf(stderr, "%s: simulator failed\n", name);
+            return;
+        }
+
+        /* Every trigger of the measurement is converted and processed */
+        expected = (unsigned long)((double)rate * BENCH_SECONDS);
+        sustained = (result.scans + 1UL >= expected) && (0UL == result.sim_losses) &&
+                    (0UL == result.losses) && (0UL != result.latencies);
+        if (sustained)
+        {
+            max_rate = rate;
+        }
+
+        printf("{\"benchmark\":\"pipeline\",\"simulator\":\"%s\",\"chain\":\"%s\",\"rate_hz\":%lu,"
+               "\"scans\":%lu,\"sim_losses\":%lu,\"losses\":%ld,"
+               "\"eos_to_dac_ns\":{\"p50\":%llu,\"p99\":%llu,\"max\":%llu},\"headroom\":%.4f,\"sustained\":%s}\n",
+               name, chain->name, rate, result.scans, result.sim_losses, (long)result.losses,
+               result.p50, result.p99, result.max, result.headroom, sustained ? "true" : "false");
+        fflush(stdout);
+    }
+
+    printf("{\"benchmark\":\"pipeline\",\"simulator\":\"%s\",\"chain\":\"%s\",\"call_ns\":%g,\"cpu_scale\":%g,"
+           "\"max_rate_hz\":%lu}\n", name, chain->name, bench_call_ns, bench_cpu_scale, max_rate);
+    fflush(stdout);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the sweep of every simulator and chain.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Optional --call-ns N and --cpu-scale X, directory of the output
+*        files, then each simulator with the virtual time of its first
+*        wakeup, SIMULATOR:SECONDS
+*
+* Return:
+*  int: EXIT_SUCCESS
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    char simulator[BENCH_LINE_SIZE];
+    const char *settle;
+    int index = 1;
+    size_t chain;
+
+    while ((index + 1 < argc) && (0 == strncmp(argv[index], "--", 2)))
+    {
+        if (0 == strcmp(argv[index], "--call-ns"))
+        {
+            bench_call_ns = strtod(argv[index + 1], NULL);
+        }
+        else if (0 == strcmp(argv[index], "--cpu-scale"))
+        {
+            bench_cpu_scale = strtod(argv[index + 1], NULL);
+        }
+        else
+        {
+            break;
+        }
+        index += 2;
+    }
+    if (((index + 2) > argc) || (0 == strncmp(argv[index], "--", 2)))
+    {
+        fprintf(stderr, "usage: %s [--call-ns N] [--cpu-scale X] DIRECTORY SIMULATOR:SECONDS...\n", argv[0]);
+        return 2;
+    }
+    bench_directory = argv[index++];
+
+    for (; index < argc; index++)
+    {
+        settle = strrchr(argv[index], ':');
+        if ((NULL == settle) || ((size_t)(settle - argv[index]) >= sizeof(simulator)))
+        {
+            fprintf(stderr, "%s: expected SIMULATOR:SECONDS\n", argv[index]);
+            return 2;
+        }
+        (void)memcpy(simulator, argv[index], (size_t)(settle - argv[index]));
+        simulator[settle - argv[index]] = '\0';
+
+        for (chain = 0U; chain < (sizeof(bench_chains) / sizeof(bench_chains[0])); chain++)
+        {
+            bench_sweep(simulator, strtod(settle + 1, NULL), &bench_chains[chain]);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,236 @@
+/******************************************************************************
+* File Name:   bench_product.c
+*
+* Description: This file contains the host benchmark of the product kernel. It
+*              measures the time per sample pair of the float path, of the
+*              fixed-point kernel per pair and of the block kernel, and
+*              prints them as JSON. On x86 hosts, the time is also given in
+*              TSC cycles.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "processing.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_USE_TSC       (1)
+#else
+#define BENCH_USE_TSC       (0)
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Sample pairs per block and blocks per measurement */
+#define BENCH_BLOCK_PAIRS   (256UL)
+#define BENCH_REPEATS       (40000UL)
+
+/* Volts per count of the ideal conversion of the PDL */
+#define BENCH_VOLTS_PER_COUNT   (3.3f / 2048.0f)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+typedef struct
+{
+    double ns;
+    double cycles;
+} bench_time_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sample_pair_t bench_pairs[BENCH_BLOCK_PAIRS];
+static uint16_t bench_codes[BENCH_BLOCK_PAIRS];
+static product_calib_t bench_calib;
+
+/* Keeps the results alive */
+static volatile uint32_t bench_sink;
+
+/*******************************************************************************
+* Function Name: bench_float_block
+********************************************************************************
+* Summary:
+* This function is the former product path: both results converted to float
+* volts, multiplied, scaled and truncated to a code.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_float_block(void)
+{
+    uint32_t index;
+    float volts0;
+    float volts1;
+
+    for (index = 0UL; index < BENCH_BLOCK_PAIRS; index++)
+    {
+        volts0 = (float)bench_pairs[index].sar0 * BENCH_VOLTS_PER_COUNT;
+        volts1 = (float)bench_pairs[index].sar1 * BENCH_VOLTS_PER_COUNT;
+        bench_codes[index] = (uint16_t)(int32_t)(volts0 * volts1 * (float)SCALING_FACTOR);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_pair_block
+********************************************************************************
+* Summary:
+* This function calls the fixed-point kernel once per sample pair.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_pair_block(void)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < BENCH_BLOCK_PAIRS; index++)
+    {
+        bench_codes[index] = (uint16_t)processing_counts_to_dac_code(&bench_calib,
+            bench_pairs[index].sar0, bench_pairs[index].sar1);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_block
+********************************************************************************
+* Summary:
+* This function calls the block kernel.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_block(void)
+{
+    processing_block_to_dac(&bench_calib, bench_pairs, bench_codes, BENCH_BLOCK_PAIRS);
+}
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+* This function times a kernel over BENCH_REPEATS blocks.
+*
+* Parameters:
+*  kernel: Function processing one block
+*
+* Return:
+*  bench_time_t: Time per sample pair
+*
+*******************************************************************************/
+static bench_time_t bench_run(void (*kernel)(void))
+{
+    struct timespec start;
+    struct timespec end;
+    bench_time_t time;
+    uint64_t cycles = 0ULL;
+    uint32_t repeat;
+    double pairs = (double)BENCH_BLOCK_PAIRS * (double)BENCH_REPEATS;
+
+    kernel();
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+#if (BENCH_USE_TSC == 1)
+    cycles = __rdtsc();
+#endif
+    for (repeat = 0UL; repeat < BENCH_REPEATS; repeat++)
+    {
+        kernel();
+        bench_sink += bench_codes[repeat % BENCH_BLOCK_PAIRS];
+    }
+#if (BENCH_USE_TSC == 1)
+    cycles = __rdtsc() - cycles;
+#endif
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    time.ns = ((((double)end.tv_sec - (double)start.tv_sec) * 1.0e9) +
+               ((double)end.tv_nsec - (double)start.tv_nsec)) / pairs;
+    time.cycles = (double)cycles / pairs;
+    return time;
+}
+
+int main(void)
+{
+    bench_time_t float_time;
+    bench_time_t pair_time;
+    bench_time_t block_time;
+    uint32_t index;
+    uint32_t seed = 1UL;
+
+    /* Ideal conversion of the PDL, from two points in microvolts */
+    processing_product_calib_init(&bench_calib, 0L, 3298388L, 0L, 3298388L);
+
+    for (index = 0UL; index < BENCH_BLOCK_PAIRS; index++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        bench_pairs[index].sar0 = (int16_t)((seed >> 12U) & 0x7FFUL);
+        seed = (seed * 1103515245UL) + 12345UL;
+        bench_pairs[index].sar1 = (int16_t)((seed >> 12U) & 0x7FFUL);
+    }
+
+    float_time = bench_run(bench_float_block);
+    pair_time = bench_run(bench_pair_block);
+    block_time = bench_run(bench_block);
+
+    printf("{\"benchmark\":\"product\",\"pairs\":%lu,"
+           "\"float_ns\":%.3f,\"pair_ns\":%.3f,\"block_ns\":%.3f,"
+           "\"float_cycles\":%.2f,\"pair_cycles\":%.2f,\"block_cycles\":%.2f,"
+           "\"block_speedup\":%.2f}\n",
+           (unsigned long)(BENCH_BLOCK_PAIRS * BENCH_REPEATS),
+           float_time.ns, pair_time.ns, block_time.ns,
+           float_time.cycles, pair_time.cycles, block_time.cycles,
+           (block_time.ns > 0.0) ? (float_time.ns / block_time.ns) : 0.0);
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name:   cmsis_compiler.h
+*
+* Description: This file contains the SIMD instructions of the Cortex-M DSP
+*              extension used by the firmware, in portable C, so that the
+*              host tests can check the DSP paths of the kernels.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CMSIS_COMPILER_H_
+#define CMSIS_COMPILER_H_
+
+#include <stdint.h>
+
+/* Subtracts the halfwords of op2 from those of op1, each modulo 2^16 */
+static inline uint32_t __SSUB16(uint32_t op1, uint32_t op2)
+{
+    uint32_t low = (uint16_t)((uint16_t)op1 - (uint16_t)op2);
+    uint32_t high = (uint16_t)((uint16_t)(op1 >> 16U) - (uint16_t)(op2 >> 16U));
+
+    return (high << 16U) | low;
+}
+
+/* Adds the products of the low halfword of op1 by the high halfword of op2
+   and of the high halfword of op1 by the low halfword of op2 */
+static inline uint32_t __SMUADX(uint32_t op1, uint32_t op2)
+{
+    int32_t cross0 = (int32_t)(int16_t)op1 * (int32_t)(int16_t)(op2 >> 16U);
+    int32_t cross1 = (int32_t)(int16_t)(op1 >> 16U) * (int32_t)(int16_t)op2;
+
+    return (uint32_t)(cross0 + cross1);
+}
+
+/* Saturates a signed value to the unsigned range of sat bits */
+static inline uint32_t __USAT(int32_t val, uint32_t sat)
+{
+    uint32_t max = (1UL << sat) - 1UL;
+
+    if (val < 0)
+    {
+        return 0UL;
+    }
+
+    return ((uint32_t)val > max) ? max : (uint32_t)val;
+}
+
+#endif /* CMSIS_COMPILER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,620 @@
+/******************************************************************************
+* File Name:   cy_pdl.h
+*
+* Description: This file stands in for the Peripheral Driver Library when
+*              the firmware is built for the host simulator. It declares the
+*              subset of the PDL used by the application, with the register
+*              fields that the firmware accesses directly. The functions
+*              are implemented by the peripheral models of the simulator
+*              in host/sim.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_PDL_H_
+#define CY_PDL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* System
+********************************************************************************/
+typedef float float32_t;
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                     (0UL)
+
+/* Failed assertions stop the simulation with the location */
+#define CY_ASSERT(x)                        do { if (!(x)) { sim_assert_failed(__FILE__, __LINE__); } } while (0)
+
+/* Interrupt lines of the peripherals used by the application */
+typedef enum
+{
+    pass_interrupt_sar_0_IRQn       = 0,
+    pass_interrupt_sar_1_IRQn       = 1,
+    cpuss_interrupts_dw0_0_IRQn     = 2,
+    cpuss_interrupts_dw0_1_IRQn     = 3,
+    cpuss_interrupts_dw0_2_IRQn     = 4,
+    scb_5_interrupt_IRQn            = 5,
+    SIM_IRQ_COUNT                   = 6
+} IRQn_Type;
+
+typedef void (*cy_israddress)(void);
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS = 0
+} cy_en_sysint_status_t;
+
+/* Frequency of the CPU clock */
+extern uint32_t SystemCoreClock;
+
+void sim_assert_failed(const char *file, int line);
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr);
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void __enable_irq(void);
+void __disable_irq(void);
+void __DMB(void);
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+
+/*******************************************************************************
+* Clocks and power modes
+********************************************************************************/
+typedef enum
+{
+    CY_SYSCLK_DIV_8_BIT = 0,
+    CY_SYSCLK_DIV_16_BIT = 1
+} cy_en_divider_types_t;
+
+typedef enum
+{
+    CY_SYSCLK_SUCCESS = 0,
+    CY_SYSCLK_BAD_PARAM = 1
+} cy_en_sysclk_status_t;
+
+/* Peripheral clocks of the TCPWM counters */
+#define PCLK_TCPWM0_CLOCKS0                 (0UL)
+#define PCLK_TCPWM0_CLOCKS1                 (1UL)
+#define PCLK_TCPWM0_CLOCKS2                 (2UL)
+
+cy_en_sysclk_status_t Cy_SysClk_PeriphAssignDivider(uint32_t ipBlock, cy_en_divider_types_t dividerType,
+                                                    uint32_t dividerNum);
+uint32_t Cy_SysClk_PeriphGetFrequency(cy_en_divider_types_t dividerType, uint32_t dividerNum);
+void Cy_SysClk_MfoEnable(bool deepSleepEnable);
+void Cy_SysClk_ClkMfEnable(void);
+uint32_t Cy_SysClk_ClkMfGetFrequency(void);
+
+typedef enum
+{
+    CY_SYSPM_WAIT_FOR_INTERRUPT = 0,
+    CY_SYSPM_WAIT_FOR_EVENT = 1
+} cy_en_syspm_waitfor_t;
+
+typedef enum
+{
+    CY_SYSPM_SUCCESS = 0,
+    CY_SYSPM_FAIL = 1
+} cy_en_syspm_status_t;
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(cy_en_syspm_waitfor_t waitFor);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor);
+
+/*******************************************************************************
+* Register blocks
+********************************************************************************/
+/* SAR registers read directly by the firmware or by the DMA */
+typedef struct
+{
+    volatile uint32_t CHAN_RESULT[16];
+    volatile uint32_t FIFO_RD_DATA;
+    volatile uint32_t STATUS;
+} SAR_Type;
+
+#define SAR_STATUS_BUSY_Msk                 (0x80000000UL)
+
+/* CTDAC register written by the DMA in buffered mode */
+typedef struct
+{
+    volatile uint32_t CTDAC_VAL;
+    volatile uint32_t CTDAC_VAL_NXT;
+} CTDAC_Type;
+
+typedef struct { uint32_t reserved; } PASS_Type;
+typedef struct { uint32_t reserved; } CTBM_Type;
+typedef struct { uint32_t reserved; } TCPWM_Type;
+typedef struct { uint32_t reserved; } DW_Type;
+
+extern SAR_Type *const SAR0;
+extern SAR_Type *const SAR1;
+extern CTDAC_Type *const CTDAC0;
+extern PASS_Type *const PASS;
+extern CTBM_Type *const CTBM0;
+extern TCPWM_Type *const TCPWM0;
+extern DW_Type *const DW0;
+
+/*******************************************************************************
+* Analog reference and PASS timer
+********************************************************************************/
+typedef enum
+{
+    CY_SYSANALOG_SUCCESS = 0,
+    CY_SYSANALOG_BAD_PARAM = 1
+} cy_en_sysanalog_status_t;
+
+typedef enum
+{
+    CY_SYSANALOG_DEEPSLEEP_DISABLE = 0,
+    CY_SYSANALOG_DEEPSLEEP_IPTAT_1 = 1,
+    CY_SYSANALOG_DEEPSLEEP_IPTAT_2 = 2,
+    CY_SYSANALOG_DEEPSLEEP_IPTAT_IZTAT_VREF = 3
+} cy_en_sysanalog_deep_sleep_t;
+
+typedef struct
+{
+    uint32_t startup;
+    uint32_t iztat;
+    uint32_t vref;
+    cy_en_sysanalog_deep_sleep_t deepSleep;
+} cy_stc_sysanalog_config_t;
+
+typedef enum
+{
+    CY_SYSANALOG_DEEPSLEEP_SRC_LFCLK = 0,
+    CY_SYSANALOG_DEEPSLEEP_SRC_MFCLK = 1
+} cy_en_sysanalog_deep_sleep_clock_sel_t;
+
+typedef enum
+{
+    CY_SYSANALOG_DEEPSLEEP_CLK_NO_DIV = 0,
+    CY_SYSANALOG_DEEPSLEEP_CLK_DIV_BY_2 = 1,
+    CY_SYSANALOG_DEEPSLEEP_CLK_DIV_BY_4 = 2
+} cy_en_sysanalog_deep_sleep_clock_div_t;
+
+typedef struct
+{
+    cy_en_sysanalog_deep_sleep_clock_sel_t clkSel;
+    cy_en_sysanalog_deep_sleep_clock_div_t clkDiv;
+} cy_stc_sysanalog_deep_sleep_config_t;
+
+typedef enum
+{
+    CY_SYSANALOG_TIMER_CLK_PERI = 0,
+    CY_SYSANALOG_TIMER_CLK_DEEPSLEEP = 1,
+    CY_SYSANALOG_TIMER_CLK_LF = 2
+} cy_en_sysanalog_timer_clock_t;
+
+typedef struct
+{
+    cy_en_sysanalog_timer_clock_t clockSel;
+    uint32_t period;
+} cy_stc_sysanalog_timer_config_t;
+
+cy_en_sysanalog_status_t Cy_SysAnalog_Init(const cy_stc_sysanalog_config_t *config);
+void Cy_SysAnalog_Enable(void);
+cy_en_sysanalog_status_t Cy_SysAnalog_DeepSleepInit(PASS_Type *base, const cy_stc_sysanalog_deep_sleep_config_t *config);
+cy_en_sysanalog_status_t Cy_SysAnalog_TimerInit(PASS_Type *base, const cy_stc_sysanalog_timer_config_t *config);
+void Cy_SysAnalog_TimerEnable(PASS_Type *base);
+void Cy_SysAnalog_TimerDisable(PASS_Type *base);
+void Cy_SysAnalog_TimerSetPeriod(PASS_Type *base, uint32_t periodVal);
+
+/*******************************************************************************
+* SAR
+********************************************************************************/
+typedef enum
+{
+    CY_SAR_SUCCESS = 0,
+    CY_SAR_BAD_PARAM = 1
+} cy_en_sar_status_t;
+
+typedef enum
+{
+    CY_SAR_AVG_CNT_2 = 0,
+    CY_SAR_AVG_CNT_4 = 1,
+    CY_SAR_AVG_CNT_8 = 2,
+    CY_SAR_AVG_CNT_16 = 3,
+    CY_SAR_AVG_CNT_32 = 4,
+    CY_SAR_AVG_CNT_64 = 5,
+    CY_SAR_AVG_CNT_128 = 6,
+    CY_SAR_AVG_CNT_256 = 7
+} cy_en_sar_sample_ctrl_avg_cnt_t;
+
+typedef enum
+{
+    CY_SAR_AVG_MODE_SEQUENTIAL_ACCUM = 0,
+    CY_SAR_AVG_MODE_SEQUENTIAL_FIXED = 1,
+    CY_SAR_AVG_MODE_INTERLEAVED = 2
+} cy_en_sar_sample_ctrl_avg_mode_t;
+
+typedef enum
+{
+    CY_SAR_SAMPLE_TIME_0 = 0,
+    CY_SAR_SAMPLE_TIME_1 = 1,
+    CY_SAR_SAMPLE_TIME_2 = 2,
+    CY_SAR_SAMPLE_TIME_3 = 3
+} cy_en_sar_channel_sampletime_t;
+
+typedef enum
+{
+    CY_SAR_RANGE_COND_BELOW = 0,
+    CY_SAR_RANGE_COND_INSIDE = 1,
+    CY_SAR_RANGE_COND_ABOVE = 2,
+    CY_SAR_RANGE_COND_OUTSIDE = 3
+} cy_en_sar_range_detect_condition_t;
+
+typedef enum
+{
+    CY_SAR_CLK_PERI = 0,
+    CY_SAR_CLK_DEEPSLEEP = 1
+} cy_en_sar_clock_source_t;
+
+typedef enum
+{
+    CY_SAR_SAR0 = 0,
+    CY_SAR_TIMER = 1
+} cy_en_sar_simult_trig_source_t;
+
+typedef struct
+{
+    uint32_t addr;
+    bool differential;
+    cy_en_sar_channel_sampletime_t sampleTimeSel;
+    bool avgEn;
+    bool rangeIntrEn;
+    bool satIntrEn;
+} cy_stc_sar_channel_config_t;
+
+typedef struct
+{
+    bool chanId;
+    bool clrTrIntrOnRead;
+    uint32_t level;
+    bool trOut;
+} cy_stc_sar_fifo_config_t;
+
+typedef struct
+{
+    uint32_t chanEn;
+    const cy_stc_sar_channel_config_t *channelConfig[16];
+    cy_en_sar_sample_ctrl_avg_cnt_t avgCnt;
+    cy_en_sar_sample_ctrl_avg_mode_t avgMode;
+    uint16_t acqTime[4];
+    uint32_t rangeThresLow;
+    uint32_t rangeThresHigh;
+    cy_en_sar_range_detect_condition_t rangeCond;
+    const cy_stc_sar_fifo_config_t *fifoCfgPtr;
+    bool trTimer;
+    bool eosEn;
+    cy_en_sar_clock_source_t clock;
+} cy_stc_sar_config_t;
+
+typedef struct
+{
+    cy_en_sar_simult_trig_source_t simultTrigSource;
+    uint32_t simultControl;
+} cy_stc_sar_common_config_t;
+
+typedef struct
+{
+    uint16_t value;
+    uint16_t channel;
+} cy_stc_sar_fifo_read_t;
+
+/* Interrupt causes */
+#define CY_SAR_INTR_EOS                     (0x00000001UL)
+#define CY_SAR_INTR_OVERFLOW                (0x00000002UL)
+#define CY_SAR_INTR_FW_COLLISION            (0x00000004UL)
+#define CY_SAR_INTR_FIFO_LEVEL              (0x00000100UL)
+#define CY_SAR_INTR_FIFO_OVERFLOW           (0x00000200UL)
+#define CY_SAR_INTR_FIFO_UNDERFLOW          (0x00000400UL)
+#define CY_SAR_INTR                         (0x000007FFUL)
+
+#define CY_SAR_NUM_CHANNELS                 (16UL)
+
+cy_en_sar_status_t Cy_SAR_CommonInit(PASS_Type *base, const cy_stc_sar_common_config_t *trigConfig);
+cy_en_sar_status_t Cy_SAR_Init(SAR_Type *base, const cy_stc_sar_config_t *config);
+void Cy_SAR_Enable(SAR_Type *base);
+void Cy_SAR_Disable(SAR_Type *base);
+void Cy_SAR_SetInterruptMask(SAR_Type *base, uint32_t intrMask);
+uint32_t Cy_SAR_GetInterruptStatus(const SAR_Type *base);
+void Cy_SAR_ClearInterrupt(SAR_Type *base, uint32_t intrMask);
+int16_t Cy_SAR_GetResult16(const SAR_Type *base, uint32_t chan);
+float32_t Cy_SAR_CountsTo_Volts(const SAR_Type *base, uint32_t chan, int16_t adcCounts);
+int32_t Cy_SAR_CountsTo_uVolts(const SAR_Type *base, uint32_t chan, int16_t adcCounts);
+uint32_t Cy_SAR_FifoGetDataCount(const SAR_Type *base);
+void Cy_SAR_FifoRead(const SAR_Type *base, cy_stc_sar_fifo_read_t *readData);
+void Cy_SAR_SetLowLimit(SAR_Type *base, uint32_t lowLimit);
+void Cy_SAR_SetHighLimit(SAR_Type *base, uint32_t highLimit);
+void Cy_SAR_SetRangeCond(SAR_Type *base, cy_en_sar_range_detect_condition_t cond);
+void Cy_SAR_SetRangeInterruptMask(SAR_Type *base, uint32_t chanMask);
+uint32_t Cy_SAR_GetRangeInterruptStatusMasked(const SAR_Type *base);
+void Cy_SAR_ClearRangeInterrupt(SAR_Type *base, uint32_t chanMask);
+void Cy_SAR_SetSatInterruptMask(SAR_Type *base, uint32_t chanMask);
+uint32_t Cy_SAR_GetSatInterruptStatusMasked(const SAR_Type *base);
+void Cy_SAR_ClearSatInterrupt(SAR_Type *base, uint32_t chanMask);
+
+/*******************************************************************************
+* CTB and CTDAC
+********************************************************************************/
+typedef enum
+{
+    CY_CTB_SUCCESS = 0,
+    CY_CTB_BAD_PARAM = 1
+} cy_en_ctb_status_t;
+
+typedef enum
+{
+    CY_CTB_OPAMP_0 = 1,
+    CY_CTB_OPAMP_1 = 2
+} cy_en_ctb_opamp_sel_t;
+
+typedef enum
+{
+    CY_CTB_DEEPSLEEP_DISABLE = 0,
+    CY_CTB_DEEPSLEEP_ENABLE = 1
+} cy_en_ctb_deep_sleep_t;
+
+typedef struct
+{
+    uint32_t power;
+    uint32_t outputMode;
+} cy_stc_ctb_opamp_config_t;
+
+cy_en_ctb_status_t Cy_CTB_OpampInit(CTBM_Type *base, cy_en_ctb_opamp_sel_t opampNum,
+                                    const cy_stc_ctb_opamp_config_t *config);
+void Cy_CTB_Enable(CTBM_Type *base);
+void Cy_CTB_SetDeepSleepMode(CTBM_Type *base, cy_en_ctb_deep_sleep_t deepSleep);
+
+typedef enum
+{
+    CY_CTDAC_SUCCESS = 0,
+    CY_CTDAC_BAD_PARAM = 1
+} cy_en_ctdac_status_t;
+
+typedef enum
+{
+    CY_CTDAC_UPDATE_DIRECT_WRITE = 0,
+    CY_CTDAC_UPDATE_BUFFERED_WRITE = 1,
+    CY_CTDAC_UPDATE_STROBE_EDGE_SYNC = 2
+} cy_en_ctdac_update_t;
+
+typedef enum
+{
+    CY_CTDAC_DEEPSLEEP_DISABLE = 0,
+    CY_CTDAC_DEEPSLEEP_ENABLE = 1
+} cy_en_ctdac_deep_sleep_t;
+
+typedef struct
+{
+    cy_en_ctdac_update_t updateMode;
+    cy_en_ctdac_deep_sleep_t deepSleep;
+    int32_t value;
+    int32_t nextValue;
+    bool enableInterrupt;
+} cy_stc_ctdac_config_t;
+
+cy_en_ctdac_status_t Cy_CTDAC_Init(CTDAC_Type *base, const cy_stc_ctdac_config_t *config);
+void Cy_CTDAC_Enable(CTDAC_Type *base);
+void Cy_CTDAC_SetValue(CTDAC_Type *base, int32_t value);
+
+/*******************************************************************************
+* TCPWM
+********************************************************************************/
+typedef enum
+{
+    CY_TCPWM_SUCCESS = 0,
+    CY_TCPWM_BAD_PARAM = 1
+} cy_en_tcpwm_status_t;
+
+typedef struct
+{
+    uint32_t period;
+    uint32_t clockPrescaler;
+    uint32_t runMode;
+    uint32_t countDirection;
+} cy_stc_tcpwm_counter_config_t;
+
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum,
+                                           const cy_stc_tcpwm_counter_config_t *config);
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerStart_Single(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerStopOrKill_Single(TCPWM_Type *base, uint32_t cntNum);
+uint32_t Cy_TCPWM_Counter_GetCounter(TCPWM_Type const *base, uint32_t cntNum);
+void Cy_TCPWM_Counter_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count);
+void Cy_TCPWM_Counter_SetPeriod(TCPWM_Type *base, uint32_t cntNum, uint32_t period);
+
+/*******************************************************************************
+* DMA (DW) and trigger multiplexer
+********************************************************************************/
+typedef enum
+{
+    CY_DMA_SUCCESS = 0,
+    CY_DMA_BAD_PARAM = 1
+} cy_en_dma_status_t;
+
+typedef enum
+{
+    CY_DMA_1D_TRANSFER = 1,
+    CY_DMA_2D_TRANSFER = 2
+} cy_en_dma_descriptor_type_t;
+
+typedef enum
+{
+    CY_DMA_BYTE = 0,
+    CY_DMA_HALFWORD = 1,
+    CY_DMA_WORD = 2
+} cy_en_dma_data_size_t;
+
+typedef enum
+{
+    CY_DMA_TRANSFER_SIZE_DATA = 0,
+    CY_DMA_TRANSFER_SIZE_WORD = 1
+} cy_en_dma_transfer_size_t;
+
+typedef enum
+{
+    CY_DMA_RETRIG_IM = 0,
+    CY_DMA_RETRIG_4CYC = 1,
+    CY_DMA_RETRIG_16CYC = 2,
+    CY_DMA_WAIT_FOR_REACT = 3
+} cy_en_dma_retrigger_t;
+
+typedef enum
+{
+    CY_DMA_1ELEMENT = 0,
+    CY_DMA_X_LOOP = 1,
+    CY_DMA_DESCR = 2,
+    CY_DMA_DESCR_CHAIN = 3
+} cy_en_dma_trigger_type_t;
+
+typedef enum
+{
+    CY_DMA_CHANNEL_ENABLED = 0,
+    CY_DMA_CHANNEL_DISABLED = 1
+} cy_en_dma_channel_state_t;
+
+/* Causes returned by Cy_DMA_Channel_GetStatus() */
+typedef enum
+{
+    CY_DMA_INTR_CAUSE_NO_INTR = 0,
+    CY_DMA_INTR_CAUSE_COMPLETION = 1,
+    CY_DMA_INTR_CAUSE_SRC_BUS_ERROR = 2,
+    CY_DMA_INTR_CAUSE_DST_BUS_ERROR = 3
+} cy_en_dma_intr_cause_t;
+
+/* Completion interrupt bit of the channel status and mask */
+#define CY_DMA_INTR_MASK                    (0x01UL)
+
+struct cy_stc_dma_descriptor;
+
+typedef struct
+{
+    cy_en_dma_retrigger_t retrigger;
+    cy_en_dma_trigger_type_t interruptType;
+    cy_en_dma_trigger_type_t triggerOutType;
+    cy_en_dma_channel_state_t channelState;
+    cy_en_dma_trigger_type_t triggerInType;
+    cy_en_dma_data_size_t dataSize;
+    cy_en_dma_transfer_size_t srcTransferSize;
+    cy_en_dma_transfer_size_t dstTransferSize;
+    cy_en_dma_descriptor_type_t descriptorType;
+    void *srcAddress;
+    void *dstAddress;
+    int32_t srcXincr;
+    int32_t dstXincr;
+    uint32_t xCount;
+    int32_t srcYincr;
+    int32_t dstYincr;
+    uint32_t yCount;
+    struct cy_stc_dma_descriptor *nextDescriptor;
+} cy_stc_dma_descriptor_config_t;
+
+/* The simulated descriptor keeps its configuration as is */
+typedef struct cy_stc_dma_descriptor
+{
+    cy_stc_dma_descriptor_config_t config;
+} cy_stc_dma_descriptor_t;
+
+typedef struct
+{
+    cy_stc_dma_descriptor_t *descriptor;
+    bool preemptable;
+    uint32_t priority;
+    bool enable;
+    bool bufferable;
+} cy_stc_dma_channel_config_t;
+
+cy_en_dma_status_t Cy_DMA_Descriptor_Init(cy_stc_dma_descriptor_t *descriptor,
+                                          const cy_stc_dma_descriptor_config_t *config);
+cy_en_dma_status_t Cy_DMA_Channel_Init(DW_Type *base, uint32_t channel,
+                                       const cy_stc_dma_channel_config_t *channelConfig);
+void Cy_DMA_Enable(DW_Type *base);
+void Cy_DMA_Channel_Enable(DW_Type *base, uint32_t channel);
+void Cy_DMA_Channel_Disable(DW_Type *base, uint32_t channel);
+void Cy_DMA_Channel_SetInterruptMask(DW_Type *base, uint32_t channel, uint32_t interrupt);
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const *base, uint32_t channel);
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const *base, uint32_t channel);
+void Cy_DMA_Channel_ClearInterrupt(DW_Type *base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetCurrentXloopIndex(DW_Type const *base, uint32_t channel);
+cy_stc_dma_descriptor_t *Cy_DMA_Channel_GetCurrentDescriptor(DW_Type const *base, uint32_t channel);
+uint32_t Cy_DMA_Channel_GetCurrentYloopIndex(DW_Type const *base, uint32_t channel);
+
+typedef enum
+{
+    CY_TRIGMUX_SUCCESS = 0,
+    CY_TRIGMUX_BAD_PARAM = 1
+} cy_en_trigmux_status_t;
+
+typedef enum
+{
+    TRIGGER_TYPE_LEVEL = 0,
+    TRIGGER_TYPE_EDGE = 1
+} en_trig_type_t;
+
+/* Trigger multiplexer inputs and outputs used by the application */
+#define TRIG_IN_MUX_0_PASS_TR_SAR_OUT0      (0x40000100UL)
+#define TRIG_IN_MUX_0_PASS_TR_SAR_OUT1      (0x40000101UL)
+#define TRIG_IN_MUX_0_TCPWM0_TR_OVERFLOW1   (0x40000111UL)
+#define TRIG_OUT_MUX_0_PDMA0_TR_IN0         (0x40000200UL)
+#define TRIG_OUT_MUX_0_PDMA0_TR_IN1         (0x40000201UL)
+#define TRIG_OUT_MUX_0_PDMA0_TR_IN2         (0x40000202UL)
+
+cy_en_trigmux_status_t Cy_TrigMux_Connect(uint32_t inTrig, uint32_t outTrig, bool invert, en_trig_type_t trigType);
+
+/*******************************************************************************
+* Configuration of the device configurator (design.modus)
+********************************************************************************/
+extern const cy_stc_sysanalog_config_t pass_0_aref_0_config;
+extern const cy_stc_ctb_opamp_config_t pass_0_ctb_0_oa_0_config;
+extern const cy_stc_ctdac_config_t pass_0_ctdac_0_config;
+extern const cy_stc_sar_common_config_t pass_0_saradc_0_config;
+extern const cy_stc_sar_config_t pass_0_saradc_0_sar_0_config;
+extern const cy_stc_sar_config_t pass_0_saradc_0_sar_1_config;
+extern const cy_stc_tcpwm_counter_config_t tcpwm_0_group_0_cnt_0_config;
+
+#endif /* CY_PDL_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,201 @@
+/******************************************************************************
+* File Name:   sim.h
+*
+* Description: This file contains the interface between the modules of the
+*              host simulator: the virtual clock, the interrupt controller,
+*              the peripheral models, and the options of the simulation.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The virtual clock counts picoseconds */
+#define SIM_PS_PER_SECOND           (1000000000000ULL)
+#define SIM_PS_PER_NS               (1000ULL)
+
+/* Time of an event that never occurs */
+#define SIM_NEVER                   (UINT64_MAX)
+
+/* Number of SARs and of DMA channels modeled */
+#define SIM_NUM_SARS                (2UL)
+#define SIM_NUM_DMA_CHANNELS        (16UL)
+#define SIM_NUM_COUNTERS            (8UL)
+
+/* Depth of the SAR FIFOs and of the UART FIFOs */
+#define SIM_SAR_FIFO_DEPTH          (64UL)
+#define SIM_UART_FIFO_DEPTH         (128UL)
+
+/* Full scale of the single-ended SAR inputs, referred to VDDA */
+#define SIM_VDDA                    (3.3)
+
+/* Largest number of RX segments given on the command line */
+#define SIM_MAX_RX_SEGMENTS         (64UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Waveform applied to the inputs of one SAR */
+typedef enum
+{
+    SIM_WAVE_DC,        /* level */
+    SIM_WAVE_SINE,      /* frequency, amplitude, offset, phase in degrees */
+    SIM_WAVE_SQUARE,    /* frequency, low level, high level */
+    SIM_WAVE_STEP       /* time in seconds, level before, level after */
+} sim_wave_type_t;
+
+typedef struct
+{
+    sim_wave_type_t type;
+    double param[4];
+} sim_wave_t;
+
+/* Bytes sent to the UART receiver from a given time */
+typedef struct
+{
+    uint64_t start;         /* Virtual time of the first byte */
+    uint8_t *data;
+    uint32_t length;
+} sim_rx_segment_t;
+
+/* Options of the simulation */
+typedef struct
+{
+    uint64_t end;                   /* Virtual time at which the simulation ends */
+    sim_wave_t wave[SIM_NUM_SARS];  /* Inputs of channel 0 of each SAR */
+    double channel_step;            /* Volts added per channel above channel 0 */
+    double noise;                   /* RMS noise of each conversion in counts */
+    uint64_t seed;                  /* Seed of the noise */
+    uint32_t sar_clock_hz;          /* Clock of the SARs from the peripheral divider */
+    uint32_t baud;                  /* Baud rate of the UART */
+    bool rx_flow;                   /* The sender waits while the RX FIFO is full */
+    double cpu_scale;               /* Virtual time per host time spent in the firmware */
+    uint64_t call_ps;               /* Virtual time of each driver call */
+    uint64_t isr_ps;                /* Virtual time of each interrupt entry and exit */
+    sim_rx_segment_t rx[SIM_MAX_RX_SEGMENTS];
+    uint32_t rx_segments;
+    FILE *uart_out;                 /* Bytes sent by the UART */
+    FILE *dac_log;                  /* Every CTDAC code with its time */
+    FILE *sar_log;                  /* Every scan of channel 0 with its trigger time */
+    FILE *report;                   /* JSON summary at the end */
+    uint64_t window_start;          /* Virtual time from which the summary counts */
+    uint64_t window_end;            /* Virtual time at which the summary is written */
+    int32_t expect_dac;             /* Expected last CTDAC code, -1 if not checked */
+    int32_t expect_dac_tolerance;
+} sim_options_t;
+
+/* Counters reported at the end of the simulation */
+typedef struct
+{
+    uint64_t wakeups;               /* Returns from sleep or deep sleep */
+    uint64_t deep_sleeps;
+    uint64_t sleep_ps;              /* Time spent in sleep or deep sleep */
+    uint64_t interrupts;            /* Interrupt handlers run */
+    uint64_t scans[SIM_NUM_SARS];   /* Scans completed by each SAR */
+    uint64_t triggers_lost;         /* Triggers of a SAR that was still busy */
+    uint64_t fifo_overflows;        /* Results dropped by a full SAR FIFO */
+    uint64_t dma_transfers;         /* Elements moved by DMA */
+    uint64_t dma_triggers_lost;     /* Triggers of a disabled DMA channel */
+    uint64_t dac_writes;            /* Codes written to the CTDAC */
+    uint32_t dac_last;              /* Last code written to the CTDAC */
+    uint64_t uart_tx_bytes;
+    uint64_t uart_rx_bytes;         /* Bytes read by the firmware */
+    uint64_t uart_rx_dropped;       /* Bytes lost to a full FIFO or to deep sleep */
+} sim_stats_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+extern sim_options_t sim_options;
+extern sim_stats_t sim_stats;
+
+/* Current virtual time */
+extern uint64_t sim_now;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Virtual clock (sim_core.c) */
+void sim_sync(void);
+void sim_advance(uint64_t duration);
+void sim_run_until(uint64_t time);
+uint64_t sim_clocks_to_ps(uint64_t clocks, uint32_t hz);
+uint64_t sim_ps_to_clocks(uint64_t ps, uint32_t hz);
+void sim_finish(void);
+
+/* Interrupts and sleep (sim_core.c) */
+void sim_sleep(bool deep);
+bool sim_in_interrupt(void);
+
+/* SAR, PASS timer and analog inputs (sim_sar.c) */
+void sim_sar_reset(void);
+uint64_t sim_sar_next_event(void);
+void sim_sar_run(uint64_t time);
+void sim_sar_trigger(cy_en_sar_simult_trig_source_t source);
+void sim_sar_wait_idle(void);
+bool sim_sar_irq_line(uint32_t sar);
+bool sim_sar_bus_read(const volatile void *address, uint32_t *value);
+uint64_t sim_sar_last_read_eos(void);
+
+/* TCPWM counters and clocks (sim_tcpwm.c) */
+uint64_t sim_tcpwm_next_event(void);
+void sim_tcpwm_run(uint64_t time);
+
+/* DMA, trigger multiplexer, CTDAC and CTB (sim_dma.c) */
+void sim_trigger(uint32_t input);
+bool sim_dma_irq_line(uint32_t channel);
+void sim_dac_report(FILE *file);
+void sim_dac_reset(void);
+
+/* UART (sim_uart.c) */
+void sim_uart_init(void);
+void sim_uart_deep_sleep(uint64_t start, uint64_t end);
+void sim_uart_flush(void);
+bool sim_uart_irq_line(void);
+uint64_t sim_uart_next_event(void);
+
+#endif /* SIM_H_ */
+
+/* [] END OF FILE */
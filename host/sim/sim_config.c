@@ -0,0 +1,155 @@
+/******************************************************************************
+* File Name:   sim_config.c
+*
+* Description: This file contains the configuration structures that the device
+*              configurator generates from design.modus, as the host simulator
+*              uses them. It is compiled with each variant of the firmware,
+*              whose channel count sets the enabled channels of the SARs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sim.h"
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Channels scanned by both SARs */
+#define SIM_CHANNEL_MASK            ((1UL << ACQ_NUM_CHANNELS) - 1UL)
+
+/* Acquisition times: 1000 ns for channel 0 and 83 ns for the others, at 18 MHz */
+#define SIM_ACQ_TIME_0              (18U)
+#define SIM_ACQ_TIME_1              (2U)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Channel 0, averaged, on sample time 0 */
+static const cy_stc_sar_channel_config_t sar_channel_0_config = {
+    .addr = 0UL,
+    .differential = false,
+    .sampleTimeSel = CY_SAR_SAMPLE_TIME_0,
+    .avgEn = true,
+    .rangeIntrEn = false,
+    .satIntrEn = false
+};
+
+/* Channels 1 to 15 on sample time 1 */
+static const cy_stc_sar_channel_config_t sar_channel_n_config = {
+    .addr = 0UL,
+    .differential = false,
+    .sampleTimeSel = CY_SAR_SAMPLE_TIME_1,
+    .avgEn = false,
+    .rangeIntrEn = false,
+    .satIntrEn = false
+};
+
+const cy_stc_sar_config_t pass_0_saradc_0_sar_0_config = {
+    .chanEn = SIM_CHANNEL_MASK,
+    .channelConfig = {
+        &sar_channel_0_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config
+    },
+    .avgCnt = CY_SAR_AVG_CNT_4,
+    .avgMode = CY_SAR_AVG_MODE_SEQUENTIAL_FIXED,
+    .acqTime = { SIM_ACQ_TIME_0, SIM_ACQ_TIME_1, SIM_ACQ_TIME_1, SIM_ACQ_TIME_1 },
+    .rangeThresLow = 0UL,
+    .rangeThresHigh = 0UL,
+    .rangeCond = CY_SAR_RANGE_COND_BELOW,
+    .fifoCfgPtr = NULL,
+    .trTimer = false,
+    .eosEn = true,
+    .clock = CY_SAR_CLK_PERI
+};
+
+const cy_stc_sar_config_t pass_0_saradc_0_sar_1_config = {
+    .chanEn = SIM_CHANNEL_MASK,
+    .channelConfig = {
+        &sar_channel_0_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config,
+        &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config, &sar_channel_n_config
+    },
+    .avgCnt = CY_SAR_AVG_CNT_4,
+    .avgMode = CY_SAR_AVG_MODE_SEQUENTIAL_FIXED,
+    .acqTime = { SIM_ACQ_TIME_0, SIM_ACQ_TIME_1, SIM_ACQ_TIME_1, SIM_ACQ_TIME_1 },
+    .rangeThresLow = 0UL,
+    .rangeThresHigh = 0UL,
+    .rangeCond = CY_SAR_RANGE_COND_BELOW,
+    .fifoCfgPtr = NULL,
+    .trTimer = false,
+    .eosEn = true,
+    .clock = CY_SAR_CLK_PERI
+};
+
+/* Both SARs triggered together by the overflow of TCPWM counter 0 */
+const cy_stc_sar_common_config_t pass_0_saradc_0_config = {
+    .simultTrigSource = CY_SAR_SAR0,
+    .simultControl = 0x3UL
+};
+
+const cy_stc_sysanalog_config_t pass_0_aref_0_config = {
+    .startup = 0UL,
+    .iztat = 0UL,
+    .vref = 0UL,
+    .deepSleep = CY_SYSANALOG_DEEPSLEEP_DISABLE
+};
+
+const cy_stc_ctb_opamp_config_t pass_0_ctb_0_oa_0_config = {
+    .power = 1UL,
+    .outputMode = 1UL
+};
+
+const cy_stc_ctdac_config_t pass_0_ctdac_0_config = {
+    .updateMode = CY_CTDAC_UPDATE_DIRECT_WRITE,
+    .deepSleep = CY_CTDAC_DEEPSLEEP_DISABLE,
+    .value = 2048L,
+    .nextValue = 2048L,
+    .enableInterrupt = false
+};
+
+/* SAR trigger, 1 MHz clock, 200000 clocks per trigger */
+const cy_stc_tcpwm_counter_config_t tcpwm_0_group_0_cnt_0_config = {
+    .period = 200000UL,
+    .clockPrescaler = 0UL,
+    .runMode = 0UL,
+    .countDirection = 0UL
+};
+
+/* [] END OF FILE */
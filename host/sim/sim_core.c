@@ -0,0 +1,1118 @@
+/******************************************************************************
+* File Name:   sim_core.c
+*
+* Description: This file contains the virtual clock of the host simulator,
+*              its interrupt controller, the sleep modes of the CPU, and
+*              the entry point that parses the options of the simulation
+*              and runs the firmware.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Default duration of the simulation */
+#define SIM_DEFAULT_SECONDS         (1.0)
+
+/* Default cost of a driver call and of an interrupt entry and exit */
+#define SIM_DEFAULT_CALL_NS         (100UL)
+#define SIM_DEFAULT_ISR_NS          (200UL)
+
+/* Default clock of the SARs from the 8-bit peripheral divider 0 */
+#define SIM_DEFAULT_SAR_CLOCK_HZ    (18000000UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* The main() function of the firmware, renamed by the build */
+int firmware_main(void);
+
+/* Returns the interrupt to serve, -1 if none */
+static int sim_pending_irq(bool ignore_primask);
+
+/* Runs the handlers of the pending interrupts */
+static void sim_dispatch(void);
+
+/* CPU time of the host in nanoseconds */
+static uint64_t sim_host_ns(void);
+
+/* Parsing of the options */
+static void sim_usage(const char *program);
+static bool sim_parse_wave(const char *text, sim_wave_t *wave);
+static bool sim_parse_send(const char *text);
+static bool sim_parse_input(const char *text);
+static bool sim_parse_window(const char *text);
+static FILE *sim_open_output(const char *name);
+static void sim_window_check(void);
+static void sim_report(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+sim_options_t sim_options;
+sim_stats_t sim_stats;
+uint64_t sim_now = 0ULL;
+
+/* Interrupt controller */
+static cy_israddress irq_handler[SIM_IRQ_COUNT];
+static uint32_t irq_priority[SIM_IRQ_COUNT];
+static bool irq_enabled[SIM_IRQ_COUNT];
+
+/* PRIMASK of the CPU and interrupt handler in progress */
+static uint32_t sim_primask = 0UL;
+static bool sim_isr_active = false;
+
+/* Host time of the last synchronization of the virtual clock */
+static uint64_t sim_host_mark = 0ULL;
+
+/* Start of the sleep in progress, or of the window if later */
+static uint64_t sim_sleep_start = 0ULL;
+static bool sim_sleeping = false;
+
+/* Whether the window of the summary has started and has been reported */
+static bool sim_window_started = false;
+static bool sim_window_reported = false;
+
+/* CPU clock reported to the firmware */
+uint32_t SystemCoreClock = 144000000UL;
+
+/*******************************************************************************
+* Function Name: sim_clocks_to_ps
+********************************************************************************
+* Summary:
+* This function returns the time of a number of periods of a clock, rounded
+* up to the next picosecond, so that clock edge n occurs at
+* sim_clocks_to_ps(n, hz) and sim_ps_to_clocks() of that time is n.
+*
+* Parameters:
+*  clocks: Number of clock periods
+*  hz: Frequency of the clock
+*
+* Return:
+*  uint64_t: Duration in picoseconds
+*
+*******************************************************************************/
+uint64_t sim_clocks_to_ps(uint64_t clocks, uint32_t hz)
+{
+    return (uint64_t)((((unsigned __int128)clocks * SIM_PS_PER_SECOND) + hz - 1U) / hz);
+}
+
+/*******************************************************************************
+* Function Name: sim_ps_to_clocks
+********************************************************************************
+* Summary:
+* This function returns the number of clock edges in a duration.
+*
+* Parameters:
+*  ps: Duration in picoseconds
+*  hz: Frequency of the clock
+*
+* Return:
+*  uint64_t: Number of clock periods
+*
+*******************************************************************************/
+uint64_t sim_ps_to_clocks(uint64_t ps, uint32_t hz)
+{
+    return (uint64_t)(((unsigned __int128)ps * hz) / SIM_PS_PER_SECOND);
+}
+
+/*******************************************************************************
+* Function Name: sim_run_until
+********************************************************************************
+* Summary:
+* This function advances the virtual clock to a time, processing the events
+* of the peripherals in time order on the way. An event raises interrupt
+* lines but runs no handler; the handlers run at the next synchronization.
+* The simulation ends when the end time is reached.
+*
+* Parameters:
+*  time: Virtual time to reach
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_run_until(uint64_t time)
+{
+    uint64_t next;
+    uint64_t sar_next;
+
+    for (;;)
+    {
+        next = sim_tcpwm_next_event();
+        sar_next = sim_sar_next_event();
+        if (sar_next < next)
+        {
+            next = sar_next;
+        }
+
+        if ((next > time) || (next >= sim_options.end))
+        {
+            break;
+        }
+
+        if (next > sim_now)
+        {
+            sim_now = next;
+        }
+        sim_window_check();
+        sim_tcpwm_run(sim_now);
+        sim_sar_run(sim_now);
+    }
+
+    if (time >= sim_options.end)
+    {
+        sim_now = sim_options.end;
+        sim_finish();
+    }
+
+    if (time > sim_now)
+    {
+        sim_now = time;
+    }
+    sim_window_check();
+}
+
+/*******************************************************************************
+* Function Name: sim_advance
+********************************************************************************
+* Summary:
+* This function advances the virtual clock by a duration.
+*
+* Parameters:
+*  duration: Duration in picoseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_advance(uint64_t duration)
+{
+    sim_run_until(sim_now + duration);
+}
+
+/*******************************************************************************
+* Function Name: sim_sync
+********************************************************************************
+* Summary:
+* This function is called on every entry into the drivers. It charges the
+* cost of the call and, scaled by the --cpu-scale option, the host CPU time
+* spent in the firmware since the previous call to the virtual clock. Then,
+* outside of interrupt handlers and critical sections, it runs the handlers
+* of the pending interrupts, like the CPU would between two instructions.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sync(void)
+{
+    uint64_t host = sim_host_ns();
+    uint64_t cost = sim_options.call_ps;
+
+    if (sim_options.cpu_scale > 0.0)
+    {
+        cost += (uint64_t)((double)(host - sim_host_mark) * sim_options.cpu_scale * (double)SIM_PS_PER_NS);
+    }
+    sim_host_mark = host;
+
+    sim_advance(cost);
+    sim_dispatch();
+
+    sim_host_mark = sim_host_ns();
+}
+
+/*******************************************************************************
+* Function Name: sim_pending_irq
+********************************************************************************
+* Summary:
+* This function returns the enabled interrupt with the highest priority whose
+* line is asserted. All lines are level sensitive.
+*
+* Parameters:
+*  ignore_primask: true to report an interrupt even in a critical section, as
+*  the wakeup from sleep does
+*
+* Return:
+*  int: Interrupt number, -1 if none is pending
+*
+*******************************************************************************/
+static int sim_pending_irq(bool ignore_primask)
+{
+    int best = -1;
+    int irq;
+    bool line;
+
+    if ((0UL != sim_primask) && !ignore_primask)
+    {
+        return -1;
+    }
+
+    for (irq = 0; irq < (int)SIM_IRQ_COUNT; irq++)
+    {
+        if (!irq_enabled[irq] || (NULL == irq_handler[irq]))
+        {
+            continue;
+        }
+
+        switch (irq)
+        {
+            case pass_interrupt_sar_0_IRQn:
+                line = sim_sar_irq_line(0UL);
+                break;
+
+            case pass_interrupt_sar_1_IRQn:
+                line = sim_sar_irq_line(1UL);
+                break;
+
+            case scb_5_interrupt_IRQn:
+                line = sim_uart_irq_line();
+                break;
+
+            default:
+                line = sim_dma_irq_line((uint32_t)(irq - (int)cpuss_interrupts_dw0_0_IRQn));
+                break;
+        }
+
+        if (line && ((best < 0) || (irq_priority[irq] < irq_priority[best])))
+        {
+            best = irq;
+        }
+    }
+
+    return best;
+}
+
+/*******************************************************************************
+* Function Name: sim_dispatch
+********************************************************************************
+* Summary:
+* This function runs the handlers of the pending interrupts one after the
+* other, unless a handler or a critical section is in progress. All
+* interrupts of the application share one priority, so handlers do not nest.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_dispatch(void)
+{
+    int irq;
+
+    if (sim_isr_active)
+    {
+        return;
+    }
+
+    while ((irq = sim_pending_irq(false)) >= 0)
+    {
+        sim_isr_active = true;
+        sim_stats.interrupts++;
+        sim_advance(sim_options.isr_ps / 2U);
+        irq_handler[irq]();
+        sim_advance(sim_options.isr_ps / 2U);
+        sim_isr_active = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_in_interrupt
+********************************************************************************
+* Summary:
+* This function checks whether an interrupt handler is running.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true in an interrupt handler
+*
+*******************************************************************************/
+bool sim_in_interrupt(void)
+{
+    return sim_isr_active;
+}
+
+/*******************************************************************************
+* Function Name: sim_sleep
+********************************************************************************
+* Summary:
+* This function models WFI: the virtual clock jumps from event to event until
+* an enabled interrupt is pending, then the handlers run. An interrupt that
+* became pending just before, and was served on entry, does not wake up the
+* CPU, as on the target. In deep sleep, the UART receives nothing.
+*
+* Parameters:
+*  deep: true for deep sleep
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sleep(bool deep)
+{
+    uint64_t start;
+    uint64_t next;
+    uint64_t sar_next;
+    uint64_t uart_next;
+
+    sim_sync();
+    start = sim_now;
+    sim_sleep_start = sim_now;
+    sim_sleeping = true;
+
+    while (sim_pending_irq(true) < 0)
+    {
+        next = sim_tcpwm_next_event();
+        sar_next = sim_sar_next_event();
+        if (sar_next < next)
+        {
+            next = sar_next;
+        }
+        uart_next = sim_uart_next_event();
+        if (uart_next < next)
+        {
+            next = uart_next;
+        }
+
+        /* Nothing can wake up the CPU before the end */
+        if ((SIM_NEVER == next) || (next >= sim_options.end))
+        {
+            sim_stats.sleep_ps += sim_options.end - sim_sleep_start;
+            sim_sleep_start = sim_options.end;
+            sim_run_until(sim_options.end);
+        }
+
+        sim_run_until(next);
+    }
+
+    sim_stats.sleep_ps += sim_now - sim_sleep_start;
+    sim_sleeping = false;
+    sim_stats.wakeups++;
+    if (deep)
+    {
+        sim_stats.deep_sleeps++;
+        sim_uart_deep_sleep(start, sim_now);
+    }
+
+    sim_host_mark = sim_host_ns();
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_host_ns
+********************************************************************************
+* Summary:
+* This function returns the CPU time used by the simulator on the host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Time in nanoseconds
+*
+*******************************************************************************/
+static uint64_t sim_host_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: sim_finish
+********************************************************************************
+* Summary:
+* This function ends the simulation at the end time: it sends the bytes left
+* in the UART, writes the JSON summary, checks the last CTDAC code if
+* requested, and exits.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_finish(void)
+{
+    int status = EXIT_SUCCESS;
+
+    sim_uart_flush();
+
+    if (!sim_window_reported)
+    {
+        sim_report();
+    }
+
+    if ((sim_options.expect_dac >= 0) &&
+        (abs((int32_t)sim_stats.dac_last - sim_options.expect_dac) > sim_options.expect_dac_tolerance))
+    {
+        fprintf(stderr, "sim: last CTDAC code %lu, expected %ld +/- %ld\n", (unsigned long)sim_stats.dac_last,
+                (long)sim_options.expect_dac, (long)sim_options.expect_dac_tolerance);
+        status = EXIT_FAILURE;
+    }
+
+    if (NULL != sim_options.dac_log)
+    {
+        fflush(sim_options.dac_log);
+    }
+    if (NULL != sim_options.sar_log)
+    {
+        fflush(sim_options.sar_log);
+    }
+
+    exit(status);
+}
+
+/*******************************************************************************
+* Function Name: sim_report
+********************************************************************************
+* Summary:
+* This function writes the JSON summary of the window: the whole simulation,
+* or the interval of the --window option.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_report(void)
+{
+    uint64_t start = sim_window_started ? sim_options.window_start : 0ULL;
+    uint64_t duration = sim_now - start;
+    double seconds = (double)duration / (double)SIM_PS_PER_SECOND;
+
+    sim_window_reported = true;
+    if (NULL == sim_options.report)
+    {
+        return;
+    }
+
+    fprintf(sim_options.report,
+            "{\"seconds\":%.6f,\"wakeups\":%llu,\"wakeups_per_second\":%.1f,\"deep_sleeps\":%llu,"
+            "\"sleep_ratio\":%.4f,\"interrupts\":%llu,\"scans\":[%llu,%llu],\"triggers_lost\":%llu,"
+            "\"fifo_overflows\":%llu,\"dma_transfers\":%llu,\"dma_triggers_lost\":%llu,",
+            seconds, (unsigned long long)sim_stats.wakeups,
+            (seconds > 0.0) ? ((double)sim_stats.wakeups / seconds) : 0.0,
+            (unsigned long long)sim_stats.deep_sleeps,
+            (0ULL != duration) ? ((double)sim_stats.sleep_ps / (double)duration) : 0.0,
+            (unsigned long long)sim_stats.interrupts,
+            (unsigned long long)sim_stats.scans[0], (unsigned long long)sim_stats.scans[1],
+            (unsigned long long)sim_stats.triggers_lost, (unsigned long long)sim_stats.fifo_overflows,
+            (unsigned long long)sim_stats.dma_transfers, (unsigned long long)sim_stats.dma_triggers_lost);
+    sim_dac_report(sim_options.report);
+    fprintf(sim_options.report, ",\"uart_tx_bytes\":%llu,\"uart_rx_bytes\":%llu,\"uart_rx_dropped\":%llu}\n",
+            (unsigned long long)sim_stats.uart_tx_bytes, (unsigned long long)sim_stats.uart_rx_bytes,
+            (unsigned long long)sim_stats.uart_rx_dropped);
+    fflush(sim_options.report);
+}
+
+/*******************************************************************************
+* Function Name: sim_window_check
+********************************************************************************
+* Summary:
+* This function starts the window of the --window option by clearing the
+* counters, and writes the JSON summary at its end. A sleep in progress is
+* counted from the start of the window and up to its end.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_window_check(void)
+{
+    uint32_t dac_last;
+
+    if ((!sim_window_started) && (0ULL != sim_options.window_start) && (sim_now >= sim_options.window_start))
+    {
+        dac_last = sim_stats.dac_last;
+        (void)memset(&sim_stats, 0, sizeof(sim_stats));
+        sim_stats.dac_last = dac_last;
+        sim_dac_reset();
+        sim_sleep_start = sim_now;
+        sim_window_started = true;
+    }
+
+    if ((!sim_window_reported) && (sim_now >= sim_options.window_end))
+    {
+        if (sim_sleeping)
+        {
+            sim_stats.sleep_ps += sim_now - sim_sleep_start;
+            sim_sleep_start = sim_now;
+        }
+        sim_report();
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_assert_failed
+********************************************************************************
+* Summary:
+* This function stops the simulation on a failed CY_ASSERT().
+*
+* Parameters:
+*  file: Source file of the assertion
+*  line: Line of the assertion
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "sim: assertion failed at %s:%d, t = %.9f s\n", file, line,
+            (double)sim_now / (double)SIM_PS_PER_SECOND);
+    sim_uart_flush();
+    abort();
+}
+
+/*******************************************************************************
+* Interrupt controller and CPU
+********************************************************************************/
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    sim_sync();
+    CY_ASSERT((config->intrSrc >= 0) && (config->intrSrc < SIM_IRQ_COUNT));
+    irq_handler[config->intrSrc] = userIsr;
+    irq_priority[config->intrSrc] = config->intrPriority;
+    return CY_SYSINT_SUCCESS;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    irq_enabled[irq] = true;
+    sim_sync();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    sim_sync();
+    irq_enabled[irq] = false;
+}
+
+void __enable_irq(void)
+{
+    sim_primask = 0UL;
+    sim_sync();
+}
+
+void __disable_irq(void)
+{
+    sim_sync();
+    sim_primask = 1UL;
+}
+
+void __DMB(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    uint32_t state;
+
+    sim_sync();
+    state = sim_primask;
+    sim_primask = 1UL;
+    return state;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    sim_primask = savedIntrStatus;
+    sim_sync();
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(cy_en_syspm_waitfor_t waitFor)
+{
+    (void)waitFor;
+    sim_sleep(false);
+    return CY_SYSPM_SUCCESS;
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(cy_en_syspm_waitfor_t waitFor)
+{
+    (void)waitFor;
+    sim_sleep(true);
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function parses the options of the simulation and runs the firmware
+* until the end time.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Arguments
+*
+* Return:
+*  int: 0 on success, 1 if the last CTDAC code was not the expected one, 2
+*  on an invalid option
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    const char *option;
+    const char *value;
+    int index;
+    uint32_t sar;
+
+    sim_options.end = (uint64_t)(SIM_DEFAULT_SECONDS * (double)SIM_PS_PER_SECOND);
+    sim_options.wave[0].type = SIM_WAVE_DC;
+    sim_options.wave[0].param[0] = 1.0;
+    sim_options.wave[1].type = SIM_WAVE_DC;
+    sim_options.wave[1].param[0] = 1.0;
+    sim_options.channel_step = 0.1;
+    sim_options.seed = 1ULL;
+    sim_options.sar_clock_hz = SIM_DEFAULT_SAR_CLOCK_HZ;
+    sim_options.baud = 115200UL;
+    sim_options.call_ps = SIM_DEFAULT_CALL_NS * SIM_PS_PER_NS;
+    sim_options.isr_ps = SIM_DEFAULT_ISR_NS * SIM_PS_PER_NS;
+    sim_options.uart_out = stdout;
+    sim_options.expect_dac = -1;
+    sim_options.window_end = SIM_NEVER;
+
+    for (index = 1; index < argc; index++)
+    {
+        option = argv[index];
+        if (0 == strcmp(option, "--rx-flow"))
+        {
+            sim_options.rx_flow = true;
+            continue;
+        }
+        if ((0 == strcmp(option, "--help")) || ((index + 1) >= argc))
+        {
+            sim_usage(argv[0]);
+        }
+
+        value = argv[++index];
+        if (0 == strcmp(option, "--seconds"))
+        {
+            sim_options.end = (uint64_t)(strtod(value, NULL) * (double)SIM_PS_PER_SECOND);
+        }
+        else if ((0 == strcmp(option, "--sar0")) || (0 == strcmp(option, "--sar1")))
+        {
+            sar = (0 == strcmp(option, "--sar0")) ? 0UL : 1UL;
+            if (!sim_parse_wave(value, &sim_options.wave[sar]))
+            {
+                sim_usage(argv[0]);
+            }
+        }
+        else if (0 == strcmp(option, "--channel-step"))
+        {
+            sim_options.channel_step = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--noise"))
+        {
+            sim_options.noise = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--seed"))
+        {
+            sim_options.seed = strtoull(value, NULL, 0);
+        }
+        else if (0 == strcmp(option, "--sar-clock"))
+        {
+            sim_options.sar_clock_hz = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (0 == strcmp(option, "--baud"))
+        {
+            sim_options.baud = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (0 == strcmp(option, "--cpu-scale"))
+        {
+            sim_options.cpu_scale = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--call-ns"))
+        {
+            sim_options.call_ps = (uint64_t)(strtod(value, NULL) * (double)SIM_PS_PER_NS);
+        }
+        else if (0 == strcmp(option, "--isr-ns"))
+        {
+            sim_options.isr_ps = (uint64_t)(strtod(value, NULL) * (double)SIM_PS_PER_NS);
+        }
+        else if (0 == strcmp(option, "--send"))
+        {
+            if (!sim_parse_send(value))
+            {
+                sim_usage(argv[0]);
+            }
+        }
+        else if (0 == strcmp(option, "--input"))
+        {
+            if (!sim_parse_input(value))
+            {
+                sim_usage(argv[0]);
+            }
+        }
+        else if (0 == strcmp(option, "--uart-out"))
+        {
+            sim_options.uart_out = sim_open_output(value);
+        }
+        else if (0 == strcmp(option, "--dac-log"))
+        {
+            sim_options.dac_log = sim_open_output(value);
+        }
+        else if (0 == strcmp(option, "--sar-log"))
+        {
+            sim_options.sar_log = sim_open_output(value);
+        }
+        else if (0 == strcmp(option, "--report"))
+        {
+            sim_options.report = (0 == strcmp(value, "-")) ? stderr : sim_open_output(value);
+        }
+        else if (0 == strcmp(option, "--window"))
+        {
+            if (!sim_parse_window(value))
+            {
+                sim_usage(argv[0]);
+            }
+        }
+        else if (0 == strcmp(option, "--expect-dac"))
+        {
+            if (2 != sscanf(value, "%d:%d", &sim_options.expect_dac, &sim_options.expect_dac_tolerance))
+            {
+                sim_options.expect_dac_tolerance = 0;
+                sim_options.expect_dac = (int32_t)strtol(value, NULL, 0);
+            }
+        }
+        else
+        {
+            sim_usage(argv[0]);
+        }
+    }
+
+    sim_sar_reset();
+    sim_uart_init();
+    sim_host_mark = sim_host_ns();
+
+    (void)firmware_main();
+
+    /* The firmware never returns */
+    sim_finish();
+    return EXIT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: sim_usage
+********************************************************************************
+* Summary:
+* This function prints the options of the simulator and exits.
+*
+* Parameters:
+*  program: Name of the program
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --seconds S          virtual time to simulate (1)\n"
+            "  --sar0 WAVE          input of SAR0 channel 0 (dc:1.0)\n"
+            "  --sar1 WAVE          input of SAR1 channel 0 (dc:1.0)\n"
+            "                       dc:V, sine:HZ:AMPLITUDE:OFFSET[:DEGREES],\n"
+            "                       square:HZ:LOW:HIGH, step:SECONDS:BEFORE:AFTER\n"
+            "  --channel-step V     added to the input of each further channel (0.1)\n"
+            "  --noise COUNTS       RMS noise of each conversion (0)\n"
+            "  --seed N             seed of the noise (1)\n"
+            "  --sar-clock HZ       SAR clock from the peripheral divider (18000000)\n"
+            "  --send S:TEXT        send TEXT to the UART at S seconds (\\r \\n \\e \\xHH)\n"
+            "  --input FILE[@S]     send the bytes of FILE to the UART from S seconds\n"
+            "  --rx-flow            the sender waits while the RX FIFO is full\n"
+            "  --baud N             baud rate of the UART (115200)\n"
+            "  --cpu-scale X        virtual ns per host ns spent in the firmware (0)\n"
+            "  --call-ns N          virtual time of each driver call (100)\n"
+            "  --isr-ns N           virtual time of each interrupt entry and exit (200)\n"
+            "  --uart-out FILE      bytes sent by the UART (standard output)\n"
+            "  --dac-log FILE       every CTDAC code as 'ns code'\n"
+            "  --sar-log FILE       every scan as 'trigger_ns sar0 sar1'\n"
+            "  --report FILE|-      JSON summary at the end\n"
+            "  --window S:E         the summary counts from S and is written at E seconds\n"
+            "  --expect-dac CODE[:TOLERANCE]  fail unless the last CTDAC code matches\n",
+            program);
+    exit(2);
+}
+
+/*******************************************************************************
+* Function Name: sim_parse_wave
+********************************************************************************
+* Summary:
+* This function parses the waveform of an input.
+*
+* Parameters:
+*  text: Waveform as given on the command line
+*  wave: Waveform to fill
+*
+* Return:
+*  bool: true if the waveform is valid
+*
+*******************************************************************************/
+static bool sim_parse_wave(const char *text, sim_wave_t *wave)
+{
+    static const struct
+    {
+        const char *name;
+        sim_wave_type_t type;
+        int min_params;
+    } waves[] = {
+        { "dc:",     SIM_WAVE_DC,     1 },
+        { "sine:",   SIM_WAVE_SINE,   3 },
+        { "square:", SIM_WAVE_SQUARE, 3 },
+        { "step:",   SIM_WAVE_STEP,   3 }
+    };
+    size_t index;
+    int count;
+
+    for (index = 0U; index < (sizeof(waves) / sizeof(waves[0])); index++)
+    {
+        if (0 == strncmp(text, waves[index].name, strlen(waves[index].name)))
+        {
+            (void)memset(wave, 0, sizeof(*wave));
+            wave->type = waves[index].type;
+            count = sscanf(text + strlen(waves[index].name), "%lf:%lf:%lf:%lf",
+                           &wave->param[0], &wave->param[1], &wave->param[2], &wave->param[3]);
+            return (count >= waves[index].min_params);
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: sim_parse_send
+********************************************************************************
+* Summary:
+* This function adds the text of a --send option to the bytes received by
+* the UART, with its escape sequences replaced.
+*
+* Parameters:
+*  text: Option value, seconds and text separated by a colon
+*
+* Return:
+*  bool: true if the option is valid
+*
+*******************************************************************************/
+static bool sim_parse_send(const char *text)
+{
+    sim_rx_segment_t *segment = &sim_options.rx[sim_options.rx_segments];
+    const char *colon = strchr(text, ':');
+    const char *source;
+    uint32_t length = 0UL;
+
+    if ((NULL == colon) || (sim_options.rx_segments >= SIM_MAX_RX_SEGMENTS))
+    {
+        return false;
+    }
+
+    segment->start = (uint64_t)(strtod(text, NULL) * (double)SIM_PS_PER_SECOND);
+    segment->data = malloc(strlen(colon));
+    for (source = colon + 1; '\0' != *source; source++)
+    {
+        if (('\\' == source[0]) && ('\0' != source[1]))
+        {
+            source++;
+            switch (*source)
+            {
+                case 'r':
+                    segment->data[length++] = '\r';
+                    break;
+                case 'n':
+                    segment->data[length++] = '\n';
+                    break;
+                case 'e':
+                    segment->data[length++] = 0x1BU;
+                    break;
+                case 'x':
+                    segment->data[length++] = (uint8_t)strtoul(source + 1, NULL, 16);
+                    while (((source[1] >= '0') && (source[1] <= '9')) || ((source[1] | 0x20) >= 'a' && ((source[1] | 0x20) <= 'f')))
+                    {
+                        source++;
+                    }
+                    break;
+                default:
+                    segment->data[length++] = (uint8_t)*source;
+                    break;
+            }
+        }
+        else
+        {
+            segment->data[length++] = (uint8_t)*source;
+        }
+    }
+
+    segment->length = length;
+    sim_options.rx_segments++;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sim_parse_input
+********************************************************************************
+* Summary:
+* This function adds the content of a file to the bytes received by the UART.
+*
+* Parameters:
+*  text: File name, optionally followed by @ and the time in seconds
+*
+* Return:
+*  bool: true if the file was read
+*
+*******************************************************************************/
+static bool sim_parse_input(const char *text)
+{
+    sim_rx_segment_t *segment = &sim_options.rx[sim_options.rx_segments];
+    char name[1024];
+    const char *at = strrchr(text, '@');
+    size_t length = (NULL != at) ? (size_t)(at - text) : strlen(text);
+    FILE *file;
+    long size;
+
+    if ((length >= sizeof(name)) || (sim_options.rx_segments >= SIM_MAX_RX_SEGMENTS))
+    {
+        return false;
+    }
+    (void)memcpy(name, text, length);
+    name[length] = '\0';
+
+    file = fopen(name, "rb");
+    if (NULL == file)
+    {
+        perror(name);
+        return false;
+    }
+    (void)fseek(file, 0L, SEEK_END);
+    size = ftell(file);
+    (void)fseek(file, 0L, SEEK_SET);
+
+    segment->start = (NULL != at) ? (uint64_t)(strtod(at + 1, NULL) * (double)SIM_PS_PER_SECOND) : 0ULL;
+    segment->data = malloc((size > 0L) ? (size_t)size : 1U);
+    segment->length = (uint32_t)fread(segment->data, 1U, (size_t)size, file);
+    (void)fclose(file);
+
+    sim_options.rx_segments++;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sim_parse_window
+********************************************************************************
+* Summary:
+* This function parses the value of the --window option, START:END in
+* seconds, with START before END.
+*
+* Parameters:
+*  text: Value of the option
+*
+* Return:
+*  bool: true if the value is valid
+*
+*******************************************************************************/
+static bool sim_parse_window(const char *text)
+{
+    double start;
+    double end;
+
+    if ((2 != sscanf(text, "%lf:%lf", &start, &end)) || (start < 0.0) || (end <= start))
+    {
+        return false;
+    }
+
+    sim_options.window_start = (uint64_t)(start * (double)SIM_PS_PER_SECOND);
+    sim_options.window_end = (uint64_t)(end * (double)SIM_PS_PER_SECOND);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sim_open_output
+********************************************************************************
+* Summary:
+* This function opens an output file of the simulation, "-" being the
+* standard output.
+*
+* Parameters:
+*  name: File name
+*
+* Return:
+*  FILE *: Open file, the simulator exits if it cannot be created
+*
+*******************************************************************************/
+static FILE *sim_open_output(const char *name)
+{
+    FILE *file;
+
+    if (0 == strcmp(name, "-"))
+    {
+        return stdout;
+    }
+
+    file = fopen(name, "wb");
+    if (NULL == file)
+    {
+        perror(name);
+        exit(2);
+    }
+
+    return file;
+}
+
+/* [] END OF FILE */
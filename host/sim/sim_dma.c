@@ -0,0 +1,638 @@
+/******************************************************************************
+* File Name:   sim_dma.c
+*
+* Description: This file contains the model of the DMA channels and of the
+*              trigger multiplexer of the host simulator, and of the CTDAC
+*              and CTB, with the latency from the End-Of-Scan to the CTDAC.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Largest number of trigger multiplexer connections */
+#define SIM_MAX_CONNECTIONS         (8UL)
+
+/* Initial size of the table of latencies */
+#define SIM_LATENCY_CHUNK           (4096UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+typedef struct
+{
+    bool initialized;
+    bool enabled;
+    cy_stc_dma_descriptor_t *descriptor;    /* Current descriptor */
+    uint32_t x;                             /* Index in the X loop */
+    uint32_t y;                             /* Index in the Y loop */
+    uint32_t intr;
+    uint32_t intr_mask;
+    cy_en_dma_intr_cause_t cause;           /* Cause of the last interrupt */
+} sim_dma_channel_t;
+
+typedef struct
+{
+    uint32_t input;
+    uint32_t output;
+} sim_connection_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void sim_dma_trigger(uint32_t channel);
+static bool sim_dma_element(sim_dma_channel_t *model);
+static uint32_t sim_bus_read(const uint8_t *address, uint32_t width);
+static void sim_bus_write(uint8_t *address, uint32_t value, uint32_t width);
+static void sim_dac_output(uint32_t code);
+static void sim_latency_commit(void);
+static int sim_latency_compare(const void *a, const void *b);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sim_dma_channel_t channels[SIM_NUM_DMA_CHANNELS];
+static bool dma_enabled = false;
+
+static sim_connection_t connections[SIM_MAX_CONNECTIONS];
+static uint32_t connection_count = 0UL;
+
+/* Latencies from the End-Of-Scan of the newest scan read to the last CTDAC
+   write of the CPU that followed it */
+static uint64_t *latencies = NULL;
+static uint32_t latency_count = 0UL;
+static uint32_t latency_size = 0UL;
+static uint64_t latency_eos = 0ULL;
+static uint64_t latency_pending = 0ULL;
+static bool latency_valid = false;
+
+/* Register blocks */
+static DW_Type dw_registers;
+static CTDAC_Type ctdac_registers;
+static CTBM_Type ctbm_registers;
+static PASS_Type pass_registers;
+DW_Type *const DW0 = &dw_registers;
+CTDAC_Type *const CTDAC0 = &ctdac_registers;
+CTBM_Type *const CTBM0 = &ctbm_registers;
+PASS_Type *const PASS = &pass_registers;
+
+/*******************************************************************************
+* Function Name: sim_trigger
+********************************************************************************
+* Summary:
+* This function applies an event to an input of the trigger multiplexer and
+* to the DMA channels connected to it.
+*
+* Parameters:
+*  input: Input of the trigger multiplexer
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_trigger(uint32_t input)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < connection_count; index++)
+    {
+        if (connections[index].input == input)
+        {
+            sim_dma_trigger(connections[index].output - TRIG_OUT_MUX_0_PDMA0_TR_IN0);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_dma_irq_line
+********************************************************************************
+* Summary:
+* This function returns the state of the interrupt line of a DMA channel.
+*
+* Parameters:
+*  channel: DMA channel
+*
+* Return:
+*  bool: true if the unmasked completion interrupt is set
+*
+*******************************************************************************/
+bool sim_dma_irq_line(uint32_t channel)
+{
+    return (0UL != (channels[channel].intr & channels[channel].intr_mask));
+}
+
+/*******************************************************************************
+* Function Name: sim_dma_trigger
+********************************************************************************
+* Summary:
+* This function serves a trigger of a DMA channel: it moves one element, one
+* X loop, one descriptor or a chain of descriptors, as the current descriptor
+* requests. A trigger of a disabled channel is lost.
+*
+* Parameters:
+*  channel: DMA channel
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_dma_trigger(uint32_t channel)
+{
+    sim_dma_channel_t *model = &channels[channel];
+    cy_en_dma_trigger_type_t type;
+    bool descriptor_done;
+
+    if ((channel >= SIM_NUM_DMA_CHANNELS) || !dma_enabled || !model->enabled || (NULL == model->descriptor))
+    {
+        sim_stats.dma_triggers_lost++;
+        return;
+    }
+
+    type = model->descriptor->config.triggerInType;
+    do
+    {
+        descriptor_done = sim_dma_element(model);
+
+        if ((CY_DMA_1ELEMENT == type) ||
+            ((CY_DMA_X_LOOP == type) && (0UL == model->x)) ||
+            ((CY_DMA_DESCR == type) && descriptor_done))
+        {
+            break;
+        }
+    } while (model->enabled && (NULL != model->descriptor));
+}
+
+/*******************************************************************************
+* Function Name: sim_dma_element
+********************************************************************************
+* Summary:
+* This function moves one element of the current descriptor of a channel,
+* raises the interrupt that the descriptor requests, and moves to the next
+* descriptor at the end of the current one.
+*
+* Parameters:
+*  model: DMA channel
+*
+* Return:
+*  bool: true if the element completed the descriptor
+*
+*******************************************************************************/
+static bool sim_dma_element(sim_dma_channel_t *model)
+{
+    const cy_stc_dma_descriptor_config_t *config = &model->descriptor->config;
+    uint32_t element_size = 1UL << (uint32_t)config->dataSize;
+    uint32_t read_width = (CY_DMA_TRANSFER_SIZE_WORD == config->srcTransferSize) ? 4UL : element_size;
+    uint32_t write_width = (CY_DMA_TRANSFER_SIZE_WORD == config->dstTransferSize) ? 4UL : element_size;
+    int32_t source_offset = ((int32_t)model->x * config->srcXincr) + ((int32_t)model->y * config->srcYincr);
+    int32_t destination_offset = ((int32_t)model->x * config->dstXincr) + ((int32_t)model->y * config->dstYincr);
+    uint32_t y_count = (CY_DMA_2D_TRANSFER == config->descriptorType) ? config->yCount : 1UL;
+    bool x_done;
+    bool done;
+    uint32_t value;
+
+    value = sim_bus_read((const uint8_t *)config->srcAddress + (source_offset * (int32_t)element_size), read_width);
+    if (read_width > element_size)
+    {
+        value &= (element_size < 4UL) ? ((1UL << (8UL * element_size)) - 1UL) : 0xFFFFFFFFUL;
+    }
+    sim_bus_write((uint8_t *)config->dstAddress + (destination_offset * (int32_t)element_size), value, write_width);
+    sim_stats.dma_transfers++;
+
+    model->x++;
+    x_done = (model->x >= config->xCount);
+    if (x_done)
+    {
+        model->x = 0UL;
+        model->y++;
+    }
+    done = x_done && (model->y >= y_count);
+
+    if ((CY_DMA_1ELEMENT == config->interruptType) ||
+        ((CY_DMA_X_LOOP == config->interruptType) && x_done) ||
+        (((CY_DMA_DESCR == config->interruptType) || (CY_DMA_DESCR_CHAIN == config->interruptType)) && done))
+    {
+        model->intr |= CY_DMA_INTR_MASK;
+        model->cause = CY_DMA_INTR_CAUSE_COMPLETION;
+    }
+
+    if (done)
+    {
+        model->y = 0UL;
+        if (CY_DMA_CHANNEL_DISABLED == config->channelState)
+        {
+            model->enabled = false;
+        }
+        model->descriptor = config->nextDescriptor;
+    }
+
+    return done;
+}
+
+/*******************************************************************************
+* Function Name: sim_bus_read
+********************************************************************************
+* Summary:
+* This function reads a word or an element for the DMA. The FIFO_RD_DATA
+* registers of the SARs remove a result from their FIFO.
+*
+* Parameters:
+*  address: Address
+*  width: Bytes to read
+*
+* Return:
+*  uint32_t: Value read
+*
+*******************************************************************************/
+static uint32_t sim_bus_read(const uint8_t *address, uint32_t width)
+{
+    uint32_t value = 0UL;
+
+    if (!sim_sar_bus_read(address, &value))
+    {
+        (void)memcpy(&value, address, width);
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: sim_bus_write
+********************************************************************************
+* Summary:
+* This function writes a word or an element for the DMA. The CTDAC_VAL_NXT
+* register of the CTDAC updates its output.
+*
+* Parameters:
+*  address: Address
+*  value: Value to write
+*  width: Bytes to write
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_bus_write(uint8_t *address, uint32_t value, uint32_t width)
+{
+    if (address == (uint8_t *)&CTDAC0->CTDAC_VAL_NXT)
+    {
+        CTDAC0->CTDAC_VAL_NXT = value;
+        sim_dac_output(value);
+        return;
+    }
+
+    (void)memcpy(address, &value, width);
+}
+
+/*******************************************************************************
+* Function Name: sim_dac_output
+********************************************************************************
+* Summary:
+* This function updates the output of the CTDAC.
+*
+* Parameters:
+*  code: 12-bit code
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_dac_output(uint32_t code)
+{
+    code &= 0xFFFUL;
+    CTDAC0->CTDAC_VAL = code;
+    sim_stats.dac_writes++;
+    sim_stats.dac_last = code;
+
+    if (NULL != sim_options.dac_log)
+    {
+        fprintf(sim_options.dac_log, "%llu %lu\n", (unsigned long long)(sim_now / SIM_PS_PER_NS), (unsigned long)code);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_latency_commit
+********************************************************************************
+* Summary:
+* This function stores the latency of the last CTDAC write after a scan.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_latency_commit(void)
+{
+    if (!latency_valid)
+    {
+        return;
+    }
+
+    if (latency_count == latency_size)
+    {
+        latency_size += SIM_LATENCY_CHUNK;
+        latencies = realloc(latencies, latency_size * sizeof(latencies[0]));
+        CY_ASSERT(NULL != latencies);
+    }
+    latencies[latency_count++] = latency_pending;
+    latency_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: sim_latency_compare
+********************************************************************************
+* Summary:
+* This function orders two latencies for qsort().
+*
+* Parameters:
+*  a: First latency
+*  b: Second latency
+*
+* Return:
+*  int: Sign of the difference
+*
+*******************************************************************************/
+static int sim_latency_compare(const void *a, const void *b)
+{
+    uint64_t first = *(const uint64_t *)a;
+    uint64_t second = *(const uint64_t *)b;
+
+    return (first > second) - (first < second);
+}
+
+/*******************************************************************************
+* Function Name: sim_dac_reset
+********************************************************************************
+* Summary:
+* This function clears the CTDAC writes and latencies at the start of the
+* window of the JSON summary. The last code is kept.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_dac_reset(void)
+{
+    latency_count = 0UL;
+    latency_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: sim_dac_report
+********************************************************************************
+* Summary:
+* This function writes the CTDAC part of the JSON summary: the writes, the
+* last code, and the median, 99th percentile and maximum of the latency from
+* the End-Of-Scan of the newest scan read by the CPU or the DMA to the last
+* CTDAC write of the CPU that followed it. CTDAC writes by the DMA have no
+* latency of their own.
+*
+* Parameters:
+*  file: JSON summary
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_dac_report(FILE *file)
+{
+    uint64_t p50 = 0ULL;
+    uint64_t p99 = 0ULL;
+    uint64_t max = 0ULL;
+
+    sim_latency_commit();
+    if (0UL != latency_count)
+    {
+        qsort(latencies, latency_count, sizeof(latencies[0]), sim_latency_compare);
+        p50 = latencies[((latency_count - 1UL) * 50UL) / 100UL];
+        p99 = latencies[((latency_count - 1UL) * 99UL) / 100UL];
+        max = latencies[latency_count - 1UL];
+    }
+
+    fprintf(file, "\"dac_writes\":%llu,\"dac_last\":%lu,"
+            "\"eos_to_dac_ns\":{\"count\":%lu,\"p50\":%llu,\"p99\":%llu,\"max\":%llu}",
+            (unsigned long long)sim_stats.dac_writes, (unsigned long)sim_stats.dac_last,
+            (unsigned long)latency_count, (unsigned long long)(p50 / SIM_PS_PER_NS),
+            (unsigned long long)(p99 / SIM_PS_PER_NS), (unsigned long long)(max / SIM_PS_PER_NS));
+}
+
+/*******************************************************************************
+* DMA driver
+********************************************************************************/
+cy_en_dma_status_t Cy_DMA_Descriptor_Init(cy_stc_dma_descriptor_t *descriptor,
+                                          const cy_stc_dma_descriptor_config_t *config)
+{
+    sim_sync();
+    descriptor->config = *config;
+    return CY_DMA_SUCCESS;
+}
+
+cy_en_dma_status_t Cy_DMA_Channel_Init(DW_Type *base, uint32_t channel,
+                                       const cy_stc_dma_channel_config_t *channelConfig)
+{
+    sim_dma_channel_t *model = &channels[channel];
+
+    (void)base;
+    sim_sync();
+    CY_ASSERT(channel < SIM_NUM_DMA_CHANNELS);
+
+    (void)memset(model, 0, sizeof(*model));
+    model->initialized = true;
+    model->enabled = channelConfig->enable;
+    model->descriptor = channelConfig->descriptor;
+    return CY_DMA_SUCCESS;
+}
+
+void Cy_DMA_Enable(DW_Type *base)
+{
+    (void)base;
+    sim_sync();
+    dma_enabled = true;
+}
+
+void Cy_DMA_Channel_Enable(DW_Type *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    channels[channel].enabled = true;
+}
+
+void Cy_DMA_Channel_Disable(DW_Type *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    channels[channel].enabled = false;
+}
+
+void Cy_DMA_Channel_SetInterruptMask(DW_Type *base, uint32_t channel, uint32_t interrupt)
+{
+    (void)base;
+    channels[channel].intr_mask = interrupt & CY_DMA_INTR_MASK;
+    sim_sync();
+}
+
+uint32_t Cy_DMA_Channel_GetInterruptStatus(DW_Type const *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    return channels[channel].intr;
+}
+
+cy_en_dma_intr_cause_t Cy_DMA_Channel_GetStatus(DW_Type const *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    return channels[channel].cause;
+}
+
+void Cy_DMA_Channel_ClearInterrupt(DW_Type *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    channels[channel].intr = 0UL;
+}
+
+uint32_t Cy_DMA_Channel_GetCurrentXloopIndex(DW_Type const *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    return channels[channel].x;
+}
+
+cy_stc_dma_descriptor_t *Cy_DMA_Channel_GetCurrentDescriptor(DW_Type const *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    return channels[channel].descriptor;
+}
+
+uint32_t Cy_DMA_Channel_GetCurrentYloopIndex(DW_Type const *base, uint32_t channel)
+{
+    (void)base;
+    sim_sync();
+    return channels[channel].y;
+}
+
+cy_en_trigmux_status_t Cy_TrigMux_Connect(uint32_t inTrig, uint32_t outTrig, bool invert, en_trig_type_t trigType)
+{
+    (void)invert;
+    (void)trigType;
+    sim_sync();
+
+    if (connection_count >= SIM_MAX_CONNECTIONS)
+    {
+        return CY_TRIGMUX_BAD_PARAM;
+    }
+    connections[connection_count].input = inTrig;
+    connections[connection_count].output = outTrig;
+    connection_count++;
+    return CY_TRIGMUX_SUCCESS;
+}
+
+/*******************************************************************************
+* CTDAC and CTB drivers
+********************************************************************************/
+cy_en_ctdac_status_t Cy_CTDAC_Init(CTDAC_Type *base, const cy_stc_ctdac_config_t *config)
+{
+    sim_sync();
+    base->CTDAC_VAL = (uint32_t)config->value & 0xFFFUL;
+    base->CTDAC_VAL_NXT = (uint32_t)config->nextValue & 0xFFFUL;
+    sim_stats.dac_last = base->CTDAC_VAL;
+    return CY_CTDAC_SUCCESS;
+}
+
+void Cy_CTDAC_Enable(CTDAC_Type *base)
+{
+    (void)base;
+    sim_sync();
+}
+
+void Cy_CTDAC_SetValue(CTDAC_Type *base, int32_t value)
+{
+    uint64_t eos;
+
+    (void)base;
+    sim_sync();
+
+    /* The last write after each newly read scan closes its latency */
+    eos = sim_sar_last_read_eos();
+    if (0ULL != eos)
+    {
+        if (eos != latency_eos)
+        {
+            sim_latency_commit();
+            latency_eos = eos;
+        }
+        latency_pending = sim_now - eos;
+        latency_valid = true;
+    }
+
+    sim_dac_output((uint32_t)value);
+}
+
+cy_en_ctb_status_t Cy_CTB_OpampInit(CTBM_Type *base, cy_en_ctb_opamp_sel_t opampNum,
+                                    const cy_stc_ctb_opamp_config_t *config)
+{
+    (void)base;
+    (void)opampNum;
+    (void)config;
+    sim_sync();
+    return CY_CTB_SUCCESS;
+}
+
+void Cy_CTB_Enable(CTBM_Type *base)
+{
+    (void)base;
+    sim_sync();
+}
+
+void Cy_CTB_SetDeepSleepMode(CTBM_Type *base, cy_en_ctb_deep_sleep_t deepSleep)
+{
+    (void)base;
+    (void)deepSleep;
+    sim_sync();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,1099 @@
+/******************************************************************************
+* File Name:   sim_sar.c
+*
+* Description: This file contains the model of the two SARs of the
+*              host simulator, with their FIFOs, window comparators and
+*              simultaneous trigger, the model of the PASS timer, and the
+*              analog waveforms applied to their inputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* SAR clocks of a conversion after the acquisition time */
+#define SIM_SAR_CONVERSION_CLOCKS   (14UL)
+
+/* Limits of the single-ended results */
+#define SIM_SAR_MIN_RESULT          (-2048L)
+#define SIM_SAR_MAX_RESULT          (2047L)
+
+/* Clock of the PASS timer from the low-frequency clock */
+#define SIM_LF_CLOCK_HZ             (32768UL)
+
+/* MF clock of the deep sleep clock of the PASS */
+#define SIM_MF_CLOCK_HZ             (2000000UL)
+
+/* Trigger multiplexer inputs of the FIFO trigger outputs */
+#define SIM_SAR_TRIG_OUT(sar)       (TRIG_IN_MUX_0_PASS_TR_SAR_OUT0 + (sar))
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+typedef struct
+{
+    cy_stc_sar_config_t config;
+    cy_stc_sar_channel_config_t channels[CY_SAR_NUM_CHANNELS];
+    cy_stc_sar_fifo_config_t fifo_config;
+    bool fifo_enabled;
+    bool enabled;
+
+    /* Interrupt causes and masks */
+    uint32_t intr;
+    uint32_t intr_mask;
+    uint32_t range_intr;
+    uint32_t range_mask;
+    uint32_t sat_intr;
+    uint32_t sat_mask;
+
+    /* Scan in progress and trigger waiting for its end */
+    bool busy;
+    bool pending;
+    uint64_t scan_start;
+    uint64_t scan_end;
+
+    /* Results of the last scan and the time of its End-Of-Scan */
+    int16_t result[CY_SAR_NUM_CHANNELS];
+    uint64_t result_eos;
+
+    /* FIFO of results with the End-Of-Scan time of each entry */
+    uint16_t fifo_value[SIM_SAR_FIFO_DEPTH];
+    uint8_t fifo_channel[SIM_SAR_FIFO_DEPTH];
+    uint64_t fifo_eos[SIM_SAR_FIFO_DEPTH];
+    uint32_t fifo_head;
+    uint32_t fifo_count;
+} sim_sar_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t sim_sar_index(const SAR_Type *base);
+static uint32_t sim_sar_clock_hz(const sim_sar_t *sar);
+static uint64_t sim_sar_scan_ps(const sim_sar_t *sar);
+static void sim_sar_start(uint32_t index, uint64_t time);
+static void sim_sar_end(uint32_t index);
+static int16_t sim_sar_convert(uint32_t index, uint32_t channel, uint64_t time);
+static bool sim_sar_in_range(const sim_sar_t *sar, int16_t result);
+static void sim_sar_fifo_pop(uint32_t index, cy_stc_sar_fifo_read_t *data);
+static double sim_input(uint32_t index, uint32_t channel, uint64_t time);
+static double sim_gaussian(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sim_sar_t sars[SIM_NUM_SARS];
+
+/* Source of the simultaneous trigger of both SARs */
+static cy_en_sar_simult_trig_source_t trigger_source = CY_SAR_SAR0;
+
+/* PASS timer */
+static cy_stc_sysanalog_timer_config_t pass_timer;
+static bool pass_timer_enabled = false;
+static uint64_t pass_timer_start = 0ULL;
+static uint64_t pass_timer_ticks = 0ULL;
+
+/* Deep sleep clock of the PASS */
+static cy_stc_sysanalog_deep_sleep_config_t pass_deep_sleep = {
+    .clkSel = CY_SYSANALOG_DEEPSLEEP_SRC_MFCLK,
+    .clkDiv = CY_SYSANALOG_DEEPSLEEP_CLK_NO_DIV
+};
+
+/* End-Of-Scan time of the newest scan read from SAR0 by the CPU or the DMA */
+static uint64_t last_read_eos = 0ULL;
+
+/* Start of the newest scan completed by SAR0, logged with --sar-log */
+static uint64_t log_scan_start = 0ULL;
+
+/* State of the noise generator */
+static uint64_t noise_state;
+static bool noise_cached = false;
+static double noise_cache;
+
+/* Register blocks of the SARs, read directly by the firmware and the DMA */
+static SAR_Type sar_registers[SIM_NUM_SARS];
+SAR_Type *const SAR0 = &sar_registers[0];
+SAR_Type *const SAR1 = &sar_registers[1];
+
+/*******************************************************************************
+* Function Name: sim_sar_reset
+********************************************************************************
+* Summary:
+* This function puts both SARs in their reset state and seeds the noise.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sar_reset(void)
+{
+    (void)memset(sars, 0, sizeof(sars));
+    (void)memset(sar_registers, 0, sizeof(sar_registers));
+    noise_state = (0ULL != sim_options.seed) ? sim_options.seed : 1ULL;
+    noise_cached = false;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_next_event
+********************************************************************************
+* Summary:
+* This function returns the time of the next End-Of-Scan or PASS timer tick.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Virtual time, SIM_NEVER if nothing is scheduled
+*
+*******************************************************************************/
+uint64_t sim_sar_next_event(void)
+{
+    uint64_t next = SIM_NEVER;
+    uint32_t index;
+
+    for (index = 0UL; index < SIM_NUM_SARS; index++)
+    {
+        if (sars[index].busy && (sars[index].scan_end < next))
+        {
+            next = sars[index].scan_end;
+        }
+    }
+
+    if (pass_timer_enabled && (0UL != pass_timer.period))
+    {
+        uint64_t tick = pass_timer_start +
+            sim_clocks_to_ps((pass_timer_ticks + 1ULL) * pass_timer.period, SIM_LF_CLOCK_HZ);
+        if (tick < next)
+        {
+            next = tick;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_run
+********************************************************************************
+* Summary:
+* This function processes the End-Of-Scans and PASS timer ticks up to a time.
+* Both SARs end a simultaneous scan at the same time; SAR0 is processed first.
+*
+* Parameters:
+*  time: Virtual time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sar_run(uint64_t time)
+{
+    uint64_t tick;
+    uint32_t index;
+    bool progress = true;
+
+    while (progress)
+    {
+        progress = false;
+
+        for (index = 0UL; index < SIM_NUM_SARS; index++)
+        {
+            if (sars[index].busy && (sars[index].scan_end <= time))
+            {
+                sim_sar_end(index);
+                progress = true;
+            }
+        }
+
+        if (pass_timer_enabled && (0UL != pass_timer.period))
+        {
+            tick = pass_timer_start +
+                sim_clocks_to_ps((pass_timer_ticks + 1ULL) * pass_timer.period, SIM_LF_CLOCK_HZ);
+            if (tick <= time)
+            {
+                pass_timer_ticks++;
+                if (CY_SAR_TIMER == trigger_source)
+                {
+                    sim_sar_trigger(CY_SAR_TIMER);
+                }
+                progress = true;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_trigger
+********************************************************************************
+* Summary:
+* This function applies a simultaneous trigger to both SARs, if they are
+* triggered from this source. A SAR still busy keeps one trigger pending and
+* loses the others.
+*
+* Parameters:
+*  source: CY_SAR_SAR0 for the TCPWM counter 0, CY_SAR_TIMER for the PASS timer
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sar_trigger(cy_en_sar_simult_trig_source_t source)
+{
+    uint32_t index;
+
+    if (source != trigger_source)
+    {
+        return;
+    }
+
+    for (index = 0UL; index < SIM_NUM_SARS; index++)
+    {
+        if (!sars[index].enabled)
+        {
+            continue;
+        }
+
+        if (!sars[index].busy)
+        {
+            sim_sar_start(index, sim_now);
+        }
+        else if (!sars[index].pending)
+        {
+            sars[index].pending = true;
+        }
+        else
+        {
+            sim_stats.triggers_lost++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_wait_idle
+********************************************************************************
+* Summary:
+* This function advances the virtual clock until both SARs completed their
+* scans, including pending ones. It stands for the firmware polling the busy
+* bit of the status registers, which does not call any driver.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_sar_wait_idle(void)
+{
+    uint64_t end;
+    uint32_t index;
+
+    for (;;)
+    {
+        end = 0ULL;
+        for (index = 0UL; index < SIM_NUM_SARS; index++)
+        {
+            if (sars[index].busy && (sars[index].scan_end > end))
+            {
+                end = sars[index].scan_end;
+            }
+        }
+
+        if (0ULL == end)
+        {
+            break;
+        }
+        sim_run_until(end);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_irq_line
+********************************************************************************
+* Summary:
+* This function returns the state of the interrupt line of a SAR.
+*
+* Parameters:
+*  sar: Index of the SAR
+*
+* Return:
+*  bool: true if an unmasked cause is set
+*
+*******************************************************************************/
+bool sim_sar_irq_line(uint32_t sar)
+{
+    const sim_sar_t *model = &sars[sar];
+
+    return (0UL != (model->intr & model->intr_mask)) ||
+           (0UL != (model->range_intr & model->range_mask)) ||
+           (0UL != (model->sat_intr & model->sat_mask));
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_bus_read
+********************************************************************************
+* Summary:
+* This function serves the reads of the DMA from the FIFO_RD_DATA register of
+* a SAR, which remove the oldest result from the FIFO.
+*
+* Parameters:
+*  address: Address read by the DMA
+*  value: Word read
+*
+* Return:
+*  bool: true if the address is a FIFO_RD_DATA register
+*
+*******************************************************************************/
+bool sim_sar_bus_read(const volatile void *address, uint32_t *value)
+{
+    cy_stc_sar_fifo_read_t data;
+    uint32_t index;
+
+    for (index = 0UL; index < SIM_NUM_SARS; index++)
+    {
+        if (address == (const volatile void *)&sar_registers[index].FIFO_RD_DATA)
+        {
+            sim_sar_fifo_pop(index, &data);
+            *value = (uint32_t)data.value | ((uint32_t)data.channel << 16U);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_last_read_eos
+********************************************************************************
+* Summary:
+* This function returns the End-Of-Scan time of the newest scan whose result
+* of SAR0 was read, the start of the latency to the CTDAC.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Virtual time
+*
+*******************************************************************************/
+uint64_t sim_sar_last_read_eos(void)
+{
+    return last_read_eos;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_index
+********************************************************************************
+* Summary:
+* This function returns the index of a SAR from its register block.
+*
+* Parameters:
+*  base: Register block
+*
+* Return:
+*  uint32_t: 0 for SAR0, 1 for SAR1
+*
+*******************************************************************************/
+static uint32_t sim_sar_index(const SAR_Type *base)
+{
+    CY_ASSERT((base == SAR0) || (base == SAR1));
+    return (base == SAR0) ? 0UL : 1UL;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_clock_hz
+********************************************************************************
+* Summary:
+* This function returns the clock of a SAR.
+*
+* Parameters:
+*  sar: SAR model
+*
+* Return:
+*  uint32_t: Frequency in Hz
+*
+*******************************************************************************/
+static uint32_t sim_sar_clock_hz(const sim_sar_t *sar)
+{
+    if (CY_SAR_CLK_DEEPSLEEP == sar->config.clock)
+    {
+        return (uint32_t)(SIM_MF_CLOCK_HZ >> (uint32_t)pass_deep_sleep.clkDiv);
+    }
+
+    return sim_options.sar_clock_hz;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_scan_ps
+********************************************************************************
+* Summary:
+* This function returns the duration of a scan of the enabled channels, each
+* conversion taking its acquisition time and 14 clocks, once per average.
+*
+* Parameters:
+*  sar: SAR model
+*
+* Return:
+*  uint64_t: Duration in picoseconds
+*
+*******************************************************************************/
+static uint64_t sim_sar_scan_ps(const sim_sar_t *sar)
+{
+    uint64_t clocks = 0ULL;
+    uint32_t channel;
+    uint32_t averages;
+
+    for (channel = 0UL; channel < CY_SAR_NUM_CHANNELS; channel++)
+    {
+        if (0UL != (sar->config.chanEn & (1UL << channel)))
+        {
+            averages = sar->channels[channel].avgEn ? (2UL << (uint32_t)sar->config.avgCnt) : 1UL;
+            clocks += (uint64_t)averages *
+                      (sar->config.acqTime[sar->channels[channel].sampleTimeSel] + SIM_SAR_CONVERSION_CLOCKS);
+        }
+    }
+
+    return sim_clocks_to_ps(clocks, sim_sar_clock_hz(sar));
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_start
+********************************************************************************
+* Summary:
+* This function starts a scan and sets the busy bit of the status register.
+*
+* Parameters:
+*  index: Index of the SAR
+*  time: Start of the scan
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_sar_start(uint32_t index, uint64_t time)
+{
+    sim_sar_t *sar = &sars[index];
+
+    sar->busy = true;
+    sar->scan_start = time;
+    sar->scan_end = time + sim_sar_scan_ps(sar);
+    sar_registers[index].STATUS |= SAR_STATUS_BUSY_Msk;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_end
+********************************************************************************
+* Summary:
+* This function completes a scan: it converts every enabled channel, updates
+* the result registers, raises the End-Of-Scan, or its overflow, and the
+* comparator events, pushes the results to the FIFO, and starts the pending
+* scan if any.
+*
+* Parameters:
+*  index: Index of the SAR
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_sar_end(uint32_t index)
+{
+    sim_sar_t *sar = &sars[index];
+    uint32_t clock_hz = sim_sar_clock_hz(sar);
+    uint64_t time = sar->scan_start;
+    uint64_t end = sar->scan_end;
+    uint32_t channel;
+    uint32_t averages;
+    uint32_t average;
+    uint32_t level_before;
+    int32_t sum;
+    int16_t value;
+    bool saturated;
+
+    for (channel = 0UL; channel < CY_SAR_NUM_CHANNELS; channel++)
+    {
+        if (0UL == (sar->config.chanEn & (1UL << channel)))
+        {
+            continue;
+        }
+
+        /* Each conversion samples the input at the end of its acquisition time */
+        averages = sar->channels[channel].avgEn ? (2UL << (uint32_t)sar->config.avgCnt) : 1UL;
+        sum = 0L;
+        saturated = false;
+        for (average = 0UL; average < averages; average++)
+        {
+            time += sim_clocks_to_ps(sar->config.acqTime[sar->channels[channel].sampleTimeSel], clock_hz);
+            value = sim_sar_convert(index, channel, time);
+            saturated = saturated || (SIM_SAR_MIN_RESULT == value) || (SIM_SAR_MAX_RESULT == value);
+            sum += value;
+            time += sim_clocks_to_ps(SIM_SAR_CONVERSION_CLOCKS, clock_hz);
+        }
+
+        /* Fixed-resolution averaging shifts the sum back to 12 bits */
+        sar->result[channel] = (int16_t)(sum >> ((uint32_t)sar->config.avgCnt + 1UL));
+        if (1UL == averages)
+        {
+            sar->result[channel] = (int16_t)sum;
+        }
+        sar_registers[index].CHAN_RESULT[channel] = (uint16_t)sar->result[channel];
+
+        if (sim_sar_in_range(sar, sar->result[channel]))
+        {
+            sar->range_intr |= 1UL << channel;
+        }
+        if (saturated)
+        {
+            sar->sat_intr |= 1UL << channel;
+        }
+
+        if (sar->fifo_enabled)
+        {
+            if (sar->fifo_count >= SIM_SAR_FIFO_DEPTH)
+            {
+                sar->intr |= CY_SAR_INTR_FIFO_OVERFLOW;
+                sim_stats.fifo_overflows++;
+            }
+            else
+            {
+                uint32_t slot = (sar->fifo_head + sar->fifo_count) % SIM_SAR_FIFO_DEPTH;
+
+                sar->fifo_value[slot] = (uint16_t)sar->result[channel];
+                sar->fifo_channel[slot] = (uint8_t)channel;
+                sar->fifo_eos[slot] = end;
+                level_before = sar->fifo_count;
+                sar->fifo_count++;
+
+                if ((level_before < sar->fifo_config.level) && (sar->fifo_count >= sar->fifo_config.level))
+                {
+                    sar->intr |= CY_SAR_INTR_FIFO_LEVEL;
+                }
+            }
+        }
+    }
+
+    if (0UL != (sar->intr & CY_SAR_INTR_EOS))
+    {
+        sar->intr |= CY_SAR_INTR_OVERFLOW;
+    }
+    if (sar->config.eosEn)
+    {
+        sar->intr |= CY_SAR_INTR_EOS;
+    }
+    sar->result_eos = end;
+    sim_stats.scans[index]++;
+
+    /* A scan is logged once both SARs have completed it, in either order */
+    if (0UL == index)
+    {
+        log_scan_start = sar->scan_start;
+    }
+    if ((NULL != sim_options.sar_log) && (sim_stats.scans[0] == sim_stats.scans[1]))
+    {
+        fprintf(sim_options.sar_log, "%llu %d %d\n",
+                (unsigned long long)(log_scan_start / SIM_PS_PER_NS), sars[0].result[0], sars[1].result[0]);
+    }
+
+    sar->busy = false;
+    sar_registers[index].STATUS &= ~SAR_STATUS_BUSY_Msk;
+
+    /* Each result at or above the level requests one DMA transfer */
+    if (sar->fifo_enabled && sar->fifo_config.trOut)
+    {
+        uint32_t requests = sar->fifo_count;
+
+        while ((requests-- > 0UL) && (sar->fifo_count >= sar->fifo_config.level))
+        {
+            sim_trigger(SIM_SAR_TRIG_OUT(index));
+        }
+    }
+
+    if (sar->pending)
+    {
+        sar->pending = false;
+        sim_sar_start(index, end);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_convert
+********************************************************************************
+* Summary:
+* This function converts the input of a channel to single-ended counts, with
+* the noise of the conversion.
+*
+* Parameters:
+*  index: Index of the SAR
+*  channel: Channel
+*  time: Sampling time
+*
+* Return:
+*  int16_t: Result, clamped to the 12-bit range
+*
+*******************************************************************************/
+static int16_t sim_sar_convert(uint32_t index, uint32_t channel, uint64_t time)
+{
+    double counts = (sim_input(index, channel, time) / SIM_VDDA) * 2048.0;
+
+    if (sim_options.noise > 0.0)
+    {
+        counts += sim_options.noise * sim_gaussian();
+    }
+
+    counts = floor(counts + 0.5);
+    if (counts < (double)SIM_SAR_MIN_RESULT)
+    {
+        counts = (double)SIM_SAR_MIN_RESULT;
+    }
+    if (counts > (double)SIM_SAR_MAX_RESULT)
+    {
+        counts = (double)SIM_SAR_MAX_RESULT;
+    }
+
+    return (int16_t)counts;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_in_range
+********************************************************************************
+* Summary:
+* This function applies the condition of the window comparator to a result.
+*
+* Parameters:
+*  sar: SAR model
+*  result: Signed result
+*
+* Return:
+*  bool: true if the condition is met
+*
+*******************************************************************************/
+static bool sim_sar_in_range(const sim_sar_t *sar, int16_t result)
+{
+    int32_t low = (int16_t)(uint16_t)sar->config.rangeThresLow;
+    int32_t high = (int16_t)(uint16_t)sar->config.rangeThresHigh;
+
+    switch (sar->config.rangeCond)
+    {
+        case CY_SAR_RANGE_COND_BELOW:
+            return (result < low);
+        case CY_SAR_RANGE_COND_INSIDE:
+            return (result >= low) && (result < high);
+        case CY_SAR_RANGE_COND_ABOVE:
+            return (result >= high);
+        default:
+            return (result < low) || (result >= high);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_fifo_pop
+********************************************************************************
+* Summary:
+* This function removes the oldest result from the FIFO of a SAR, for the
+* CPU or for the DMA. Reading an empty FIFO raises the underflow interrupt.
+*
+* Parameters:
+*  index: Index of the SAR
+*  data: Result and channel read
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_sar_fifo_pop(uint32_t index, cy_stc_sar_fifo_read_t *data)
+{
+    sim_sar_t *sar = &sars[index];
+
+    if (0UL == sar->fifo_count)
+    {
+        sar->intr |= CY_SAR_INTR_FIFO_UNDERFLOW;
+        data->value = 0U;
+        data->channel = 0U;
+        return;
+    }
+
+    data->value = sar->fifo_value[sar->fifo_head];
+    data->channel = sar->fifo_channel[sar->fifo_head];
+    if ((0UL == index) && (sar->fifo_eos[sar->fifo_head] > last_read_eos))
+    {
+        last_read_eos = sar->fifo_eos[sar->fifo_head];
+    }
+    sar->fifo_head = (sar->fifo_head + 1UL) % SIM_SAR_FIFO_DEPTH;
+    sar->fifo_count--;
+}
+
+/*******************************************************************************
+* Function Name: sim_input
+********************************************************************************
+* Summary:
+* This function returns the voltage at an input of a SAR. Channel 0 carries
+* the waveform of the SAR; each further channel adds the channel step.
+*
+* Parameters:
+*  index: Index of the SAR
+*  channel: Channel
+*  time: Virtual time
+*
+* Return:
+*  double: Voltage
+*
+*******************************************************************************/
+static double sim_input(uint32_t index, uint32_t channel, uint64_t time)
+{
+    const sim_wave_t *wave = &sim_options.wave[index];
+    double t = (double)time / (double)SIM_PS_PER_SECOND;
+    double volts;
+    double cycles;
+
+    switch (wave->type)
+    {
+        case SIM_WAVE_SINE:
+            volts = wave->param[2] +
+                    (wave->param[1] * sin((2.0 * M_PI * wave->param[0] * t) + (wave->param[3] * M_PI / 180.0)));
+            break;
+
+        case SIM_WAVE_SQUARE:
+            cycles = wave->param[0] * t;
+            volts = ((cycles - floor(cycles)) < 0.5) ? wave->param[1] : wave->param[2];
+            break;
+
+        case SIM_WAVE_STEP:
+            volts = (t < wave->param[0]) ? wave->param[1] : wave->param[2];
+            break;
+
+        default:
+            volts = wave->param[0];
+            break;
+    }
+
+    return volts + ((double)channel * sim_options.channel_step);
+}
+
+/*******************************************************************************
+* Function Name: sim_gaussian
+********************************************************************************
+* Summary:
+* This function returns normally distributed noise of unit variance from a
+* xorshift64* generator, so that a seed always gives the same run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  double: Noise sample
+*
+*******************************************************************************/
+static double sim_gaussian(void)
+{
+    double u1;
+    double u2;
+    double radius;
+
+    if (noise_cached)
+    {
+        noise_cached = false;
+        return noise_cache;
+    }
+
+    do
+    {
+        noise_state ^= noise_state >> 12U;
+        noise_state ^= noise_state << 25U;
+        noise_state ^= noise_state >> 27U;
+        u1 = (double)((noise_state * 2685821657736338717ULL) >> 11U) / 9007199254740992.0;
+        noise_state ^= noise_state >> 12U;
+        noise_state ^= noise_state << 25U;
+        noise_state ^= noise_state >> 27U;
+        u2 = (double)((noise_state * 2685821657736338717ULL) >> 11U) / 9007199254740992.0;
+    } while (u1 <= 0.0);
+
+    radius = sqrt(-2.0 * log(u1));
+    noise_cache = radius * sin(2.0 * M_PI * u2);
+    noise_cached = true;
+
+    return radius * cos(2.0 * M_PI * u2);
+}
+
+/*******************************************************************************
+* SAR driver
+********************************************************************************/
+cy_en_sar_status_t Cy_SAR_CommonInit(PASS_Type *base, const cy_stc_sar_common_config_t *trigConfig)
+{
+    (void)base;
+    sim_sync();
+    trigger_source = trigConfig->simultTrigSource;
+    return CY_SAR_SUCCESS;
+}
+
+cy_en_sar_status_t Cy_SAR_Init(SAR_Type *base, const cy_stc_sar_config_t *config)
+{
+    sim_sar_t *sar = &sars[sim_sar_index(base)];
+    uint32_t channel;
+
+    sim_sync();
+    CY_ASSERT(!sar->busy);
+
+    sar->config = *config;
+    for (channel = 0UL; channel < CY_SAR_NUM_CHANNELS; channel++)
+    {
+        if (NULL != config->channelConfig[channel])
+        {
+            sar->channels[channel] = *config->channelConfig[channel];
+        }
+        else
+        {
+            (void)memset(&sar->channels[channel], 0, sizeof(sar->channels[channel]));
+        }
+        sar->config.channelConfig[channel] = &sar->channels[channel];
+    }
+
+    sar->fifo_enabled = (NULL != config->fifoCfgPtr);
+    if (sar->fifo_enabled)
+    {
+        sar->fifo_config = *config->fifoCfgPtr;
+        sar->config.fifoCfgPtr = &sar->fifo_config;
+    }
+
+    sar->intr = 0UL;
+    sar->intr_mask = 0UL;
+    sar->range_intr = 0UL;
+    sar->range_mask = 0UL;
+    sar->sat_intr = 0UL;
+    sar->sat_mask = 0UL;
+    for (channel = 0UL; channel < CY_SAR_NUM_CHANNELS; channel++)
+    {
+        sar->range_mask |= sar->channels[channel].rangeIntrEn ? (1UL << channel) : 0UL;
+        sar->sat_mask |= sar->channels[channel].satIntrEn ? (1UL << channel) : 0UL;
+    }
+    sar->pending = false;
+    sar->fifo_head = 0UL;
+    sar->fifo_count = 0UL;
+
+    return CY_SAR_SUCCESS;
+}
+
+void Cy_SAR_Enable(SAR_Type *base)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].enabled = true;
+}
+
+void Cy_SAR_Disable(SAR_Type *base)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].enabled = false;
+    sars[sim_sar_index(base)].pending = false;
+}
+
+void Cy_SAR_SetInterruptMask(SAR_Type *base, uint32_t intrMask)
+{
+    sars[sim_sar_index(base)].intr_mask = intrMask & CY_SAR_INTR;
+    sim_sync();
+}
+
+uint32_t Cy_SAR_GetInterruptStatus(const SAR_Type *base)
+{
+    sim_sync();
+    return sars[sim_sar_index(base)].intr;
+}
+
+void Cy_SAR_ClearInterrupt(SAR_Type *base, uint32_t intrMask)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].intr &= ~intrMask;
+}
+
+int16_t Cy_SAR_GetResult16(const SAR_Type *base, uint32_t chan)
+{
+    uint32_t index = sim_sar_index(base);
+
+    sim_sync();
+    if ((0UL == index) && (sars[0].result_eos > last_read_eos))
+    {
+        last_read_eos = sars[0].result_eos;
+    }
+    return sars[index].result[chan];
+}
+
+float32_t Cy_SAR_CountsTo_Volts(const SAR_Type *base, uint32_t chan, int16_t adcCounts)
+{
+    (void)base;
+    (void)chan;
+    return ((float32_t)adcCounts * 3.3f) / 2048.0f;
+}
+
+int32_t Cy_SAR_CountsTo_uVolts(const SAR_Type *base, uint32_t chan, int16_t adcCounts)
+{
+    (void)base;
+    (void)chan;
+    return (int32_t)(((int64_t)adcCounts * 3300000LL) / 2048LL);
+}
+
+uint32_t Cy_SAR_FifoGetDataCount(const SAR_Type *base)
+{
+    sim_sync();
+    return sars[sim_sar_index(base)].fifo_count;
+}
+
+void Cy_SAR_FifoRead(const SAR_Type *base, cy_stc_sar_fifo_read_t *readData)
+{
+    sim_sync();
+    sim_sar_fifo_pop(sim_sar_index(base), readData);
+}
+
+void Cy_SAR_SetLowLimit(SAR_Type *base, uint32_t lowLimit)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].config.rangeThresLow = lowLimit;
+}
+
+void Cy_SAR_SetHighLimit(SAR_Type *base, uint32_t highLimit)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].config.rangeThresHigh = highLimit;
+}
+
+void Cy_SAR_SetRangeCond(SAR_Type *base, cy_en_sar_range_detect_condition_t cond)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].config.rangeCond = cond;
+}
+
+void Cy_SAR_SetRangeInterruptMask(SAR_Type *base, uint32_t chanMask)
+{
+    sars[sim_sar_index(base)].range_mask = chanMask;
+    sim_sync();
+}
+
+uint32_t Cy_SAR_GetRangeInterruptStatusMasked(const SAR_Type *base)
+{
+    const sim_sar_t *sar = &sars[sim_sar_index(base)];
+
+    sim_sync();
+    return sar->range_intr & sar->range_mask;
+}
+
+void Cy_SAR_ClearRangeInterrupt(SAR_Type *base, uint32_t chanMask)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].range_intr &= ~chanMask;
+}
+
+void Cy_SAR_SetSatInterruptMask(SAR_Type *base, uint32_t chanMask)
+{
+    sars[sim_sar_index(base)].sat_mask = chanMask;
+    sim_sync();
+}
+
+uint32_t Cy_SAR_GetSatInterruptStatusMasked(const SAR_Type *base)
+{
+    const sim_sar_t *sar = &sars[sim_sar_index(base)];
+
+    sim_sync();
+    return sar->sat_intr & sar->sat_mask;
+}
+
+void Cy_SAR_ClearSatInterrupt(SAR_Type *base, uint32_t chanMask)
+{
+    sim_sync();
+    sars[sim_sar_index(base)].sat_intr &= ~chanMask;
+}
+
+/*******************************************************************************
+* PASS timer and analog reference
+********************************************************************************/
+cy_en_sysanalog_status_t Cy_SysAnalog_Init(const cy_stc_sysanalog_config_t *config)
+{
+    (void)config;
+    sim_sync();
+    return CY_SYSANALOG_SUCCESS;
+}
+
+void Cy_SysAnalog_Enable(void)
+{
+    sim_sync();
+}
+
+cy_en_sysanalog_status_t Cy_SysAnalog_DeepSleepInit(PASS_Type *base, const cy_stc_sysanalog_deep_sleep_config_t *config)
+{
+    (void)base;
+    sim_sync();
+    pass_deep_sleep = *config;
+    return CY_SYSANALOG_SUCCESS;
+}
+
+cy_en_sysanalog_status_t Cy_SysAnalog_TimerInit(PASS_Type *base, const cy_stc_sysanalog_timer_config_t *config)
+{
+    (void)base;
+    sim_sync();
+    CY_ASSERT(CY_SYSANALOG_TIMER_CLK_LF == config->clockSel);
+    pass_timer = *config;
+    return CY_SYSANALOG_SUCCESS;
+}
+
+void Cy_SysAnalog_TimerEnable(PASS_Type *base)
+{
+    (void)base;
+    sim_sync();
+    pass_timer_enabled = true;
+    pass_timer_start = sim_now;
+    pass_timer_ticks = 0ULL;
+}
+
+void Cy_SysAnalog_TimerDisable(PASS_Type *base)
+{
+    (void)base;
+    sim_sync();
+    pass_timer_enabled = false;
+    sim_sar_wait_idle();
+}
+
+void Cy_SysAnalog_TimerSetPeriod(PASS_Type *base, uint32_t periodVal)
+{
+    (void)base;
+    sim_sync();
+    pass_timer.period = periodVal;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,359 @@
+/******************************************************************************
+* File Name:   sim_tcpwm.c
+*
+* Description: This file contains the model of the TCPWM counters of the
+*              host simulator and of the peripheral clocks that drive the
+*              counters and the SARs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Clocks of the 8-bit peripheral dividers used by the design */
+#define SIM_DIVIDER_1_HZ            (24000000UL)
+#define SIM_DIVIDER_2_HZ            (1000000UL)
+
+/* Clock of the TCPWM counters, from the 8-bit divider 2 */
+#define SIM_COUNTER_HZ              (SIM_DIVIDER_2_HZ)
+
+/* Trigger multiplexer input of the overflow of the first counter */
+#define SIM_TCPWM_OVERFLOW0         (TRIG_IN_MUX_0_TCPWM0_TR_OVERFLOW1 - 1UL)
+
+/* Counter whose overflow is the simultaneous trigger of the SARs */
+#define SIM_SAR_TRIGGER_COUNTER     (0UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+typedef struct
+{
+    bool enabled;
+    bool running;
+    uint64_t period;        /* Terminal count */
+    uint64_t count;         /* Count when stopped, or when started at start */
+    uint64_t start;         /* Virtual time at which count was loaded */
+    uint64_t overflows;     /* Overflows since start */
+} sim_counter_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint64_t sim_counter_overflow_time(const sim_counter_t *counter);
+static uint32_t sim_counter_value(const sim_counter_t *counter);
+static void sim_counter_anchor(sim_counter_t *counter, uint64_t count);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sim_counter_t counters[SIM_NUM_COUNTERS];
+
+/* Register block of the TCPWM */
+static TCPWM_Type tcpwm_registers;
+TCPWM_Type *const TCPWM0 = &tcpwm_registers;
+
+/*******************************************************************************
+* Function Name: sim_tcpwm_next_event
+********************************************************************************
+* Summary:
+* This function returns the time of the next overflow of a running counter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Virtual time, SIM_NEVER if no counter runs
+*
+*******************************************************************************/
+uint64_t sim_tcpwm_next_event(void)
+{
+    uint64_t next = SIM_NEVER;
+    uint64_t time;
+    uint32_t index;
+
+    for (index = 0UL; index < SIM_NUM_COUNTERS; index++)
+    {
+        if (counters[index].running)
+        {
+            time = sim_counter_overflow_time(&counters[index]);
+            if (time < next)
+            {
+                next = time;
+            }
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: sim_tcpwm_run
+********************************************************************************
+* Summary:
+* This function processes the counter overflows up to a time. The overflow
+* of counter 0 triggers both SARs; the overflow of every counter also drives
+* its input of the trigger multiplexer.
+*
+* Parameters:
+*  time: Virtual time
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_tcpwm_run(uint64_t time)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < SIM_NUM_COUNTERS; index++)
+    {
+        while (counters[index].running && (sim_counter_overflow_time(&counters[index]) <= time))
+        {
+            counters[index].overflows++;
+
+            if (SIM_SAR_TRIGGER_COUNTER == index)
+            {
+                sim_sar_trigger(CY_SAR_SAR0);
+            }
+            sim_trigger(SIM_TCPWM_OVERFLOW0 + index);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_counter_overflow_time
+********************************************************************************
+* Summary:
+* This function returns the time of the next overflow of a running counter.
+* The counter counts from 0 to its period, so the overflows are period + 1
+* clocks apart.
+*
+* Parameters:
+*  counter: Counter model
+*
+* Return:
+*  uint64_t: Virtual time
+*
+*******************************************************************************/
+static uint64_t sim_counter_overflow_time(const sim_counter_t *counter)
+{
+    uint64_t clocks = ((counter->overflows + 1ULL) * (counter->period + 1ULL)) - counter->count;
+
+    return counter->start + sim_clocks_to_ps(clocks, SIM_COUNTER_HZ);
+}
+
+/*******************************************************************************
+* Function Name: sim_counter_value
+********************************************************************************
+* Summary:
+* This function returns the count of a counter at the current time.
+*
+* Parameters:
+*  counter: Counter model
+*
+* Return:
+*  uint32_t: Count
+*
+*******************************************************************************/
+static uint32_t sim_counter_value(const sim_counter_t *counter)
+{
+    uint64_t clocks;
+
+    if (!counter->running)
+    {
+        return (uint32_t)counter->count;
+    }
+
+    clocks = sim_ps_to_clocks(sim_now - counter->start, SIM_COUNTER_HZ);
+    return (uint32_t)((counter->count + clocks) % (counter->period + 1ULL));
+}
+
+/*******************************************************************************
+* Function Name: sim_counter_anchor
+********************************************************************************
+* Summary:
+* This function loads a count at the current time.
+*
+* Parameters:
+*  counter: Counter model
+*  count: Count
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_counter_anchor(sim_counter_t *counter, uint64_t count)
+{
+    counter->count = count % (counter->period + 1ULL);
+    counter->start = sim_now;
+    counter->overflows = 0ULL;
+}
+
+/*******************************************************************************
+* TCPWM driver
+********************************************************************************/
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum,
+                                           const cy_stc_tcpwm_counter_config_t *config)
+{
+    (void)base;
+    sim_sync();
+    CY_ASSERT(cntNum < SIM_NUM_COUNTERS);
+
+    (void)memset(&counters[cntNum], 0, sizeof(counters[cntNum]));
+    counters[cntNum].period = config->period;
+    return CY_TCPWM_SUCCESS;
+}
+
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum)
+{
+    (void)base;
+    sim_sync();
+    counters[cntNum].enabled = true;
+}
+
+void Cy_TCPWM_TriggerStart_Single(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_counter_t *counter = &counters[cntNum];
+
+    (void)base;
+    sim_sync();
+    if (counter->enabled && !counter->running)
+    {
+        sim_counter_anchor(counter, counter->count);
+        counter->running = true;
+    }
+}
+
+void Cy_TCPWM_TriggerStopOrKill_Single(TCPWM_Type *base, uint32_t cntNum)
+{
+    sim_counter_t *counter = &counters[cntNum];
+
+    (void)base;
+    sim_sync();
+    counter->count = sim_counter_value(counter);
+    counter->running = false;
+
+    /* The firmware polls the busy bits of the SARs after stopping their
+       trigger, without calling any driver */
+    if (SIM_SAR_TRIGGER_COUNTER == cntNum)
+    {
+        sim_sar_wait_idle();
+    }
+}
+
+uint32_t Cy_TCPWM_Counter_GetCounter(TCPWM_Type const *base, uint32_t cntNum)
+{
+    (void)base;
+    sim_sync();
+    return sim_counter_value(&counters[cntNum]);
+}
+
+void Cy_TCPWM_Counter_SetCounter(TCPWM_Type *base, uint32_t cntNum, uint32_t count)
+{
+    (void)base;
+    sim_sync();
+    sim_counter_anchor(&counters[cntNum], count);
+}
+
+void Cy_TCPWM_Counter_SetPeriod(TCPWM_Type *base, uint32_t cntNum, uint32_t period)
+{
+    sim_counter_t *counter = &counters[cntNum];
+    uint32_t value;
+
+    (void)base;
+    sim_sync();
+    value = sim_counter_value(counter);
+    counter->period = period;
+    sim_counter_anchor(counter, value);
+}
+
+/*******************************************************************************
+* Clocks
+********************************************************************************/
+cy_en_sysclk_status_t Cy_SysClk_PeriphAssignDivider(uint32_t ipBlock, cy_en_divider_types_t dividerType,
+                                                    uint32_t dividerNum)
+{
+    (void)ipBlock;
+    sim_sync();
+
+    /* The counters are modeled on the 1 MHz clock of divider 2 only */
+    CY_ASSERT((CY_SYSCLK_DIV_8_BIT == dividerType) && (2UL == dividerNum));
+    return CY_SYSCLK_SUCCESS;
+}
+
+uint32_t Cy_SysClk_PeriphGetFrequency(cy_en_divider_types_t dividerType, uint32_t dividerNum)
+{
+    sim_sync();
+    if (CY_SYSCLK_DIV_8_BIT != dividerType)
+    {
+        return 0UL;
+    }
+
+    switch (dividerNum)
+    {
+        case 0UL:
+            return sim_options.sar_clock_hz;
+        case 1UL:
+            return SIM_DIVIDER_1_HZ;
+        case 2UL:
+            return SIM_DIVIDER_2_HZ;
+        default:
+            return 0UL;
+    }
+}
+
+void Cy_SysClk_MfoEnable(bool deepSleepEnable)
+{
+    (void)deepSleepEnable;
+    sim_sync();
+}
+
+void Cy_SysClk_ClkMfEnable(void)
+{
+    sim_sync();
+}
+
+uint32_t Cy_SysClk_ClkMfGetFrequency(void)
+{
+    sim_sync();
+    return 2000000UL;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,492 @@
+/******************************************************************************
+* File Name:   sim_uart.c
+*
+* Description: This file contains the model of the debug UART of the host
+*              simulator: the HAL UART and retarget-io functions used by
+*              the firmware, paced at the baud rate, with FIFOs of 128 bytes.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sim.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Bits of a byte on the line: start, 8 data bits and stop */
+#define SIM_UART_BITS_PER_BYTE      (10ULL)
+
+/* Result of cyhal_uart_getc() without a byte */
+#define SIM_UART_RX_TIMEOUT         (1UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void sim_uart_rx_update(uint64_t limit, bool drop);
+static uint64_t sim_uart_rx_next(void);
+static uint32_t sim_uart_events(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+/* Time of a byte on the line */
+static uint64_t byte_ps = 0ULL;
+
+/* End of the transmission of the last byte written */
+static uint64_t tx_busy_until = 0ULL;
+
+/* RX FIFO */
+static uint8_t rx_fifo[SIM_UART_FIFO_DEPTH];
+static uint32_t rx_head = 0UL;
+static uint32_t rx_count = 0UL;
+
+/* Next byte to receive and arrival time of the previous one */
+static uint32_t rx_segment = 0UL;
+static uint32_t rx_position = 0UL;
+static uint64_t rx_previous = 0ULL;
+static bool rx_started = false;
+
+/* Event callback of the application and enabled events */
+static cyhal_uart_event_callback_t event_callback = NULL;
+static void *event_callback_arg = NULL;
+static uint32_t event_enabled = 0UL;
+
+/*******************************************************************************
+* Function Name: sim_uart_init
+********************************************************************************
+* Summary:
+* This function sets the time of a byte from the baud rate.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_uart_init(void)
+{
+    byte_ps = (SIM_UART_BITS_PER_BYTE * SIM_PS_PER_SECOND) / sim_options.baud;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_rx_update
+********************************************************************************
+* Summary:
+* This function receives the bytes that arrived up to a time. Bytes follow
+* each other at the baud rate from the start of their segment. A byte that
+* finds the FIFO full is lost, unless --rx-flow is given: then the sender
+* holds it, and the bytes after it, until the firmware reads the FIFO.
+*
+* Parameters:
+*  limit: Virtual time
+*  drop: true to lose the bytes, the UART being off in deep sleep
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_uart_rx_update(uint64_t limit, bool drop)
+{
+    const sim_rx_segment_t *segment;
+    uint64_t arrival;
+
+    while (rx_segment < sim_options.rx_segments)
+    {
+        segment = &sim_options.rx[rx_segment];
+        if (rx_position >= segment->length)
+        {
+            rx_segment++;
+            rx_position = 0UL;
+            continue;
+        }
+
+        arrival = segment->start + ((uint64_t)(rx_position + 1UL) * byte_ps);
+        if (rx_started && (arrival < (rx_previous + byte_ps)))
+        {
+            arrival = rx_previous + byte_ps;
+        }
+        if (arrival > limit)
+        {
+            break;
+        }
+
+        if (!drop && (rx_count >= SIM_UART_FIFO_DEPTH))
+        {
+            if (sim_options.rx_flow)
+            {
+                break;
+            }
+            sim_stats.uart_rx_dropped++;
+        }
+        else if (drop)
+        {
+            sim_stats.uart_rx_dropped++;
+        }
+        else
+        {
+            rx_fifo[(rx_head + rx_count) % SIM_UART_FIFO_DEPTH] = segment->data[rx_position];
+            rx_count++;
+        }
+
+        rx_previous = arrival;
+        rx_started = true;
+        rx_position++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_rx_next
+********************************************************************************
+* Summary:
+* This function returns the arrival time of the next byte to receive, as
+* computed by sim_uart_rx_update().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Virtual time, SIM_NEVER if no byte is left to send
+*
+*******************************************************************************/
+static uint64_t sim_uart_rx_next(void)
+{
+    const sim_rx_segment_t *segment;
+    uint32_t index = rx_segment;
+    uint32_t position = rx_position;
+    uint64_t arrival;
+
+    while ((index < sim_options.rx_segments) && (position >= sim_options.rx[index].length))
+    {
+        index++;
+        position = 0UL;
+    }
+    if (index >= sim_options.rx_segments)
+    {
+        return SIM_NEVER;
+    }
+
+    segment = &sim_options.rx[index];
+    arrival = segment->start + ((uint64_t)(position + 1UL) * byte_ps);
+    if (rx_started && (arrival < (rx_previous + byte_ps)))
+    {
+        arrival = rx_previous + byte_ps;
+    }
+
+    return arrival;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_events
+********************************************************************************
+* Summary:
+* This function returns the enabled events that are present: the TX FIFO is
+* empty, or the RX FIFO holds a byte.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: cyhal_uart_event_t bits
+*
+*******************************************************************************/
+static uint32_t sim_uart_events(void)
+{
+    uint32_t events = 0UL;
+
+    if (tx_busy_until <= sim_now)
+    {
+        events |= (uint32_t)CYHAL_UART_IRQ_TX_EMPTY;
+    }
+
+    if (0UL != (event_enabled & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        sim_uart_rx_update(sim_now, false);
+        if (0UL != rx_count)
+        {
+            events |= (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY;
+        }
+    }
+
+    return events & event_enabled;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_deep_sleep
+********************************************************************************
+* Summary:
+* This function loses the bytes that arrived while the CPU was in deep sleep.
+*
+* Parameters:
+*  start: Entry into deep sleep
+*  end: Wakeup
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_uart_deep_sleep(uint64_t start, uint64_t end)
+{
+    sim_uart_rx_update(start, false);
+    sim_uart_rx_update(end, true);
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_flush
+********************************************************************************
+* Summary:
+* This function writes out the bytes sent by the firmware.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_uart_flush(void)
+{
+    fflush(sim_options.uart_out);
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_irq_line
+********************************************************************************
+* Summary:
+* This function returns the level of the UART interrupt: the TX FIFO is
+* empty or the RX FIFO holds a byte, and the event is enabled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if the interrupt is requested
+*
+*******************************************************************************/
+bool sim_uart_irq_line(void)
+{
+    return (0UL != sim_uart_events());
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_next_event
+********************************************************************************
+* Summary:
+* This function returns the time at which the UART interrupt is requested,
+* so that a sleeping CPU wakes up when the TX FIFO empties or, if the event
+* is enabled, when the next byte is received.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Virtual time, SIM_NEVER if the event is disabled
+*
+*******************************************************************************/
+uint64_t sim_uart_next_event(void)
+{
+    uint64_t next = SIM_NEVER;
+    uint64_t arrival;
+
+    if (0UL != (event_enabled & (uint32_t)CYHAL_UART_IRQ_TX_EMPTY))
+    {
+        next = (tx_busy_until > sim_now) ? tx_busy_until : sim_now;
+    }
+
+    if (0UL != (event_enabled & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        sim_uart_rx_update(sim_now, false);
+        arrival = (0UL != rx_count) ? sim_now : sim_uart_rx_next();
+        if (arrival < next)
+        {
+            next = arrival;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_isr
+********************************************************************************
+* Summary:
+* This function is the interrupt handler of the HAL, which calls the event
+* callback of the application with the events present.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_uart_isr(void)
+{
+    if (NULL != event_callback)
+    {
+        event_callback(event_callback_arg, (cyhal_uart_event_t)sim_uart_events());
+    }
+}
+
+/*******************************************************************************
+* HAL UART and retarget-io
+********************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    sim_sync();
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_retarget_io_init(uint32_t tx, uint32_t rx, uint32_t baudrate)
+{
+    (void)tx;
+    (void)rx;
+    (void)baudrate;
+    sim_sync();
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj)
+{
+    (void)obj;
+    sim_sync();
+    sim_uart_rx_update(sim_now, false);
+    return rx_count;
+}
+
+cy_rslt_t cyhal_uart_getc(cyhal_uart_t *obj, uint8_t *value, uint32_t timeout)
+{
+    uint64_t deadline;
+
+    (void)obj;
+    sim_sync();
+    deadline = sim_now + ((uint64_t)timeout * 1000000000ULL);
+
+    for (;;)
+    {
+        sim_uart_rx_update(sim_now, false);
+        if ((0UL != rx_count) || (sim_now >= deadline))
+        {
+            break;
+        }
+        sim_advance(byte_ps);
+    }
+
+    if (0UL == rx_count)
+    {
+        return SIM_UART_RX_TIMEOUT;
+    }
+
+    *value = rx_fifo[rx_head];
+    rx_head = (rx_head + 1UL) % SIM_UART_FIFO_DEPTH;
+    rx_count--;
+    sim_stats.uart_rx_bytes++;
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t cyhal_uart_writable(cyhal_uart_t *obj)
+{
+    uint64_t occupancy = 0ULL;
+
+    (void)obj;
+    sim_sync();
+    if (tx_busy_until > sim_now)
+    {
+        occupancy = ((tx_busy_until - sim_now) + byte_ps - 1ULL) / byte_ps;
+    }
+
+    return (occupancy >= SIM_UART_FIFO_DEPTH) ? 0UL : (uint32_t)(SIM_UART_FIFO_DEPTH - occupancy);
+}
+
+cy_rslt_t cyhal_uart_putc(cyhal_uart_t *obj, uint32_t value)
+{
+    uint64_t room;
+
+    (void)obj;
+    sim_sync();
+
+    /* Wait until the oldest byte of a full FIFO is sent */
+    room = (SIM_UART_FIFO_DEPTH - 1ULL) * byte_ps;
+    if (tx_busy_until > (sim_now + room))
+    {
+        sim_run_until(tx_busy_until - room);
+    }
+
+    tx_busy_until = ((tx_busy_until > sim_now) ? tx_busy_until : sim_now) + byte_ps;
+    (void)fputc((int)(value & 0xFFUL), sim_options.uart_out);
+    sim_stats.uart_tx_bytes++;
+    return CY_RSLT_SUCCESS;
+}
+
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    (void)obj;
+    sim_sync();
+    return (tx_busy_until > sim_now);
+}
+
+void cyhal_uart_register_callback(cyhal_uart_t *obj, cyhal_uart_event_callback_t callback, void *callback_arg)
+{
+    (void)obj;
+    sim_sync();
+    event_callback = callback;
+    event_callback_arg = callback_arg;
+}
+
+void cyhal_uart_enable_event(cyhal_uart_t *obj, cyhal_uart_event_t event, uint8_t intr_priority, bool enable)
+{
+    const cy_stc_sysint_t config = { scb_5_interrupt_IRQn, intr_priority };
+
+    (void)obj;
+    (void)Cy_SysInt_Init(&config, sim_uart_isr);
+    NVIC_EnableIRQ(scb_5_interrupt_IRQn);
+    if (enable)
+    {
+        event_enabled |= (uint32_t)event;
+    }
+    else
+    {
+        event_enabled &= ~(uint32_t)event;
+    }
+    sim_sync();
+}
+
+/* [] END OF FILE */
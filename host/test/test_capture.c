@@ -0,0 +1,505 @@
+/******************************************************************************
+* File Name:   test_capture.c
+*
+* Description: This file contains the test of the capture format and of its
+*              host reader. It runs the capture variant of the simulator with
+*              noisy sine inputs, and checks the pairs, their trigger times,
+*              the range queries and the downsampled views of the reader
+*              against the results logged by the simulator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "capture_reader.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The first wakeup of the DMA mode, at 25.6 s, applies the 1 kHz period, so
+   the capture holds one chunk at 5 Hz and about 14400 pairs at 1 kHz. The
+   20 Hz sine on SAR0 takes some differences out of the int8 range. */
+#define TEST_OPTIONS            "--seconds 40 --sar0 sine:20:1.0:1.6 --sar1 sine:0.5:0.8:1.6 --noise 3 " \
+                                "--send 0.1:r999\\\\r"
+
+/* Largest number of scans logged by the simulator */
+#define TEST_MAX_SCANS          (32768UL)
+
+/* The chunk time of a DMA block is derived from the TCPWM time base, read
+   a few microseconds before the simulator logs the start of the scan */
+#define TEST_TIME_TOLERANCE_NS  (10000LL)
+
+/* A view over the capture, and one over 1.5 s with more bins than pairs */
+#define TEST_VIEW_BINS          (16UL)
+#define TEST_FINE_START         (27000000ULL)
+#define TEST_FINE_END           (28500000ULL)
+#define TEST_FINE_BINS          (2000UL)
+
+/* Longest path and command line */
+#define TEST_LINE_SIZE          (512)
+#define TEST_COMMAND_SIZE       (2048)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Scans logged by the simulator */
+static long long test_log_ns[TEST_MAX_SCANS];
+static int16_t test_log_sar[2][TEST_MAX_SCANS];
+static uint32_t test_log_count;
+
+/* Pairs of the capture, from the query of the whole capture */
+static uint64_t test_time[TEST_MAX_SCANS];
+static int16_t test_sar[2][TEST_MAX_SCANS];
+static uint32_t test_count;
+
+/* Bins of a view, from the reader and from the pairs */
+static capture_bin_t test_view[TEST_FINE_BINS];
+static capture_bin_t test_expected[TEST_FINE_BINS];
+
+/* Directory of the output files */
+static const char *test_directory;
+
+/*******************************************************************************
+* Function Name: test_run
+********************************************************************************
+* Summary:
+* This function runs a simulator, its UART output and its scans written to
+* files of the output directory, and reads the scans.
+*
+* Parameters:
+*  simulator: Simulator with the capture telemetry
+*  uart: Location to store the path of the UART output
+*  size: Size of the location
+*
+* Return:
+*  bool: true if the simulator succeeded
+*
+*******************************************************************************/
+static bool test_run(const char *simulator, char *uart, size_t size)
+{
+    char command[TEST_COMMAND_SIZE];
+    char path[TEST_LINE_SIZE];
+    long long time;
+    int sar0;
+    int sar1;
+    FILE *file;
+
+    (void)snprintf(uart, size, "%s/capture.uart", test_directory);
+    (void)snprintf(path, sizeof(path), "%s/capture.sar", test_directory);
+    (void)snprintf(command, sizeof(command), "%s %s --uart-out %s --sar-log %s > /dev/null",
+                   simulator, TEST_OPTIONS, uart, path);
+    if (0 != system(command))
+    {
+        return false;
+    }
+
+    file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return false;
+    }
+    test_log_count = 0UL;
+    while ((test_log_count < TEST_MAX_SCANS) && (3 == fscanf(file, "%lld %d %d", &time, &sar0, &sar1)))
+    {
+        test_log_ns[test_log_count] = time;
+        test_log_sar[0][test_log_count] = (int16_t)sar0;
+        test_log_sar[1][test_log_count] = (int16_t)sar1;
+        test_log_count++;
+    }
+    (void)fclose(file);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: test_whole
+********************************************************************************
+* Summary:
+* This function reads the whole capture with a range query and compares
+* every pair and its trigger time with the scans of the simulator. The
+* capture holds the pairs from the first scan, without gaps. The chunks
+* are padded to even offsets, so the int16 columns of every chunk must be
+* returned in place, whatever the length of the text before them.
+*
+* Parameters:
+*  reader: Reader of the capture
+*
+* Return:
+*  uint32_t: Number of spans returned in place from the mapped file
+*
+*******************************************************************************/
+static uint32_t test_whole(capture_reader_t *reader)
+{
+    const capture_chunk_t *chunk;
+    capture_range_t range;
+    capture_span_t span;
+    uint32_t in_place = 0UL;
+    uint32_t raw = 0UL;
+    uint32_t pair;
+    uint32_t mismatches = 0UL;
+    long long error;
+
+    test_count = 0UL;
+    capture_reader_range_index(reader, 0ULL, UINT64_MAX, &range);
+    while (capture_reader_next(reader, &range, &span))
+    {
+        TEST_CHECK(span.index == test_count, "span at pair %llu after %lu pairs",
+                   (unsigned long long)span.index, (unsigned long)test_count);
+        chunk = &reader->chunks[range.chunk - 1UL];
+        if (!chunk->delta)
+        {
+            raw++;
+        }
+        if (((const uint8_t *)span.sar0 >= reader->data) &&
+            ((const uint8_t *)span.sar0 < &reader->data[reader->size]))
+        {
+            in_place++;
+        }
+        for (pair = 0UL; (pair < span.count) && (test_count < test_log_count); pair++)
+        {
+            test_time[test_count] = span.time + ((uint64_t)pair * span.interval);
+            test_sar[0][test_count] = span.sar0[pair];
+            test_sar[1][test_count] = span.sar1[pair];
+
+            error = ((long long)test_time[test_count] * 1000LL) - test_log_ns[test_count];
+            if ((span.sar0[pair] != test_log_sar[0][test_count]) ||
+                (span.sar1[pair] != test_log_sar[1][test_count]) ||
+                (error < -TEST_TIME_TOLERANCE_NS) || (error > TEST_TIME_TOLERANCE_NS))
+            {
+                if (0UL == mismatches)
+                {
+                    TEST_CHECK(false, "pair %lu is %d %d at %+lld ns, logged %d %d",
+                               (unsigned long)test_count, span.sar0[pair], span.sar1[pair], error,
+                               test_log_sar[0][test_count], test_log_sar[1][test_count]);
+                }
+                mismatches++;
+            }
+            test_count++;
+        }
+    }
+    TEST_CHECK(test_count == reader->pairs, "%lu of %llu pairs read", (unsigned long)test_count,
+               (unsigned long long)reader->pairs);
+    TEST_CHECK(0UL == mismatches, "%lu pairs differ from the log", (unsigned long)mismatches);
+    TEST_CHECK(in_place == raw, "%lu of %lu int16 chunks read in place", (unsigned long)in_place,
+               (unsigned long)raw);
+
+    return in_place;
+}
+
+/*******************************************************************************
+* Function Name: test_range
+********************************************************************************
+* Summary:
+* This function compares a range query with the pairs of the whole capture.
+*
+* Parameters:
+*  reader: Reader of the capture
+*  range: Query to check
+*  first: Index of the first pair expected
+*  count: Number of pairs expected
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_range(capture_reader_t *reader, capture_range_t *range, uint32_t first, uint32_t count)
+{
+    capture_span_t span;
+    uint32_t index = first;
+    uint32_t pair;
+    uint32_t mismatches = 0UL;
+
+    while (capture_reader_next(reader, range, &span))
+    {
+        TEST_CHECK(span.index == index, "span at pair %llu, expected %lu", (unsigned long long)span.index,
+                   (unsigned long)index);
+        for (pair = 0UL; (pair < span.count) && (index < test_count); pair++)
+        {
+            if ((span.sar0[pair] != test_sar[0][index]) || (span.sar1[pair] != test_sar[1][index]) ||
+                ((span.time + ((uint64_t)pair * span.interval)) != test_time[index]))
+            {
+                mismatches++;
+            }
+            index++;
+        }
+    }
+    TEST_CHECK((index - first) == count, "%lu pairs from %lu, expected %lu", (unsigned long)(index - first),
+               (unsigned long)first, (unsigned long)count);
+    TEST_CHECK(0UL == mismatches, "%lu pairs of the range differ", (unsigned long)mismatches);
+}
+
+/*******************************************************************************
+* Function Name: test_check_view
+********************************************************************************
+* Summary:
+* This function compares a view of the reader with the bins of the pairs of
+* the whole capture.
+*
+* Parameters:
+*  reader: Reader of the capture
+*  start: Trigger time of the first bin
+*  end: Trigger time after the last bin
+*  bins: Number of bins
+*
+* Return:
+*  uint32_t: Number of chunks read by the reader
+*
+*******************************************************************************/
+static uint32_t test_check_view(capture_reader_t *reader, uint64_t start, uint64_t end, uint32_t bins)
+{
+    capture_bin_t *bin;
+    uint32_t read;
+    uint32_t index;
+    uint32_t sar;
+    uint32_t mismatches = 0UL;
+
+    read = capture_reader_view(reader, start, end, bins, test_view);
+
+    (void)memset(test_expected, 0, sizeof(test_expected));
+    for (index = 0UL; index < test_count; index++)
+    {
+        if ((test_time[index] < start) || (test_time[index] >= end))
+        {
+            continue;
+        }
+        bin = &test_expected[((test_time[index] - start) * bins) / (end - start)];
+        for (sar = 0UL; sar < 2UL; sar++)
+        {
+            if ((0ULL == bin->pairs) || (test_sar[sar][index] < bin->min[sar]))
+            {
+                bin->min[sar] = test_sar[sar][index];
+            }
+            if ((0ULL == bin->pairs) || (test_sar[sar][index] > bin->max[sar]))
+            {
+                bin->max[sar] = test_sar[sar][index];
+            }
+        }
+        bin->pairs++;
+    }
+
+    for (index = 0UL; index < bins; index++)
+    {
+        if (0 != memcmp(&test_view[index], &test_expected[index], sizeof(capture_bin_t)))
+        {
+            if (0UL == mismatches)
+            {
+                TEST_CHECK(false, "bin %lu of %lu: %llu pairs, %d..%d %d..%d, expected %llu pairs, %d..%d %d..%d",
+                           (unsigned long)index, (unsigned long)bins, (unsigned long long)test_view[index].pairs,
+                           test_view[index].min[0], test_view[index].max[0], test_view[index].min[1],
+                           test_view[index].max[1], (unsigned long long)test_expected[index].pairs,
+                           test_expected[index].min[0], test_expected[index].max[0],
+                           test_expected[index].min[1], test_expected[index].max[1]);
+            }
+            mismatches++;
+        }
+    }
+    TEST_CHECK(0UL == mismatches, "%lu of %lu bins differ", (unsigned long)mismatches, (unsigned long)bins);
+
+    return read;
+}
+
+/*******************************************************************************
+* Function Name: test_damaged
+********************************************************************************
+* Summary:
+* This function indexes a copy of the capture with one result of a chunk
+* changed, which must drop that chunk alone.
+*
+* Parameters:
+*  reader: Reader of the intact capture
+*  number: Chunk to damage
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_damaged(const capture_reader_t *reader, uint32_t number)
+{
+    capture_reader_t damaged;
+    uint8_t *copy = malloc(reader->size);
+    const capture_chunk_t *chunk = &reader->chunks[number];
+
+    if (NULL == copy)
+    {
+        TEST_CHECK(false, "no memory for a copy of the capture");
+        return;
+    }
+    (void)memcpy(copy, reader->data, reader->size);
+    copy[(size_t)(chunk->columns - reader->data) + (chunk->length / 2UL)] ^= 0x01U;
+
+    if (capture_reader_load(&damaged, copy, reader->size))
+    {
+        TEST_CHECK(1ULL == damaged.crc_errors, "%llu CRC errors", (unsigned long long)damaged.crc_errors);
+        TEST_CHECK((damaged.chunk_count + 1UL) == reader->chunk_count, "%lu of %lu chunks left",
+                   (unsigned long)damaged.chunk_count, (unsigned long)reader->chunk_count);
+        TEST_CHECK(damaged.pairs_missed == chunk->count, "%llu pairs missed, expected %lu",
+                   (unsigned long long)damaged.pairs_missed, (unsigned long)chunk->count);
+        capture_reader_close(&damaged);
+    }
+    else
+    {
+        TEST_CHECK(false, "cannot index the damaged capture");
+    }
+    free(copy);
+}
+
+/*******************************************************************************
+* Function Name: test_capture
+********************************************************************************
+* Summary:
+* This function runs one simulator and checks the queries of its capture.
+*
+* Parameters:
+*  simulator: Simulator with the capture telemetry
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_capture(const char *simulator)
+{
+    char uart[TEST_LINE_SIZE];
+    capture_reader_t reader;
+    capture_range_t range;
+    uint32_t delta_chunks = 0UL;
+    uint32_t in_place;
+    uint32_t view_read;
+    uint32_t fine_read;
+    uint32_t first;
+    uint32_t number;
+    uint64_t end;
+
+    if (!test_run(simulator, uart, sizeof(uart)))
+    {
+        TEST_CHECK(false, "%s failed", simulator);
+        return;
+    }
+    if (!capture_reader_open(&reader, uart))
+    {
+        TEST_CHECK(false, "cannot map %s", uart);
+        return;
+    }
+    TEST_CHECK(reader.chunk_count > 100UL, "%lu chunks", (unsigned long)reader.chunk_count);
+    TEST_CHECK((0ULL == reader.crc_errors) && (0ULL == reader.pairs_missed),
+               "%llu CRC errors, %llu pairs missed", (unsigned long long)reader.crc_errors,
+               (unsigned long long)reader.pairs_missed);
+    if (0UL == reader.chunk_count)
+    {
+        capture_reader_close(&reader);
+        return;
+    }
+    for (number = 0UL; number < reader.chunk_count; number++)
+    {
+        delta_chunks += reader.chunks[number].delta ? 1UL : 0UL;
+    }
+
+    in_place = test_whole(&reader);
+
+    /* By index, across chunk boundaries */
+    capture_reader_range_index(&reader, 1000ULL, 2500ULL, &range);
+    test_range(&reader, &range, 1000UL, 2500UL);
+
+    /* By time, from the first pair at or after the start */
+    capture_reader_range_time(&reader, TEST_FINE_START, TEST_FINE_END, &range);
+    for (first = 0UL; (first < test_count) && (test_time[first] < TEST_FINE_START); first++)
+    {
+    }
+    for (number = first; (number < test_count) && (test_time[number] < TEST_FINE_END); number++)
+    {
+    }
+    test_range(&reader, &range, first, number - first);
+
+    /* Past the end */
+    capture_reader_range_index(&reader, test_count, 10ULL, &range);
+    test_range(&reader, &range, test_count, 0UL);
+
+    end = test_time[test_count - 1UL] + 1ULL;
+    view_read = test_check_view(&reader, test_time[0], end, TEST_VIEW_BINS);
+    fine_read = test_check_view(&reader, TEST_FINE_START, TEST_FINE_END, TEST_FINE_BINS);
+
+    /* A coarse view reads the columns only of the chunks across its bins */
+    TEST_CHECK(view_read <= (TEST_VIEW_BINS + 1UL), "%lu of %lu chunks read for %lu bins",
+               (unsigned long)view_read, (unsigned long)reader.chunk_count, (unsigned long)TEST_VIEW_BINS);
+
+    test_damaged(&reader, reader.chunk_count / 2UL);
+
+    printf("{\"simulator\":\"%s\",\"chunks\":%lu,\"delta_chunks\":%lu,\"pairs\":%lu,\"bytes\":%llu,"
+           "\"in_place_spans\":%lu,\"view_chunks_read\":%lu,\"fine_view_chunks_read\":%lu}\n",
+           simulator, (unsigned long)reader.chunk_count, (unsigned long)delta_chunks, (unsigned long)test_count,
+           (unsigned long long)reader.size, (unsigned long)in_place, (unsigned long)view_read,
+           (unsigned long)fine_read);
+
+    capture_reader_close(&reader);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function checks the capture of each simulator given.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Directory of the output files, then the simulators
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    int arg;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s DIRECTORY SIMULATOR...\n", argv[0]);
+        return 2;
+    }
+    test_directory = argv[1];
+
+    for (arg = 2; arg < argc; arg++)
+    {
+        test_capture(argv[arg]);
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,309 @@
+/******************************************************************************
+* File Name:   test_correlator.c
+*
+* Description: This file contains the host test of the cross-correlation
+*              engine. It delays band-limited noise and sines by fractions
+*              of a sample and checks the delay, the correlation coefficient
+*              and the phase measured by the direct and by the FFT path
+*              against the applied values.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "correlator.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Half length of the interpolation filter that delays the noise, in samples */
+#define TEST_TAPS           (24L)
+
+/* Cutoff of the band-limited noise, in cycles per sample */
+#define TEST_CUTOFF         (0.2)
+
+/* Standard deviation of the signals, in SAR counts */
+#define TEST_AMPLITUDE      (600.0)
+
+/* Largest error of the delay, in samples, and of the phase, in degrees */
+#define TEST_DELAY_TOLERANCE    (0.05)
+#define TEST_PHASE_TOLERANCE    (1.0)
+
+/* Smallest correlation coefficient of a delayed copy. It is less than 1 at
+   fractional delays, and the FFT path divides by the energy of the whole
+   window rather than of the samples that overlap. */
+#define TEST_MIN_COEFFICIENT    (0.85)
+
+#define TEST_PI             (3.14159265358979323846)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* White noise, with TEST_TAPS samples of margin on both sides */
+static double test_noise[CORR_MAX_WINDOW + (2L * TEST_TAPS)];
+
+/* Capture fed to the correlator */
+static sample_pair_t test_pairs[CORR_MAX_WINDOW];
+
+/*******************************************************************************
+* Function Name: test_lowpass
+********************************************************************************
+* Summary:
+* This function evaluates the impulse response of the low-pass filter that
+* band-limits the noise: a sinc with a cutoff of TEST_CUTOFF, shaped by a
+* Hann window of TEST_TAPS samples on each side.
+*
+* Parameters:
+*  t: Time from the center of the filter in samples, not only integers
+*
+* Return:
+*  double: Filter coefficient
+*
+*******************************************************************************/
+static double test_lowpass(double t)
+{
+    double sinc = (fabs(t) < 1.0e-9) ? 1.0 : (sin(2.0 * TEST_PI * TEST_CUTOFF * t) / (2.0 * TEST_PI * TEST_CUTOFF * t));
+
+    if (fabs(t) >= (double)TEST_TAPS)
+    {
+        return 0.0;
+    }
+
+    return 2.0 * TEST_CUTOFF * sinc * (0.5 + (0.5 * cos((TEST_PI * t) / (double)TEST_TAPS)));
+}
+
+/*******************************************************************************
+* Function Name: test_fill_noise
+********************************************************************************
+* Summary:
+* This function fills the capture with band-limited noise on SAR0 and the
+* same noise delayed by a fraction of a sample on SAR1. Both are filtered
+* from the same white noise by the same low-pass filter, shifted by the
+* delay for SAR1.
+*
+* Parameters:
+*  window: Number of sample pairs
+*  delay: Delay of SAR1 in samples
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_fill_noise(uint32_t window, double delay)
+{
+    uint32_t index;
+    int32_t tap;
+    double sum0;
+    double sum1;
+    double gain = 0.0;
+
+    for (tap = -TEST_TAPS; tap <= TEST_TAPS; tap++)
+    {
+        gain += test_lowpass((double)tap) * test_lowpass((double)tap);
+    }
+    gain = TEST_AMPLITUDE / sqrt(gain);
+
+    for (index = 0UL; index < window; index++)
+    {
+        sum0 = 0.0;
+        sum1 = 0.0;
+        for (tap = -TEST_TAPS; tap <= TEST_TAPS; tap++)
+        {
+            sum0 += test_noise[(int32_t)index + TEST_TAPS + tap] * test_lowpass((double)tap);
+            sum1 += test_noise[(int32_t)index + TEST_TAPS + tap] * test_lowpass((double)tap + delay);
+        }
+        test_pairs[index].sar0 = (int16_t)lround(sum0 * gain);
+        test_pairs[index].sar1 = (int16_t)lround(sum1 * gain);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_correlate
+********************************************************************************
+* Summary:
+* This function passes the capture to the correlator, in blocks of 50 pairs
+* like the main loop, and returns its result.
+*
+* Parameters:
+*  window: Number of sample pairs
+*  result: Result to fill
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_correlate(uint32_t window, corr_result_t *result)
+{
+    uint32_t index;
+
+    TEST_CHECK(correlator_start(window), "window %lu refused", (unsigned long)window);
+    for (index = 0UL; index < window; index += 50UL)
+    {
+        correlator_process(&test_pairs[index], ((window - index) < 50UL) ? (window - index) : 50UL);
+    }
+    TEST_CHECK(correlator_get_result(result), "no result for window %lu", (unsigned long)window);
+}
+
+/*******************************************************************************
+* Function Name: test_delays
+********************************************************************************
+* Summary:
+* This function measures fractional delays of band-limited noise in both
+* directions, over windows of both paths.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_delays(void)
+{
+    static const uint32_t windows[] = { 64UL, 128UL, 200UL, 256UL, 1024UL, CORR_MAX_WINDOW };
+    static const double delays[] = { 0.0, 1.6, -3.3, 0.5, -0.25, 7.75, -20.4 };
+    corr_result_t result;
+    uint32_t window;
+    uint32_t delay;
+
+    for (window = 0UL; window < (sizeof(windows) / sizeof(windows[0])); window++)
+    {
+        for (delay = 0UL; delay < (sizeof(delays) / sizeof(delays[0])); delay++)
+        {
+            test_fill_noise(windows[window], delays[delay]);
+            test_correlate(windows[window], &result);
+
+            TEST_CHECK((windows[window] >= CORR_FFT_WINDOW) == result.fft, "window %lu: fft %d",
+                       (unsigned long)windows[window], (int)result.fft);
+            TEST_CHECK(fabs((double)result.delay - delays[delay]) <= TEST_DELAY_TOLERANCE,
+                       "window %lu: delay %.3f measured as %.3f", (unsigned long)windows[window],
+                       delays[delay], (double)result.delay);
+            TEST_CHECK((double)result.coefficient >= TEST_MIN_COEFFICIENT, "window %lu, delay %.3f: coefficient %.3f",
+                       (unsigned long)windows[window], delays[delay], (double)result.coefficient);
+            printf("{\"window\":%lu,\"fft\":%s,\"delay\":%.2f,\"measured\":%.4f,\"coefficient\":%.4f}\n",
+                   (unsigned long)windows[window], result.fft ? "true" : "false", delays[delay],
+                   (double)result.delay, (double)result.coefficient);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_phase
+********************************************************************************
+* Summary:
+* This function delays a sine with a whole number of cycles in the window,
+* with SAR1 inverted, and checks the frequency, the phase and the negative
+* coefficient reported by the FFT path.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_phase(void)
+{
+    const uint32_t window = 512UL;
+    const double frequency = 20.0 / (double)window;
+    const double delay = 1.6;
+    double phase;
+    corr_result_t result;
+    uint32_t index;
+
+    for (index = 0UL; index < window; index++)
+    {
+        test_pairs[index].sar0 = (int16_t)lround(1500.0 * sin(2.0 * TEST_PI * frequency * (double)index));
+        test_pairs[index].sar1 = (int16_t)lround(-1500.0 * sin(2.0 * TEST_PI * frequency * ((double)index - delay)));
+    }
+    test_correlate(window, &result);
+
+    /* SAR1 lags by the delay and by the inversion */
+    phase = remainder((-360.0 * frequency * delay) + 180.0, 360.0);
+    TEST_CHECK(fabs((double)result.frequency - frequency) < 1.0e-6, "frequency %.5f measured as %.5f",
+               frequency, (double)result.frequency);
+    TEST_CHECK(fabs(remainder((double)result.phase - phase, 360.0)) <= TEST_PHASE_TOLERANCE,
+               "phase %.2f measured as %.2f", phase, (double)result.phase);
+    printf("{\"window\":%lu,\"frequency\":%.5f,\"phase\":%.2f,\"measured\":%.2f,\"coefficient\":%.4f}\n",
+           (unsigned long)window, frequency, phase, (double)result.phase, (double)result.coefficient);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the correlator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(void)
+{
+    uint32_t index;
+    uint32_t seed = 1UL;
+    double u1;
+    double u2;
+
+    /* Gaussian white noise, Box-Muller */
+    for (index = 0UL; index < (sizeof(test_noise) / sizeof(test_noise[0])); index++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        u1 = ((double)(seed >> 8U) + 1.0) / 16777217.0;
+        seed = (seed * 1103515245UL) + 12345UL;
+        u2 = (double)(seed >> 8U) / 16777216.0;
+        test_noise[index] = sqrt(-2.0 * log(u1)) * cos(2.0 * TEST_PI * u2);
+    }
+
+    fft_init();
+    test_delays();
+
+    /* Only the FFT path measures the phase */
+    if (512UL >= CORR_FFT_WINDOW)
+    {
+        test_phase();
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,296 @@
+/******************************************************************************
+* File Name:   test_decimator.c
+*
+* Description: This file contains the host test of the decimation filter. It
+*              checks the DC gain, the saturation of the output to the SAR
+*              range on full scale steps, that the output does not depend
+*              on the block size, and the group delay reported for the
+*              timestamps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "decimator.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of input pairs of each test */
+#define TEST_PAIRS          (4096UL)
+
+/* Number of decimated pairs of the step response of the CIC and FIR filters */
+#define TEST_SETTLE         (24UL)
+
+/* Full scale SAR results */
+#define TEST_MIN_RESULT     (-2048)
+#define TEST_MAX_RESULT     (2047)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sample_pair_t test_input[TEST_PAIRS];
+static sample_pair_t test_output[DECIM_MAX_OUTPUT(TEST_PAIRS)];
+static sample_pair_t test_reference[DECIM_MAX_OUTPUT(TEST_PAIRS)];
+
+/*******************************************************************************
+* Function Name: test_dc
+********************************************************************************
+* Summary:
+* This function checks that a constant input comes out unchanged once the
+* filter has settled, on both inputs and at both ends of the SAR range.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_dc(void)
+{
+    static const int16_t levels[] = { 0, 1, -1, 1000, -1000, TEST_MAX_RESULT, TEST_MIN_RESULT };
+    uint32_t level;
+    uint32_t count;
+    uint32_t first;
+    uint32_t index;
+
+    for (level = 0UL; level < (sizeof(levels) / sizeof(levels[0])); level++)
+    {
+        for (index = 0UL; index < TEST_PAIRS; index++)
+        {
+            test_input[index].sar0 = levels[level];
+            test_input[index].sar1 = (int16_t)-levels[level];
+        }
+
+        decimator_set_enabled(true);
+        count = decimator_process(test_input, TEST_PAIRS, test_output, &first);
+        TEST_CHECK((TEST_PAIRS / DECIM_RATIO) == count, "%lu outputs from %lu pairs",
+                   (unsigned long)count, TEST_PAIRS);
+
+        for (index = TEST_SETTLE; index < count; index++)
+        {
+            TEST_CHECK(levels[level] == test_output[index].sar0, "DC %d: sar0 %d at %lu",
+                       levels[level], test_output[index].sar0, (unsigned long)index);
+            TEST_CHECK(((levels[level] == TEST_MIN_RESULT) ? TEST_MAX_RESULT : -levels[level]) ==
+                       test_output[index].sar1, "DC %d: sar1 %d at %lu",
+                       -levels[level], test_output[index].sar1, (unsigned long)index);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_saturation
+********************************************************************************
+* Summary:
+* This function feeds full scale steps and a full scale square wave near the
+* edge of the pass band, which make the FIR filter overshoot, and checks that
+* every output stays within the 12-bit SAR range and reaches both ends of it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_saturation(void)
+{
+    /* Half periods of the square waves in input pairs: single steps, and
+       0.2 of the decimated sample rate */
+    static const uint32_t half_periods[] = { 512UL, 5UL * DECIM_RATIO / 2UL };
+    uint32_t wave;
+    uint32_t count;
+    uint32_t first;
+    uint32_t index;
+    int16_t low;
+    int16_t high;
+
+    for (wave = 0UL; wave < (sizeof(half_periods) / sizeof(half_periods[0])); wave++)
+    {
+        for (index = 0UL; index < TEST_PAIRS; index++)
+        {
+            test_input[index].sar0 = (0UL == ((index / half_periods[wave]) % 2UL)) ? TEST_MIN_RESULT : TEST_MAX_RESULT;
+            test_input[index].sar1 = (int16_t)(-1 - test_input[index].sar0);
+        }
+
+        decimator_set_enabled(true);
+        count = decimator_process(test_input, TEST_PAIRS, test_output, &first);
+
+        low = INT16_MAX;
+        high = INT16_MIN;
+        for (index = 0UL; index < count; index++)
+        {
+            TEST_CHECK((test_output[index].sar0 >= TEST_MIN_RESULT) && (test_output[index].sar0 <= TEST_MAX_RESULT) &&
+                       (test_output[index].sar1 >= TEST_MIN_RESULT) && (test_output[index].sar1 <= TEST_MAX_RESULT),
+                       "half period %lu: pair %d, %d at %lu out of the SAR range", (unsigned long)half_periods[wave],
+                       test_output[index].sar0, test_output[index].sar1, (unsigned long)index);
+            low = (test_output[index].sar0 < low) ? test_output[index].sar0 : low;
+            high = (test_output[index].sar0 > high) ? test_output[index].sar0 : high;
+        }
+        TEST_CHECK((TEST_MIN_RESULT == low) && (TEST_MAX_RESULT == high), "half period %lu: sar0 from %d to %d",
+                   (unsigned long)half_periods[wave], low, high);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_blocks
+********************************************************************************
+* Summary:
+* This function checks that the output is the same whether the input is
+* processed in one block or in blocks of varying sizes, and that the input
+* pair reported to complete the first output of each block follows the
+* decimation phase across blocks.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_blocks(void)
+{
+    uint32_t reference_count;
+    uint32_t added;
+    uint32_t first;
+    uint32_t count = 0UL;
+    uint32_t position = 0UL;
+    uint32_t size = 1UL;
+    uint32_t index;
+    uint32_t seed = 1UL;
+
+    for (index = 0UL; index < TEST_PAIRS; index++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        test_input[index].sar0 = (int16_t)((int32_t)((seed >> 16U) & 0xFFFUL) - 2048L);
+        test_input[index].sar1 = (int16_t)((int32_t)((seed >> 4U) & 0xFFFUL) - 2048L);
+    }
+
+    decimator_set_enabled(true);
+    reference_count = decimator_process(test_input, TEST_PAIRS, test_reference, &first);
+    TEST_CHECK((DECIM_RATIO - 1UL) == first, "first output completed by input %lu", (unsigned long)first);
+
+    decimator_set_enabled(true);
+    while (position < TEST_PAIRS)
+    {
+        if (size > (TEST_PAIRS - position))
+        {
+            size = TEST_PAIRS - position;
+        }
+        added = decimator_process(&test_input[position], size, &test_output[count], &first);
+        TEST_CHECK((0UL == added) || ((position + first) == (((count + 1UL) * DECIM_RATIO) - 1UL)),
+                   "output %lu completed by input %lu", (unsigned long)count, (unsigned long)(position + first));
+        count += added;
+        position += size;
+        size = (size % 37UL) + 1UL;
+    }
+
+    TEST_CHECK(reference_count == count, "%lu outputs in blocks, %lu in one block",
+               (unsigned long)count, (unsigned long)reference_count);
+    TEST_CHECK(0 == memcmp(test_reference, test_output, reference_count * sizeof(sample_pair_t)),
+               "output depends on the block size");
+}
+
+/*******************************************************************************
+* Function Name: test_delay
+********************************************************************************
+* Summary:
+* This function feeds a ramp of one count per input pair and checks that,
+* once the filter has settled, each output is the input DECIM_DELAY_HALF_PAIRS
+* / 2 pairs before the input pair that completes it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_delay(void)
+{
+    uint32_t count;
+    uint32_t first;
+    uint32_t index;
+    double expected;
+
+    for (index = 0UL; index < TEST_PAIRS; index++)
+    {
+        test_input[index].sar0 = (int16_t)((int32_t)index - 2048L);
+        test_input[index].sar1 = (int16_t)(2047L - (int32_t)index);
+    }
+
+    decimator_set_enabled(true);
+    count = decimator_process(test_input, TEST_PAIRS, test_output, &first);
+
+    for (index = TEST_SETTLE; index < count; index++)
+    {
+        expected = (double)(first + (index * DECIM_RATIO)) - ((double)DECIM_DELAY_HALF_PAIRS / 2.0) - 2048.0;
+        TEST_CHECK(fabs((double)test_output[index].sar0 - expected) <= 0.75, "ramp: output %lu is %d, expected %.1f",
+                   (unsigned long)index, test_output[index].sar0, expected);
+        TEST_CHECK(fabs((double)test_output[index].sar1 + expected + 1.0) <= 0.75, "ramp: output %lu is %d, expected %.1f",
+                   (unsigned long)index, test_output[index].sar1, -expected - 1.0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the decimation filter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(void)
+{
+    test_dc();
+    test_saturation();
+    test_blocks();
+    test_delay();
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
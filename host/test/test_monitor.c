@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name:   test_monitor.c
+*
+* Description: This file contains the test of the event monitor in DMA
+*              mode. It runs the DMA variant of the simulator with a step
+*              on SAR1 after a long quiet period, checks that the armed
+*              monitor does not wake up the CPU until the step, and compares
+*              the pairs captured around the step with the scans logged by
+*              the simulator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The first wakeup of the DMA mode, at 25.6 s, applies the 1 kHz period; the
+   monitor is armed at 26 s and SAR1 steps out of the default window at 45 s.
+   The 3 Hz sine on SAR0 stays inside the window and tells the pairs apart. */
+#define TEST_OPTIONS            "--seconds 50 --sar0 sine:3:0.5:1.6 --sar1 step:45:1.0:3.1 " \
+                                "--send 0.1:r999\\\\r --send 26:e --window 28:44"
+
+/* Wakeups per second allowed while the monitor is armed and the inputs are
+   quiet, against about 7.8 for the blocks of 128 pairs at 1 kHz */
+#define TEST_MAX_QUIET_RATE     (0.5)
+
+/* Increase of the SAR1 result that marks the step in the log */
+#define TEST_STEP_COUNTS        (500)
+
+/* Largest number of scans logged by the simulator */
+#define TEST_MAX_SCANS          (32768UL)
+
+/* Pairs captured before and after the trigger, as in monitor.h */
+#define TEST_PRE_PAIRS          (128L)
+#define TEST_POST_PAIRS         (128L)
+
+/* Longest path and command line */
+#define TEST_LINE_SIZE          (512)
+#define TEST_COMMAND_SIZE       (2048)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Scans logged by the simulator */
+static int16_t test_log_sar[2][TEST_MAX_SCANS];
+static uint32_t test_log_count;
+
+/* Directory of the output files */
+static const char *test_directory;
+
+/*******************************************************************************
+* Function Name: test_read_log
+********************************************************************************
+* Summary:
+* This function reads the scans logged by the simulator.
+*
+* Parameters:
+*  path: Log of the scans
+*
+* Return:
+*  bool: true if the log was read
+*
+*******************************************************************************/
+static bool test_read_log(const char *path)
+{
+    long long time;
+    int sar0;
+    int sar1;
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        return false;
+    }
+    test_log_count = 0UL;
+    while ((test_log_count < TEST_MAX_SCANS) && (3 == fscanf(file, "%lld %d %d", &time, &sar0, &sar1)))
+    {
+        test_log_sar[0][test_log_count] = (int16_t)sar0;
+        test_log_sar[1][test_log_count] = (int16_t)sar1;
+        test_log_count++;
+    }
+    (void)fclose(file);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: test_quiet_rate
+********************************************************************************
+* Summary:
+* This function reads the wakeups per second of the report of the simulator,
+* counted over the quiet window.
+*
+* Parameters:
+*  path: Report of the simulator
+*
+* Return:
+*  double: Wakeups per second, or -1 if the report has none
+*
+*******************************************************************************/
+static double test_quiet_rate(const char *path)
+{
+    char line[TEST_COMMAND_SIZE];
+    const char *field;
+    double rate = -1.0;
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        return rate;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        field = strstr(line, "\"wakeups_per_second\":");
+        if (NULL != field)
+        {
+            (void)sscanf(field, "\"wakeups_per_second\":%lf", &rate);
+        }
+    }
+    (void)fclose(file);
+
+    return rate;
+}
+
+/*******************************************************************************
+* Function Name: test_check_event
+********************************************************************************
+* Summary:
+* This function finds the first event reported on the UART and compares its
+* scan and its pairs with the log. The trigger must be the first scan of the
+* step, and the pairs before it come from the DMA blocks held while the
+* monitor was armed.
+*
+* Parameters:
+*  path: UART output of the simulator
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_check_event(const char *path)
+{
+    char line[TEST_LINE_SIZE];
+    const char *field;
+    unsigned long scan = 0UL;
+    unsigned long step;
+    long expected = -TEST_PRE_PAIRS;
+    long offset;
+    long index;
+    int sar0;
+    int sar1;
+    uint32_t mismatches = 0UL;
+    bool found = false;
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        TEST_CHECK(false, "cannot open %s", path);
+        return;
+    }
+    while ((!found) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        field = strstr(line, " at scan ");
+        if ((0 == strncmp(line, "Event:", 6U)) && (NULL != field))
+        {
+            TEST_CHECK(NULL != strstr(line, "SAR1 window"), "unexpected event: %s", line);
+            found = (1 == sscanf(field, " at scan %lu", &scan));
+        }
+    }
+    TEST_CHECK(found, "no event reported");
+
+    for (step = 1UL; step < test_log_count; step++)
+    {
+        if (test_log_sar[1][step] > (test_log_sar[1][0] + TEST_STEP_COUNTS))
+        {
+            break;
+        }
+    }
+    TEST_CHECK(scan == step, "event at scan %lu, step at scan %lu", scan, step);
+
+    while (found && (expected < TEST_POST_PAIRS) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        if (3 != sscanf(line, "%ld %d %d", &offset, &sar0, &sar1))
+        {
+            continue;
+        }
+        TEST_CHECK(offset == expected, "pair %ld reported as %ld", expected, offset);
+        index = (long)scan + offset;
+        if ((index < 0L) || (index >= (long)test_log_count))
+        {
+            mismatches++;
+        }
+        else if ((sar0 != test_log_sar[0][index]) || (sar1 != test_log_sar[1][index]))
+        {
+            if (0UL == mismatches)
+            {
+                TEST_CHECK(false, "pair %ld is %d %d, logged %d %d", offset, sar0, sar1,
+                           test_log_sar[0][index], test_log_sar[1][index]);
+            }
+            mismatches++;
+        }
+        expected = offset + 1L;
+    }
+    TEST_CHECK(expected == TEST_POST_PAIRS, "%ld of %ld pairs reported", expected + TEST_PRE_PAIRS,
+               TEST_PRE_PAIRS + TEST_POST_PAIRS);
+    TEST_CHECK(0UL == mismatches, "%lu pairs differ from the log", (unsigned long)mismatches);
+
+    (void)fclose(file);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the simulator, then checks its wakeups while the monitor
+* is armed and the event it reports.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Simulator in DMA mode, then the directory of the output files
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    char command[TEST_COMMAND_SIZE];
+    char uart[TEST_LINE_SIZE];
+    char log[TEST_LINE_SIZE];
+    char report[TEST_LINE_SIZE];
+    double rate;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s SIMULATOR DIRECTORY\n", argv[0]);
+        return 2;
+    }
+    test_directory = argv[2];
+
+    (void)snprintf(uart, sizeof(uart), "%s/monitor.uart", test_directory);
+    (void)snprintf(log, sizeof(log), "%s/monitor.sar", test_directory);
+    (void)snprintf(report, sizeof(report), "%s/monitor.json", test_directory);
+    (void)snprintf(command, sizeof(command), "%s %s --uart-out %s --sar-log %s --report %s > /dev/null",
+                   argv[1], TEST_OPTIONS, uart, log, report);
+    if ((0 != system(command)) || (!test_read_log(log)))
+    {
+        TEST_CHECK(false, "%s failed", argv[1]);
+        return TEST_RESULT();
+    }
+
+    rate = test_quiet_rate(report);
+    TEST_CHECK((rate >= 0.0) && (rate <= TEST_MAX_QUIET_RATE), "%.1f wakeups/s while armed", rate);
+
+    test_check_event(uart);
+
+    printf("{\"quiet_wakeups_per_second\":%.1f,\"scans\":%lu}\n", rate, (unsigned long)test_log_count);
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
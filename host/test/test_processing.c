@@ -0,0 +1,281 @@
+/******************************************************************************
+* File Name:   test_processing.c
+*
+* Description: This file contains the host test of the fixed-point
+*              product. It checks the documented error bound of
+*              processing_counts_to_dac_code() exhaustively over all pairs
+*              of 12-bit results, and that processing_block_to_dac() gives
+*              the same codes.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <math.h>
+#include "processing.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Range of the single-ended SAR results */
+#define TEST_MIN_COUNTS     (-2048L)
+#define TEST_MAX_COUNTS     (2047L)
+
+/* Bound of the documented error against the exact product: 0.5 code from
+   the rounding plus 0.01 code from the quantization of the gain */
+#define TEST_EXACT_BOUND    (0.51)
+
+/* Bound of the documented error against the truncated float path */
+#define TEST_FLOAT_BOUND    (1L)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Two points of the counts to microvolts conversion of each SAR */
+typedef struct
+{
+    const char *name;
+    int32_t sar0_uv_zero;
+    int32_t sar0_uv_span;
+    int32_t sar1_uv_zero;
+    int32_t sar1_uv_span;
+} test_calib_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const test_calib_t test_calibs[] = {
+    /* Ideal conversion of the PDL: 3.3 V full scale, truncated to microvolts */
+    { "ideal", 0L, 3298388L, 0L, 3298388L },
+    /* Offset of 5 and -3 counts and gain errors of +0.4 % and -0.3 % */
+    { "trimmed", -8090L, 3303156L, 4819L, 3293297L }
+};
+
+/*******************************************************************************
+* Function Name: test_calib
+********************************************************************************
+* Summary:
+* This function compares the fixed-point product of every pair of results
+* with the exact product of the calibrated voltages, and with the truncated
+* float path it replaced, where that path gives a valid code.
+*
+* Parameters:
+*  test: Calibration to test
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_calib(const test_calib_t *test)
+{
+    product_calib_t calib;
+    double gain0;
+    double gain1;
+    double volts0;
+    double volts1;
+    double exact;
+    double error;
+    double max_error = 0.0;
+    float float_volts0;
+    float float_volts1;
+    int32_t float_code;
+    int32_t code;
+    long counts0;
+    long counts1;
+    unsigned long float_mismatches = 0UL;
+
+    processing_product_calib_init(&calib, test->sar0_uv_zero, test->sar0_uv_span,
+                                  test->sar1_uv_zero, test->sar1_uv_span);
+    gain0 = (double)(test->sar0_uv_span - test->sar0_uv_zero) / (double)CALIB_SPAN_COUNTS * 1.0e-6;
+    gain1 = (double)(test->sar1_uv_span - test->sar1_uv_zero) / (double)CALIB_SPAN_COUNTS * 1.0e-6;
+
+    for (counts0 = TEST_MIN_COUNTS; counts0 <= TEST_MAX_COUNTS; counts0++)
+    {
+        volts0 = (double)(counts0 - calib.offset0) * gain0;
+        float_volts0 = (float)(((double)test->sar0_uv_zero * 1.0e-6) + ((double)counts0 * gain0));
+
+        for (counts1 = TEST_MIN_COUNTS; counts1 <= TEST_MAX_COUNTS; counts1++)
+        {
+            volts1 = (double)(counts1 - calib.offset1) * gain1;
+            code = (int32_t)processing_counts_to_dac_code(&calib, (int16_t)counts0, (int16_t)counts1);
+
+            /* Exact product, saturated like the CTDAC code */
+            exact = volts0 * volts1 * (double)SCALING_FACTOR;
+            exact = fmin(fmax(exact, 0.0), (double)DAC_CODE_MAX);
+            error = fabs((double)code - exact);
+            if (error > max_error)
+            {
+                max_error = error;
+            }
+            TEST_CHECK(error <= TEST_EXACT_BOUND, "%s: %ld x %ld gives %ld, exact %.4f",
+                       test->name, counts0, counts1, (long)code, exact);
+
+            /* Former path: float volts, product, truncation to an int */
+            float_volts1 = (float)(((double)test->sar1_uv_zero * 1.0e-6) + ((double)counts1 * gain1));
+            float_code = (int32_t)(float_volts0 * float_volts1 * (float)SCALING_FACTOR);
+            if ((float_code >= 0L) && (float_code <= (int32_t)DAC_CODE_MAX) &&
+                (labs((long)(code - float_code)) > TEST_FLOAT_BOUND))
+            {
+                float_mismatches++;
+            }
+        }
+    }
+
+    TEST_CHECK(0UL == float_mismatches, "%s: %lu codes differ from the float path by more than %ld",
+               test->name, float_mismatches, TEST_FLOAT_BOUND);
+    printf("%s: offsets %ld %ld, max error %.4f code\n", test->name,
+           (long)calib.offset0, (long)calib.offset1, max_error);
+}
+
+/*******************************************************************************
+* Function Name: test_block
+********************************************************************************
+* Summary:
+* This function checks that the block kernel gives the codes of the pair
+* kernel, for every block length up to 67 pairs so that the unrolled and the
+* remaining pairs are covered.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_block(void)
+{
+    product_calib_t calib;
+    sample_pair_t pairs[67];
+    uint16_t codes[67];
+    uint32_t count;
+    uint32_t index;
+    uint32_t seed = 12345UL;
+
+    processing_product_calib_init(&calib, test_calibs[1].sar0_uv_zero, test_calibs[1].sar0_uv_span,
+                                  test_calibs[1].sar1_uv_zero, test_calibs[1].sar1_uv_span);
+
+    for (index = 0UL; index < 67UL; index++)
+    {
+        seed = (seed * 1103515245UL) + 12345UL;
+        pairs[index].sar0 = (int16_t)((int32_t)((seed >> 8U) & 0xFFFUL) - 2048L);
+        seed = (seed * 1103515245UL) + 12345UL;
+        pairs[index].sar1 = (int16_t)((int32_t)((seed >> 8U) & 0xFFFUL) - 2048L);
+    }
+
+    for (count = 0UL; count <= 67UL; count++)
+    {
+        processing_block_to_dac(&calib, pairs, codes, count);
+        for (index = 0UL; index < count; index++)
+        {
+            TEST_CHECK((uint32_t)codes[index] ==
+                       processing_counts_to_dac_code(&calib, pairs[index].sar0, pairs[index].sar1),
+                       "block of %lu: code %lu differs", (unsigned long)count, (unsigned long)index);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_offsets
+********************************************************************************
+* Summary:
+* This function checks the block kernel against the pair kernel with offsets
+* at and beyond PRODUCT_MAX_OFFSET, up to the 16-bit range, for the extreme
+* results of both SARs. Within the bound, the DSP path subtracts the offsets
+* in 16 bits; beyond it, the kernel must fall back to the pair kernel. The
+* gain keeps the codes of the largest differences below DAC_CODE_MAX, so
+* that a wrapped difference changes the code.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_offsets(void)
+{
+    static const int32_t offsets[] = { PRODUCT_MAX_OFFSET, -PRODUCT_MAX_OFFSET, PRODUCT_MAX_OFFSET + 1L,
+                                       -(PRODUCT_MAX_OFFSET + 1L), 32000L, -32000L, 32767L, -32768L, 0L };
+    static const int16_t results[] = { -2048, -2047, -1, 0, 1, 2046, 2047 };
+    const uint32_t result_count = sizeof(results) / sizeof(results[0]);
+    product_calib_t calib;
+    sample_pair_t pairs[49];
+    uint16_t codes[49];
+    uint32_t offset0;
+    uint32_t offset1;
+    uint32_t index;
+
+    for (index = 0UL; index < (result_count * result_count); index++)
+    {
+        pairs[index].sar0 = results[index / result_count];
+        pairs[index].sar1 = results[index % result_count];
+    }
+
+    calib.gain = 12000LL;
+    for (offset0 = 0UL; offset0 < (sizeof(offsets) / sizeof(offsets[0])); offset0++)
+    {
+        for (offset1 = 0UL; offset1 < (sizeof(offsets) / sizeof(offsets[0])); offset1++)
+        {
+            calib.offset0 = offsets[offset0];
+            calib.offset1 = offsets[offset1];
+            processing_block_to_dac(&calib, pairs, codes, result_count * result_count);
+            for (index = 0UL; index < (result_count * result_count); index++)
+            {
+                TEST_CHECK((uint32_t)codes[index] ==
+                           processing_counts_to_dac_code(&calib, pairs[index].sar0, pairs[index].sar1),
+                           "offsets %ld %ld, results %d %d: code %u differs", (long)calib.offset0,
+                           (long)calib.offset1, pairs[index].sar0, pairs[index].sar1, codes[index]);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < (sizeof(test_calibs) / sizeof(test_calibs[0])); index++)
+    {
+        test_calib(&test_calibs[index]);
+    }
+    test_block();
+    test_offsets();
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,410 @@
+/******************************************************************************
+* File Name:   test_profiles.c
+*
+* Description: This file contains the host test of the acquisition profiles
+*              against the simulator. For every profile, it measures the
+*              noise with the 'n' command on inputs with a known RMS noise
+*              per conversion, and compares the ENOB reported with the ENOB
+*              of the averaging and quantization model of the simulator. It
+*              also runs the profile at its highest reported rate, which
+*              must complete every scan.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of acquisition profiles listed by the firmware */
+#define TEST_PROFILES           (3UL)
+
+/* RMS noise of each conversion, in counts. It is large enough for the
+   averaged results of every profile to dither their quantization. */
+#define TEST_NOISE              (16.0)
+
+/* Tolerance of the ENOB, reported with one decimal */
+#define TEST_ENOB_TOLERANCE     (0.15)
+
+/* Clock of the trigger counter */
+#define TEST_TRIGGER_HZ         (1000000.0)
+
+/* Start and end of the rate measurement, after the first FIFO wakeup at
+   6.4 s has applied the commands */
+#define TEST_RATE_START         (7.0)
+#define TEST_RATE_END           (8.0)
+
+/* Longest options, output line and command line */
+#define TEST_LINE_SIZE          (512)
+#define TEST_COMMAND_SIZE       (2048)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Acquisition profile as listed by the firmware */
+typedef struct
+{
+    char name[16];
+    unsigned long averages;
+    unsigned long max_rate;
+} test_profile_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static test_profile_t test_profiles[TEST_PROFILES];
+
+/* Simulator and directory of its output files */
+static const char *test_simulator;
+static const char *test_directory;
+
+/*******************************************************************************
+* Function Name: test_run
+********************************************************************************
+* Summary:
+* This function runs the simulator with the given options, its UART output
+* and its report written to files of the output directory.
+*
+* Parameters:
+*  name: Base name of the output files
+*  options: Options of the simulator
+*
+* Return:
+*  bool: true if the simulator succeeded
+*
+*******************************************************************************/
+static bool test_run(const char *name, const char *options)
+{
+    char command[TEST_COMMAND_SIZE];
+    int length;
+
+    length = snprintf(command, sizeof(command), "%s %s --uart-out %s/%s.uart --report %s/%s.json > /dev/null",
+                      test_simulator, options, test_directory, name, test_directory, name);
+    if ((length < 0) || ((size_t)length >= sizeof(command)))
+    {
+        return false;
+    }
+
+    return (0 == system(command));
+}
+
+/*******************************************************************************
+* Function Name: test_open
+********************************************************************************
+* Summary:
+* This function opens an output file of the simulator.
+*
+* Parameters:
+*  name: Base name of the output file
+*  extension: "uart" or "json"
+*
+* Return:
+*  FILE *: Open file, NULL on error
+*
+*******************************************************************************/
+static FILE *test_open(const char *name, const char *extension)
+{
+    char path[TEST_LINE_SIZE];
+
+    (void)snprintf(path, sizeof(path), "%s/%s.%s", test_directory, name, extension);
+
+    return fopen(path, "r");
+}
+
+/*******************************************************************************
+* Function Name: test_list
+********************************************************************************
+* Summary:
+* This function reads the list of profiles, printed by the firmware after an
+* unknown profile.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if all profiles were listed
+*
+*******************************************************************************/
+static bool test_list(void)
+{
+    char line[TEST_LINE_SIZE];
+    test_profile_t profile;
+    unsigned long index;
+    unsigned long listed = 0UL;
+    FILE *file;
+
+    if (!test_run("profiles", "--seconds 7 --send 0.1:o9\\\\r"))
+    {
+        return false;
+    }
+
+    file = test_open("profiles", "uart");
+    if (NULL == file)
+    {
+        return false;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        if ((4 == sscanf(line, "o%lu: %15s %lu averages, %*u ns, up to %lu Hz",
+                         &index, profile.name, &profile.averages, &profile.max_rate)) && (index < TEST_PROFILES))
+        {
+            test_profiles[index] = profile;
+            listed |= 1UL << index;
+        }
+    }
+    (void)fclose(file);
+
+    return ((1UL << TEST_PROFILES) - 1UL) == listed;
+}
+
+/*******************************************************************************
+* Function Name: test_enob
+********************************************************************************
+* Summary:
+* This function measures the noise of a profile and compares it with the
+* model of the simulator. Each conversion is rounded to a count, so its
+* variance is the input noise plus 1/12. The averaged result divides it by
+* the number of conversions and adds 1/12 for the truncation of the sum.
+* The firmware adds the quantization noise of the result:
+*
+* ENOB = 12 - log2(sqrt(12 * variance + 1))
+*
+* Parameters:
+*  index: Index of the profile
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_enob(uint32_t index)
+{
+    const test_profile_t *profile = &test_profiles[index];
+    char options[TEST_LINE_SIZE];
+    char name[32];
+    char line[TEST_LINE_SIZE];
+    double variance;
+    double expected;
+    double mean;
+    double rms;
+    double enob;
+    unsigned sar;
+    unsigned measured = 0U;
+    FILE *file;
+
+    variance = (TEST_NOISE * TEST_NOISE) + (1.0 / 12.0);
+    if (profile->averages > 1UL)
+    {
+        variance = (variance / (double)profile->averages) + (1.0 / 12.0);
+    }
+    expected = 12.0 - (0.5 * log2((12.0 * variance) + 1.0));
+
+    /* The commands wait for the first FIFO wakeup, then 1024 scans take
+       about 1 s at 1 kHz */
+    (void)snprintf(name, sizeof(name), "profile%lu_noise", (unsigned long)index);
+    (void)snprintf(options, sizeof(options),
+                   "--seconds 10 --sar0 dc:1.65 --sar1 dc:1.0 --noise %.1f --seed %lu "
+                   "--send 0.1:r1000\\\\r --send 6.5:o%lu\\\\r --send 6.6:n",
+                   TEST_NOISE, (unsigned long)index + 1UL, (unsigned long)index);
+    if (!test_run(name, options) || (NULL == (file = test_open(name, "uart"))))
+    {
+        TEST_CHECK(false, "%s: simulator failed", profile->name);
+        return;
+    }
+
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        if (4 == sscanf(line, "SAR%u noise: mean %lf, rms %lf counts, ENOB %lf", &sar, &mean, &rms, &enob))
+        {
+            measured++;
+            TEST_CHECK(fabs(enob - expected) <= TEST_ENOB_TOLERANCE, "%s: SAR%u ENOB %.1f, model %.2f",
+                       profile->name, sar, enob, expected);
+            TEST_CHECK(fabs(rms - sqrt(variance)) <= (0.1 * sqrt(variance)), "%s: SAR%u rms %.2f, model %.2f",
+                       profile->name, sar, rms, sqrt(variance));
+            printf("{\"profile\":\"%s\",\"averages\":%lu,\"sar\":%u,\"rms\":%.2f,\"enob\":%.1f,\"model_enob\":%.2f}\n",
+                   profile->name, profile->averages, sar, rms, enob, expected);
+        }
+    }
+    (void)fclose(file);
+
+    TEST_CHECK(2U == measured, "%s: %u noise results", profile->name, measured);
+}
+
+/*******************************************************************************
+* Function Name: test_rate
+********************************************************************************
+* Summary:
+* This function runs a profile at the shortest trigger period of its highest
+* reported rate, the TCPWM counter overflowing every period + 1 clocks. The firmware must accept the period, the simulated SARs
+* must complete every scan without losing a trigger, and the scans per
+* second must match the sample rate reported by the firmware.
+*
+* Parameters:
+*  index: Index of the profile
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_rate(uint32_t index)
+{
+    const test_profile_t *profile = &test_profiles[index];
+    unsigned long period = (unsigned long)ceil(TEST_TRIGGER_HZ / (double)profile->max_rate) - 1UL;
+    unsigned long set_period = 0UL;
+    unsigned long reported_rate = 0UL;
+    unsigned long triggers_lost = 1UL;
+    unsigned long scans_start = 0UL;
+    unsigned long scans = 0UL;
+    char options[TEST_LINE_SIZE];
+    char name[32];
+    char line[TEST_LINE_SIZE];
+    char *field;
+    double rate;
+    FILE *file;
+
+    /* The scans from TEST_RATE_START are those of the last run minus those
+       of a run ending at TEST_RATE_START */
+    (void)snprintf(name, sizeof(name), "profile%lu_rate", (unsigned long)index);
+    (void)snprintf(options, sizeof(options), "--seconds %.1f --send 0.1:o%lu\\\\r --send 0.2:r%lu\\\\r",
+                   TEST_RATE_START, (unsigned long)index, period);
+    if (test_run(name, options) && (NULL != (file = test_open(name, "json"))))
+    {
+        if (NULL != fgets(line, sizeof(line), file))
+        {
+            field = strstr(line, "\"scans\":[");
+            if (NULL != field)
+            {
+                (void)sscanf(field, "\"scans\":[%lu", &scans_start);
+            }
+        }
+        (void)fclose(file);
+    }
+
+    (void)snprintf(options, sizeof(options), "--seconds %.1f --send 0.1:o%lu\\\\r --send 0.2:r%lu\\\\r",
+                   TEST_RATE_END, (unsigned long)index, period);
+    if (!test_run(name, options))
+    {
+        TEST_CHECK(false, "%s: simulator failed", profile->name);
+        return;
+    }
+
+    file = test_open(name, "json");
+    if ((NULL != file) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        field = strstr(line, "\"scans\":[");
+        if (NULL != field)
+        {
+            (void)sscanf(field, "\"scans\":[%lu", &scans);
+        }
+        field = strstr(line, "\"triggers_lost\":");
+        if (NULL != field)
+        {
+            (void)sscanf(field, "\"triggers_lost\":%lu", &triggers_lost);
+        }
+    }
+    if (NULL != file)
+    {
+        (void)fclose(file);
+    }
+
+    file = test_open(name, "uart");
+    while ((NULL != file) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        (void)sscanf(line, "Period: %lu clocks (%lu Hz)", &set_period, &reported_rate);
+    }
+    if (NULL != file)
+    {
+        (void)fclose(file);
+    }
+
+    rate = (double)(scans - scans_start) / (TEST_RATE_END - TEST_RATE_START);
+    TEST_CHECK(period == set_period, "%s: period %lu set instead of %lu", profile->name, set_period, period);
+    TEST_CHECK(0UL == triggers_lost, "%s: %lu triggers lost at %lu Hz", profile->name, triggers_lost,
+               profile->max_rate);
+    TEST_CHECK(fabs(rate - (double)reported_rate) <= (0.01 * rate),
+               "%s: %.0f scans per second, %lu Hz reported", profile->name, rate, reported_rate);
+    printf("{\"profile\":\"%s\",\"max_rate\":%lu,\"period\":%lu,\"reported_rate\":%lu,"
+           "\"scans_per_second\":%.0f,\"triggers_lost\":%lu}\n",
+           profile->name, profile->max_rate, period, reported_rate, rate, triggers_lost);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the acquisition profiles.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Simulator in FIFO mode and directory of the output files
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint32_t index;
+
+    if (3 != argc)
+    {
+        fprintf(stderr, "usage: %s SIMULATOR DIRECTORY\n", argv[0]);
+        return 2;
+    }
+    test_simulator = argv[1];
+    test_directory = argv[2];
+
+    TEST_CHECK(test_list(), "the profiles are not listed");
+    if (0UL != test_failures)
+    {
+        return TEST_RESULT();
+    }
+
+    for (index = 0UL; index < TEST_PROFILES; index++)
+    {
+        test_enob(index);
+        test_rate(index);
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,449 @@
+/******************************************************************************
+* File Name:   test_queue.c
+*
+* Description: This file contains the host stress test of the sample queue. A
+*              producer thread stands for the End-Of-Scan interrupt and
+*              the main thread for the main loop: every entry must arrive
+*              complete and in order, and every lost entry must be counted
+*              as an overrun. It prints the throughput and the loss rate of
+*              a steady and of a burst load.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include "sample_queue.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the queue, that of the End-Of-Scan queue of the acquisition */
+#define TEST_QUEUE_SIZE     (ACQ_QUEUE_SIZE)
+
+/* Entries pushed by each stress run */
+#define TEST_ENTRIES        (4000000UL)
+
+/* Most entries removed by one pop, like the main loop */
+#define TEST_POP_COUNT      (16UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Load of a stress run */
+typedef struct
+{
+    const char *name;
+    uint32_t burst;         /* Entries pushed back to back */
+    uint32_t pause;         /* Spins of the producer after each burst */
+    uint32_t work;          /* Spins of the consumer after each pop */
+} test_load_t;
+
+/* State shared by the producer and the consumer */
+typedef struct
+{
+    sample_queue_t queue;
+    const test_load_t *load;
+    volatile bool done;
+    uint32_t pushed;
+} test_run_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const test_load_t test_loads[] = {
+    /* The consumer keeps up with a producer that pauses between entries */
+    { "steady", 1UL, 200UL, 0UL },
+    /* Bursts of several queues of entries into a slower consumer */
+    { "burst", 4UL * TEST_QUEUE_SIZE, 20000UL, 50UL }
+};
+
+/* Storage of the queue */
+static sample_entry_t test_storage[TEST_QUEUE_SIZE];
+
+/*******************************************************************************
+* Function Name: __DMB
+********************************************************************************
+* Summary:
+* This function is the data memory barrier of the queue, which separates
+* the writes of an entry from the publication of its index. Between threads
+* of the host, it must be a full fence.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*******************************************************************************
+* Function Name: sim_assert_failed
+********************************************************************************
+* Summary:
+* This function stops the test on a failed CY_ASSERT().
+*
+* Parameters:
+*  file: Source file of the assertion
+*  line: Line of the assertion
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "%s:%d: assertion failed\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+* Function Name: test_fill
+********************************************************************************
+* Summary:
+* This function fills every field of an entry from its scan index, so that
+* the consumer detects an entry read while it was written.
+*
+* Parameters:
+*  entry: Entry to fill
+*  scan: Scan index
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_fill(sample_entry_t *entry, uint32_t scan)
+{
+    uint32_t channel;
+
+    for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
+    {
+        entry->pairs[channel].sar0 = (int16_t)((scan * 7UL) + channel);
+        entry->pairs[channel].sar1 = (int16_t)(scan ^ channel);
+    }
+    entry->scan = scan;
+    entry->timestamp = (uint64_t)scan * 200001ULL;
+}
+
+/*******************************************************************************
+* Function Name: test_complete
+********************************************************************************
+* Summary:
+* This function checks that an entry holds the fields of its scan index.
+*
+* Parameters:
+*  entry: Entry to check
+*
+* Return:
+*  bool: true if the entry is complete
+*
+*******************************************************************************/
+static bool test_complete(const sample_entry_t *entry)
+{
+    sample_entry_t expected;
+
+    test_fill(&expected, entry->scan);
+
+    return (0 == memcmp(expected.pairs, entry->pairs, sizeof(expected.pairs))) &&
+           (expected.timestamp == entry->timestamp);
+}
+
+/*******************************************************************************
+* Function Name: test_spin
+********************************************************************************
+* Summary:
+* This function waits for a number of iterations without a system call.
+*
+* Parameters:
+*  count: Number of iterations
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_spin(uint32_t count)
+{
+    volatile uint32_t index;
+
+    for (index = 0UL; index < count; index++)
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_producer
+********************************************************************************
+* Summary:
+* This function is the producer thread, which stands for the End-Of-Scan
+* interrupt. It pushes TEST_ENTRIES entries, in bursts, whether or not the
+* queue has room.
+*
+* Parameters:
+*  arg: Run
+*
+* Return:
+*  void *: NULL
+*
+*******************************************************************************/
+static void *test_producer(void *arg)
+{
+    test_run_t *run = (test_run_t *)arg;
+    sample_entry_t entry;
+    uint32_t scan = 0UL;
+    uint32_t burst;
+
+    while (scan < TEST_ENTRIES)
+    {
+        for (burst = 0UL; (burst < run->load->burst) && (scan < TEST_ENTRIES); burst++)
+        {
+            test_fill(&entry, scan);
+            (void)sample_queue_push(&run->queue, &entry);
+            scan++;
+        }
+        test_spin(run->load->pause);
+    }
+
+    run->pushed = scan;
+    __atomic_store_n(&run->done, true, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_stress
+********************************************************************************
+* Summary:
+* This function runs the producer against the consumer of the main thread.
+* Every entry received must be complete and follow the previous one, the
+* entries skipped must add up to the overruns, and the entries received and
+* lost must add up to the entries pushed.
+*
+* Parameters:
+*  load: Load of the run
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_stress(const test_load_t *load)
+{
+    sample_entry_t entries[TEST_POP_COUNT];
+    test_run_t run;
+    pthread_t producer;
+    struct timespec start;
+    struct timespec end;
+    unsigned long received = 0UL;
+    unsigned long skipped = 0UL;
+    unsigned long torn = 0UL;
+    unsigned long disordered = 0UL;
+    uint32_t next_scan = 0UL;
+    uint32_t count;
+    uint32_t index;
+    uint32_t peak = 0UL;
+    double seconds;
+    bool done;
+
+    sample_queue_init(&run.queue, test_storage, TEST_QUEUE_SIZE);
+    run.load = load;
+    run.done = false;
+    run.pushed = 0UL;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    if (0 != pthread_create(&producer, NULL, test_producer, &run))
+    {
+        TEST_CHECK(false, "%s: cannot create the producer", load->name);
+        return;
+    }
+
+    do
+    {
+        /* Read the flag before the queue, so that the last entries are seen */
+        done = __atomic_load_n(&run.done, __ATOMIC_ACQUIRE);
+        if (sample_queue_count(&run.queue) > peak)
+        {
+            peak = sample_queue_count(&run.queue);
+        }
+
+        count = sample_queue_pop(&run.queue, entries, TEST_POP_COUNT);
+        for (index = 0UL; index < count; index++)
+        {
+            if (!test_complete(&entries[index]))
+            {
+                torn++;
+            }
+            if (entries[index].scan < next_scan)
+            {
+                disordered++;
+            }
+            else
+            {
+                skipped += entries[index].scan - next_scan;
+            }
+            next_scan = entries[index].scan + 1UL;
+        }
+        received += count;
+
+        if (0UL == count)
+        {
+            (void)sched_yield();
+        }
+        test_spin(load->work);
+    } while (!done || (0UL != count));
+
+    (void)pthread_join(producer, NULL);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    skipped += run.pushed - next_scan;
+
+    seconds = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) * 1.0e-9);
+    TEST_CHECK(0UL == torn, "%s: %lu entries read while written", load->name, torn);
+    TEST_CHECK(0UL == disordered, "%s: %lu entries out of order", load->name, disordered);
+    TEST_CHECK(skipped == run.queue.overruns, "%s: %lu entries missing, %lu overruns counted",
+               load->name, skipped, (unsigned long)run.queue.overruns);
+    TEST_CHECK((received + run.queue.overruns) == run.pushed, "%s: %lu received and %lu lost of %lu",
+               load->name, received, (unsigned long)run.queue.overruns, (unsigned long)run.pushed);
+    TEST_CHECK(peak <= TEST_QUEUE_SIZE, "%s: %lu entries in a queue of %lu", load->name,
+               (unsigned long)peak, (unsigned long)TEST_QUEUE_SIZE);
+
+    printf("{\"load\":\"%s\",\"entries\":%lu,\"received\":%lu,\"overruns\":%lu,\"loss_rate\":%.6f,"
+           "\"peak_count\":%lu,\"entries_per_second\":%.0f}\n",
+           load->name, (unsigned long)run.pushed, received, (unsigned long)run.queue.overruns,
+           (double)run.queue.overruns / (double)run.pushed, (unsigned long)peak,
+           (double)run.pushed / seconds);
+}
+
+/*******************************************************************************
+* Function Name: test_single
+********************************************************************************
+* Summary:
+* This function checks the queue from one thread: the overrun of a full
+* queue, the order of the entries and the wrap of the free running indices.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_single(void)
+{
+    sample_queue_t queue;
+    sample_entry_t storage[8];
+    sample_entry_t entries[8];
+    sample_entry_t entry;
+    uint32_t scan;
+    uint32_t count;
+    uint32_t index;
+    uint32_t round;
+
+    sample_queue_init(&queue, storage, 8UL);
+    for (scan = 0UL; scan < 8UL; scan++)
+    {
+        test_fill(&entry, scan);
+        TEST_CHECK(sample_queue_push(&queue, &entry), "push %lu into a queue of 8 failed", (unsigned long)scan);
+    }
+    test_fill(&entry, 8UL);
+    TEST_CHECK(!sample_queue_push(&queue, &entry), "push into a full queue succeeded");
+    TEST_CHECK((1UL == queue.overruns) && (8UL == sample_queue_count(&queue)),
+               "%lu overruns and %lu entries after a push into a full queue",
+               (unsigned long)queue.overruns, (unsigned long)sample_queue_count(&queue));
+
+    count = sample_queue_pop(&queue, entries, 3UL);
+    TEST_CHECK((3UL == count) && (0UL == entries[0].scan) && (2UL == entries[2].scan),
+               "pop of 3 entries gave %lu", (unsigned long)count);
+    count = sample_queue_pop(&queue, entries, 8UL);
+    TEST_CHECK((5UL == count) && (3UL == entries[0].scan) && (7UL == entries[4].scan),
+               "pop of the other entries gave %lu", (unsigned long)count);
+    TEST_CHECK(0UL == sample_queue_pop(&queue, entries, 8UL), "pop from an empty queue");
+
+    /* The indices wrap at 32 bits */
+    queue.head = 0xFFFFFFFCUL;
+    queue.tail = 0xFFFFFFFCUL;
+    for (round = 0UL; round < 3UL; round++)
+    {
+        for (index = 0UL; index < 6UL; index++)
+        {
+            test_fill(&entry, (round * 6UL) + index);
+            (void)sample_queue_push(&queue, &entry);
+        }
+        count = sample_queue_pop(&queue, entries, 8UL);
+        for (index = 0UL; index < count; index++)
+        {
+            TEST_CHECK(((round * 6UL) + index) == entries[index].scan, "entry %lu of round %lu is scan %lu",
+                       (unsigned long)index, (unsigned long)round, (unsigned long)entries[index].scan);
+        }
+        TEST_CHECK(6UL == count, "round %lu across the wrap gave %lu entries",
+                   (unsigned long)round, (unsigned long)count);
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the sample queue.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(void)
+{
+    uint32_t load;
+
+    test_single();
+    for (load = 0UL; load < (sizeof(test_loads) / sizeof(test_loads[0])); load++)
+    {
+        test_stress(&test_loads[load]);
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,404 @@
+/******************************************************************************
+* File Name:   test_replay.c
+*
+* Description: This file contains the host test of the record and replay
+*              of binary traces on the simulator. It records the stream of
+*              noisy sine inputs with their CTDAC codes, sends the stream back
+*              after the 'v0' command, and checks that the replay reproduces
+*              every code bit for bit and that the replayed blocks are left
+*              out of the latency profile.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Length of the recording at 100 Hz, after the first wakeup at 0.2 s has
+   applied the period */
+#define TEST_RECORD_OPTIONS     "--seconds 10 --sar0 sine:0.7:1.0:1.5 --sar1 sine:0.3:0.8:1.6 --noise 3 " \
+                                "--send 0.1:r9999\\\\r"
+
+/* The replay starts at the first wakeup at 0.2 s. The trace is sent from
+   0.3 s and takes 0.34 s at 115200 baud; ESC then ends the replay at 0.8 s,
+   followed by the 'p' command. The simulator sends the bytes in the order
+   of the options. The profile is cleared just before the replay, so it
+   only holds the block processed at the first wakeup and the replayed
+   blocks. */
+#define TEST_REPLAY_OPTIONS     "--seconds 1.5 --sar0 dc:0.5 --sar1 dc:0.5 --rx-flow " \
+                                "--send 0.1:cv0\\\\r --input %s/record.uart@0.3 --send 0.8:\\\\ep"
+
+/* Largest number of CTDAC codes of a run */
+#define TEST_MAX_CODES          (4096UL)
+
+/* Smallest number of replayed pairs: the recording keeps up to a telemetry
+   buffer of pairs that the UART had not sent at the end */
+#define TEST_MIN_PAIRS          (800UL)
+
+/* Largest UART output of the replay */
+#define TEST_MAX_OUTPUT         (65536UL)
+
+/* Longest options and command line */
+#define TEST_LINE_SIZE          (512)
+#define TEST_COMMAND_SIZE       (2048)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* CTDAC codes of the recording and of the replay */
+static uint32_t test_record_codes[TEST_MAX_CODES];
+static uint32_t test_replay_codes[TEST_MAX_CODES];
+static uint32_t test_record_count;
+
+/* UART output of the replay, frames and text */
+static char test_output[TEST_MAX_OUTPUT + 1UL];
+static size_t test_output_size;
+
+/* Simulator and directory of its output files */
+static const char *test_simulator;
+static const char *test_directory;
+
+/*******************************************************************************
+* Function Name: test_run
+********************************************************************************
+* Summary:
+* This function runs the simulator with the given options, its UART output
+* and its CTDAC codes written to files of the output directory.
+*
+* Parameters:
+*  name: Base name of the output files
+*  options: Options of the simulator
+*
+* Return:
+*  bool: true if the simulator succeeded
+*
+*******************************************************************************/
+static bool test_run(const char *name, const char *options)
+{
+    char command[TEST_COMMAND_SIZE];
+    int length;
+
+    length = snprintf(command, sizeof(command), "%s %s --uart-out %s/%s.uart --dac-log %s/%s.dac > /dev/null",
+                      test_simulator, options, test_directory, name, test_directory, name);
+    if ((length < 0) || ((size_t)length >= sizeof(command)))
+    {
+        return false;
+    }
+
+    return (0 == system(command));
+}
+
+/*******************************************************************************
+* Function Name: test_open
+********************************************************************************
+* Summary:
+* This function opens an output file of the simulator.
+*
+* Parameters:
+*  name: Base name of the output file
+*  extension: "uart", "dac" or "json"
+*
+* Return:
+*  FILE *: Open file, NULL on error
+*
+*******************************************************************************/
+static FILE *test_open(const char *name, const char *extension)
+{
+    char path[TEST_LINE_SIZE];
+
+    (void)snprintf(path, sizeof(path), "%s/%s.%s", test_directory, name, extension);
+
+    return fopen(path, "rb");
+}
+
+/*******************************************************************************
+* Function Name: test_read_codes
+********************************************************************************
+* Summary:
+* This function reads the CTDAC codes written by a run, in order.
+*
+* Parameters:
+*  name: Base name of the run
+*  codes: Location of TEST_MAX_CODES codes
+*
+* Return:
+*  uint32_t: Number of codes read
+*
+*******************************************************************************/
+static uint32_t test_read_codes(const char *name, uint32_t *codes)
+{
+    unsigned long long time;
+    unsigned long code;
+    uint32_t count = 0UL;
+    FILE *file = test_open(name, "dac");
+
+    if (NULL == file)
+    {
+        return 0UL;
+    }
+    while ((count < TEST_MAX_CODES) && (2 == fscanf(file, "%llu %lu", &time, &code)))
+    {
+        codes[count++] = (uint32_t)code;
+    }
+    (void)fclose(file);
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: test_find
+********************************************************************************
+* Summary:
+* This function finds a line of text in the UART output of the replay. The
+* frames around it may hold zero bytes, so the search does not stop at them.
+*
+* Parameters:
+*  key: Start of the line
+*
+* Return:
+*  const char *: Start of the line, or an empty string if not found
+*
+*******************************************************************************/
+static const char *test_find(const char *key)
+{
+    size_t length = strlen(key);
+    size_t position;
+
+    for (position = 0U; (position + length) <= test_output_size; position++)
+    {
+        if (0 == memcmp(&test_output[position], key, length))
+        {
+            return &test_output[position];
+        }
+    }
+
+    return "";
+}
+
+/*******************************************************************************
+* Function Name: test_longest_match
+********************************************************************************
+* Summary:
+* This function finds the longest run of replayed codes that repeats the
+* recorded codes from the first one.
+*
+* Parameters:
+*  recorded: Number of recorded codes
+*  replayed: Number of codes of the replay run
+*
+* Return:
+*  uint32_t: Number of recorded codes reproduced in order
+*
+*******************************************************************************/
+static uint32_t test_longest_match(uint32_t recorded, uint32_t replayed)
+{
+    uint32_t longest = 0UL;
+    uint32_t start;
+    uint32_t length;
+
+    for (start = 0UL; start < replayed; start++)
+    {
+        length = 0UL;
+        while (((start + length) < replayed) && (length < recorded) &&
+               (test_replay_codes[start + length] == test_record_codes[length]))
+        {
+            length++;
+        }
+        if (length > longest)
+        {
+            longest = length;
+        }
+    }
+
+    return longest;
+}
+
+/*******************************************************************************
+* Function Name: test_replay_file
+********************************************************************************
+* Summary:
+* This function replays the recorded trace from its file with the host
+* driver, without the simulator, and compares its CTDAC codes with the
+* recording.
+*
+* Parameters:
+*  driver: Host driver of the replay
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_replay_file(const char *driver)
+{
+    char command[TEST_COMMAND_SIZE];
+    char summary[TEST_LINE_SIZE] = "";
+    unsigned long frames = 0UL;
+    unsigned long pairs = 0UL;
+    unsigned long crc_errors = 1UL;
+    unsigned long gaps = 1UL;
+    unsigned long overflows = 1UL;
+    uint32_t replayed;
+    uint32_t matched;
+    FILE *file;
+
+    (void)snprintf(command, sizeof(command), "%s --dac %s/file.dac %s/record.uart > %s/file.json", driver,
+                   test_directory, test_directory, test_directory);
+    if (0 != system(command))
+    {
+        TEST_CHECK(false, "%s failed", driver);
+        return;
+    }
+    file = test_open("file", "json");
+    if (NULL != file)
+    {
+        if (NULL == fgets(summary, sizeof(summary), file))
+        {
+            summary[0] = '\0';
+        }
+        (void)fclose(file);
+    }
+    (void)sscanf(summary, "{\"bytes\":%*u,\"frames\":%lu,\"pairs\":%lu,\"crc_errors\":%lu,\"sequence_gaps\":%lu,"
+                 "\"overflows\":%lu", &frames, &pairs, &crc_errors, &gaps, &overflows);
+
+    replayed = test_read_codes("file", test_replay_codes);
+    matched = test_longest_match(test_record_count, replayed);
+
+    TEST_CHECK(pairs >= TEST_MIN_PAIRS, "%lu pairs replayed from the file", pairs);
+    TEST_CHECK((0UL == crc_errors) && (0UL == gaps) && (0UL == overflows),
+               "%lu CRC errors, %lu sequence gaps, %lu pairs overflowed in the file replay", crc_errors, gaps,
+               overflows);
+    TEST_CHECK((replayed == pairs) && (matched == pairs), "%lu of %lu codes of the file replay match the recording",
+               (unsigned long)matched, pairs);
+
+    printf("{\"file_frames\":%lu,\"file_pairs\":%lu,\"file_matched_codes\":%lu}\n", frames, pairs,
+           (unsigned long)matched);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function records a trace, replays it, and compares the CTDAC codes
+* and the profile of both runs. With the host driver of the replay, it also
+* replays the trace from its file.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Simulator with the binary telemetry, directory of the output files
+*        and optionally the host driver of the replay
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    char options[TEST_LINE_SIZE];
+    unsigned long pairs = 0UL;
+    unsigned long frames = 0UL;
+    unsigned long crc_errors = 1UL;
+    unsigned long missing = 1UL;
+    unsigned long overflows = 1UL;
+    unsigned long eos_to_read = 1UL;
+    unsigned long eos_to_dac = 1UL;
+    unsigned long sample = 0UL;
+    uint32_t recorded;
+    uint32_t replayed;
+    uint32_t matched;
+    FILE *file;
+
+    if ((3 != argc) && (4 != argc))
+    {
+        fprintf(stderr, "usage: %s SIMULATOR DIRECTORY [REPLAY_FILE]\n", argv[0]);
+        return 2;
+    }
+    test_simulator = argv[1];
+    test_directory = argv[2];
+
+    (void)snprintf(options, sizeof(options), TEST_REPLAY_OPTIONS, test_directory);
+    if (!test_run("record", TEST_RECORD_OPTIONS) || !test_run("replay", options))
+    {
+        TEST_CHECK(false, "simulator failed");
+        return TEST_RESULT();
+    }
+
+    /* The replay reports its counters as text between the frames it sends */
+    file = test_open("replay", "uart");
+    if (NULL != file)
+    {
+        test_output_size = fread(test_output, 1U, TEST_MAX_OUTPUT, file);
+        (void)fclose(file);
+    }
+    (void)sscanf(test_find("Replay: "), "Replay: %lu pairs, %lu frames, %lu CRC errors, %lu missing, %lu overflows",
+                 &pairs, &frames, &crc_errors, &missing, &overflows);
+    (void)sscanf(test_find("eos_to_read "), "eos_to_read n=%lu", &eos_to_read);
+    (void)sscanf(test_find("eos_to_dac "), "eos_to_dac n=%lu", &eos_to_dac);
+    (void)sscanf(test_find("sample "), "sample n=%lu", &sample);
+
+    recorded = test_read_codes("record", test_record_codes);
+    test_record_count = recorded;
+    replayed = test_read_codes("replay", test_replay_codes);
+    matched = test_longest_match(recorded, replayed);
+
+    TEST_CHECK(pairs >= TEST_MIN_PAIRS, "%lu pairs replayed", pairs);
+    TEST_CHECK((0UL == crc_errors) && (0UL == missing) && (0UL == overflows),
+               "%lu CRC errors, %lu frames missing, %lu pairs overflowed", crc_errors, missing, overflows);
+    TEST_CHECK(matched == pairs, "%lu of %lu replayed codes match the recording", (unsigned long)matched, pairs);
+
+    /* Only the block of the first wakeup, before the replay, has a latency */
+    TEST_CHECK(eos_to_read <= 1UL, "%lu End-Of-Scan to read latencies profiled", eos_to_read);
+    TEST_CHECK(eos_to_dac <= 1UL, "%lu End-Of-Scan to CTDAC latencies profiled", eos_to_dac);
+    TEST_CHECK(sample > eos_to_read, "%lu blocks profiled", sample);
+
+    printf("{\"recorded_codes\":%lu,\"replayed_pairs\":%lu,\"frames\":%lu,\"matched_codes\":%lu,"
+           "\"eos_to_read\":%lu,\"eos_to_dac\":%lu,\"sample\":%lu}\n",
+           (unsigned long)recorded, pairs, frames, (unsigned long)matched, eos_to_read, eos_to_dac, sample);
+
+    if (4 == argc)
+    {
+        test_replay_file(argv[3]);
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,461 @@
+/******************************************************************************
+* File Name:   test_spectrum.c
+*
+* Description: This file contains the host test of the spectrum analysis. It
+*              feeds sines with harmonics and noise, different on each input,
+*              and compares the magnitude of every bin, the fundamental,
+*              the THD, the SNR and the SINAD of the fixed-point analysis
+*              with a double-precision reference that windows and transforms
+*              the same samples by a direct DFT.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "spectrum.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Amplitude of a full scale sine wave in counts */
+#define TEST_FULL_SCALE         (2048.0)
+
+/* Largest errors against the reference: the magnitude of a bin, relative to
+   full scale and to the bin, the fundamental in bins, its amplitude in dB,
+   and the ratios in dB */
+#define TEST_BIN_FLOOR          (1.0e-6)
+#define TEST_BIN_RELATIVE       (1.0e-3)
+#define TEST_FREQUENCY_ERROR    (1.0e-3)
+#define TEST_AMPLITUDE_ERROR    (0.01)
+#define TEST_RATIO_ERROR        (0.1)
+
+/* Largest error of the reference amplitude against the applied one, in dB */
+#define TEST_APPLIED_ERROR      (0.05)
+
+#define TEST_PI                 (3.14159265358979323846)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Test signal of one input: a fundamental in cycles per block and dBFS,
+   one harmonic in dB relative to it, and Gaussian noise in counts RMS */
+typedef struct
+{
+    double cycles;
+    double amplitude;
+    uint32_t harmonic;
+    double harmonic_level;
+    double noise;
+} test_signal_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sample_pair_t test_pairs[SPECTRUM_MAX_POINTS];
+
+/* Windowed input and magnitudes of the reference, in fractions of full scale */
+static double test_windowed[SPECTRUM_MAX_POINTS];
+static double test_magnitude[2][SPECTRUM_MAX_POINTS / 2UL];
+static double test_cos[SPECTRUM_MAX_POINTS];
+static double test_sin[SPECTRUM_MAX_POINTS];
+
+/* Bins of the reference assigned to a tone */
+static bool test_used[SPECTRUM_MAX_POINTS / 2UL];
+
+/* Mean and mean square of the window */
+static double test_window_gain;
+static double test_window_power;
+
+static uint32_t test_seed = 1UL;
+
+/*******************************************************************************
+* Function Name: test_gaussian
+********************************************************************************
+* Summary:
+* This function returns a Gaussian random number by the Box-Muller method.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  double: Random number with a mean of 0 and a standard deviation of 1
+*
+*******************************************************************************/
+static double test_gaussian(void)
+{
+    double u1;
+    double u2;
+
+    test_seed = (test_seed * 1103515245UL) + 12345UL;
+    u1 = ((double)(test_seed >> 8U) + 1.0) / 16777217.0;
+    test_seed = (test_seed * 1103515245UL) + 12345UL;
+    u2 = (double)(test_seed >> 8U) / 16777216.0;
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * TEST_PI * u2);
+}
+
+/*******************************************************************************
+* Function Name: test_sample
+********************************************************************************
+* Summary:
+* This function calculates one SAR result of a test signal, rounded and
+* clipped to 12 bits.
+*
+* Parameters:
+*  signal: Test signal
+*  points: Number of points of the block
+*  index: Index of the sample in the block
+*
+* Return:
+*  int16_t: SAR result
+*
+*******************************************************************************/
+static int16_t test_sample(const test_signal_t *signal, uint32_t points, uint32_t index)
+{
+    double phase = (2.0 * TEST_PI * signal->cycles * (double)index) / (double)points;
+    double amplitude = TEST_FULL_SCALE * pow(10.0, signal->amplitude / 20.0);
+    double value;
+
+    value = amplitude * (sin(phase) + (pow(10.0, signal->harmonic_level / 20.0) * sin(phase * (double)signal->harmonic)))
+            + (signal->noise * test_gaussian());
+    value = round(value);
+
+    return (int16_t)((value > 2047.0) ? 2047.0 : ((value < -2048.0) ? -2048.0 : value));
+}
+
+/*******************************************************************************
+* Function Name: test_reference_bins
+********************************************************************************
+* Summary:
+* This function calculates the reference magnitudes of one input: the mean
+* is removed, the 4-term Blackman-Harris window applied, and each bin below
+* N / 2 calculated by a direct DFT in double precision. The magnitudes are
+* those of sines in fractions of full scale, like the dBFS of
+* spectrum_get_magnitude().
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  points: Number of points
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_reference_bins(uint32_t sar, uint32_t points)
+{
+    double mean = 0.0;
+    double window;
+    double re;
+    double im;
+    double angle;
+    uint32_t index;
+    uint32_t bin;
+
+    for (index = 0UL; index < points; index++)
+    {
+        mean += (0UL == sar) ? test_pairs[index].sar0 : test_pairs[index].sar1;
+        test_cos[index] = cos((2.0 * TEST_PI * (double)index) / (double)points);
+        test_sin[index] = sin((2.0 * TEST_PI * (double)index) / (double)points);
+    }
+    mean /= (double)points;
+
+    test_window_gain = 0.0;
+    test_window_power = 0.0;
+    for (index = 0UL; index < points; index++)
+    {
+        angle = (2.0 * TEST_PI * (double)index) / (double)points;
+        window = 0.35875 - (0.48829 * cos(angle)) + (0.14128 * cos(2.0 * angle)) - (0.01168 * cos(3.0 * angle));
+        test_window_gain += window;
+        test_window_power += window * window;
+        test_windowed[index] = (((0UL == sar) ? test_pairs[index].sar0 : test_pairs[index].sar1) - mean) * window;
+    }
+    test_window_gain /= (double)points;
+    test_window_power /= (double)points;
+
+    for (bin = 0UL; bin < (points / 2UL); bin++)
+    {
+        re = 0.0;
+        im = 0.0;
+        for (index = 0UL; index < points; index++)
+        {
+            re += test_windowed[index] * test_cos[(bin * index) % points];
+            im -= test_windowed[index] * test_sin[(bin * index) % points];
+        }
+        test_magnitude[sar][bin] = (2.0 * sqrt((re * re) + (im * im))) / ((double)points * test_window_gain * TEST_FULL_SCALE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_take_lobe
+********************************************************************************
+* Summary:
+* This function adds the power of the free reference bins within
+* SPECTRUM_LOBE_BINS of a tone and above DC, and marks them as used.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  points: Number of points
+*  center: Bin of the tone
+*  moment: If not NULL, receives the sum of the bin times its power
+*
+* Return:
+*  double: Power of the tone
+*
+*******************************************************************************/
+static double test_take_lobe(uint32_t sar, uint32_t points, int32_t center, double *moment)
+{
+    int32_t bin;
+    double power;
+    double sum = 0.0;
+
+    for (bin = center - (int32_t)SPECTRUM_LOBE_BINS; bin <= (center + (int32_t)SPECTRUM_LOBE_BINS); bin++)
+    {
+        if ((bin >= (int32_t)SPECTRUM_DC_BINS) && (bin < (int32_t)(points / 2UL)) && !test_used[bin])
+        {
+            test_used[bin] = true;
+            power = test_magnitude[sar][bin] * test_magnitude[sar][bin];
+            sum += power;
+            if (NULL != moment)
+            {
+                *moment += (double)bin * power;
+            }
+        }
+    }
+
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: test_reference_analysis
+********************************************************************************
+* Summary:
+* This function derives the fundamental, the THD, the SNR and the SINAD from
+* the reference magnitudes, with the definitions of spectrum.h: the tones
+* take the bins of their main lobe, and the power of the other bins above
+* DC, extended to all of them, is noise.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  points: Number of points
+*  input: Analysis to fill
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_reference_analysis(uint32_t sar, uint32_t points, spectrum_input_t *input)
+{
+    uint32_t bins = points / 2UL;
+    uint32_t bin;
+    uint32_t peak_bin = SPECTRUM_DC_BINS;
+    uint32_t harmonic;
+    uint32_t noise_bins = 0UL;
+    double moment = 0.0;
+    double signal;
+    double distortion = 0.0;
+    double noise = 0.0;
+    double folded;
+
+    (void)memset(test_used, 0, sizeof(test_used));
+    for (bin = SPECTRUM_DC_BINS; bin < bins; bin++)
+    {
+        if (test_magnitude[sar][bin] > test_magnitude[sar][peak_bin])
+        {
+            peak_bin = bin;
+        }
+    }
+
+    signal = test_take_lobe(sar, points, (int32_t)peak_bin, &moment);
+    input->frequency = (float)(moment / signal);
+
+    for (harmonic = 2UL; harmonic <= SPECTRUM_HARMONICS; harmonic++)
+    {
+        folded = fmod((double)input->frequency * (double)harmonic, (double)points);
+        if (folded > (double)bins)
+        {
+            folded = (double)points - folded;
+        }
+        distortion += test_take_lobe(sar, points, (int32_t)lround(folded), NULL);
+    }
+
+    for (bin = SPECTRUM_DC_BINS; bin < bins; bin++)
+    {
+        if (!test_used[bin])
+        {
+            noise += test_magnitude[sar][bin] * test_magnitude[sar][bin];
+            noise_bins++;
+        }
+    }
+    noise *= (double)(bins - SPECTRUM_DC_BINS) / (double)noise_bins;
+
+    /* The magnitudes are scaled by the mean of the window: the power of the
+       lobe is the squared amplitude times the mean square of the window over
+       its squared mean */
+    input->amplitude = (float)(10.0 * log10((signal * test_window_gain * test_window_gain) / test_window_power));
+    input->thd = (float)(10.0 * log10(distortion / signal));
+    input->snr = (float)(10.0 * log10(signal / noise));
+    input->sinad = (float)(10.0 * log10(signal / (noise + distortion)));
+}
+
+/*******************************************************************************
+* Function Name: test_compare
+********************************************************************************
+* Summary:
+* This function analyzes a block of two test signals with the spectrum
+* module and with the reference, and compares the bins and the results.
+*
+* Parameters:
+*  points: Number of points
+*  signal0: Signal of SAR0
+*  signal1: Signal of SAR1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_compare(uint32_t points, const test_signal_t *signal0, const test_signal_t *signal1)
+{
+    const test_signal_t *signals[2] = { signal0, signal1 };
+    spectrum_result_t result;
+    spectrum_input_t reference;
+    uint32_t index;
+    uint32_t sar;
+    uint32_t bin;
+    uint32_t bin_errors = 0UL;
+    double magnitude;
+    double worst = 0.0;
+
+    for (index = 0UL; index < points; index++)
+    {
+        test_pairs[index].sar0 = test_sample(signal0, points, index);
+        test_pairs[index].sar1 = test_sample(signal1, points, index);
+    }
+
+    TEST_CHECK(spectrum_start(points), "%lu points refused", (unsigned long)points);
+    for (index = 0UL; index < points; index += 100UL)
+    {
+        spectrum_process(&test_pairs[index], ((points - index) < 100UL) ? (points - index) : 100UL);
+    }
+    TEST_CHECK(spectrum_get_result(&result), "no result for %lu points", (unsigned long)points);
+    TEST_CHECK((points / 2UL) == spectrum_get_bins(), "%lu bins for %lu points",
+               (unsigned long)spectrum_get_bins(), (unsigned long)points);
+
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        test_reference_bins(sar, points);
+
+        for (bin = 0UL; bin < (points / 2UL); bin++)
+        {
+            magnitude = pow(10.0, (double)spectrum_get_magnitude(sar, bin) / 20.0);
+            if (fabs(magnitude - test_magnitude[sar][bin]) > (TEST_BIN_FLOOR + (TEST_BIN_RELATIVE * test_magnitude[sar][bin])))
+            {
+                bin_errors++;
+            }
+            worst = fmax(worst, fabs(magnitude - test_magnitude[sar][bin]));
+        }
+
+        test_reference_analysis(sar, points, &reference);
+        TEST_CHECK(fabs((double)(result.sar[sar].frequency - reference.frequency)) <= TEST_FREQUENCY_ERROR,
+                   "%lu points, SAR%lu: fundamental %.4f, reference %.4f", (unsigned long)points,
+                   (unsigned long)sar, (double)result.sar[sar].frequency, (double)reference.frequency);
+        TEST_CHECK(fabs((double)(result.sar[sar].amplitude - reference.amplitude)) <= TEST_AMPLITUDE_ERROR,
+                   "%lu points, SAR%lu: amplitude %.3f dBFS, reference %.3f", (unsigned long)points,
+                   (unsigned long)sar, (double)result.sar[sar].amplitude, (double)reference.amplitude);
+        TEST_CHECK(fabs((double)reference.amplitude - signals[sar]->amplitude) <= TEST_APPLIED_ERROR,
+                   "%lu points, SAR%lu: reference amplitude %.3f dBFS, applied %.3f", (unsigned long)points,
+                   (unsigned long)sar, (double)reference.amplitude, signals[sar]->amplitude);
+        TEST_CHECK(fabs((double)(result.sar[sar].thd - reference.thd)) <= TEST_RATIO_ERROR,
+                   "%lu points, SAR%lu: THD %.2f dB, reference %.2f", (unsigned long)points,
+                   (unsigned long)sar, (double)result.sar[sar].thd, (double)reference.thd);
+        TEST_CHECK(fabs((double)(result.sar[sar].snr - reference.snr)) <= TEST_RATIO_ERROR,
+                   "%lu points, SAR%lu: SNR %.2f dB, reference %.2f", (unsigned long)points,
+                   (unsigned long)sar, (double)result.sar[sar].snr, (double)reference.snr);
+        TEST_CHECK(fabs((double)(result.sar[sar].sinad - reference.sinad)) <= TEST_RATIO_ERROR,
+                   "%lu points, SAR%lu: SINAD %.2f dB, reference %.2f", (unsigned long)points,
+                   (unsigned long)sar, (double)result.sar[sar].sinad, (double)reference.sinad);
+
+        printf("{\"points\":%lu,\"sar\":%lu,\"frequency\":%.4f,\"amplitude\":%.3f,\"thd\":%.2f,"
+               "\"snr\":%.2f,\"sinad\":%.2f,\"reference\":{\"frequency\":%.4f,\"amplitude\":%.3f,"
+               "\"thd\":%.2f,\"snr\":%.2f,\"sinad\":%.2f}}\n",
+               (unsigned long)points, (unsigned long)sar, (double)result.sar[sar].frequency,
+               (double)result.sar[sar].amplitude, (double)result.sar[sar].thd, (double)result.sar[sar].snr,
+               (double)result.sar[sar].sinad, (double)reference.frequency, (double)reference.amplitude,
+               (double)reference.thd, (double)reference.snr, (double)reference.sinad);
+    }
+
+    TEST_CHECK(0UL == bin_errors, "%lu points: %lu bins differ from the reference, by up to %.2e of full scale",
+               (unsigned long)points, (unsigned long)bin_errors, worst);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the spectrum analysis.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(void)
+{
+    static const uint32_t points[] = { SPECTRUM_MIN_POINTS, 1024UL, SPECTRUM_MAX_POINTS };
+    uint32_t index;
+    test_signal_t signal0;
+    test_signal_t signal1;
+
+    fft_init();
+
+    for (index = 0UL; index < (sizeof(points) / sizeof(points[0])); index++)
+    {
+        /* SAR0 near full scale with a third harmonic, SAR1 lower with a
+           second harmonic and more noise, both between bins */
+        signal0 = (test_signal_t){ (double)points[index] * 0.0371, -1.0, 3UL, -60.0, 0.5 };
+        signal1 = (test_signal_t){ (double)points[index] * 0.1113, -12.0, 2UL, -50.0, 3.0 };
+        test_compare(points[index], &signal0, &signal1);
+    }
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,407 @@
+/******************************************************************************
+* File Name:   test_stream.c
+*
+* Description: This file contains the host test of the sample stream
+*              framing. It checks the CRC against its check value, the
+*              packing of every pair of 12-bit results, the frame header
+*              and sequence numbers, the layout of the time record, and when
+*              time records are sent.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sample_stream.h"
+#include "crc16.h"
+#include "telemetry.h"
+#include "test.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Check value of CRC-16/CCITT-FALSE, the CRC of "123456789" */
+#define TEST_CRC_CHECK      (0x29B1U)
+
+/* Number of 12-bit results */
+#define TEST_RESULTS        (4096L)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Last frame written by the stream */
+static uint8_t test_frame[STREAM_HEADER_SIZE + (255UL * STREAM_PAIR_SIZE) + STREAM_CRC_SIZE];
+static uint32_t test_frame_length = 0UL;
+
+/* Number of frames written, and whether the telemetry accepts them */
+static uint32_t test_frames = 0UL;
+static bool test_accept = true;
+
+/* Number of time records written */
+static uint32_t test_time_records = 0UL;
+
+/*******************************************************************************
+* Function Name: telemetry_write
+********************************************************************************
+* Summary:
+* This function replaces the telemetry output of the stream. It keeps the
+* last frame for the checks.
+*
+* Parameters:
+*  data: Frame
+*  length: Length of the frame
+*
+* Return:
+*  bool: True if the frame is accepted
+*
+*******************************************************************************/
+bool telemetry_write(const uint8_t *data, uint32_t length)
+{
+    if (length <= sizeof(test_frame))
+    {
+        (void)memcpy(test_frame, data, length);
+        test_frame_length = length;
+    }
+    if ((length > 2UL) && (STREAM_FRAME_TIME == data[2]))
+    {
+        test_time_records++;
+    }
+    test_frames++;
+
+    return test_accept;
+}
+
+/*******************************************************************************
+* Function Name: test_frame_valid
+********************************************************************************
+* Summary:
+* This function checks the sync bytes, the type, the length and the CRC of
+* the last frame.
+*
+* Parameters:
+*  type: Expected frame type
+*  payload: Expected length of the payload in bytes
+*
+* Return:
+*  bool: True if the frame is valid
+*
+*******************************************************************************/
+static bool test_frame_valid(uint8_t type, uint32_t payload)
+{
+    uint16_t crc;
+
+    if ((STREAM_HEADER_SIZE + payload + STREAM_CRC_SIZE) != test_frame_length)
+    {
+        return false;
+    }
+
+    crc = crc16_update(CRC16_INIT, &test_frame[2], STREAM_HEADER_SIZE + payload - 2UL);
+
+    return (STREAM_SYNC0 == test_frame[0]) && (STREAM_SYNC1 == test_frame[1]) && (type == test_frame[2]) &&
+           ((uint8_t)crc == test_frame[test_frame_length - 2UL]) &&
+           ((uint8_t)(crc >> 8U) == test_frame[test_frame_length - 1UL]);
+}
+
+/*******************************************************************************
+* Function Name: test_sequence
+********************************************************************************
+* Summary:
+* This function returns the sequence number of the last frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint16_t: Sequence number
+*
+*******************************************************************************/
+static uint16_t test_sequence(void)
+{
+    return (uint16_t)test_frame[3] | ((uint16_t)test_frame[4] << 8U);
+}
+
+/*******************************************************************************
+* Function Name: test_crc
+********************************************************************************
+* Summary:
+* This function checks the CRC against its published check value, also when
+* the data is added in two parts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_crc(void)
+{
+    static const uint8_t check[] = "123456789";
+    uint16_t crc;
+
+    crc = crc16_update(CRC16_INIT, check, 9UL);
+    TEST_CHECK(TEST_CRC_CHECK == crc, "CRC of \"123456789\" is 0x%04X", (unsigned)crc);
+
+    crc = crc16_update(crc16_update(CRC16_INIT, check, 4UL), &check[4], 5UL);
+    TEST_CHECK(TEST_CRC_CHECK == crc, "CRC in two parts is 0x%04X", (unsigned)crc);
+}
+
+/*******************************************************************************
+* Function Name: test_packing
+********************************************************************************
+* Summary:
+* This function sends every pair of 12-bit results through the stream and
+* checks that each frame is valid, that the sequence numbers increment and
+* that the frames unpack to the pairs that were sent. It also checks the
+* bytes of one pair against the documented layout.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_packing(void)
+{
+    sample_pair_t pairs[STREAM_FRAME_PAIRS];
+    sample_pair_t unpacked[STREAM_FRAME_PAIRS];
+    unsigned long mismatches = 0UL;
+    unsigned long invalid = 0UL;
+    uint32_t frames = test_frames;
+    uint16_t sequence = 0U;
+    uint32_t count = 0UL;
+    long sar0;
+    long sar1;
+
+    for (sar0 = -TEST_RESULTS / 2L; sar0 < (TEST_RESULTS / 2L); sar0++)
+    {
+        for (sar1 = -TEST_RESULTS / 2L; sar1 < (TEST_RESULTS / 2L); sar1++)
+        {
+            pairs[count].sar0 = (int16_t)sar0;
+            pairs[count].sar1 = (int16_t)sar1;
+            count++;
+            sample_stream_put(&pairs[count - 1UL], 1UL);
+            if (STREAM_FRAME_PAIRS != count)
+            {
+                continue;
+            }
+
+            if (!test_frame_valid(STREAM_FRAME_SAMPLES, STREAM_FRAME_PAIRS * STREAM_PAIR_SIZE) ||
+                (STREAM_FRAME_PAIRS != test_frame[5]) ||
+                ((frames != test_frames) && (test_sequence() != sequence)))
+            {
+                invalid++;
+            }
+            sample_stream_unpack(&test_frame[STREAM_HEADER_SIZE], STREAM_FRAME_PAIRS, unpacked);
+            if (0 != memcmp(pairs, unpacked, sizeof(pairs)))
+            {
+                mismatches++;
+            }
+            sequence = (uint16_t)(test_sequence() + 1U);
+            frames = test_frames;
+            count = 0UL;
+        }
+    }
+    TEST_CHECK(0UL == invalid, "%lu invalid frames", invalid);
+    TEST_CHECK(0UL == mismatches, "%lu frames unpack to other pairs", mismatches);
+
+    /* sar0 = 0x7FF and sar1 = -2048 = 0x800 */
+    pairs[0].sar0 = 2047;
+    pairs[0].sar1 = -2048;
+    sample_stream_put(pairs, 1UL);
+    sample_stream_flush();
+    TEST_CHECK(test_frame_valid(STREAM_FRAME_SAMPLES, STREAM_PAIR_SIZE) && (1U == test_frame[5]),
+               "flushed frame of one pair is invalid");
+    TEST_CHECK((0xFFU == test_frame[6]) && (0x07U == test_frame[7]) && (0x80U == test_frame[8]),
+               "pair packed as %02X %02X %02X", test_frame[6], test_frame[7], test_frame[8]);
+
+    /* An empty frame is not sent */
+    frames = test_frames;
+    sample_stream_flush();
+    TEST_CHECK(frames == test_frames, "empty frame sent");
+}
+
+/*******************************************************************************
+* Function Name: test_records
+********************************************************************************
+* Summary:
+* This function checks the layout of the time record, that the pairs
+* collected before it are sent first, the rejection of a
+* record longer than STREAM_MAX_RECORD, and that the sequence number also
+* counts the frames the telemetry drops.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_records(void)
+{
+    static const uint8_t expected[STREAM_TIME_RECORD_SIZE] = {
+        0x05U, 0x00U, 0x00U, 0x01U,
+        0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+        0x41U, 0x0DU, 0x03U, 0x00U
+    };
+    uint8_t record[STREAM_MAX_RECORD + 1UL];
+    sample_pair_t pairs[5];
+    uint32_t frames;
+    uint16_t sequence;
+
+    /* After the 2^24 + 1 pairs of test_packing(), the next pair is 2^24 + 5 */
+    (void)memset(pairs, 0, sizeof(pairs));
+    sample_stream_put(pairs, 4UL);
+    frames = test_frames;
+    sample_stream_send_time(0x0123456789ABCDEFULL, 200001UL);
+    TEST_CHECK((frames + 2UL) == test_frames, "pairs before the time record not sent first");
+    TEST_CHECK(test_frame_valid(STREAM_FRAME_TIME, STREAM_TIME_RECORD_SIZE) &&
+               (STREAM_TIME_RECORD_SIZE == test_frame[5]), "time frame is invalid");
+    TEST_CHECK(0 == memcmp(&test_frame[STREAM_HEADER_SIZE], expected, STREAM_TIME_RECORD_SIZE),
+               "time record does not match its layout");
+
+    /* A record that does not fit is not sent */
+    frames = test_frames;
+    (void)memset(record, 0, sizeof(record));
+    sample_stream_send(STREAM_FRAME_EVENT, record, STREAM_MAX_RECORD + 1UL);
+    TEST_CHECK(frames == test_frames, "record longer than STREAM_MAX_RECORD sent");
+
+    /* The sequence number counts the frames the telemetry drops */
+    sequence = test_sequence();
+    test_accept = false;
+    sample_stream_send(STREAM_FRAME_EVENT, record, 1UL);
+    test_accept = true;
+    sample_stream_send(STREAM_FRAME_EVENT, record, 1UL);
+    TEST_CHECK((uint16_t)(sequence + 2U) == test_sequence(), "sequence %u after %u and a dropped frame",
+               (unsigned)test_sequence(), (unsigned)sequence);
+}
+
+/*******************************************************************************
+* Function Name: test_timed
+********************************************************************************
+* Summary:
+* This function checks that timed sample pairs are preceded by a time record
+* only when they do not continue the pairs of the previous one: at the
+* start, after a missed trigger, a change of the interval, untimed pairs, or
+* a dropped frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void test_timed(void)
+{
+    sample_pair_t pairs[40];
+    uint32_t records;
+    uint64_t time = 1000000ULL;
+    uint32_t block;
+
+    (void)memset(pairs, 0, sizeof(pairs));
+
+    /* The start of the stream and 100 consecutive blocks */
+    records = test_time_records;
+    for (block = 0UL; block < 100UL; block++)
+    {
+        sample_stream_put_timed(pairs, 40UL, time, 200UL);
+        time += 40UL * 200UL;
+    }
+    TEST_CHECK((records + 1UL) == test_time_records, "%lu time records for consecutive blocks",
+               (unsigned long)(test_time_records - records));
+
+    /* A missed trigger */
+    records = test_time_records;
+    time += 200UL;
+    sample_stream_put_timed(pairs, 40UL, time, 200UL);
+    time += 40UL * 200UL;
+    TEST_CHECK((records + 1UL) == test_time_records, "no time record after a missed trigger");
+
+    /* A change of the interval, such as the decimation, at the expected time */
+    records = test_time_records;
+    sample_stream_put_timed(pairs, 40UL, time, 1600UL);
+    time += 40UL * 1600UL;
+    TEST_CHECK((records + 1UL) == test_time_records, "no time record after a change of the interval");
+
+    /* Pairs without a time, such as a capture of the event monitor */
+    records = test_time_records;
+    sample_stream_put(pairs, 10UL);
+    sample_stream_put_timed(pairs, 40UL, time, 1600UL);
+    time += 40UL * 1600UL;
+    TEST_CHECK((records + 1UL) == test_time_records, "no time record after untimed pairs");
+
+    /* A dropped frame */
+    records = test_time_records;
+    test_accept = false;
+    sample_stream_put_timed(pairs, 40UL, time, 1600UL);
+    time += 40UL * 1600UL;
+    test_accept = true;
+    sample_stream_put_timed(pairs, 40UL, time, 1600UL);
+    time += 40UL * 1600UL;
+    TEST_CHECK((records + 1UL) == test_time_records, "no time record after a dropped frame");
+    sample_stream_put_timed(pairs, 40UL, time, 1600UL);
+    TEST_CHECK((records + 1UL) == test_time_records, "time record after the resynchronization");
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function runs the tests of the sample stream.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int: EXIT_SUCCESS if all checks pass
+*
+*******************************************************************************/
+int main(void)
+{
+    test_crc();
+    test_packing();
+    test_records();
+    test_timed();
+
+    printf("stream: %lu frames\n", (unsigned long)test_frames);
+
+    return TEST_RESULT();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,373 @@
+/******************************************************************************
+* File Name:   capture_read.c
+*
+* Description: This file contains the Linux tool that reads a capture file. It
+*              prints a JSON summary of the chunks, and optionally writes
+*              a range of sample pairs, selected by index or by time, or a
+*              downsampled view of the range as CSV.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "capture_reader.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Default trigger clock of the chunk times, the 1 MHz TCPWM clock */
+#define READ_CLOCK_HZ       (1000000.0)
+
+/*******************************************************************************
+* Function Name: read_usage
+********************************************************************************
+* Summary:
+* This function prints the options of the tool.
+*
+* Parameters:
+*  name: Name of the executable
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void read_usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] FILE\n"
+            "Indexes the chunks of the capture FILE and prints a JSON summary.\n"
+            "  --pairs FIRST:COUNT     select COUNT pairs from index FIRST\n"
+            "  --time START:END        select the pairs from START to before END seconds\n"
+            "  --view BINS             reduce the selection to BINS bins of equal time\n"
+            "  --csv FILE              write the selection as index,seconds,sar0,sar1, or the\n"
+            "                          view as seconds,pairs,sar0_min,sar0_max,sar1_min,sar1_max\n"
+            "  --clock HZ              trigger clock of the chunk times (1000000)\n",
+            name);
+}
+
+/*******************************************************************************
+* Function Name: read_seconds
+********************************************************************************
+* Summary:
+* This function returns the time elapsed since a start time.
+*
+* Parameters:
+*  start: Start time, from CLOCK_MONOTONIC
+*
+* Return:
+*  double: Elapsed time in seconds
+*
+*******************************************************************************/
+static double read_seconds(const struct timespec *start)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)(now.tv_sec - start->tv_sec) + ((double)(now.tv_nsec - start->tv_nsec) * 1.0e-9);
+}
+
+/*******************************************************************************
+* Function Name: read_pairs
+********************************************************************************
+* Summary:
+* This function writes the pairs of a range as CSV.
+*
+* Parameters:
+*  reader: Reader
+*  range: Query of the pairs
+*  clock_hz: Trigger clock
+*  csv: Output, or NULL to only read the pairs
+*  spans: Location to store the number of chunks read
+*
+* Return:
+*  unsigned long long: Number of pairs
+*
+*******************************************************************************/
+static unsigned long long read_pairs(capture_reader_t *reader, capture_range_t *range, double clock_hz, FILE *csv,
+                                     uint32_t *spans)
+{
+    capture_span_t span;
+    unsigned long long pairs = 0ULL;
+    uint32_t pair;
+
+    *spans = 0UL;
+    while (capture_reader_next(reader, range, &span))
+    {
+        for (pair = 0UL; (NULL != csv) && (pair < span.count); pair++)
+        {
+            fprintf(csv, "%llu,%.6f,%d,%d\n", (unsigned long long)(span.index + pair),
+                    (double)(span.time + ((uint64_t)pair * span.interval)) / clock_hz,
+                    span.sar0[pair], span.sar1[pair]);
+        }
+        pairs += span.count;
+        (*spans)++;
+    }
+
+    return pairs;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function indexes the capture, runs the query of the command line,
+* and prints the summary with the time taken by each step. The exit status
+* is 1 when the capture holds no chunk and 2 on a usage or I/O error.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Arguments, see read_usage()
+*
+* Return:
+*  int: Exit status
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    capture_reader_t reader;
+    capture_range_t range;
+    capture_bin_t *view = NULL;
+    const capture_chunk_t *last;
+    const char *input_name = NULL;
+    const char *csv_name = NULL;
+    FILE *csv = NULL;
+    double clock_hz = READ_CLOCK_HZ;
+    double time_start = 0.0;
+    double time_end = 0.0;
+    double index_seconds;
+    double query_seconds;
+    unsigned long long first = 0ULL;
+    unsigned long long count = 0ULL;
+    unsigned long long selected = 0ULL;
+    uint64_t first_time = 0ULL;
+    uint64_t last_time = 0ULL;
+    uint64_t start;
+    uint64_t end;
+    uint64_t delta_chunks = 0ULL;
+    int16_t min[2] = { 0, 0 };
+    int16_t max[2] = { 0, 0 };
+    bool by_index = false;
+    bool by_time = false;
+    uint32_t bins = 0UL;
+    uint32_t chunks_read = 0UL;
+    uint32_t number;
+    uint32_t bin;
+    uint32_t sar;
+    struct timespec clock_start;
+    char *text_end;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--pairs")) && ((arg + 1) < argc) &&
+            (2 == sscanf(argv[arg + 1], "%llu:%llu", &first, &count)))
+        {
+            by_index = true;
+            arg++;
+        }
+        else if ((0 == strcmp(argv[arg], "--time")) && ((arg + 1) < argc) &&
+                 (2 == sscanf(argv[arg + 1], "%lf:%lf", &time_start, &time_end)) &&
+                 (time_start >= 0.0) && (time_end > time_start))
+        {
+            by_time = true;
+            arg++;
+        }
+        else if ((0 == strcmp(argv[arg], "--view")) && ((arg + 1) < argc))
+        {
+            bins = (uint32_t)strtoul(argv[++arg], &text_end, 0);
+            if (('\0' != *text_end) || (0UL == bins))
+            {
+                read_usage(argv[0]);
+                return 2;
+            }
+        }
+        else if ((0 == strcmp(argv[arg], "--csv")) && ((arg + 1) < argc))
+        {
+            csv_name = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--clock")) && ((arg + 1) < argc))
+        {
+            clock_hz = strtod(argv[++arg], NULL);
+        }
+        else if (('-' != argv[arg][0]) && (NULL == input_name))
+        {
+            input_name = argv[arg];
+        }
+        else
+        {
+            read_usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((NULL == input_name) || (by_index && by_time) || (by_index && (0UL != bins)))
+    {
+        read_usage(argv[0]);
+        return 2;
+    }
+    if (clock_hz <= 0.0)
+    {
+        clock_hz = READ_CLOCK_HZ;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &clock_start);
+    if (!capture_reader_open(&reader, input_name))
+    {
+        perror(input_name);
+        return 2;
+    }
+    index_seconds = read_seconds(&clock_start);
+
+    if (NULL != csv_name)
+    {
+        csv = fopen(csv_name, "w");
+        if (NULL == csv)
+        {
+            perror(csv_name);
+            capture_reader_close(&reader);
+            return 2;
+        }
+    }
+
+    /* The range of each SAR comes from the chunk headers alone */
+    for (number = 0UL; number < reader.chunk_count; number++)
+    {
+        for (sar = 0UL; sar < 2UL; sar++)
+        {
+            if ((0UL == number) || (reader.chunks[number].min[sar] < min[sar]))
+            {
+                min[sar] = reader.chunks[number].min[sar];
+            }
+            if ((0UL == number) || (reader.chunks[number].max[sar] > max[sar]))
+            {
+                max[sar] = reader.chunks[number].max[sar];
+            }
+        }
+        delta_chunks += reader.chunks[number].delta ? 1ULL : 0ULL;
+    }
+
+    /* Without --time, the view covers the whole capture */
+    if (0UL != reader.chunk_count)
+    {
+        last = &reader.chunks[reader.chunk_count - 1UL];
+        first_time = reader.chunks[0].time;
+        last_time = last->time + ((uint64_t)(last->count - 1UL) * last->interval);
+    }
+    start = first_time;
+    end = last_time + 1ULL;
+    if (by_time)
+    {
+        start = (uint64_t)(time_start * clock_hz);
+        end = (uint64_t)(time_end * clock_hz);
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &clock_start);
+    if (0UL != bins)
+    {
+        view = calloc(bins, sizeof(capture_bin_t));
+        if (NULL == view)
+        {
+            fprintf(stderr, "capture_read: %s\n", strerror(ENOMEM));
+            capture_reader_close(&reader);
+            return 2;
+        }
+        chunks_read = capture_reader_view(&reader, start, end, bins, view);
+        for (bin = 0UL; bin < bins; bin++)
+        {
+            selected += view[bin].pairs;
+        }
+    }
+    else
+    {
+        if (by_index)
+        {
+            capture_reader_range_index(&reader, first, count, &range);
+        }
+        else
+        {
+            capture_reader_range_time(&reader, start, end, &range);
+        }
+        if (NULL != csv)
+        {
+            fprintf(csv, "index,seconds,sar0,sar1\n");
+        }
+        selected = read_pairs(&reader, &range, clock_hz, csv, &chunks_read);
+    }
+    query_seconds = read_seconds(&clock_start);
+
+    if (NULL != csv)
+    {
+        if (NULL != view)
+        {
+            fprintf(csv, "seconds,pairs,sar0_min,sar0_max,sar1_min,sar1_max\n");
+            for (bin = 0UL; bin < bins; bin++)
+            {
+                fprintf(csv, "%.6f,%llu,%d,%d,%d,%d\n",
+                        (double)(start + (((end - start) * bin) / bins)) / clock_hz,
+                        (unsigned long long)view[bin].pairs, view[bin].min[0], view[bin].max[0],
+                        view[bin].min[1], view[bin].max[1]);
+            }
+        }
+        (void)fclose(csv);
+    }
+
+    printf("{\"bytes\":%llu,\"chunks\":%lu,\"delta_chunks\":%llu,\"pairs\":%llu,\"pairs_missed\":%llu,"
+           "\"crc_errors\":%llu,\"skipped_bytes\":%llu,\"first_seconds\":%.6f,\"last_seconds\":%.6f,"
+           "\"sar0\":{\"min\":%d,\"max\":%d},\"sar1\":{\"min\":%d,\"max\":%d},"
+           "\"selected_pairs\":%llu,\"chunks_read\":%lu,\"index_ms\":%.3f,\"query_ms\":%.3f}\n",
+           (unsigned long long)reader.size, (unsigned long)reader.chunk_count,
+           (unsigned long long)delta_chunks, (unsigned long long)reader.pairs,
+           (unsigned long long)reader.pairs_missed, (unsigned long long)reader.crc_errors,
+           (unsigned long long)reader.skipped_bytes, (double)first_time / clock_hz,
+           (double)last_time / clock_hz,
+           min[0], max[0], min[1], max[1], selected, (unsigned long)chunks_read,
+           index_seconds * 1.0e3, query_seconds * 1.0e3);
+
+    free(view);
+    number = reader.chunk_count;
+    capture_reader_close(&reader);
+
+    return (0UL != number) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,761 @@
+/******************************************************************************
+* File Name:   capture_reader.c
+*
+* Description: This file contains the host reader of the chunked capture
+*              format. It maps a capture file, indexes its chunks, returns
+*              ranges of sample pairs in place when their columns are not
+*              delta coded, and reduces ranges to the smallest and largest
+*              results per bin for plotting, from the chunk headers where
+*              a chunk lies within a bin.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "capture.h"
+#include "crc16.h"
+#include "capture_reader.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Most pairs of a chunk, from the 16-bit count of the header */
+#define READER_MAX_PAIRS    (65535UL)
+
+/* The int16 columns are used in place on a little-endian host */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define READER_IN_PLACE     (1U)
+#else
+#define READER_IN_PLACE     (0U)
+#endif
+
+/*******************************************************************************
+* Function Name: reader_le
+********************************************************************************
+* Summary:
+* This function reads a little-endian field of up to 8 bytes.
+*
+* Parameters:
+*  data: First byte of the field
+*  size: Size of the field in bytes
+*
+* Return:
+*  uint64_t: Value of the field
+*
+*******************************************************************************/
+static uint64_t reader_le(const uint8_t *data, uint32_t size)
+{
+    uint64_t value = 0ULL;
+
+    while (size > 0UL)
+    {
+        size--;
+        value = (value << 8U) | data[size];
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: reader_parse
+********************************************************************************
+* Summary:
+* This function checks whether the bytes at an offset start a valid chunk
+* and reads its header. The length of the columns must agree with the
+* number of pairs and the coding, so that decoding a column never reads
+* past the chunk.
+*
+* Parameters:
+*  reader: Reader
+*  offset: Offset of the magic in the capture
+*  chunk: Location to store the header, with the index as sent
+*
+* Return:
+*  uint32_t: Size of the chunk, 0 if the bytes do not start a valid chunk
+*
+*******************************************************************************/
+static uint32_t reader_parse(capture_reader_t *reader, size_t offset, capture_chunk_t *chunk)
+{
+    const uint8_t *data = &reader->data[offset];
+    size_t left = reader->size - offset;
+    uint64_t length;
+    uint32_t sar;
+
+    if ((left < (CAPTURE_HEADER_SIZE + CAPTURE_CRC_SIZE)) ||
+        (CAPTURE_MAGIC0 != data[0]) || (CAPTURE_MAGIC1 != data[1]) ||
+        (CAPTURE_MAGIC2 != data[2]) || (CAPTURE_MAGIC3 != data[3]) ||
+        (CAPTURE_VERSION != data[4]))
+    {
+        return 0UL;
+    }
+
+    length = reader_le(&data[32], 4UL);
+    if (length > (left - CAPTURE_HEADER_SIZE - CAPTURE_CRC_SIZE))
+    {
+        return 0UL;
+    }
+    if (crc16_update(CRC16_INIT, &data[4], (uint32_t)(CAPTURE_HEADER_SIZE - 4UL + length)) !=
+        (uint16_t)reader_le(&data[CAPTURE_HEADER_SIZE + length], CAPTURE_CRC_SIZE))
+    {
+        reader->crc_errors++;
+        return 0UL;
+    }
+
+    chunk->count = (uint32_t)reader_le(&data[6], 2UL);
+    chunk->index = reader_le(&data[8], 4UL);
+    chunk->time = reader_le(&data[12], 8UL);
+    chunk->interval = (uint32_t)reader_le(&data[20], 4UL);
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        chunk->min[sar] = (int16_t)reader_le(&data[24UL + (sar * 4UL)], 2UL);
+        chunk->max[sar] = (int16_t)reader_le(&data[26UL + (sar * 4UL)], 2UL);
+    }
+    chunk->delta = (0U != (data[5] & CAPTURE_FLAG_DELTA));
+    chunk->columns = &data[CAPTURE_HEADER_SIZE];
+    chunk->length = (uint32_t)length;
+
+    /* A delta column takes 1 to 3 bytes per result after the first */
+    if ((0UL == chunk->count) ||
+        ((!chunk->delta) && (length != (chunk->count * 4ULL))) ||
+        (chunk->delta && ((length < (2ULL * (chunk->count + 1ULL))) ||
+                          (length > (2ULL * ((3ULL * chunk->count) - 1ULL))))))
+    {
+        return 0UL;
+    }
+
+    return (uint32_t)(CAPTURE_HEADER_SIZE + length + CAPTURE_CRC_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: reader_decode_column
+********************************************************************************
+* Summary:
+* This function decodes a delta coded column.
+*
+* Parameters:
+*  data: First byte of the column
+*  left: Bytes of the chunk from the column on
+*  count: Number of results
+*  column: Location to store the results
+*
+* Return:
+*  uint32_t: Size of the column in bytes, 0 if it runs past the chunk
+*
+*******************************************************************************/
+static uint32_t reader_decode_column(const uint8_t *data, uint32_t left, uint32_t count, int16_t *column)
+{
+    uint32_t size = 2UL;
+    uint32_t index;
+
+    column[0] = (int16_t)reader_le(data, 2UL);
+    for (index = 1UL; index < count; index++)
+    {
+        if (size >= left)
+        {
+            return 0UL;
+        }
+        if (CAPTURE_DELTA_ESCAPE != data[size])
+        {
+            column[index] = (int16_t)(column[index - 1UL] + (int8_t)data[size]);
+            size++;
+        }
+        else
+        {
+            if ((size + 3UL) > left)
+            {
+                return 0UL;
+            }
+            column[index] = (int16_t)reader_le(&data[size + 1UL], 2UL);
+            size += 3UL;
+        }
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+* Function Name: reader_columns
+********************************************************************************
+* Summary:
+* This function returns the results of a chunk. The int16 columns are
+* returned in place when they are aligned in the capture; delta coded or
+* unaligned columns are decoded into the buffer of the reader, which holds
+* one chunk.
+*
+* Parameters:
+*  reader: Reader
+*  number: Chunk
+*  sar0: Location to store the SAR0 results
+*  sar1: Location to store the SAR1 results
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void reader_columns(capture_reader_t *reader, uint32_t number, const int16_t **sar0, const int16_t **sar1)
+{
+    const capture_chunk_t *chunk = &reader->chunks[number];
+    uint32_t used;
+    uint32_t index;
+
+    if ((!chunk->delta) && (0U != READER_IN_PLACE) && (0U == ((uintptr_t)chunk->columns % sizeof(int16_t))))
+    {
+        *sar0 = (const int16_t *)(const void *)chunk->columns;
+        *sar1 = &(*sar0)[chunk->count];
+        return;
+    }
+
+    if (number != reader->decoded)
+    {
+        if (chunk->delta)
+        {
+            used = reader_decode_column(chunk->columns, chunk->length, chunk->count, reader->column[0]);
+            if ((0UL == used) ||
+                (0UL == reader_decode_column(&chunk->columns[used], chunk->length - used, chunk->count,
+                                             reader->column[1])))
+            {
+                /* Cannot happen for a chunk coded by capture.c */
+                (void)memset(reader->column[0], 0, chunk->count * sizeof(int16_t));
+                (void)memset(reader->column[1], 0, chunk->count * sizeof(int16_t));
+            }
+        }
+        else
+        {
+            for (index = 0UL; index < chunk->count; index++)
+            {
+                reader->column[0][index] = (int16_t)reader_le(&chunk->columns[index * 2UL], 2UL);
+                reader->column[1][index] =
+                    (int16_t)reader_le(&chunk->columns[(chunk->count + index) * 2UL], 2UL);
+            }
+        }
+        reader->decoded = number;
+    }
+
+    *sar0 = reader->column[0];
+    *sar1 = reader->column[1];
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_load
+********************************************************************************
+* Summary:
+* This function indexes the chunks of a capture in memory. The bytes that
+* do not start a valid chunk are skipped one at a time, as a text response
+* or a damaged chunk may sit between two chunks. The 32-bit index of each
+* chunk is extended from the previous chunk, and the pairs missing between
+* the chunks are counted.
+*
+* Parameters:
+*  reader: Reader to initialize
+*  data: Bytes of the capture
+*  size: Number of bytes
+*
+* Return:
+*  bool: False if the memory for the index cannot be allocated
+*
+*******************************************************************************/
+bool capture_reader_load(capture_reader_t *reader, const uint8_t *data, size_t size)
+{
+    capture_chunk_t chunk;
+    capture_chunk_t *previous;
+    capture_chunk_t *chunks;
+    uint32_t capacity = 0UL;
+    uint32_t chunk_size;
+    uint64_t next;
+    int32_t missed;
+    size_t offset = 0U;
+
+    (void)memset(reader, 0, sizeof(*reader));
+    reader->data = data;
+    reader->size = size;
+    reader->column[0] = malloc(READER_MAX_PAIRS * sizeof(int16_t));
+    reader->column[1] = malloc(READER_MAX_PAIRS * sizeof(int16_t));
+    if ((NULL == reader->column[0]) || (NULL == reader->column[1]))
+    {
+        capture_reader_close(reader);
+        return false;
+    }
+
+    while (offset < size)
+    {
+        chunk_size = reader_parse(reader, offset, &chunk);
+        if (0UL == chunk_size)
+        {
+            reader->skipped_bytes++;
+            offset++;
+            continue;
+        }
+
+        if (reader->chunk_count == capacity)
+        {
+            capacity = (0UL == capacity) ? 1024UL : (capacity * 2UL);
+            chunks = realloc(reader->chunks, capacity * sizeof(capture_chunk_t));
+            if (NULL == chunks)
+            {
+                capture_reader_close(reader);
+                return false;
+            }
+            reader->chunks = chunks;
+        }
+
+        /* The index of a chunk wraps at 32 bits */
+        if (0UL != reader->chunk_count)
+        {
+            previous = &reader->chunks[reader->chunk_count - 1UL];
+            next = previous->index + previous->count;
+            missed = (int32_t)((uint32_t)chunk.index - (uint32_t)next);
+            if (missed > 0L)
+            {
+                reader->pairs_missed += (uint64_t)missed;
+            }
+            chunk.index = (uint64_t)((int64_t)next + missed);
+        }
+
+        reader->chunks[reader->chunk_count] = chunk;
+        reader->chunk_count++;
+        reader->pairs += chunk.count;
+        offset += chunk_size;
+    }
+    reader->decoded = reader->chunk_count;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_open
+********************************************************************************
+* Summary:
+* This function maps a capture file read-only and indexes its chunks. Only
+* the headers are read; the columns are read when a query returns them.
+*
+* Parameters:
+*  reader: Reader to initialize
+*  path: Capture file
+*
+* Return:
+*  bool: False if the file cannot be mapped or indexed, with errno set
+*
+*******************************************************************************/
+bool capture_reader_open(capture_reader_t *reader, const char *path)
+{
+    struct stat status;
+    void *data = NULL;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    if (0 != fstat(file, &status))
+    {
+        (void)close(file);
+        return false;
+    }
+    if (status.st_size > 0)
+    {
+        data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (MAP_FAILED == data)
+        {
+            (void)close(file);
+            return false;
+        }
+    }
+    (void)close(file);
+
+    if (!capture_reader_load(reader, data, (size_t)status.st_size))
+    {
+        if (NULL != data)
+        {
+            (void)munmap(data, (size_t)status.st_size);
+        }
+        return false;
+    }
+    reader->mapped = (NULL != data);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_close
+********************************************************************************
+* Summary:
+* This function frees the index and the decoding buffers, and unmaps the
+* capture file. The spans returned by the reader are no longer valid.
+*
+* Parameters:
+*  reader: Reader
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void capture_reader_close(capture_reader_t *reader)
+{
+    if (reader->mapped)
+    {
+        (void)munmap((void *)(uintptr_t)reader->data, reader->size);
+    }
+    free(reader->chunks);
+    free(reader->column[0]);
+    free(reader->column[1]);
+    (void)memset(reader, 0, sizeof(*reader));
+}
+
+/*******************************************************************************
+* Function Name: reader_find_index
+********************************************************************************
+* Summary:
+* This function finds, by binary search, the first chunk that ends after a
+* pair. The indexes of the chunks increase through the capture.
+*
+* Parameters:
+*  reader: Reader
+*  index: Index of the pair
+*
+* Return:
+*  uint32_t: Chunk, chunk_count if all chunks end before the pair
+*
+*******************************************************************************/
+static uint32_t reader_find_index(const capture_reader_t *reader, uint64_t index)
+{
+    uint32_t low = 0UL;
+    uint32_t high = reader->chunk_count;
+    uint32_t middle;
+
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2UL);
+        if ((reader->chunks[middle].index + reader->chunks[middle].count) <= index)
+        {
+            low = middle + 1UL;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/*******************************************************************************
+* Function Name: reader_time_to_index
+********************************************************************************
+* Summary:
+* This function finds the first pair triggered at or after a time. The
+* chunks are found by binary search on the time of their last pair, which
+* increases through the capture.
+*
+* Parameters:
+*  reader: Reader
+*  time: Trigger time
+*
+* Return:
+*  uint64_t: Index of the pair, after the last pair if none is that late
+*
+*******************************************************************************/
+static uint64_t reader_time_to_index(const capture_reader_t *reader, uint64_t time)
+{
+    const capture_chunk_t *chunk;
+    uint32_t low = 0UL;
+    uint32_t high = reader->chunk_count;
+    uint32_t middle;
+    uint64_t pair;
+
+    while (low < high)
+    {
+        middle = low + ((high - low) / 2UL);
+        chunk = &reader->chunks[middle];
+        if ((chunk->time + ((uint64_t)(chunk->count - 1UL) * chunk->interval)) < time)
+        {
+            low = middle + 1UL;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low == reader->chunk_count)
+    {
+        chunk = &reader->chunks[reader->chunk_count - 1UL];
+        return chunk->index + chunk->count;
+    }
+
+    chunk = &reader->chunks[low];
+    pair = 0ULL;
+    if ((time > chunk->time) && (0UL != chunk->interval))
+    {
+        pair = ((time - chunk->time) + chunk->interval - 1ULL) / chunk->interval;
+    }
+
+    return chunk->index + pair;
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_range_index
+********************************************************************************
+* Summary:
+* This function starts a query of the pairs with indexes from first to
+* first + count - 1. The pairs missing from the capture are left out.
+*
+* Parameters:
+*  reader: Reader
+*  first: Index of the first pair
+*  count: Number of pairs
+*  range: Query to initialize, for capture_reader_next()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void capture_reader_range_index(capture_reader_t *reader, uint64_t first, uint64_t count,
+                                capture_range_t *range)
+{
+    range->chunk = reader_find_index(reader, first);
+    range->next = first;
+    range->end = ((UINT64_MAX - first) < count) ? UINT64_MAX : (first + count);
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_range_time
+********************************************************************************
+* Summary:
+* This function starts a query of the pairs triggered from start to before
+* end, in trigger clocks.
+*
+* Parameters:
+*  reader: Reader
+*  start: Trigger time of the first pair
+*  end: Trigger time after the last pair
+*  range: Query to initialize, for capture_reader_next()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void capture_reader_range_time(capture_reader_t *reader, uint64_t start, uint64_t end,
+                               capture_range_t *range)
+{
+    uint64_t first = 0ULL;
+    uint64_t last = 0ULL;
+
+    if ((0UL != reader->chunk_count) && (start < end))
+    {
+        first = reader_time_to_index(reader, start);
+        last = reader_time_to_index(reader, end);
+    }
+    range->chunk = reader_find_index(reader, first);
+    range->next = first;
+    range->end = last;
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_next
+********************************************************************************
+* Summary:
+* This function returns the pairs of a range held by the next chunk. The
+* results of a chunk without delta coding point into the mapped file; the
+* others are decoded, and are valid until the next call.
+*
+* Parameters:
+*  reader: Reader
+*  range: Query started by capture_reader_range_index() or _time()
+*  span: Location to store the pairs
+*
+* Return:
+*  bool: False when the range has no more pairs
+*
+*******************************************************************************/
+bool capture_reader_next(capture_reader_t *reader, capture_range_t *range, capture_span_t *span)
+{
+    const capture_chunk_t *chunk;
+    const int16_t *sar0;
+    const int16_t *sar1;
+    uint64_t first;
+    uint64_t end;
+
+    if ((range->chunk >= reader->chunk_count) || (range->next >= range->end))
+    {
+        return false;
+    }
+
+    chunk = &reader->chunks[range->chunk];
+    first = (range->next > chunk->index) ? range->next : chunk->index;
+    end = chunk->index + chunk->count;
+    if (end > range->end)
+    {
+        end = range->end;
+    }
+    if (first >= end)
+    {
+        range->next = range->end;
+        return false;
+    }
+
+    reader_columns(reader, range->chunk, &sar0, &sar1);
+    span->index = first;
+    span->time = chunk->time + ((first - chunk->index) * chunk->interval);
+    span->interval = chunk->interval;
+    span->count = (uint32_t)(end - first);
+    span->sar0 = &sar0[first - chunk->index];
+    span->sar1 = &sar1[first - chunk->index];
+
+    range->chunk++;
+    range->next = end;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: reader_bin_add
+********************************************************************************
+* Summary:
+* This function adds the smallest and largest results of some pairs to a
+* bin of a view.
+*
+* Parameters:
+*  bin: Bin
+*  pairs: Number of pairs
+*  min: Smallest result of SAR0 and SAR1
+*  max: Largest result of SAR0 and SAR1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void reader_bin_add(capture_bin_t *bin, uint64_t pairs, const int16_t *min, const int16_t *max)
+{
+    uint32_t sar;
+
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        if ((0ULL == bin->pairs) || (min[sar] < bin->min[sar]))
+        {
+            bin->min[sar] = min[sar];
+        }
+        if ((0ULL == bin->pairs) || (max[sar] > bin->max[sar]))
+        {
+            bin->max[sar] = max[sar];
+        }
+    }
+    bin->pairs += pairs;
+}
+
+/*******************************************************************************
+* Function Name: capture_reader_view
+********************************************************************************
+* Summary:
+* This function reduces the pairs triggered from start to before end to the
+* smallest and largest results of each SAR in bins of equal time, for a
+* plot of a long capture. A chunk whose pairs all fall in one bin adds the
+* range in its header, without reading its columns; only the chunks across
+* a bin boundary or the ends of the view are decoded. Bin b covers the
+* times from start + b * (end - start) / bins.
+*
+* Parameters:
+*  reader: Reader
+*  start: Trigger time of the first bin
+*  end: Trigger time after the last bin
+*  bins: Number of bins
+*  view: Location to store the bins
+*
+* Return:
+*  uint32_t: Number of chunks whose columns were read
+*
+*******************************************************************************/
+uint32_t capture_reader_view(capture_reader_t *reader, uint64_t start, uint64_t end,
+                             uint32_t bins, capture_bin_t *view)
+{
+    const capture_chunk_t *chunk;
+    capture_range_t range;
+    capture_span_t span;
+    int16_t value[2];
+    uint64_t span_end;
+    uint64_t first;
+    uint64_t last;
+    uint64_t duration = end - start;
+    uint32_t read = 0UL;
+    uint32_t pair;
+
+    (void)memset(view, 0, bins * sizeof(capture_bin_t));
+    if ((0UL == bins) || (start >= end))
+    {
+        return 0UL;
+    }
+
+    capture_reader_range_time(reader, start, end, &range);
+    while ((range.chunk < reader->chunk_count) && (range.next < range.end))
+    {
+        chunk = &reader->chunks[range.chunk];
+        span_end = chunk->index + chunk->count;
+        first = chunk->time;
+        last = chunk->time + ((uint64_t)(chunk->count - 1UL) * chunk->interval);
+
+        if ((range.next <= chunk->index) && (span_end <= range.end) &&
+            ((((first - start) * bins) / duration) == (((last - start) * bins) / duration)))
+        {
+            reader_bin_add(&view[((first - start) * bins) / duration], chunk->count, chunk->min, chunk->max);
+            range.chunk++;
+            range.next = span_end;
+            continue;
+        }
+
+        if (!capture_reader_next(reader, &range, &span))
+        {
+            break;
+        }
+        read++;
+        for (pair = 0UL; pair < span.count; pair++)
+        {
+            value[0] = span.sar0[pair];
+            value[1] = span.sar1[pair];
+            reader_bin_add(&view[(((span.time + ((uint64_t)pair * span.interval)) - start) * bins) / duration],
+                           1ULL, value, value);
+        }
+    }
+
+    return read;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name:   capture_reader.h
+*
+* Description: This file contains the declarations of the host reader of the
+*              chunked capture format. A capture file is mapped in memory
+*              and indexed by chunk, so that ranges of sample pairs are found
+*              by index or by trigger time without reading the whole file.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CAPTURE_READER_H_
+#define CAPTURE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* A chunk of the capture, from its header */
+typedef struct
+{
+    uint64_t index;             /* Index of the first pair, without the 32-bit wrap */
+    uint64_t time;              /* Trigger time of the first pair, in trigger clocks */
+    uint32_t interval;          /* Trigger clocks between two pairs */
+    uint32_t count;             /* Number of pairs */
+    int16_t min[2];             /* Smallest result of SAR0 and SAR1 */
+    int16_t max[2];             /* Largest result of SAR0 and SAR1 */
+    bool delta;                 /* Columns are delta coded */
+    const uint8_t *columns;     /* Columns, in the mapped file */
+    uint32_t length;            /* Length of the columns in bytes */
+} capture_chunk_t;
+
+/* A mapped and indexed capture */
+typedef struct
+{
+    const uint8_t *data;        /* Bytes of the capture */
+    size_t size;                /* Number of bytes */
+    bool mapped;                /* data is a mapping of a file */
+    capture_chunk_t *chunks;    /* Valid chunks, in the order of the file */
+    uint32_t chunk_count;       /* Number of valid chunks */
+    uint64_t pairs;             /* Pairs of the valid chunks */
+    uint64_t pairs_missed;      /* Pairs missing between the indexes of the chunks */
+    uint64_t crc_errors;        /* Chunk headers followed by a wrong CRC */
+    uint64_t skipped_bytes;     /* Bytes outside the valid chunks */
+    int16_t *column[2];         /* Results of the last decoded chunk */
+    uint32_t decoded;           /* Chunk held by column, chunk_count if none */
+} capture_reader_t;
+
+/* Pairs of a range, from one chunk */
+typedef struct
+{
+    uint64_t index;             /* Index of the first pair */
+    uint64_t time;              /* Trigger time of the first pair */
+    uint32_t interval;          /* Trigger clocks between two pairs */
+    uint32_t count;             /* Number of pairs */
+    const int16_t *sar0;        /* SAR0 results, valid until the next span */
+    const int16_t *sar1;        /* SAR1 results, valid until the next span */
+} capture_span_t;
+
+/* Position of a range query between the spans */
+typedef struct
+{
+    uint32_t chunk;             /* Next chunk to return */
+    uint64_t next;              /* Index of the next pair */
+    uint64_t end;               /* Index after the last pair */
+} capture_range_t;
+
+/* Results of one bin of a downsampled view */
+typedef struct
+{
+    uint64_t pairs;             /* Number of pairs in the bin, 0 for a gap */
+    int16_t min[2];             /* Smallest result of SAR0 and SAR1 */
+    int16_t max[2];             /* Largest result of SAR0 and SAR1 */
+} capture_bin_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Maps a capture file and indexes its chunks */
+bool capture_reader_open(capture_reader_t *reader, const char *path);
+
+/* Indexes the chunks of a capture already in memory, which must outlive the reader */
+bool capture_reader_load(capture_reader_t *reader, const uint8_t *data, size_t size);
+
+/* Frees the index and unmaps the file */
+void capture_reader_close(capture_reader_t *reader);
+
+/* Starts a query of count pairs from the pair of index first */
+void capture_reader_range_index(capture_reader_t *reader, uint64_t first, uint64_t count,
+                                capture_range_t *range);
+
+/* Starts a query of the pairs triggered from start to before end */
+void capture_reader_range_time(capture_reader_t *reader, uint64_t start, uint64_t end,
+                               capture_range_t *range);
+
+/* Returns the pairs of the next chunk in a range */
+bool capture_reader_next(capture_reader_t *reader, capture_range_t *range, capture_span_t *span);
+
+/* Reduces the pairs triggered from start to before end to bins of equal time */
+uint32_t capture_reader_view(capture_reader_t *reader, uint64_t start, uint64_t end,
+                             uint32_t bins, capture_bin_t *view);
+
+#endif /* CAPTURE_READER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,364 @@
+/******************************************************************************
+* File Name:   replay_file.c
+*
+* Description: This file contains the Linux driver of the replay. It reads a
+*              binary trace from a file, or from the standard input, straight
+*              into the replay parser of the firmware, without the UART and
+*              without pacing, and passes the replayed blocks through the
+*              decimation filter and the product as the main loop does. It
+*              writes the CTDAC codes and prints a JSON summary with the
+*              replay counters and the speed relative to real time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "processing.h"
+#include "decimator.h"
+#include "replay.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the input buffer */
+#define REPLAY_FILE_BUFFER_SIZE (65536UL)
+
+/* Ideal conversion of the PDL: 2047 counts are 3.3 V * 2047 / 2048 */
+#define REPLAY_FILE_SPAN_UV     (3298388L)
+
+/* Default trigger clock of the trace, the 1 MHz TCPWM clock */
+#define REPLAY_FILE_CLOCK_HZ    (1000000.0)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Product constants of the replay */
+static product_calib_t replay_file_calib;
+
+/* Sample pairs of a block after the decimation filter and their times */
+static sample_pair_t replay_file_decimated[DECIM_MAX_OUTPUT(REPLAY_BLOCK_PAIRS)];
+static uint64_t replay_file_decimated_times[DECIM_MAX_OUTPUT(REPLAY_BLOCK_PAIRS)];
+
+/* CTDAC codes of a block */
+static uint16_t replay_file_codes[REPLAY_BLOCK_PAIRS];
+
+/* Trigger clocks between two replayed sample pairs */
+static uint64_t replay_file_interval = 0ULL;
+
+/* Output of the CTDAC codes, NULL if not written */
+static FILE *replay_file_dac = NULL;
+
+/* Number of CTDAC codes and trigger times of the first and last one */
+static unsigned long long replay_file_code_count = 0ULL;
+static uint64_t replay_file_first_time = 0ULL;
+static uint64_t replay_file_last_time = 0ULL;
+
+/*******************************************************************************
+* Function Name: telemetry_write
+********************************************************************************
+* Summary:
+* This function is the telemetry output of sample_stream.c, which the replay
+* only uses to unpack the pairs. It never sends.
+*
+* Parameters:
+*  data: Unused
+*  length: Unused
+*
+* Return:
+*  bool: Always false
+*
+*******************************************************************************/
+bool telemetry_write(const uint8_t *data, uint32_t length)
+{
+    (void)data;
+    (void)length;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: replay_file_process
+********************************************************************************
+* Summary:
+* This function filters and decimates a replayed block, if enabled, and
+* computes its CTDAC codes like the main loop of the firmware. A decimated
+* pair is timed from the input pair that completes it, less the group delay
+* of the filters at the interval of the trace.
+*
+* Parameters:
+*  pairs: Replayed sample pairs
+*  timestamps: Trigger times of the sample pairs
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void replay_file_process(const sample_pair_t *pairs, const uint64_t *timestamps, uint32_t count)
+{
+    uint32_t first_input;
+    uint32_t index;
+    uint64_t delay;
+    uint64_t time;
+
+    if (decimator_is_enabled())
+    {
+        if (count > 1UL)
+        {
+            replay_file_interval = timestamps[1] - timestamps[0];
+        }
+        count = decimator_process(pairs, count, replay_file_decimated, &first_input);
+        delay = ((uint64_t)DECIM_DELAY_HALF_PAIRS * replay_file_interval) / 2ULL;
+        for (index = 0UL; index < count; index++)
+        {
+            time = timestamps[first_input + (index * DECIM_RATIO)];
+            replay_file_decimated_times[index] = (time > delay) ? (time - delay) : 0ULL;
+        }
+        pairs = replay_file_decimated;
+        timestamps = replay_file_decimated_times;
+    }
+    if (0UL == count)
+    {
+        return;
+    }
+
+    processing_block_to_dac(&replay_file_calib, pairs, replay_file_codes, count);
+
+    if (0ULL == replay_file_code_count)
+    {
+        replay_file_first_time = timestamps[0];
+    }
+    replay_file_last_time = timestamps[count - 1UL];
+    replay_file_code_count += count;
+
+    if (NULL != replay_file_dac)
+    {
+        for (index = 0UL; index < count; index++)
+        {
+            fprintf(replay_file_dac, "%llu %u\n", (unsigned long long)timestamps[index],
+                    (unsigned)replay_file_codes[index]);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_file_drain
+********************************************************************************
+* Summary:
+* This function processes all sample pairs received by the replay so far,
+* so that its ring never overflows.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void replay_file_drain(void)
+{
+    const sample_pair_t *pairs;
+    const uint64_t *timestamps;
+    uint32_t first_index;
+    uint32_t count;
+
+    while (0UL != (count = replay_get_block(&pairs, &timestamps, &first_index, 0UL)))
+    {
+        replay_file_process(pairs, timestamps, count);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_file_usage
+********************************************************************************
+* Summary:
+* This function prints the options of the driver.
+*
+* Parameters:
+*  name: Name of the executable
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void replay_file_usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] [FILE]\n"
+            "Replays the binary trace of FILE, or of the standard input if FILE is\n"
+            "missing or -, through the processing of the firmware as fast as possible,\n"
+            "and prints a JSON summary.\n"
+            "  --dac FILE              write the CTDAC codes as 'trigger_clock code'\n"
+            "  --decimate              enable the decimation filter\n"
+            "  --span UV0:UV1          microvolts of 2047 counts of SAR0 and SAR1 (3298388)\n"
+            "  --clock HZ              trigger clock of the trace (1000000)\n",
+            name);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function replays a trace file and reports the replay counters, the
+* duration of the trace and the time taken to process it.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Options, then the trace file
+*
+* Return:
+*  int: EXIT_SUCCESS, or 2 on a usage or file error
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t buffer[REPLAY_FILE_BUFFER_SIZE];
+    const char *input_name = "-";
+    const char *dac_name = NULL;
+    long span0 = REPLAY_FILE_SPAN_UV;
+    long span1 = REPLAY_FILE_SPAN_UV;
+    double clock_hz = REPLAY_FILE_CLOCK_HZ;
+    FILE *input = stdin;
+    replay_stats_t stats;
+    struct timespec start;
+    struct timespec end;
+    unsigned long long bytes = 0ULL;
+    double wall;
+    double trace_seconds;
+    size_t got;
+    size_t index;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--dac")) && ((arg + 1) < argc))
+        {
+            dac_name = argv[++arg];
+        }
+        else if (0 == strcmp(argv[arg], "--decimate"))
+        {
+            decimator_set_enabled(true);
+        }
+        else if ((0 == strcmp(argv[arg], "--span")) && ((arg + 1) < argc) &&
+                 (2 == sscanf(argv[arg + 1], "%ld:%ld", &span0, &span1)))
+        {
+            arg++;
+        }
+        else if ((0 == strcmp(argv[arg], "--clock")) && ((arg + 1) < argc))
+        {
+            clock_hz = strtod(argv[++arg], NULL);
+        }
+        else if (('-' != argv[arg][0]) || ('\0' == argv[arg][1]))
+        {
+            input_name = argv[arg];
+        }
+        else
+        {
+            replay_file_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (clock_hz <= 0.0)
+    {
+        replay_file_usage(argv[0]);
+        return 2;
+    }
+
+    if (0 != strcmp(input_name, "-"))
+    {
+        input = fopen(input_name, "rb");
+        if (NULL == input)
+        {
+            perror(input_name);
+            return 2;
+        }
+    }
+    if (NULL != dac_name)
+    {
+        replay_file_dac = fopen(dac_name, "w");
+        if (NULL == replay_file_dac)
+        {
+            perror(dac_name);
+            return 2;
+        }
+    }
+
+    processing_product_calib_init(&replay_file_calib, 0L, (int32_t)span0, 0L, (int32_t)span1);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    replay_start(REPLAY_FULL_SPEED);
+    while (0U != (got = fread(buffer, 1U, sizeof(buffer), input)))
+    {
+        bytes += got;
+        for (index = 0U; index < got; index++)
+        {
+            replay_feed(buffer[index]);
+            replay_file_drain();
+        }
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    replay_get_stats(&stats);
+
+    if (stdin != input)
+    {
+        (void)fclose(input);
+    }
+    if (NULL != replay_file_dac)
+    {
+        (void)fclose(replay_file_dac);
+    }
+
+    wall = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) * 1.0e-9);
+    trace_seconds = (double)(replay_file_last_time - replay_file_first_time) / clock_hz;
+
+    printf("{\"bytes\":%llu,\"frames\":%lu,\"pairs\":%lu,\"crc_errors\":%lu,\"sequence_gaps\":%lu,"
+           "\"overflows\":%lu,\"codes\":%llu,\"trace_seconds\":%.6f,\"wall_seconds\":%.6f,"
+           "\"pairs_per_second\":%.1f,\"real_time_factor\":%.1f}\n",
+           bytes, (unsigned long)stats.frames, (unsigned long)stats.pairs, (unsigned long)stats.crc_errors,
+           (unsigned long)stats.sequence_gaps, (unsigned long)stats.overflows, replay_file_code_count,
+           trace_seconds, wall, (wall > 0.0) ? ((double)stats.pairs / wall) : 0.0,
+           (wall > 0.0) ? (trace_seconds / wall) : 0.0);
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,641 @@
+/******************************************************************************
+* File Name:   stream_decode.c
+*
+* Description: This file contains the Linux decoder of the binary sample
+*              stream. It reads a capture file, a pty or the standard input,
+*              finds the frames by their sync bytes, checks their CRC and
+*              sequence numbers, timestamps the sample pairs from the time
+*              records, optionally writes them as CSV, and prints a JSON
+*              summary with the errors and the decoding throughput.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "sample_stream.h"
+#include "crc16.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the input buffer, a multiple of the longest frame */
+#define DECODE_BUFFER_SIZE  (65536UL)
+
+/* Longest frame of any type */
+#define DECODE_MAX_FRAME    (STREAM_HEADER_SIZE + (255UL * STREAM_PAIR_SIZE) + STREAM_CRC_SIZE)
+
+/* Default trigger clock of the time records, the 1 MHz TCPWM clock */
+#define DECODE_CLOCK_HZ     (1000000.0)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Sum, minimum and maximum of the results of one SAR */
+typedef struct
+{
+    double sum;
+    long min;
+    long max;
+} decode_channel_t;
+
+/* Expected mean of the results of one SAR */
+typedef struct
+{
+    bool enabled;
+    double counts;
+    double tolerance;
+} decode_expect_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Decoder state and counters */
+static struct
+{
+    FILE *csv;
+    double clock_hz;
+    unsigned long long bytes;
+    unsigned long long frames;
+    unsigned long long sample_frames;
+    unsigned long long record_frames;
+    unsigned long long pairs;
+    unsigned long long time_records;
+    unsigned long long crc_errors;
+    unsigned long long sequence_gaps;
+    unsigned long long frames_missed;
+    unsigned long long pairs_missed;
+    unsigned long long time_gaps;
+    unsigned long long skipped_bytes;
+    bool have_sequence;
+    uint16_t sequence;
+    uint64_t pair_index;
+    bool have_time;
+    uint64_t time_index;
+    uint64_t time_stamp;
+    uint32_t time_interval;
+    uint64_t first_stamp;
+    uint64_t last_stamp;
+    decode_channel_t channel[2];
+} decoder;
+
+/*******************************************************************************
+* Function Name: telemetry_write
+********************************************************************************
+* Summary:
+* This function is the telemetry output of sample_stream.c, which the
+* decoder only uses to unpack the pairs and check the CRC. It never sends.
+*
+* Parameters:
+*  data: Unused
+*  length: Unused
+*
+* Return:
+*  bool: Always false
+*
+*******************************************************************************/
+bool telemetry_write(const uint8_t *data, uint32_t length)
+{
+    (void)data;
+    (void)length;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: decode_u32
+********************************************************************************
+* Summary:
+* This function reads a little-endian 32-bit field of a record.
+*
+* Parameters:
+*  data: First byte of the field
+*
+* Return:
+*  uint32_t: Value of the field
+*
+*******************************************************************************/
+static uint32_t decode_u32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8U) |
+           ((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: decode_u64
+********************************************************************************
+* Summary:
+* This function reads a little-endian 64-bit field of a record.
+*
+* Parameters:
+*  data: First byte of the field
+*
+* Return:
+*  uint64_t: Value of the field
+*
+*******************************************************************************/
+static uint64_t decode_u64(const uint8_t *data)
+{
+    return (uint64_t)decode_u32(data) | ((uint64_t)decode_u32(&data[4]) << 32U);
+}
+
+/*******************************************************************************
+* Function Name: decode_time
+********************************************************************************
+* Summary:
+* This function handles a time record, which refers to the first pair of
+* the next frame of samples. The pairs of the frames missed since the
+* previous record are counted from its index, and a record whose time
+* disagrees with the time expected from the previous record counts as a time
+* gap, such as triggers lost or a change of the trigger period.
+*
+* Parameters:
+*  record: Time record, STREAM_TIME_RECORD_SIZE bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void decode_time(const uint8_t *record)
+{
+    uint32_t index = decode_u32(&record[0]);
+    uint64_t stamp = decode_u64(&record[4]);
+    uint32_t interval = decode_u32(&record[12]);
+    int32_t missed = (int32_t)(index - (uint32_t)decoder.pair_index);
+
+    /* The index in the record wraps at 32 bits. Before the first record,
+       the decoder may have started in the middle of the stream. */
+    if (decoder.have_time && (missed > 0L))
+    {
+        decoder.pairs_missed += (unsigned long long)missed;
+    }
+    decoder.pair_index = (uint64_t)((int64_t)decoder.pair_index + missed);
+
+    if (decoder.have_time &&
+        (stamp != (decoder.time_stamp + ((decoder.pair_index - decoder.time_index) * decoder.time_interval))))
+    {
+        decoder.time_gaps++;
+    }
+    /* With the decimation filter, the first pairs are timed before the
+       last unfiltered pair, so the stream starts at the earliest record */
+    if ((!decoder.have_time) || (stamp < decoder.first_stamp))
+    {
+        decoder.first_stamp = stamp;
+    }
+
+    decoder.have_time = true;
+    decoder.time_index = decoder.pair_index;
+    decoder.time_stamp = stamp;
+    decoder.time_interval = interval;
+    decoder.time_records++;
+}
+
+/*******************************************************************************
+* Function Name: decode_samples
+********************************************************************************
+* Summary:
+* This function unpacks the sample pairs of a frame, updates the statistics
+* of both SARs and writes the pairs as CSV.
+*
+* Parameters:
+*  packed: Packed sample pairs
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void decode_samples(const uint8_t *packed, uint32_t count)
+{
+    sample_pair_t pairs[255];
+    decode_channel_t *channel;
+    uint64_t stamp;
+    uint32_t index;
+    long value[2];
+    uint32_t sar;
+
+    sample_stream_unpack(packed, count, pairs);
+
+    for (index = 0UL; index < count; index++)
+    {
+        value[0] = pairs[index].sar0;
+        value[1] = pairs[index].sar1;
+        for (sar = 0UL; sar < 2UL; sar++)
+        {
+            channel = &decoder.channel[sar];
+            channel->sum += (double)value[sar];
+            if ((0ULL == decoder.pairs) || (value[sar] < channel->min))
+            {
+                channel->min = value[sar];
+            }
+            if ((0ULL == decoder.pairs) || (value[sar] > channel->max))
+            {
+                channel->max = value[sar];
+            }
+        }
+
+        if (decoder.have_time)
+        {
+            stamp = decoder.time_stamp + ((decoder.pair_index - decoder.time_index) * decoder.time_interval);
+            decoder.last_stamp = stamp;
+            if (NULL != decoder.csv)
+            {
+                fprintf(decoder.csv, "%llu,%.6f,%ld,%ld\n", (unsigned long long)decoder.pair_index,
+                        (double)stamp / decoder.clock_hz, value[0], value[1]);
+            }
+        }
+        else if (NULL != decoder.csv)
+        {
+            fprintf(decoder.csv, "%llu,,%ld,%ld\n", (unsigned long long)decoder.pair_index,
+                    value[0], value[1]);
+        }
+
+        decoder.pair_index++;
+        decoder.pairs++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: decode_buffer
+********************************************************************************
+* Summary:
+* This function decodes the complete frames of a buffer. Bytes that do not
+* start a frame with a valid CRC are skipped one at a time, so that the
+* decoder resynchronizes on the next sync bytes after an error.
+*
+* Parameters:
+*  data: Received bytes
+*  length: Number of received bytes
+*
+* Return:
+*  uint32_t: Number of bytes consumed, the rest starts an incomplete frame
+*
+*******************************************************************************/
+static uint32_t decode_buffer(const uint8_t *data, uint32_t length)
+{
+    uint32_t offset = 0UL;
+    uint32_t payload;
+    uint32_t frame_length;
+    uint16_t crc;
+    uint16_t sequence;
+    const uint8_t *frame;
+
+    while ((length - offset) >= 2UL)
+    {
+        frame = &data[offset];
+        if ((STREAM_SYNC0 != frame[0]) || (STREAM_SYNC1 != frame[1]))
+        {
+            decoder.skipped_bytes++;
+            offset++;
+            continue;
+        }
+        if ((length - offset) < STREAM_HEADER_SIZE)
+        {
+            break;
+        }
+
+        payload = frame[5];
+        if (STREAM_FRAME_SAMPLES == frame[2])
+        {
+            payload *= STREAM_PAIR_SIZE;
+        }
+        frame_length = STREAM_HEADER_SIZE + payload + STREAM_CRC_SIZE;
+        if ((length - offset) < frame_length)
+        {
+            break;
+        }
+
+        crc = crc16_update(CRC16_INIT, &frame[2], STREAM_HEADER_SIZE + payload - 2UL);
+        if (crc != ((uint16_t)frame[frame_length - 2UL] | ((uint16_t)frame[frame_length - 1UL] << 8U)))
+        {
+            decoder.crc_errors++;
+            decoder.skipped_bytes++;
+            offset++;
+            continue;
+        }
+
+        sequence = (uint16_t)frame[3] | ((uint16_t)frame[4] << 8U);
+        if (decoder.have_sequence && (sequence != (uint16_t)(decoder.sequence + 1U)))
+        {
+            decoder.sequence_gaps++;
+            decoder.frames_missed += (uint16_t)(sequence - decoder.sequence - 1U);
+        }
+        decoder.have_sequence = true;
+        decoder.sequence = sequence;
+        decoder.frames++;
+
+        if (STREAM_FRAME_SAMPLES == frame[2])
+        {
+            decoder.sample_frames++;
+            decode_samples(&frame[STREAM_HEADER_SIZE], frame[5]);
+        }
+        else
+        {
+            decoder.record_frames++;
+            if ((STREAM_FRAME_TIME == frame[2]) && (STREAM_TIME_RECORD_SIZE == payload))
+            {
+                decode_time(&frame[STREAM_HEADER_SIZE]);
+            }
+        }
+        offset += frame_length;
+    }
+
+    return offset;
+}
+
+/*******************************************************************************
+* Function Name: decode_parse_expect
+********************************************************************************
+* Summary:
+* This function parses the COUNTS[:TOL] argument of --expect-sar0/1.
+*
+* Parameters:
+*  text: Argument
+*  expect: Location to store the expected mean
+*
+* Return:
+*  bool: True if the argument is valid
+*
+*******************************************************************************/
+static bool decode_parse_expect(const char *text, decode_expect_t *expect)
+{
+    char *end;
+
+    expect->counts = strtod(text, &end);
+    expect->tolerance = 1.0;
+    if (':' == *end)
+    {
+        expect->tolerance = strtod(end + 1, &end);
+    }
+    expect->enabled = true;
+
+    return ('\0' == *end);
+}
+
+/*******************************************************************************
+* Function Name: decode_usage
+********************************************************************************
+* Summary:
+* This function prints the options of the decoder.
+*
+* Parameters:
+*  name: Name of the executable
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void decode_usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] [FILE]\n"
+            "Decodes the binary sample stream of FILE, or of the standard input if FILE\n"
+            "is missing or -, and prints a JSON summary.\n"
+            "  --csv FILE              write the pairs as index,seconds,sar0,sar1\n"
+            "  --clock HZ              trigger clock of the time records (1000000)\n"
+            "  --strict                fail on CRC errors, missed frames or missed pairs\n"
+            "  --expect-sar0 C[:TOL]   fail unless the mean of SAR0 is C counts (TOL 1)\n"
+            "  --expect-sar1 C[:TOL]   fail unless the mean of SAR1 is C counts (TOL 1)\n",
+            name);
+}
+
+/*******************************************************************************
+* Function Name: decode_check_mean
+********************************************************************************
+* Summary:
+* This function compares the mean of the results of a SAR with the value
+* expected on the command line.
+*
+* Parameters:
+*  sar: SAR to check
+*  expect: Expected mean, if enabled
+*
+* Return:
+*  bool: True if the check is disabled or passes
+*
+*******************************************************************************/
+static bool decode_check_mean(uint32_t sar, const decode_expect_t *expect)
+{
+    double mean;
+
+    if (!expect->enabled)
+    {
+        return true;
+    }
+    if (0ULL == decoder.pairs)
+    {
+        fprintf(stderr, "stream_decode: no sample pairs to check SAR%u\n", (unsigned)sar);
+        return false;
+    }
+
+    mean = decoder.channel[sar].sum / (double)decoder.pairs;
+    if ((mean < (expect->counts - expect->tolerance)) || (mean > (expect->counts + expect->tolerance)))
+    {
+        fprintf(stderr, "stream_decode: mean of SAR%u is %.2f counts, expected %.2f +- %.2f\n",
+                (unsigned)sar, mean, expect->counts, expect->tolerance);
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This function reads the stream in blocks, decodes the complete frames of
+* each block, and prints the summary. The exit status is 1 when a check
+* fails and 2 on a usage or I/O error.
+*
+* Parameters:
+*  argc: Number of arguments
+*  argv: Arguments, see decode_usage()
+*
+* Return:
+*  int: Exit status
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t buffer[DECODE_BUFFER_SIZE];
+    decode_expect_t expect[2] = { { false, 0.0, 0.0 }, { false, 0.0, 0.0 } };
+    const char *input_name = "-";
+    const char *csv_name = NULL;
+    bool strict = false;
+    bool passed = true;
+    FILE *input = stdin;
+    struct timespec start;
+    struct timespec end;
+    double wall;
+    double stream_seconds;
+    size_t got;
+    uint32_t kept = 0UL;
+    uint32_t used;
+    uint32_t sar;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--csv")) && ((arg + 1) < argc))
+        {
+            csv_name = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--clock")) && ((arg + 1) < argc))
+        {
+            decoder.clock_hz = strtod(argv[++arg], NULL);
+        }
+        else if (0 == strcmp(argv[arg], "--strict"))
+        {
+            strict = true;
+        }
+        else if ((0 == strncmp(argv[arg], "--expect-sar", 12)) && ((arg + 1) < argc) &&
+                 (('0' == argv[arg][12]) || ('1' == argv[arg][12])) && ('\0' == argv[arg][13]))
+        {
+            sar = (uint32_t)(argv[arg][12] - '0');
+            if (!decode_parse_expect(argv[++arg], &expect[sar]))
+            {
+                decode_usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (('-' != argv[arg][0]) || ('\0' == argv[arg][1]))
+        {
+            input_name = argv[arg];
+        }
+        else
+        {
+            decode_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (decoder.clock_hz <= 0.0)
+    {
+        decoder.clock_hz = DECODE_CLOCK_HZ;
+    }
+
+    if (0 != strcmp(input_name, "-"))
+    {
+        input = fopen(input_name, "rb");
+        if (NULL == input)
+        {
+            perror(input_name);
+            return 2;
+        }
+    }
+    if (NULL != csv_name)
+    {
+        decoder.csv = fopen(csv_name, "w");
+        if (NULL == decoder.csv)
+        {
+            perror(csv_name);
+            return 2;
+        }
+        fprintf(decoder.csv, "index,seconds,sar0,sar1\n");
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (;;)
+    {
+        got = fread(&buffer[kept], 1, DECODE_BUFFER_SIZE - kept, input);
+        if (0U == got)
+        {
+            break;
+        }
+        decoder.bytes += got;
+        kept += (uint32_t)got;
+        used = decode_buffer(buffer, kept);
+        kept -= used;
+        (void)memmove(buffer, &buffer[used], kept);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* The bytes left over start a frame cut short by the end of the stream */
+    decoder.skipped_bytes += kept;
+
+    if (stdin != input)
+    {
+        (void)fclose(input);
+    }
+    if (NULL != decoder.csv)
+    {
+        (void)fclose(decoder.csv);
+    }
+
+    wall = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) * 1.0e-9);
+    stream_seconds = (double)(decoder.last_stamp - decoder.first_stamp) / decoder.clock_hz;
+
+    printf("{\"bytes\":%llu,\"frames\":%llu,\"sample_frames\":%llu,\"record_frames\":%llu,"
+           "\"pairs\":%llu,\"time_records\":%llu,\"crc_errors\":%llu,\"sequence_gaps\":%llu,"
+           "\"frames_missed\":%llu,\"pairs_missed\":%llu,\"time_gaps\":%llu,\"skipped_bytes\":%llu,"
+           "\"stream_seconds\":%.6f,\"pairs_per_second\":%.1f,\"decode_mb_per_second\":%.1f",
+           decoder.bytes, decoder.frames, decoder.sample_frames, decoder.record_frames,
+           decoder.pairs, decoder.time_records, decoder.crc_errors, decoder.sequence_gaps,
+           decoder.frames_missed, decoder.pairs_missed, decoder.time_gaps, decoder.skipped_bytes,
+           stream_seconds, (stream_seconds > 0.0) ? ((double)decoder.pairs / stream_seconds) : 0.0,
+           (wall > 0.0) ? ((double)decoder.bytes / wall * 1.0e-6) : 0.0);
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        printf(",\"sar%u\":{\"mean\":%.3f,\"min\":%ld,\"max\":%ld}", (unsigned)sar,
+               (0ULL != decoder.pairs) ? (decoder.channel[sar].sum / (double)decoder.pairs) : 0.0,
+               decoder.channel[sar].min, decoder.channel[sar].max);
+    }
+    printf("}\n");
+
+    if (strict && ((0ULL != decoder.crc_errors) || (0ULL != decoder.frames_missed) ||
+                   (0ULL != decoder.pairs_missed)))
+    {
+        fprintf(stderr, "stream_decode: %llu CRC errors, %llu frames and %llu pairs missed\n",
+                decoder.crc_errors, decoder.frames_missed, decoder.pairs_missed);
+        passed = false;
+    }
+    for (sar = 0UL; sar < 2UL; sar++)
+    {
+        if (!decode_check_mean(sar, &expect[sar]))
+        {
+            passed = false;
+        }
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* [] END OF FILE */
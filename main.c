@@ -4,7 +4,9 @@
 * Description: In this code example, two SAR ADCs are configured to sample
 *              external signals simultaneously. In the firmware, product of the
 *              results are calculated and sent to UART Terminal. The scaled
-*              value of product is loaded into DAC.
+*              value of product is loaded into DAC. The SAR acquisition is
+*              implemented in acquisition.c and the hardware independent
+*              sample processing in processing.c.
 *
 * Related Document: See README.md
 *
@@ -46,23 +48,22 @@
 #include "cyhal.h"
 #include "cybsp.h"
 #include "cy_retarget_io.h"
-
-/*******************************************************************************
-* Macros
-********************************************************************************/
-/*
- * Scaling factor is to reduce the product of inputs to range of 0V - 3.3V
- * The values to be set in CTDAC next value register is from 0 to 4095
- * The maximum product of two inputs can be 3.3V*3.3V = 10.89V
- * So 4095 represents 10.89V; 1V is represented by 372
- * Since the output on Analog pin ranges from 0 to 3.3V, the output measured
- * on the pin is to be multiplied with 3.3 to get the correct result.
- *
- */
-#define SCALING_FACTOR 372
-
-/* TCPWM Counter 0 */
-#define TCPWM_CNT_NUM   (0UL)
+#include "acquisition.h"
+#include "processing.h"
+#include "decimator.h"
+#include "meter.h"
+#include "correlator.h"
+#include "spectrum.h"
+#include "telemetry.h"
+#include "sample_stream.h"
+#include "profiler.h"
+#include "command.h"
+#include "dac_dma.h"
+#include "power.h"
+#include "monitor.h"
+#include "stats.h"
+#include "replay.h"
+#include "capture.h"
 
 /*******************************************************************************
 * Function Prototypes
@@ -70,29 +71,20 @@
 /* Analog Initialization Function */
 void init_analog_resources(void);
 
-/* SAR0 Interrupt Handler */
-void sar0_interrupt(void);
-
-/* SAR1 Interrupt Handler */
-void sar1_interrupt(void);
-
-/* SAR0 interrupt configuration structure */
-/* Source is set to SAR0 and Priority as 7 */
-const cy_stc_sysint_t SAR0_IRQ_cfg = {
-    .intrSrc = (IRQn_Type) pass_interrupt_sar_0_IRQn,
-    .intrPriority = 7UL
-};
-
-/* SAR1 interrupt configuration structure */
-/* Source is set to SAR1 and Priority as 7 */
-const cy_stc_sysint_t SAR1_IRQ_cfg = {
-    .intrSrc = (IRQn_Type) pass_interrupt_sar_1_IRQn,
-    .intrPriority = 7UL
-};
-
-/* Flags to check End-Of-Scan interrupt from SAR0 and SAR1 */
-static bool sar0_isr_set = false;
-static bool sar1_isr_set = false;
+/* Returns the next block of acquired or replayed sample pairs */
+static uint32_t read_block(const sample_pair_t **pairs, const uint64_t **timestamps, uint32_t *first_index,
+                           bool *replayed);
+
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_TEXT)
+/* Number of leading sample pairs of a block without a missed trigger */
+static uint32_t consecutive_pairs(const uint64_t *timestamps, uint32_t count, uint32_t interval);
+#endif
+
+#if ((ACQ_NUM_CHANNELS > 1UL) && (TELEMETRY_FORMAT == TELEMETRY_FORMAT_TEXT))
+/* Processing callback of the channel blocks */
+static void report_channels(const channel_block_t *block);
+#endif
+
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
@@ -114,10 +106,66 @@ int main(void)
     /* Variable to capture return value of functions */
     cy_rslt_t result;
 
-    /* Variable to hold data retrieved from SAR result register */
-    int16_t sar_result0 = 0, sar_result1 = 0;
+    /* Length of the banner */
+    int banner;
+
+    /* Variables to hold data retrieved from the SARs */
+    const sample_pair_t *sample_block;
+    uint32_t pair_count;
+
+    /* Index of the first sample pair of the block in the acquisition or
+       in the replayed trace */
+    uint32_t block_index;
+    uint32_t index;
+
+    /* Whether the block comes from a replayed trace. Its latencies have no
+       relation to the last End-Of-Scan, so they are not profiled. */
+    bool replayed;
+
+    /* Sample pairs of the current block after the decimation filter, the
+       index of the input pair that completes the first one, and their times */
+    static sample_pair_t decimated_block[DECIM_MAX_OUTPUT(ACQ_CHANNEL_BLOCK_SCANS)];
+    static uint64_t decimated_times[DECIM_MAX_OUTPUT(ACQ_CHANNEL_BLOCK_SCANS)];
+    uint32_t first_input;
+    uint64_t delay;
+
+    /* CTDAC codes of the current block */
+    static uint16_t dac_codes[ACQ_CHANNEL_BLOCK_SCANS];
+
+    /* Profiler timestamps of the current block */
+    uint32_t read_time;
+    uint32_t product_time;
+    uint32_t write_time;
+    uint32_t dac_time;
+
+    /* Trigger times of the sample pairs of the block, the time of the
+       first (binary and capture) or last (text) one, and the trigger clocks
+       between two pairs */
+    const uint64_t *timestamps;
+    uint64_t block_time;
+    uint32_t pair_interval;
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_TEXT)
+    uint32_t run;
+#endif
+
+    /* Constants of the fixed-point product */
+    product_calib_t product_calib;
+
+    /* Power meter result of the last window and its scales. A capture
+       only holds the sample pairs. */
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_CAPTURE)
+    meter_result_t meter_result;
+#endif
+    channel_scale_t voltage_scale;
+    channel_scale_t current_scale;
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    uint8_t meter_record[METER_RECORD_SIZE];
+#endif
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_TEXT)
     float32_t resultV_0 = 0, resultV_1 = 0;
-    float32_t product_result = 0;
+
+#endif
 
     /* Initialize the device and board peripherals */
     result = cybsp_init() ;
@@ -134,200 +182,446 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    /* Wake up on the UART while telemetry is queued */
+    telemetry_init();
+
     /* Print message */
 
     /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
-    printf("-----------------------------------------------------------\r\n");
-    printf("PSoC 6 MCU: Simultaneous Sampling SAR ADCs \r\n");
-    printf("-----------------------------------------------------------\r\n\n");
-    printf("Provide input voltages at pin P10.0 and P10.1 and observe \r\n");
-    printf("the scaled product of inputs on pin P9.2.\r\n\n");
+    banner = printf("\x1b[2J\x1b[;H");
+    banner += printf("-----------------------------------------------------------\r\n");
+    banner += printf("PSoC 6 MCU: Simultaneous Sampling SAR ADCs \r\n");
+    banner += printf("-----------------------------------------------------------\r\n\n");
+    banner += printf("Provide input voltages at pin P10.0 and P10.1 and observe \r\n");
+    banner += printf("the scaled product of inputs on pin P9.2.\r\n\n");
+    banner += printf("Press 'p' for the cycle profile, 'h' for the profile with\r\n");
+    banner += printf("histograms and 'c' to clear the profile. Type 'r<period>'\r\n");
+    banner += printf("or 'a<ns>' and Enter to change the trigger period or the\r\n");
+    banner += printf("acquisition time, 's' to show them. Type 'o0' (fast),\r\n");
+    banner += printf("'o1' (balanced) or 'o2' (high resolution) and Enter to\r\n");
+    banner += printf("select an averaging profile, 'n' to measure the noise.\r\n");
+    banner += printf("Press 'd' to toggle the decimation filter, 'k' to\r\n");
+    banner += printf("benchmark the product kernel, 'm' to toggle the power\r\n");
+    banner += printf("meter. Type 'w<pairs>' and Enter to set its window,\r\n");
+    banner += printf("'x<pairs>' and Enter to measure the delay of SAR1.\r\n");
+    banner += printf("Type 'f<points>' and Enter to analyze the spectrum of\r\n");
+    banner += printf("both inputs, 'b' to list its bins. Press 'u' for the\r\n");
+    banner += printf("CPU wakeups and duty cycle since the last 'u'.\r\n");
+    banner += printf("Press 'e' to toggle the event monitor. Type 'j<SAR>' and\r\n");
+    banner += printf("Enter to select a SAR, then 'l<mV>' or 'g<mV>' for the\r\n");
+    banner += printf("limits of its window, 'i<condition>' (0 below, 1 inside,\r\n");
+    banner += printf("2 above, 3 outside) and 'q<channels>' for its channels.\r\n");
+    banner += printf("Press 't' for the sample losses of every stage. Type\r\n");
+    banner += printf("'v0' (full speed) or 'v1' (real time) and Enter to\r\n");
+    banner += printf("replay a binary trace sent to the UART, ESC to end it.\r\n\n");
+
+    /* The telemetry starts at an even offset of the output, so that the
+       columns of the capture chunks are aligned in a saved file */
+    if (0 != (banner % 2))
+    {
+        (void)printf("\n");
+    }
 
     /* Initialize analog resources */
     init_analog_resources();
 
+    /* Precompute the fixed-point product from the SAR calibration */
+    acquisition_get_product_calib(&product_calib);
+
+    /* SAR0 is the voltage and SAR1 the current of the power meter */
+    (void)acquisition_get_channel_scale(0UL, 0UL, &voltage_scale);
+    (void)acquisition_get_channel_scale(1UL, 0UL, &current_scale);
+    meter_init(&voltage_scale, &current_scale);
+
+    /* Load the window of the event monitor into the SAR comparators */
+    monitor_init();
+
+    /* Build the twiddle table of the delay measurement and the spectrum */
+    fft_init();
+
+#if ((ACQ_NUM_CHANNELS > 1UL) && (TELEMETRY_FORMAT == TELEMETRY_FORMAT_TEXT))
+    /* Report the other channels scanned with channel 0 */
+    acquisition_set_channel_callback(report_channels);
+#endif
+
+    /* Start the cycle counter used to profile the sample to CTDAC path */
+    profiler_init();
+
+    /* Start counting the wakeups and the active time of the CPU */
+    power_init();
+
     /* Enable IRQ */
     __enable_irq();
 
     /* Start the TCPWM Timer */
-    Cy_TCPWM_TriggerStart_Single(TCPWM0, TCPWM_CNT_NUM);
+    acquisition_start();
 
     for (;;)
     {
-        /* Wait till printf completes the UART transfer */
-        while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj) == true);
+        /* Sleep until both SAR conversions (or a block of them) are complete.
+           Queued telemetry is moved to the UART on every wakeup, without
+           waiting for the transfer to complete. Deep sleep acquisition only
+           enters deep sleep once the telemetry is sent. A replay polls the
+           UART for the trace instead of sleeping. */
+        while(0UL == (pair_count = read_block(&sample_block, &timestamps, &block_index, &replayed)))
+        {
+             command_process();
+             telemetry_service();
+             if (!replay_is_receiving())
+             {
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+                 /* While the monitor holds the DMA blocks, only its events
+                    and the commands wake up the CPU */
+                 if (monitor_is_enabled())
+                 {
+                     telemetry_wake_on_rx();
+                 }
+#endif
+                 power_sleep();
+             }
+        }
 
-        /* Sleep until both SAR conversions are complete */
-        while(!(sar0_isr_set & sar1_isr_set))
+        read_time = profiler_now();
+        if (!replayed)
         {
-             Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+            profiler_record(PROFILER_EOS_TO_READ, read_time - profiler_get_eos());
         }
 
-        /* Clear the flags */
-        sar0_isr_set = false;
-        sar1_isr_set = false;
-        
-        /* Retrieve value from SAR result register */
-        sar_result0 = Cy_SAR_GetResult16(SAR0, 0 );
-        sar_result1 = Cy_SAR_GetResult16(SAR1, 0 );
+        /* Keep the history of the event monitor and capture around events.
+           During a replay, read_block() gives it the acquired block instead,
+           as its events come from the live comparators. */
+        if (!replayed)
+        {
+            monitor_process(sample_block, pair_count, block_index);
+        }
+
+        /* Filter and decimate the block, if enabled. A short block may not
+           complete a decimated sample pair. */
+        pair_interval = acquisition_get_interval();
+        if (decimator_is_enabled())
+        {
+            pair_count = decimator_process(sample_block, pair_count, decimated_block, &first_input);
+            sample_block = decimated_block;
+
+            if (0UL == pair_count)
+            {
+                acquisition_process_channels();
+                continue;
+            }
+
+            /* A decimated pair is timed from the input pair that completes
+               it, less the group delay of the filters. The decimation phase
+               carries over between blocks, so this is not the first input
+               pair of the block. */
+            delay = ((uint64_t)DECIM_DELAY_HALF_PAIRS * pair_interval) / 2ULL;
+            for (index = 0UL; index < pair_count; index++)
+            {
+                block_time = timestamps[first_input + (index * DECIM_RATIO)];
+                decimated_times[index] = (block_time > delay) ? (block_time - delay) : 0ULL;
+            }
+            timestamps = decimated_times;
+            pair_interval *= DECIM_RATIO;
+        }
 
-        /* Convert data retrieved from SAR to Volts */
-        resultV_0 = Cy_SAR_CountsTo_Volts(SAR0, 0, sar_result0);
-        resultV_1 = Cy_SAR_CountsTo_Volts(SAR1, 0, sar_result1);
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_TEXT)
+        block_time = timestamps[0];
+#else
+        block_time = timestamps[pair_count - 1UL];
+#endif
+
+        /* Scale the product of the results for range 0V to 3.3V and output to pin */
+        product_time = profiler_now();
+        processing_block_to_dac(&product_calib, sample_block, dac_codes, pair_count);
+        write_time = profiler_now();
+#if (DAC_OUTPUT_MODE == DAC_MODE_DMA)
+        /* Queue the codes for the DMA, which outputs one per sample pair period */
+        dac_dma_track(acquisition_get_period(), decimator_is_enabled() ? DECIM_RATIO : 1UL);
+        (void)dac_dma_write(dac_codes, pair_count);
+#else
+        for (index = 0UL; index < pair_count; index++)
+        {
+            Cy_CTDAC_SetValue(CTDAC0, (int32_t)dac_codes[index]);
+        }
+#endif
+
+        dac_time = profiler_now();
+        profiler_record(PROFILER_SAMPLE, (dac_time - read_time) / pair_count);
+        profiler_record(PROFILER_PRODUCT, (write_time - product_time) / pair_count);
+        profiler_record(PROFILER_DAC_WRITE, (dac_time - write_time) / pair_count);
+        if (!replayed)
+        {
+            profiler_record(PROFILER_EOS_TO_DAC, dac_time - profiler_get_eos());
+        }
+
+        /* Process all channels once the CTDAC is updated */
+        acquisition_process_channels();
+
+        /* Accumulate the window of the power meter, if enabled */
+        meter_process(sample_block, pair_count);
+
+        /* Capture and correlate the window of the delay measurement, if started */
+        correlator_process(sample_block, pair_count);
+
+        /* Capture and analyze the block of the spectrum, if started */
+        spectrum_process(sample_block, pair_count);
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+        if (meter_is_enabled())
+        {
+            /* Send one record per window instead of the sample pairs */
+            if (meter_get_result(&meter_result))
+            {
+                meter_pack_result(&meter_result, meter_record);
+                sample_stream_send(STREAM_FRAME_METER, meter_record, METER_RECORD_SIZE);
+            }
+        }
+        else if (monitor_is_enabled())
+        {
+            /* Only the captures around events are sent, by the command handler */
+        }
+        else
+        {
+            /* Stream every sample pair as raw counts. A time record
+               precedes the pairs that follow a missed trigger. */
+            for (index = 0UL; index < pair_count; index += run)
+            {
+                run = consecutive_pairs(&timestamps[index], pair_count - index, pair_interval);
+                sample_stream_put_timed(&sample_block[index], run, timestamps[index], pair_interval);
+            }
+        }
+#elif (TELEMETRY_FORMAT == TELEMETRY_FORMAT_CAPTURE)
+        /* Capture every sample pair, whatever else is enabled. A new chunk
+           starts after a missed trigger. */
+        for (index = 0UL; index < pair_count; index += run)
+        {
+            run = consecutive_pairs(&timestamps[index], pair_count - index, pair_interval);
+            capture_put(&sample_block[index], run, timestamps[index], pair_interval);
+        }
+#else
+        if (meter_is_enabled())
+        {
+            /* Report one line per window instead of one per block */
+            if (meter_get_result(&meter_result))
+            {
+                (void)telemetry_printf("P: %.6f  Vrms: %.4f  Irms: %.4f  S: %.6f  PF: %.3f\r\n",
+                                       (double)meter_result.real_power, (double)meter_result.voltage_rms,
+                                       (double)meter_result.current_rms, (double)meter_result.apparent_power,
+                                       (double)meter_result.power_factor);
+            }
+        }
+        else if (monitor_is_enabled())
+        {
+            /* Only the captures around events are reported, by the command handler */
+        }
+        else
+        {
+            /* Convert the latest sample pair to Volts */
+            resultV_0 = Cy_SAR_CountsTo_Volts(SAR0, 0, sample_block[pair_count - 1UL].sar0);
+            resultV_1 = Cy_SAR_CountsTo_Volts(SAR1, 0, sample_block[pair_count - 1UL].sar1);
+
+            /* Queue the inputs of the latest sample pair. The message is dropped
+               if the UART cannot keep up with the sampling rate. */
+            (void)telemetry_printf("SAR0 input: %.2fV \t SAR1 input: %.2fV \t t: %lu.%06lu s\r\n",
+                                   resultV_0, resultV_1,
+                                   (unsigned long)(block_time / ACQ_TRIGGER_CLOCK_HZ),
+                                   (unsigned long)(((block_time % ACQ_TRIGGER_CLOCK_HZ) * 1000000ULL) / ACQ_TRIGGER_CLOCK_HZ));
+        }
+#endif
 
-        /* Product of the result obtained */
-        product_result = resultV_0 * resultV_1;
-        /* Scale the result of the product for range 0V to 3.3V and output to pin*/
-        Cy_CTDAC_SetValue(CTDAC0, (int)(product_result*SCALING_FACTOR));
+        /* Report the losses of every stage once per period */
+        stats_process(block_time);
 
-        /* Print the inputs and the result */
-        printf("SAR0 input: %.2fV \t SAR1 input: %.2fV\r\n", resultV_0, resultV_1);
+        profiler_record(PROFILER_TELEMETRY, profiler_now() - dac_time);
 
+        telemetry_service();
     }
 }
 
 /*******************************************************************************
-* Function Name: init_analog_resources
+* Function Name: read_block
 ********************************************************************************
 * Summary:
-* This function initializes analog components - CTBM, SAR ADC and CTDAC
+* This function returns the next block of sample pairs to process: the block
+* of the acquisition or, during a replay, the next block of the trace. The
+* acquisition keeps running during a replay; its blocks pace a real-time
+* replay and go to the event monitor, which follows the live inputs.
 *
 * Parameters:
-*  void
+*  pairs: Location to store the address of the first sample pair
+*  timestamps: Location to store the address of the first trigger time
+*  first_index: Location to store the index of the first sample pair, in
+*               scans since startup or in pairs since the start of the trace
+*  replayed: Location to store whether the block comes from the trace
 *
 * Return:
-*  void
+*  uint32_t: Number of sample pairs in the block, 0 if none is ready
 *
 *******************************************************************************/
-void init_analog_resources(void)
+static uint32_t read_block(const sample_pair_t **pairs, const uint64_t **timestamps, uint32_t *first_index,
+                           bool *replayed)
 {
-    /* Variable to capture return value of functions */
-    cy_rslt_t result;
-
-    /* Initialize AREF */
-    result = Cy_SysAnalog_Init(&pass_0_aref_0_config);
-    if (CY_SYSANALOG_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
-
-    /* Enable AREF */
-    Cy_SysAnalog_Enable();
-
-    /* Initialize common resources for SAR ADCs. */
-    /* Common resources include simultaneous trigger parameters, scan count
-       and power up delay. This is configured in the device configurator. */
-    result = Cy_SAR_CommonInit(PASS, &pass_0_saradc_0_config);
-    if (CY_SAR_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
-
-    /* Initialize SAR0 and SAR1 */
-    result = Cy_SAR_Init(SAR0, &pass_0_saradc_0_sar_0_config );
-    if (CY_SAR_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
-
-    result = Cy_SAR_Init(SAR1, &pass_0_saradc_0_sar_1_config );
-    if (CY_SAR_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
-
-    /* Enable SAR block */
-    Cy_SAR_Enable(SAR0);
-    Cy_SAR_Enable(SAR1);
-
-    Cy_SAR_SetInterruptMask(SAR0, CY_SAR_INTR);
-    Cy_SAR_SetInterruptMask(SAR1, CY_SAR_INTR);
-
-    (void)Cy_SysInt_Init(&SAR0_IRQ_cfg, sar0_interrupt);
-    (void)Cy_SysInt_Init(&SAR1_IRQ_cfg, sar1_interrupt);
-
-    /* Enable the SAR interrupts */
-    NVIC_EnableIRQ(SAR0_IRQ_cfg.intrSrc);
-    NVIC_EnableIRQ(SAR1_IRQ_cfg.intrSrc);
+    uint32_t count = acquisition_get_block(pairs);
 
-    /* Enable OpAmp for buffered output of CTDAC */
-    /* The routing from CTDAC to CTBM is configured using the design.modus file */
-    result = Cy_CTB_OpampInit(CTBM0, CY_CTB_OPAMP_0, &pass_0_ctb_0_oa_0_config);
-    if(CY_CTB_SUCCESS != result)
+    *replayed = replay_is_active();
+    if (*replayed)
     {
-        CY_ASSERT(0);
+        if (0UL != count)
+        {
+            monitor_process(*pairs, count, acquisition_get_scans() - count);
+        }
+        return replay_get_block(pairs, timestamps, first_index, count);
     }
 
-    /* Initialize DAC block*/
-    result = Cy_CTDAC_Init(CTDAC0, &pass_0_ctdac_0_config);
-    if(CY_CTDAC_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
+    *timestamps = acquisition_get_timestamps();
+    *first_index = acquisition_get_scans() - count;
+    return count;
+}
 
-    /* Enable OpAmp and CTDAC */
-    Cy_CTDAC_Enable(CTDAC0);
-    Cy_CTB_Enable(CTBM0);
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_TEXT)
+/*******************************************************************************
+* Function Name: consecutive_pairs
+********************************************************************************
+* Summary:
+* This function counts the sample pairs at the start of a block that follow
+* each other by the given interval, up to the first missed trigger.
+*
+* Parameters:
+*  timestamps: Trigger times of the sample pairs
+*  count: Number of sample pairs, at least 1
+*  interval: Trigger clocks between two sample pairs
+*
+* Return:
+*  uint32_t: Number of consecutive sample pairs, at least 1
+*
+*******************************************************************************/
+static uint32_t consecutive_pairs(const uint64_t *timestamps, uint32_t count, uint32_t interval)
+{
+    uint32_t index = 1UL;
 
-    /* Initialize TCPWM Counter */
-    result = Cy_TCPWM_Counter_Init(TCPWM0, TCPWM_CNT_NUM, &tcpwm_0_group_0_cnt_0_config);
-    if(CY_TCPWM_SUCCESS != result)
+    while ((index < count) && (timestamps[index] == (timestamps[index - 1UL] + interval)))
     {
-        CY_ASSERT(0);
+        index++;
     }
 
-    /* Enable the initialized counter */
-    Cy_TCPWM_Counter_Enable(TCPWM0, TCPWM_CNT_NUM);
+    return index;
 }
+#endif
 
+#if ((ACQ_NUM_CHANNELS > 1UL) && (TELEMETRY_FORMAT == TELEMETRY_FORMAT_TEXT))
 /*******************************************************************************
-* Function Name: sar0_interrupt
+* Function Name: report_channels
 ********************************************************************************
 * Summary:
-* This function is the handler for SAR0 interrupt
+*  This function queues the average input of every channel of both SARs over
+*  a block of scans.
 *
 * Parameters:
-*  None
+*  block: Channel block in microvolts
 *
 * Return:
-*  None
+*  void
 *
 *******************************************************************************/
-void sar0_interrupt(void)
+static void report_channels(const channel_block_t *block)
 {
-    /* Check if End-Of-Scan trigger has occurred. If yes, set sar0_isr_set flag to true  */
-    if (Cy_SAR_GetInterruptStatus(SAR0) & CY_SAR_INTR_EOS)
+    int64_t sum[ACQ_NUM_SARS];
+    uint32_t channel;
+    uint32_t sar;
+    uint32_t scan;
+
+    for (channel = 0UL; channel < ACQ_NUM_CHANNELS; channel++)
     {
-        sar0_isr_set = true;
-    }
+        for (sar = 0UL; sar < ACQ_NUM_SARS; sar++)
+        {
+            sum[sar] = 0;
+            for (scan = 0UL; scan < block->scans; scan++)
+            {
+                sum[sar] += block->value[channel][sar][scan];
+            }
+        }
 
-    /* Clear the interrupts */
-    Cy_SAR_ClearInterrupt(SAR0, CY_SAR_INTR);
+        (void)telemetry_printf("CH%lu SAR0: %ld mV \t SAR1: %ld mV\r\n", (unsigned long)channel,
+                               (long)(sum[0] / ((int64_t)block->scans * 1000)),
+                               (long)(sum[1] / ((int64_t)block->scans * 1000)));
+    }
 }
+#endif
 
 /*******************************************************************************
-* Function Name: sar1_interrupt
+* Function Name: init_analog_resources
 ********************************************************************************
 * Summary:
-* This function is the handler for SAR1 interrupt
+* This function initializes analog components - CTBM, SAR ADC and CTDAC
 *
 * Parameters:
-*  None
+*  void
 *
 * Return:
-*  None
+*  void
 *
 *******************************************************************************/
-void sar1_interrupt(void)
+void init_analog_resources(void)
 {
-    /* Check if End-Of-Scan trigger has occurred. If yes, set sar1_isr_set flag to true  */
-    if (Cy_SAR_GetInterruptStatus(SAR1) & CY_SAR_INTR_EOS)
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+#if (ACQ_DEEP_SLEEP != 0U)
+    /* Configurations of the device configurator, kept enabled in deep sleep */
+    cy_stc_sysanalog_config_t aref_config = pass_0_aref_0_config;
+    cy_stc_ctdac_config_t ctdac_config = pass_0_ctdac_0_config;
+
+    aref_config.deepSleep = CY_SYSANALOG_DEEPSLEEP_IPTAT_IZTAT_VREF;
+    ctdac_config.deepSleep = CY_CTDAC_DEEPSLEEP_ENABLE;
+#endif
+
+    /* Initialize AREF */
+#if (ACQ_DEEP_SLEEP != 0U)
+    result = Cy_SysAnalog_Init(&aref_config);
+#else
+    result = Cy_SysAnalog_Init(&pass_0_aref_0_config);
+#endif
+    if (CY_SYSANALOG_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Enable AREF */
+    Cy_SysAnalog_Enable();
+
+    /* Initialize SAR0, SAR1 and the TCPWM counter that triggers them */
+    acquisition_init();
+
+    /* Enable OpAmp for buffered output of CTDAC */
+    /* The routing from CTDAC to CTBM is configured using the design.modus file */
+    result = Cy_CTB_OpampInit(CTBM0, CY_CTB_OPAMP_0, &pass_0_ctb_0_oa_0_config);
+    if(CY_CTB_SUCCESS != result)
     {
-        sar1_isr_set = true;
+        CY_ASSERT(0);
     }
 
-    /* Clear the interrupts */
-    Cy_SAR_ClearInterrupt(SAR1, CY_SAR_INTR);
+#if (DAC_OUTPUT_MODE == DAC_MODE_DMA)
+    /* Initialize DAC block in buffered mode, fed by DMA */
+    dac_dma_init(CTDAC0);
+#else
+    /* Initialize DAC block*/
+#if (ACQ_DEEP_SLEEP != 0U)
+    result = Cy_CTDAC_Init(CTDAC0, &ctdac_config);
+#else
+    result = Cy_CTDAC_Init(CTDAC0, &pass_0_ctdac_0_config);
+#endif
+    if(CY_CTDAC_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    /* Keep the output buffer of the CTDAC powered in deep sleep */
+    Cy_CTB_SetDeepSleepMode(CTBM0, CY_CTB_DEEPSLEEP_ENABLE);
+#endif
+
+    /* Enable OpAmp and CTDAC */
+    Cy_CTDAC_Enable(CTDAC0);
+    Cy_CTB_Enable(CTBM0);
 }
+
 /* [] END OF FILE */
@@ -0,0 +1,353 @@
+/******************************************************************************
+* File Name:   meter.c
+*
+* Description: This file contains the power meter. It treats the results of
+*              SAR0 as voltage and of SAR1 as current, accumulates their
+*              products and squares over a window of sample pairs in 64-bit
+*              integers, and derives the real power, the RMS values, the
+*              apparent power and the power factor once per window.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include "meter.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Scale of the power factor in a packed record */
+#define METER_PF_SCALE      (10000.0f)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Derives the result of the completed window */
+static void meter_finish_window(void);
+
+/* Stores a 32-bit value in little endian order */
+static void meter_put_u32(uint8_t *buffer, uint32_t value);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Scales of the voltage and current results */
+static channel_scale_t meter_voltage_scale;
+static channel_scale_t meter_current_scale;
+
+/* Number of sample pairs per window */
+static uint32_t meter_window = METER_DEFAULT_WINDOW;
+
+/* Sums of the current window, in offset corrected counts */
+static int64_t meter_sum_vi = 0;
+static uint64_t meter_sum_vv = 0ULL;
+static uint64_t meter_sum_ii = 0ULL;
+static uint32_t meter_count = 0UL;
+
+/* Result of the last window */
+static meter_result_t meter_result;
+static bool meter_result_ready = false;
+
+/* Meter enable */
+static bool meter_enabled = false;
+
+/*******************************************************************************
+* Function Name: meter_init
+********************************************************************************
+* Summary:
+* This function sets the offsets and gains used to convert the results of
+* SAR0 and SAR1 to voltage and current, and clears the current window.
+*
+* Parameters:
+*  voltage: Channel scale of SAR0
+*  current: Channel scale of SAR1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void meter_init(const channel_scale_t *voltage, const channel_scale_t *current)
+{
+    meter_voltage_scale = *voltage;
+    meter_current_scale = *current;
+    meter_set_enabled(meter_enabled);
+}
+
+/*******************************************************************************
+* Function Name: meter_set_enabled
+********************************************************************************
+* Summary:
+* This function enables or disables the meter. The current window is cleared.
+*
+* Parameters:
+*  enabled: true to accumulate the sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void meter_set_enabled(bool enabled)
+{
+    meter_sum_vi = 0;
+    meter_sum_vv = 0ULL;
+    meter_sum_ii = 0ULL;
+    meter_count = 0UL;
+    meter_result_ready = false;
+    meter_enabled = enabled;
+}
+
+/*******************************************************************************
+* Function Name: meter_is_enabled
+********************************************************************************
+* Summary:
+* This function returns the state of the meter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if the meter is enabled
+*
+*******************************************************************************/
+bool meter_is_enabled(void)
+{
+    return meter_enabled;
+}
+
+/*******************************************************************************
+* Function Name: meter_set_window
+********************************************************************************
+* Summary:
+* This function changes the number of sample pairs per window and restarts
+* the current window.
+*
+* Parameters:
+*  pairs: Window from METER_MIN_WINDOW to METER_MAX_WINDOW sample pairs
+*
+* Return:
+*  bool: true if the window was changed, false if it is out of range
+*
+*******************************************************************************/
+bool meter_set_window(uint32_t pairs)
+{
+    if ((pairs < METER_MIN_WINDOW) || (pairs > METER_MAX_WINDOW))
+    {
+        return false;
+    }
+
+    meter_window = pairs;
+    meter_set_enabled(meter_enabled);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: meter_get_window
+********************************************************************************
+* Summary:
+* This function returns the number of sample pairs per window.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Sample pairs per window
+*
+*******************************************************************************/
+uint32_t meter_get_window(void)
+{
+    return meter_window;
+}
+
+/*******************************************************************************
+* Function Name: meter_process
+********************************************************************************
+* Summary:
+* This function adds a block of sample pairs to the sums of the current
+* window. The offsets are removed, so each product is below 2^24 in
+* magnitude and the 64-bit sums are exact. When the window is complete, its
+* result is derived and the next window starts with the rest of the block.
+*
+* Parameters:
+*  pairs: Sample pairs, SAR0 voltage and SAR1 current
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void meter_process(const sample_pair_t *pairs, uint32_t count)
+{
+    int32_t voltage;
+    int32_t current;
+    uint32_t index;
+
+    if (!meter_enabled)
+    {
+        return;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        voltage = (int32_t)pairs[index].sar0 - meter_voltage_scale.offset;
+        current = (int32_t)pairs[index].sar1 - meter_current_scale.offset;
+
+        meter_sum_vi += (int64_t)(voltage * current);
+        meter_sum_vv += (uint64_t)(voltage * voltage);
+        meter_sum_ii += (uint64_t)(current * current);
+
+        meter_count++;
+        if (meter_window == meter_count)
+        {
+            meter_finish_window();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: meter_get_result
+********************************************************************************
+* Summary:
+* This function returns the result of the last complete window, once.
+*
+* Parameters:
+*  result: Result to fill
+*
+* Return:
+*  bool: true if a window completed since the previous call
+*
+*******************************************************************************/
+bool meter_get_result(meter_result_t *result)
+{
+    if (!meter_result_ready)
+    {
+        return false;
+    }
+
+    *result = meter_result;
+    meter_result_ready = false;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: meter_pack_result
+********************************************************************************
+* Summary:
+* This function packs a result into a record of METER_RECORD_SIZE bytes in
+* micro units, see meter.h for the layout.
+*
+* Parameters:
+*  result: Result to pack
+*  record: Buffer of METER_RECORD_SIZE bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void meter_pack_result(const meter_result_t *result, uint8_t *record)
+{
+    meter_put_u32(&record[0], result->window);
+    meter_put_u32(&record[4], (uint32_t)(int32_t)lroundf(result->real_power * 1.0e6f));
+    meter_put_u32(&record[8], (uint32_t)lroundf(result->voltage_rms * 1.0e6f));
+    meter_put_u32(&record[12], (uint32_t)lroundf(result->current_rms * 1.0e6f));
+    meter_put_u32(&record[16], (uint32_t)lroundf(result->apparent_power * 1.0e6f));
+    meter_put_u32(&record[20], (uint32_t)(int32_t)lroundf(result->power_factor * METER_PF_SCALE));
+}
+
+/*******************************************************************************
+* Function Name: meter_finish_window
+********************************************************************************
+* Summary:
+* This function derives the result of the completed window from its sums and
+* clears the sums. The means are calculated in double precision once per
+* window; the gains of the channel scales convert them from counts to units.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void meter_finish_window(void)
+{
+    /* Units per count */
+    double voltage_gain = (double)meter_voltage_scale.gain * (1.0e-6 / (double)(1UL << CHANNEL_GAIN_SHIFT));
+    double current_gain = (double)meter_current_scale.gain * (1.0e-6 / (double)(1UL << CHANNEL_GAIN_SHIFT));
+    double count = (double)meter_count;
+    double real_power = ((double)meter_sum_vi / count) * voltage_gain * current_gain;
+    double voltage_rms = sqrt((double)meter_sum_vv / count) * fabs(voltage_gain);
+    double current_rms = sqrt((double)meter_sum_ii / count) * fabs(current_gain);
+    double apparent_power = voltage_rms * current_rms;
+
+    meter_result.window = meter_count;
+    meter_result.real_power = (float)real_power;
+    meter_result.voltage_rms = (float)voltage_rms;
+    meter_result.current_rms = (float)current_rms;
+    meter_result.apparent_power = (float)apparent_power;
+    meter_result.power_factor = (apparent_power > 0.0) ? (float)(real_power / apparent_power) : 0.0f;
+    meter_result_ready = true;
+
+    meter_sum_vi = 0;
+    meter_sum_vv = 0ULL;
+    meter_sum_ii = 0ULL;
+    meter_count = 0UL;
+}
+
+/*******************************************************************************
+* Function Name: meter_put_u32
+********************************************************************************
+* Summary:
+* This function stores a 32-bit value in little endian order.
+*
+* Parameters:
+*  buffer: Location of the 4 bytes
+*  value: Value to store
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void meter_put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8U);
+    buffer[2] = (uint8_t)(value >> 16U);
+    buffer[3] = (uint8_t)(value >> 24U);
+}
+
+/* [] END OF FILE */
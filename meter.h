@@ -0,0 +1,122 @@
+/******************************************************************************
+* File Name:   meter.h
+*
+* Description: This file contains the declarations of the power meter, which
+*              treats SAR0 as voltage and SAR1 as current.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef METER_H_
+#define METER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Range of the window, in sample pairs. A window never ends twice in one
+ * block, and the 64-bit sums cannot overflow.
+ */
+#define METER_MIN_WINDOW            (ACQ_CHANNEL_BLOCK_SCANS)
+#define METER_MAX_WINDOW            (1UL << 24U)
+
+/* Window used at startup */
+#ifndef METER_DEFAULT_WINDOW
+#define METER_DEFAULT_WINDOW        (1000UL)
+#endif
+
+/* Size of a packed result. Fields are little endian:
+ *
+ *  Offset  Size  Field
+ *  0       4     Number of sample pairs in the window
+ *  4       4     Real power, micro units, signed
+ *  8       4     Voltage RMS, micro units
+ *  12      4     Current RMS, micro units
+ *  16      4     Apparent power, micro units
+ *  20      4     Power factor x 10000, signed
+ */
+#define METER_RECORD_SIZE           (24UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Result of one window. The units follow the channel scales of channel 0:
+ * with the default scales in microvolts, the results are in V, V and V^2.
+ * When SAR1 is scaled to microamperes, the powers are in W and VA.
+ */
+typedef struct
+{
+    uint32_t window;        /* Number of sample pairs */
+    float real_power;       /* Mean of voltage x current */
+    float voltage_rms;      /* RMS of the voltage, including DC */
+    float current_rms;      /* RMS of the current, including DC */
+    float apparent_power;   /* Voltage RMS x current RMS */
+    float power_factor;     /* Real power / apparent power, 0 if undefined */
+} meter_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Sets the scales of the voltage and current results and clears the window */
+void meter_init(const channel_scale_t *voltage, const channel_scale_t *current);
+
+/* Enables or disables the meter, clearing the window */
+void meter_set_enabled(bool enabled);
+
+/* Returns true if the meter is enabled */
+bool meter_is_enabled(void);
+
+/* Changes the number of sample pairs per window */
+bool meter_set_window(uint32_t pairs);
+
+/* Returns the number of sample pairs per window */
+uint32_t meter_get_window(void);
+
+/* Adds a block of sample pairs to the current window */
+void meter_process(const sample_pair_t *pairs, uint32_t count);
+
+/* Returns the result of the last window, once */
+bool meter_get_result(meter_result_t *result);
+
+/* Packs a result into METER_RECORD_SIZE bytes */
+void meter_pack_result(const meter_result_t *result, uint8_t *record);
+
+#endif /* METER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,487 @@
+/******************************************************************************
+* File Name:   monitor.c
+*
+* Description: This file contains the event monitor. The SAR window comparator
+*              detects the excursions in hardware, so the monitor only keeps a
+*              history of the sample pairs and searches the blocks flagged by an
+*              event for the trigger, then captures the pairs around it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "monitor.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of blocks searched for the result that raised an event. The event
+ * is raised before its block is read, so it is found in the next block
+ * unless the conversion was not kept, for example by averaging.
+ */
+#define MONITOR_SEARCH_BLOCKS       (2UL)
+
+/* Results of a saturated conversion */
+#define MONITOR_SAT_LOW             (-2048)
+#define MONITOR_SAT_HIGH            (2047)
+
+#if ((MONITOR_HISTORY_SIZE & (MONITOR_HISTORY_SIZE - 1UL)) != 0UL)
+#error "MONITOR_HISTORY_SIZE must be a power of two"
+#endif
+
+#if (MONITOR_HISTORY_SIZE < (MONITOR_CAPTURE_PAIRS + ACQ_CHANNEL_BLOCK_SCANS))
+#error "MONITOR_HISTORY_SIZE must hold a capture and a block"
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* States of the monitor */
+typedef enum
+{
+    MONITOR_OFF,        /* Disabled */
+    MONITOR_ARMED,      /* Waiting for an event */
+    MONITOR_POST,       /* Collecting the pairs after the trigger */
+    MONITOR_READY       /* Capture waiting for monitor_release() */
+} monitor_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Index of the first pair of a block that matches the events, or count if none */
+static uint32_t monitor_find_trigger(const sample_pair_t *pairs, uint32_t count, uint32_t events);
+
+/* Applies the window of one SAR to its comparator */
+static bool monitor_apply(uint32_t sar, const monitor_window_t *window);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static monitor_state_t monitor_state = MONITOR_OFF;
+
+/* Windows of the comparators of both SARs */
+static monitor_window_t monitor_windows[ACQ_NUM_SARS];
+
+/* Latest sample pairs, indexed by scan, and the scans they cover */
+static sample_pair_t monitor_history[MONITOR_HISTORY_SIZE];
+static uint32_t monitor_history_start = 0UL;
+static uint32_t monitor_history_end = 0UL;
+
+/* Events waiting to be located and the blocks searched for them */
+static uint32_t monitor_pending = 0UL;
+static uint32_t monitor_searched = 0UL;
+
+/* Capture of the current event */
+static sample_pair_t monitor_capture[MONITOR_CAPTURE_PAIRS];
+static monitor_event_t monitor_event;
+static bool monitor_event_ready = false;
+
+/*******************************************************************************
+* Function Name: monitor_init
+********************************************************************************
+* Summary:
+* This function applies the default window to the comparators of both SARs
+* with the monitor disabled. The acquisition must be initialized.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void monitor_init(void)
+{
+    uint32_t sar;
+
+    monitor_state = MONITOR_OFF;
+    acquisition_enable_monitor(false);
+
+    for (sar = 0UL; sar < ACQ_NUM_SARS; sar++)
+    {
+        monitor_windows[sar].channels = MONITOR_DEFAULT_CHANNELS;
+        monitor_windows[sar].cond = MONITOR_DEFAULT_COND;
+        monitor_windows[sar].low_mv = MONITOR_DEFAULT_LOW_MV;
+        monitor_windows[sar].high_mv = MONITOR_DEFAULT_HIGH_MV;
+        (void)monitor_apply(sar, &monitor_windows[sar]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: monitor_set_enabled
+********************************************************************************
+* Summary:
+* This function enables or disables the comparator interrupts and the
+* capture. Any capture in progress or not yet reported is discarded.
+*
+* Parameters:
+*  enabled: true to enable the monitor
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void monitor_set_enabled(bool enabled)
+{
+    /* The history restarts with the next block */
+    monitor_history_start = acquisition_get_scans();
+    monitor_history_end = monitor_history_start;
+    monitor_pending = 0UL;
+    monitor_searched = 0UL;
+    monitor_event_ready = false;
+    monitor_state = enabled ? MONITOR_ARMED : MONITOR_OFF;
+
+    acquisition_enable_monitor(enabled);
+}
+
+/*******************************************************************************
+* Function Name: monitor_is_enabled
+********************************************************************************
+* Summary:
+* This function returns the state of the monitor.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if the monitor is enabled
+*
+*******************************************************************************/
+bool monitor_is_enabled(void)
+{
+    return (MONITOR_OFF != monitor_state);
+}
+
+/*******************************************************************************
+* Function Name: monitor_set_window
+********************************************************************************
+* Summary:
+* This function changes the window of the comparator of one SAR: the
+* channels compared, the condition that raises an event and the limits. The
+* SAR has one pair of limits, shared by the channels compared. If the monitor
+* is enabled, it is armed again: events raised with the previous window and
+* any capture are discarded.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  window: Window to apply
+*
+* Return:
+*  bool: true if the window was changed, false if it is invalid
+*
+*******************************************************************************/
+bool monitor_set_window(uint32_t sar, const monitor_window_t *window)
+{
+    if (!monitor_apply(sar, window))
+    {
+        return false;
+    }
+
+    monitor_windows[sar] = *window;
+    if (monitor_is_enabled())
+    {
+        monitor_set_enabled(true);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: monitor_get_window
+********************************************************************************
+* Summary:
+* This function returns the window of the comparator of one SAR.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  window: Location to store the window
+*
+* Return:
+*  bool: true if the SAR exists
+*
+*******************************************************************************/
+bool monitor_get_window(uint32_t sar, monitor_window_t *window)
+{
+    if (sar >= ACQ_NUM_SARS)
+    {
+        return false;
+    }
+
+    *window = monitor_windows[sar];
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: monitor_process
+********************************************************************************
+* Summary:
+* This function adds a block of sample pairs to the history. If the SAR
+* comparators raised an event, the block is searched for the first result
+* that caused it, which becomes the trigger. Once MONITOR_POST_PAIRS pairs
+* follow the trigger, the pairs around it are copied to the capture. Without
+* events, the cost is the copy of the block.
+*
+* Parameters:
+*  pairs: Sample pairs of the block, before the decimation filter
+*  count: Number of sample pairs
+*  first_index: Index of the first sample pair, in scans since startup or in
+*               pairs since the start of a replayed trace
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void monitor_process(const sample_pair_t *pairs, uint32_t count, uint32_t first_index)
+{
+    uint32_t trigger;
+    uint32_t start;
+    uint32_t index;
+
+    if (MONITOR_OFF == monitor_state)
+    {
+        return;
+    }
+
+    /* A block not passed to the monitor breaks the history */
+    if (first_index != monitor_history_end)
+    {
+        monitor_history_start = first_index;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        monitor_history[(first_index + index) & (MONITOR_HISTORY_SIZE - 1UL)] = pairs[index];
+    }
+    monitor_history_end = first_index + count;
+
+    if (MONITOR_ARMED == monitor_state)
+    {
+        monitor_pending |= acquisition_take_events();
+        if (0UL != monitor_pending)
+        {
+            index = monitor_find_trigger(pairs, count, monitor_pending);
+            monitor_searched++;
+
+            /* An event that is not found is placed at the start of the last block searched */
+            if ((index < count) || (monitor_searched >= MONITOR_SEARCH_BLOCKS))
+            {
+                monitor_event.events = monitor_pending;
+                monitor_event.scan = first_index + ((index < count) ? index : 0UL);
+                monitor_pending = 0UL;
+                monitor_searched = 0UL;
+                monitor_state = MONITOR_POST;
+            }
+        }
+    }
+
+    if ((MONITOR_POST == monitor_state) &&
+        ((monitor_history_end - monitor_event.scan) >= MONITOR_POST_PAIRS))
+    {
+        trigger = monitor_event.scan;
+        monitor_event.pre = trigger - monitor_history_start;
+        if (monitor_event.pre > MONITOR_PRE_PAIRS)
+        {
+            monitor_event.pre = MONITOR_PRE_PAIRS;
+        }
+        monitor_event.pairs = monitor_event.pre + MONITOR_POST_PAIRS;
+
+        start = trigger - monitor_event.pre;
+        for (index = 0UL; index < monitor_event.pairs; index++)
+        {
+            monitor_capture[index] = monitor_history[(start + index) & (MONITOR_HISTORY_SIZE - 1UL)];
+        }
+        monitor_event.capture = monitor_capture;
+
+        monitor_event_ready = true;
+        monitor_state = MONITOR_READY;
+    }
+}
+
+/*******************************************************************************
+* Function Name: monitor_get_event
+********************************************************************************
+* Summary:
+* This function returns the capture of the last event once it is complete.
+* Each capture is returned once, and stays valid until monitor_release().
+*
+* Parameters:
+*  event: Location to store the event
+*
+* Return:
+*  bool: true if a new capture was stored
+*
+*******************************************************************************/
+bool monitor_get_event(monitor_event_t *event)
+{
+    if (!monitor_event_ready)
+    {
+        return false;
+    }
+
+    monitor_event_ready = false;
+    *event = monitor_event;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: monitor_release
+********************************************************************************
+* Summary:
+* This function releases the capture and arms the monitor again. Events
+* raised while the capture was held are discarded, and the comparator
+* interrupts are enabled again.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void monitor_release(void)
+{
+    if (MONITOR_READY == monitor_state)
+    {
+        monitor_event_ready = false;
+        monitor_state = MONITOR_ARMED;
+        acquisition_rearm_monitor();
+    }
+}
+
+/*******************************************************************************
+* Function Name: monitor_pack_event
+********************************************************************************
+* Summary:
+* This function packs an event into a binary record, see MONITOR_RECORD_SIZE.
+*
+* Parameters:
+*  event: Event to pack
+*  record: Location of MONITOR_RECORD_SIZE bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void monitor_pack_event(const monitor_event_t *event, uint8_t *record)
+{
+    record[0] = (uint8_t)event->events;
+    record[1] = (uint8_t)event->scan;
+    record[2] = (uint8_t)(event->scan >> 8U);
+    record[3] = (uint8_t)(event->scan >> 16U);
+    record[4] = (uint8_t)(event->scan >> 24U);
+    record[5] = (uint8_t)event->pre;
+    record[6] = (uint8_t)(event->pre >> 8U);
+    record[7] = (uint8_t)event->pairs;
+    record[8] = (uint8_t)(event->pairs >> 8U);
+}
+
+/*******************************************************************************
+* Function Name: monitor_find_trigger
+********************************************************************************
+* Summary:
+* This function searches a block for the first sample pair that matches the
+* events: a result of channel 0 that meets the condition of a SAR with a
+* range event, or a saturated result of a SAR with a saturation event. An
+* event of another channel is not found in the block.
+*
+* Parameters:
+*  pairs: Sample pairs of the block
+*  count: Number of sample pairs
+*  events: ACQ_EVENT_ bits to match
+*
+* Return:
+*  uint32_t: Index of the first matching pair, count if none matches
+*
+*******************************************************************************/
+static uint32_t monitor_find_trigger(const sample_pair_t *pairs, uint32_t count, uint32_t events)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < count; index++)
+    {
+        if ((0UL != (events & ACQ_EVENT_RANGE_SAR0)) && acquisition_in_window(0UL, pairs[index].sar0))
+        {
+            break;
+        }
+        if ((0UL != (events & ACQ_EVENT_RANGE_SAR1)) && acquisition_in_window(1UL, pairs[index].sar1))
+        {
+            break;
+        }
+        if ((0UL != (events & ACQ_EVENT_SAT_SAR0)) &&
+            ((pairs[index].sar0 <= MONITOR_SAT_LOW) || (pairs[index].sar0 >= MONITOR_SAT_HIGH)))
+        {
+            break;
+        }
+        if ((0UL != (events & ACQ_EVENT_SAT_SAR1)) &&
+            ((pairs[index].sar1 <= MONITOR_SAT_LOW) || (pairs[index].sar1 >= MONITOR_SAT_HIGH)))
+        {
+            break;
+        }
+    }
+
+    return index;
+}
+
+/*******************************************************************************
+* Function Name: monitor_apply
+********************************************************************************
+* Summary:
+* This function converts the limits of a window to microvolts and applies it
+* to the comparator of one SAR.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  window: Window to apply
+*
+* Return:
+*  bool: true if the window was applied, false if it is invalid
+*
+*******************************************************************************/
+static bool monitor_apply(uint32_t sar, const monitor_window_t *window)
+{
+    acq_window_t limits;
+
+    if ((window->low_mv < (INT32_MIN / 1000L)) || (window->high_mv > (INT32_MAX / 1000L)))
+    {
+        return false;
+    }
+
+    limits.channels = window->channels;
+    limits.cond = window->cond;
+    limits.low_uv = window->low_mv * 1000L;
+    limits.high_uv = window->high_mv * 1000L;
+    return acquisition_set_monitor(sar, &limits);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name:   monitor.h
+*
+* Description: This file contains the declarations of the event monitor, which
+*              captures the sample pairs around the events of the SAR window
+*              comparator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MONITOR_H_
+#define MONITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Sample pairs kept before and after the trigger of each capture */
+#ifndef MONITOR_PRE_PAIRS
+#define MONITOR_PRE_PAIRS           (128UL)
+#endif
+#ifndef MONITOR_POST_PAIRS
+#define MONITOR_POST_PAIRS          (128UL)
+#endif
+
+#define MONITOR_CAPTURE_PAIRS       (MONITOR_PRE_PAIRS + MONITOR_POST_PAIRS)
+
+/* History of the latest sample pairs. It holds a capture and the block that
+ * completes it. Must be a power of two.
+ */
+#define MONITOR_HISTORY_SIZE        (512UL)
+
+/* Window applied to both SARs at startup: channel 0, outside 300 to 3000 mV */
+#define MONITOR_DEFAULT_CHANNELS    (1UL)
+#define MONITOR_DEFAULT_COND        (ACQ_RANGE_OUTSIDE)
+#define MONITOR_DEFAULT_LOW_MV      (300L)
+#define MONITOR_DEFAULT_HIGH_MV     (3000L)
+
+/* Binary record of an event, followed by the capture in sample frames.
+ * Multi-byte fields are little endian.
+ *
+ *  Offset  Size  Field
+ *  0       1     ACQ_EVENT_ bits that triggered the capture
+ *  1       4     Scan of the trigger since startup
+ *  5       2     Sample pairs before the trigger
+ *  7       2     Sample pairs in the capture
+ */
+#define MONITOR_RECORD_SIZE         (9UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Window of the comparator of one SAR, see acquisition_set_monitor() */
+typedef struct
+{
+    uint32_t channels;      /* Channels compared, bit n for channel n, 0 for none */
+    uint32_t cond;          /* ACQ_RANGE_ condition that raises an event */
+    int32_t low_mv;         /* Low limit in millivolts */
+    int32_t high_mv;        /* High limit in millivolts, above the low limit */
+} monitor_window_t;
+
+/* Capture around one event */
+typedef struct
+{
+    uint32_t events;                /* ACQ_EVENT_ bits that triggered the capture */
+    uint32_t scan;                  /* Index of the trigger pair, in scans since startup or in
+                                       pairs since the start of a replayed trace */
+    uint32_t pre;                   /* Sample pairs before the trigger */
+    uint32_t pairs;                 /* Sample pairs in the capture */
+    const sample_pair_t *capture;   /* Sample pairs, valid until monitor_release() */
+} monitor_event_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Applies the default window to both SARs with the monitor disabled */
+void monitor_init(void);
+
+/* Enables or disables the monitor, discarding any capture */
+void monitor_set_enabled(bool enabled);
+
+/* Returns true if the monitor is enabled */
+bool monitor_is_enabled(void);
+
+/* Changes the window of the comparator of one SAR */
+bool monitor_set_window(uint32_t sar, const monitor_window_t *window);
+
+/* Returns the window of the comparator of one SAR */
+bool monitor_get_window(uint32_t sar, monitor_window_t *window);
+
+/* Adds a block of sample pairs, before decimation, to the history and the capture */
+void monitor_process(const sample_pair_t *pairs, uint32_t count, uint32_t first_index);
+
+/* Returns the completed capture, once */
+bool monitor_get_event(monitor_event_t *event);
+
+/* Releases the capture and arms the monitor for the next event */
+void monitor_release(void);
+
+/* Packs an event into MONITOR_RECORD_SIZE bytes */
+void monitor_pack_event(const monitor_event_t *event, uint8_t *record);
+
+#endif /* MONITOR_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,199 @@
+/******************************************************************************
+* File Name:   power.c
+*
+* Description: This file contains the sleep control of the main loop, which
+*              enters deep sleep between the FIFO batches of the deep sleep
+*              acquisition, and measures the wakeups and the active time of the
+*              CPU.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "power.h"
+#include "acquisition.h"
+#include "profiler.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Activity of the current interval */
+static uint32_t power_wakeups = 0UL;
+static uint32_t power_deep_sleeps = 0UL;
+static uint64_t power_active_ticks = 0ULL;
+
+/* Profiler time of the last wakeup */
+static uint32_t power_wake_time = 0UL;
+
+/* Trigger time at the start of the interval */
+static uint64_t power_start_time = 0ULL;
+
+/*******************************************************************************
+* Function Name: power_init
+********************************************************************************
+* Summary:
+* This function starts the first measurement interval. The profiler must be
+* initialized.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void power_init(void)
+{
+    power_wakeups = 0UL;
+    power_deep_sleeps = 0UL;
+    power_active_ticks = 0ULL;
+    power_start_time = acquisition_get_trigger_time();
+    power_wake_time = profiler_now();
+}
+
+/*******************************************************************************
+* Function Name: power_sleep
+********************************************************************************
+* Summary:
+* This function puts the CPU to sleep until the next interrupt. With
+* ACQ_DEEP_SLEEP, it enters deep sleep when no telemetry is waiting and the
+* UART has sent its last byte, and falls back to sleep if a deep sleep
+* callback rejects the transition. The time from the previous wakeup is added
+* to the active time. Interrupt handlers run before this function returns and
+* are not included.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void power_sleep(void)
+{
+    power_active_ticks += (uint64_t)(profiler_now() - power_wake_time);
+
+#if (ACQ_DEEP_SLEEP != 0U)
+    if ((!telemetry_is_pending()) &&
+        (!cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj)) &&
+        (CY_SYSPM_SUCCESS == Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT)))
+    {
+        power_deep_sleeps++;
+    }
+    else
+#endif
+    {
+        (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+    }
+
+    power_wakeups++;
+    power_wake_time = profiler_now();
+}
+
+/*******************************************************************************
+* Function Name: power_get_activity
+********************************************************************************
+* Summary:
+* This function returns the activity of the CPU since the previous call, or
+* since power_init(), and starts a new interval. The profiler counter does
+* not run in deep sleep, so the duration is derived from the trigger time,
+* which keeps counting while the monitor holds the DMA blocks. Intervals must
+* be shorter than about 71 minutes.
+*
+* Parameters:
+*  activity: Location to store the activity
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void power_get_activity(power_activity_t *activity)
+{
+    uint64_t now = acquisition_get_trigger_time();
+
+    activity->elapsed_us = (uint32_t)(((now - power_start_time) * 1000000ULL) / ACQ_TRIGGER_CLOCK_HZ);
+    activity->wakeups = power_wakeups;
+    activity->deep_sleeps = power_deep_sleeps;
+    activity->active_us = (uint32_t)((power_active_ticks * 1000000ULL) / profiler_ticks_per_second());
+
+    power_start_time = now;
+    power_wakeups = 0UL;
+    power_deep_sleeps = 0UL;
+    power_active_ticks = 0ULL;
+}
+
+/*******************************************************************************
+* Function Name: power_report
+********************************************************************************
+* Summary:
+* This function queues the wakeups per second and the active duty cycle of
+* the CPU since the previous report on the telemetry output.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void power_report(void)
+{
+    power_activity_t activity;
+    uint32_t wakeup_rate_x10;
+    uint32_t duty_x100;
+
+    power_get_activity(&activity);
+
+    if (0UL == activity.elapsed_us)
+    {
+        (void)telemetry_printf("Power: no scans since the last report\r\n");
+        return;
+    }
+
+    wakeup_rate_x10 = (uint32_t)(((uint64_t)activity.wakeups * 10000000ULL) / activity.elapsed_us);
+    duty_x100 = (uint32_t)(((uint64_t)activity.active_us * 10000ULL) / activity.elapsed_us);
+
+    (void)telemetry_printf("Power: %lu.%lu wakeups/s (%lu of %lu in deep sleep), active %lu.%02lu %% of %lu ms\r\n",
+                           (unsigned long)(wakeup_rate_x10 / 10UL), (unsigned long)(wakeup_rate_x10 % 10UL),
+                           (unsigned long)activity.deep_sleeps, (unsigned long)activity.wakeups,
+                           (unsigned long)(duty_x100 / 100UL), (unsigned long)(duty_x100 % 100UL),
+                           (unsigned long)(activity.elapsed_us / 1000UL));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name:   power.h
+*
+* Description: This file contains the declarations of the CPU sleep control
+*              and of the wakeup and duty cycle statistics.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Activity of the CPU over a measurement interval */
+typedef struct
+{
+    uint32_t elapsed_us;        /* Duration, from the scans acquired */
+    uint32_t wakeups;           /* Returns from sleep or deep sleep */
+    uint32_t deep_sleeps;       /* Sleeps that entered deep sleep */
+    uint32_t active_us;         /* Time spent by the main loop between sleeps */
+} power_activity_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the first measurement interval */
+void power_init(void);
+
+/* Sleeps until the next interrupt, in deep sleep when possible */
+void power_sleep(void);
+
+/* Returns the activity since the previous call and starts a new interval */
+void power_get_activity(power_activity_t *activity);
+
+/* Queues the activity since the previous report on the telemetry output */
+void power_report(void);
+
+#endif /* POWER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,267 @@
+/******************************************************************************
+* File Name:   processing.c
+*
+* Description: This file contains the sample processing that turns the
+*              SAR0 and SAR1 results into the CTDAC output code with
+*              fixed-point arithmetic.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "processing.h"
+
+/* The host tests set PROCESSING_USE_DSP to check the DSP path */
+#ifndef PROCESSING_USE_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define PROCESSING_USE_DSP  (1)
+#else
+#define PROCESSING_USE_DSP  (0)
+#endif
+#endif
+
+#if (PROCESSING_USE_DSP == 1)
+#include "cmsis_compiler.h"
+#endif
+
+/*******************************************************************************
+* Function Name: processing_product_calib_init
+********************************************************************************
+* Summary:
+*  Precomputes the offsets and the gain of the fixed-point product. The
+*  conversion of each SAR channel is linear, so two points of its counts to
+*  microvolts conversion, at 0 and CALIB_SPAN_COUNTS counts, are enough to
+*  recover its offset and gain. This function is called once, so it uses
+*  double precision to keep the quantization of the gain to a minimum.
+*
+* Parameters:
+*  calib: Product constants to initialize
+*  sar0_uv_zero: SAR0 input in microvolts for a result of 0 counts
+*  sar0_uv_span: SAR0 input in microvolts for a result of CALIB_SPAN_COUNTS
+*  sar1_uv_zero: SAR1 input in microvolts for a result of 0 counts
+*  sar1_uv_span: SAR1 input in microvolts for a result of CALIB_SPAN_COUNTS
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void processing_product_calib_init(product_calib_t *calib,
+                                   int32_t sar0_uv_zero, int32_t sar0_uv_span,
+                                   int32_t sar1_uv_zero, int32_t sar1_uv_span)
+{
+    /* Microvolts per count of each SAR */
+    double gain0 = (double)(sar0_uv_span - sar0_uv_zero) / (double)CALIB_SPAN_COUNTS;
+    double gain1 = (double)(sar1_uv_span - sar1_uv_zero) / (double)CALIB_SPAN_COUNTS;
+
+    /* The PDL conversion subtracts an integer offset in counts */
+    calib->offset0 = (int32_t)lround(-(double)sar0_uv_zero / gain0);
+    calib->offset1 = (int32_t)lround(-(double)sar1_uv_zero / gain1);
+
+    /* CTDAC codes per count squared: gain0 * gain1 in V^2 times SCALING_FACTOR */
+    calib->gain = (int64_t)llround(((gain0 * 1.0e-6) * (gain1 * 1.0e-6) * SCALING_FACTOR)
+                                   * (double)(1ULL << PRODUCT_GAIN_SHIFT));
+}
+
+/*******************************************************************************
+* Function Name: processing_counts_to_dac_code
+********************************************************************************
+* Summary:
+*  Calculates the product of the two input voltages from the raw SAR results
+*  and scales it for the range 0V to 3.3V of the CTDAC output, using integer
+*  arithmetic only. Products that fall outside the range of the CTDAC are
+*  saturated. See product_calib_t for the error bound.
+*
+* Parameters:
+*  calib: Product constants from processing_product_calib_init()
+*  counts0: Result of SAR0
+*  counts1: Result of SAR1
+*
+* Return:
+*  uint32_t: CTDAC code in the range 0 to DAC_CODE_MAX
+*
+*******************************************************************************/
+uint32_t processing_counts_to_dac_code(const product_calib_t *calib,
+                                       int16_t counts0, int16_t counts1)
+{
+    /* Product of the offset corrected results, at most 2^24 in magnitude */
+    int32_t product = ((int32_t)counts0 - calib->offset0) * ((int32_t)counts1 - calib->offset1);
+
+    /* Scale to CTDAC codes with rounding */
+    int64_t dac_code = (((int64_t)product * calib->gain) + (1LL << (PRODUCT_GAIN_SHIFT - 1U)))
+                       >> PRODUCT_GAIN_SHIFT;
+
+    /* An input slightly below ground gives a negative product */
+    if (dac_code <= 0)
+    {
+        return 0UL;
+    }
+
+    if (dac_code >= (int64_t)DAC_CODE_MAX)
+    {
+        return DAC_CODE_MAX;
+    }
+
+    return (uint32_t)dac_code;
+}
+
+/*******************************************************************************
+* Function Name: processing_block_to_dac
+********************************************************************************
+* Summary:
+*  Calculates the CTDAC codes of a block of sample pairs, with the same
+*  result as processing_counts_to_dac_code() for every 12-bit pair. With
+*  realistic SAR calibrations the gain fits in 32 bits and the offsets are
+*  within PRODUCT_MAX_OFFSET, so the differences fit in 16 bits and the loop
+*  only needs a 32x32-bit multiply-accumulate per pair. With the DSP
+*  extension, the offsets of both results are subtracted by one SSUB16,
+*  which wraps modulo 2^16, and the results are multiplied by one SMUADX. Without it, the loop is plain
+*  integer C that the compiler can vectorize.
+*
+* Parameters:
+*  calib: Product constants from processing_product_calib_init()
+*  pairs: Sample pairs
+*  codes: CTDAC codes in the range 0 to DAC_CODE_MAX, one per sample pair
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void processing_block_to_dac(const product_calib_t *calib, const sample_pair_t *pairs,
+                             uint16_t *codes, uint32_t count)
+{
+    int32_t gain = (int32_t)calib->gain;
+    int64_t dac_code;
+    uint32_t index;
+#if (PROCESSING_USE_DSP == 1)
+    uint32_t offsets = ((uint32_t)(uint16_t)calib->offset1 << 16U) | (uint32_t)(uint16_t)calib->offset0;
+    uint32_t pair;
+    uint32_t difference;
+#endif
+
+    if ((calib->gain > INT32_MAX) || (calib->gain < 0) ||
+        (calib->offset0 > PRODUCT_MAX_OFFSET) || (calib->offset0 < -PRODUCT_MAX_OFFSET) ||
+        (calib->offset1 > PRODUCT_MAX_OFFSET) || (calib->offset1 < -PRODUCT_MAX_OFFSET))
+    {
+        for (index = 0UL; index < count; index++)
+        {
+            codes[index] = (uint16_t)processing_counts_to_dac_code(calib, pairs[index].sar0, pairs[index].sar1);
+        }
+        return;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+#if (PROCESSING_USE_DSP == 1)
+        /* {sar1 - offset1, sar0 - offset0}, then their product */
+        (void)memcpy(&pair, &pairs[index], sizeof(pair));
+        difference = __SSUB16(pair, offsets);
+        dac_code = (int64_t)(int32_t)__SMUADX(difference, difference & 0xFFFFUL) * gain;
+#else
+        dac_code = (int64_t)(((int32_t)pairs[index].sar0 - calib->offset0) *
+                             ((int32_t)pairs[index].sar1 - calib->offset1)) * gain;
+#endif
+
+        /* Round and saturate to the range of the CTDAC */
+        dac_code = (dac_code + (1LL << (PRODUCT_GAIN_SHIFT - 1U))) >> PRODUCT_GAIN_SHIFT;
+#if (PROCESSING_USE_DSP == 1)
+        /* DAC_CODE_MAX is the largest 12-bit value */
+        codes[index] = (uint16_t)__USAT((int32_t)dac_code, 12U);
+#else
+        if (dac_code < 0)
+        {
+            dac_code = 0;
+        }
+        if (dac_code > (int64_t)DAC_CODE_MAX)
+        {
+            dac_code = (int64_t)DAC_CODE_MAX;
+        }
+        codes[index] = (uint16_t)dac_code;
+#endif
+    }
+}
+
+/*******************************************************************************
+* Function Name: processing_channel_scale_init
+********************************************************************************
+* Summary:
+*  Derives the offset and the gain of a channel scale in microvolts from two
+*  points of the counts to microvolts conversion of a SAR channel, at 0 and
+*  CALIB_SPAN_COUNTS counts.
+*
+* Parameters:
+*  scale: Channel scale to initialize
+*  uv_zero: Input in microvolts for a result of 0 counts
+*  uv_span: Input in microvolts for a result of CALIB_SPAN_COUNTS
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void processing_channel_scale_init(channel_scale_t *scale, int32_t uv_zero, int32_t uv_span)
+{
+    /* Microvolts per count */
+    double gain = (double)(uv_span - uv_zero) / (double)CALIB_SPAN_COUNTS;
+
+    scale->offset = (int32_t)lround(-(double)uv_zero / gain);
+    scale->gain = (int32_t)lround(gain * (double)(1UL << CHANNEL_GAIN_SHIFT));
+}
+
+/*******************************************************************************
+* Function Name: processing_scale_counts
+********************************************************************************
+* Summary:
+*  Scales a SAR result with the offset and the gain of its channel, rounded
+*  to the nearest unit.
+*
+* Parameters:
+*  scale: Channel scale of the SAR channel
+*  counts: Result of the SAR channel
+*
+* Return:
+*  int32_t: Scaled result
+*
+*******************************************************************************/
+int32_t processing_scale_counts(const channel_scale_t *scale, int16_t counts)
+{
+    int64_t value = ((int64_t)((int32_t)counts - scale->offset) * scale->gain)
+                    + (1LL << (CHANNEL_GAIN_SHIFT - 1U));
+
+    return (int32_t)(value >> CHANNEL_GAIN_SHIFT);
+}
+
+/* [] END OF FILE */
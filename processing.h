@@ -0,0 +1,144 @@
+/******************************************************************************
+* File Name:   processing.h
+*
+* Description: This file contains the declarations of the sample processing
+*              functions. These functions do not access any peripheral and
+*              can be compiled independently of the PDL.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROCESSING_H_
+#define PROCESSING_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/*
+ * Scaling factor is to reduce the product of inputs to range of 0V - 3.3V
+ * The values to be set in CTDAC next value register is from 0 to 4095
+ * The maximum product of two inputs can be 3.3V*3.3V = 10.89V
+ * So 4095 represents 10.89V; 1V is represented by 372
+ * Since the output on Analog pin ranges from 0 to 3.3V, the output measured
+ * on the pin is to be multiplied with 3.3 to get the correct result.
+ *
+ */
+#define SCALING_FACTOR      (372)
+
+/* Largest value accepted by the CTDAC value register */
+#define DAC_CODE_MAX        (4095UL)
+
+/* Number of counts between the two points used to derive the gain of a SAR
+ * channel from its counts to microvolts conversion.
+ */
+#define CALIB_SPAN_COUNTS   (2047L)
+
+/* Number of fractional bits of the product gain */
+#define PRODUCT_GAIN_SHIFT  (32U)
+
+/* Largest offset of a SAR for which the difference between any 12-bit
+ * result, -2048 to 2047, and the offset fits in 16 bits.
+ */
+#define PRODUCT_MAX_OFFSET  (32767L - 2048L)
+
+/* Number of fractional bits of the gain of a channel scale */
+#define CHANNEL_GAIN_SHIFT  (16U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Results of one simultaneous conversion of SAR0 and SAR1 */
+typedef struct
+{
+    int16_t sar0;
+    int16_t sar1;
+} sample_pair_t;
+
+/* Constants of the fixed-point product, precomputed from the SAR calibration.
+ *
+ * dac_code = ((counts0 - offset0) * (counts1 - offset1) * gain) >> 32
+ *
+ * The result differs from the exact product of the calibrated input voltages
+ * multiplied by SCALING_FACTOR by at most 0.5 code from the final rounding,
+ * plus less than 0.01 code from the quantization of gain. It therefore
+ * differs from the truncated float calculation by at most 1 code.
+ */
+typedef struct
+{
+    int32_t offset0;        /* SAR0 counts at 0 V */
+    int32_t offset1;        /* SAR1 counts at 0 V */
+    int64_t gain;           /* CTDAC codes per count squared, Q32 */
+} product_calib_t;
+
+/* Linear scaling of the results of one SAR channel.
+ *
+ * value = ((counts - offset) * gain) >> 16
+ *
+ * When derived from the SAR calibration, value is in microvolts.
+ */
+typedef struct
+{
+    int32_t offset;         /* Counts at a value of 0 */
+    int32_t gain;           /* Units per count, Q16 */
+} channel_scale_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Derives the product constants from two points of each SAR conversion */
+void processing_product_calib_init(product_calib_t *calib,
+                                   int32_t sar0_uv_zero, int32_t sar0_uv_span,
+                                   int32_t sar1_uv_zero, int32_t sar1_uv_span);
+
+/* Product of two SAR results scaled to a CTDAC code */
+uint32_t processing_counts_to_dac_code(const product_calib_t *calib,
+                                       int16_t counts0, int16_t counts1);
+
+/* Products of a block of sample pairs scaled to CTDAC codes */
+void processing_block_to_dac(const product_calib_t *calib, const sample_pair_t *pairs,
+                             uint16_t *codes, uint32_t count);
+
+/* Derives a microvolt channel scale from two points of the SAR conversion */
+void processing_channel_scale_init(channel_scale_t *scale, int32_t uv_zero, int32_t uv_span);
+
+/* Result of a SAR channel scaled with its channel scale */
+int32_t processing_scale_counts(const channel_scale_t *scale, int16_t counts);
+
+#endif /* PROCESSING_H_ */
+
+/* [] END OF FILE */
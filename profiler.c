@@ -0,0 +1,336 @@
+/******************************************************************************
+* File Name:   profiler.c
+*
+* Description: This file contains the cycle profiler of the sample to CTDAC
+*              path. On the target, durations are measured with the DWT cycle
+*              counter of the CPU. When compiled for a host, a monotonic clock
+*              in nanoseconds is used instead so that the same statistics and
+*              report are available in simulation.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "profiler.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The DWT cycle counter is used when compiled for a Cortex-M target. A host
+   build on an ARM Linux system, such as a Cortex-A, has no DWT. */
+#if defined(__ICCARM__) || (defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M') && !defined(__linux__))
+#define PROFILER_USE_DWT    (1U)
+#else
+#define PROFILER_USE_DWT    (0U)
+#endif
+
+/* Unit of the profiler ticks in the report */
+#if (PROFILER_USE_DWT == 1U)
+#define PROFILER_UNIT       "cycles"
+#else
+#define PROFILER_UNIT       "ns"
+#endif
+
+#if (PROFILER_USE_DWT == 1U)
+#include "cy_pdl.h"
+#else
+#include <time.h>
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Statistics of each stage */
+static profiler_stats_t profiler_stats[PROFILER_STAGE_COUNT];
+
+/* Entry time of the latest acquisition interrupt */
+static volatile uint32_t profiler_eos = 0UL;
+
+/* Names of the stages in the report */
+static const char * const profiler_names[PROFILER_STAGE_COUNT] = {
+    "isr",
+    "eos_to_read",
+    "sample",
+    "product",
+    "dac_write",
+    "telemetry",
+    "eos_to_dac"
+};
+
+/*******************************************************************************
+* Function Name: profiler_init
+********************************************************************************
+* Summary:
+* This function starts the DWT cycle counter and clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_init(void)
+{
+#if (PROFILER_USE_DWT == 1U)
+    /* Enable the trace unit and the cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0UL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    profiler_reset();
+}
+
+/*******************************************************************************
+* Function Name: profiler_now
+********************************************************************************
+* Summary:
+* This function returns the current time in profiler ticks: CPU cycles on the
+* target, nanoseconds on a host. The value wraps around, so only differences
+* shorter than 2^32 ticks are meaningful.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Current time
+*
+*******************************************************************************/
+uint32_t profiler_now(void)
+{
+#if (PROFILER_USE_DWT == 1U)
+    return DWT->CYCCNT;
+#else
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: profiler_ticks_per_second
+********************************************************************************
+* Summary:
+* This function returns the rate of the profiler ticks: the CPU clock on the
+* target, 1 GHz on a host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Ticks per second
+*
+*******************************************************************************/
+uint32_t profiler_ticks_per_second(void)
+{
+#if (PROFILER_USE_DWT == 1U)
+    return SystemCoreClock;
+#else
+    return 1000000000UL;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: profiler_mark_eos
+********************************************************************************
+* Summary:
+* This function records the entry time of the acquisition interrupt, which is
+* the start of the end-to-end measurements.
+*
+* Parameters:
+*  timestamp: Time of the interrupt entry from profiler_now()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_mark_eos(uint32_t timestamp)
+{
+    profiler_eos = timestamp;
+}
+
+/*******************************************************************************
+* Function Name: profiler_get_eos
+********************************************************************************
+* Summary:
+* This function returns the entry time of the latest acquisition interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Time of the interrupt entry
+*
+*******************************************************************************/
+uint32_t profiler_get_eos(void)
+{
+    return profiler_eos;
+}
+
+/*******************************************************************************
+* Function Name: profiler_record
+********************************************************************************
+* Summary:
+* This function adds a duration to the minimum, maximum, mean and histogram
+* of a stage. Each stage must be recorded from a single context.
+*
+* Parameters:
+*  stage: Stage that was measured
+*  duration: Duration in profiler ticks
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_record(profiler_stage_t stage, uint32_t duration)
+{
+    profiler_stats_t *stats = &profiler_stats[stage];
+    uint32_t bucket = 0UL;
+    uint32_t value = duration;
+
+    if ((0UL == stats->count) || (duration < stats->min))
+    {
+        stats->min = duration;
+    }
+    if (duration > stats->max)
+    {
+        stats->max = duration;
+    }
+    stats->sum += duration;
+    stats->count++;
+
+    /* Bucket is the number of significant bits of the duration */
+    while ((0UL != value) && (bucket < (PROFILER_BUCKETS - 1UL)))
+    {
+        value >>= 1U;
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+}
+
+/*******************************************************************************
+* Function Name: profiler_get_stats
+********************************************************************************
+* Summary:
+* This function returns a copy of the statistics of a stage.
+*
+* Parameters:
+*  stage: Stage to query
+*  stats: Location to store the statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_get_stats(profiler_stage_t stage, profiler_stats_t *stats)
+{
+    *stats = profiler_stats[stage];
+}
+
+/*******************************************************************************
+* Function Name: profiler_reset
+********************************************************************************
+* Summary:
+* This function clears the statistics of all stages.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_reset(void)
+{
+#if (PROFILER_USE_DWT == 1U)
+    /* The interrupt stage is recorded by the acquisition interrupt */
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    (void)memset(profiler_stats, 0, sizeof(profiler_stats));
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+#else
+    (void)memset(profiler_stats, 0, sizeof(profiler_stats));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: profiler_report
+********************************************************************************
+* Summary:
+* This function queues one line per stage with the number of measurements and
+* the minimum, mean and maximum duration on the telemetry output, optionally
+* followed by the histogram of each stage.
+*
+* Parameters:
+*  histogram: true to add the histograms to the report
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiler_report(bool histogram)
+{
+    profiler_stats_t stats;
+    uint32_t stage;
+    uint32_t bucket;
+
+    (void)telemetry_printf("Profile (%s):\r\n", PROFILER_UNIT);
+
+    for (stage = 0UL; stage < (uint32_t)PROFILER_STAGE_COUNT; stage++)
+    {
+        profiler_get_stats((profiler_stage_t)stage, &stats);
+
+        (void)telemetry_printf("%-12s n=%lu min=%lu mean=%lu max=%lu\r\n",
+                               profiler_names[stage], (unsigned long)stats.count,
+                               (unsigned long)stats.min,
+                               (unsigned long)((0UL != stats.count) ? (stats.sum / stats.count) : 0UL),
+                               (unsigned long)stats.max);
+
+        if (histogram)
+        {
+            (void)telemetry_printf("%-12s", "");
+            for (bucket = 0UL; bucket < PROFILER_BUCKETS; bucket++)
+            {
+                (void)telemetry_printf(" %lu", (unsigned long)stats.histogram[bucket]);
+            }
+            (void)telemetry_printf("\r\n");
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name:   profiler.h
+*
+* Description: This file contains the declarations of the cycle profiler of
+*              the sample to CTDAC path.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of histogram buckets. Bucket n counts durations from 2^(n-1) to
+ * 2^n - 1, the last bucket counts all longer durations.
+ */
+#define PROFILER_BUCKETS            (16UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Measured stages of the sample to CTDAC path */
+typedef enum
+{
+    PROFILER_ISR,               /* Acquisition interrupt, entry to exit */
+    PROFILER_EOS_TO_READ,       /* Acquisition interrupt entry to block read */
+    PROFILER_SAMPLE,            /* Block read to last CTDAC write, per sample pair */
+    PROFILER_PRODUCT,           /* Product kernel, per sample pair */
+    PROFILER_DAC_WRITE,         /* CTDAC writes or DMA ring enqueue, per sample pair */
+    PROFILER_TELEMETRY,         /* Telemetry enqueue, per block */
+    PROFILER_EOS_TO_DAC,        /* Acquisition interrupt entry to last CTDAC write */
+    PROFILER_STAGE_COUNT
+} profiler_stage_t;
+
+/* Statistics of one stage */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[PROFILER_BUCKETS];
+} profiler_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the time base and clears the statistics */
+void profiler_init(void);
+
+/* Current time in profiler ticks */
+uint32_t profiler_now(void);
+
+/* Number of profiler ticks per second */
+uint32_t profiler_ticks_per_second(void);
+
+/* Records the entry time of the acquisition interrupt */
+void profiler_mark_eos(uint32_t timestamp);
+
+/* Entry time of the latest acquisition interrupt */
+uint32_t profiler_get_eos(void);
+
+/* Adds a duration to the statistics of a stage */
+void profiler_record(profiler_stage_t stage, uint32_t duration);
+
+/* Returns a copy of the statistics of a stage */
+void profiler_get_stats(profiler_stage_t stage, profiler_stats_t *stats);
+
+/* Clears the statistics of all stages */
+void profiler_reset(void);
+
+/* Queues the statistics of all stages on the telemetry output */
+void profiler_report(bool histogram);
+
+#endif /* PROFILER_H_ */
+
+/* [] END OF FILE */
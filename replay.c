@@ -0,0 +1,454 @@
+/******************************************************************************
+* File Name:   replay.c
+*
+* Description: This file replays binary traces of sample pairs, as sent
+*              by the binary telemetry, received on the debug UART. The
+*              replayed pairs replace the acquired ones in the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "replay.h"
+#include "sample_stream.h"
+#include "crc16.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Longest frame of the trace: 255 sample pairs */
+#define REPLAY_MAX_FRAME            (STREAM_HEADER_SIZE + (255UL * STREAM_PAIR_SIZE) + STREAM_CRC_SIZE)
+
+/* Offsets of the header fields */
+#define REPLAY_TYPE_OFFSET          (2UL)
+#define REPLAY_SEQUENCE_OFFSET      (3UL)
+#define REPLAY_COUNT_OFFSET         (5UL)
+
+#if ((REPLAY_RING_PAIRS & (REPLAY_RING_PAIRS - 1UL)) != 0UL)
+#error "REPLAY_RING_PAIRS must be a power of two"
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* States of the frame parser */
+typedef enum
+{
+    REPLAY_WAIT_SYNC0,
+    REPLAY_WAIT_SYNC1,
+    REPLAY_RECEIVE
+} replay_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Checks a complete frame and takes its sample pairs or time record */
+static void replay_take_frame(void);
+
+/* Reads a little endian value from a buffer */
+static uint64_t replay_get_le(const uint8_t *buffer, uint32_t size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Pacing of the replay and whether the trace is still being received */
+static replay_mode_t replay_mode = REPLAY_FULL_SPEED;
+static bool replay_receiving = false;
+
+/* Frame being received */
+static uint8_t replay_frame[REPLAY_MAX_FRAME];
+static replay_state_t replay_state = REPLAY_WAIT_SYNC0;
+static uint32_t replay_position = 0UL;
+static uint32_t replay_length = 0UL;
+
+/* Sequence number expected for the next frame */
+static uint16_t replay_sequence = 0U;
+static bool replay_sequence_valid = false;
+
+/* Frames were lost since the last time record */
+static bool replay_resync = false;
+
+/* Received sample pairs and their trigger times */
+static sample_pair_t replay_ring[REPLAY_RING_PAIRS];
+static uint64_t replay_ring_times[REPLAY_RING_PAIRS];
+static uint32_t replay_head = 0UL;
+static uint32_t replay_tail = 0UL;
+
+/* Index of the next received sample pair in the trace, and the last time
+ * record: the index and trigger time of a pair and the trigger period
+ */
+static uint32_t replay_index = 0UL;
+static uint32_t replay_anchor_index = 0UL;
+static uint64_t replay_anchor_time = 0ULL;
+static uint32_t replay_interval = 0UL;
+
+/* Block returned to the main loop */
+static sample_pair_t replay_block[REPLAY_BLOCK_PAIRS];
+static uint64_t replay_block_times[REPLAY_BLOCK_PAIRS];
+
+/* Counters of the replay */
+static replay_stats_t replay_stats;
+
+/*******************************************************************************
+* Function Name: replay_start
+********************************************************************************
+* Summary:
+* This function starts receiving a trace. From now on, the bytes received on
+* the debug UART are parsed as frames of the binary telemetry, laid out in
+* sample_stream.h, until REPLAY_EXIT is received outside a frame. Frames of
+* sample pairs are replayed; time records timestamp the following pairs;
+* other frames are skipped.
+*
+* Parameters:
+*  mode: Pacing of the replayed sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void replay_start(replay_mode_t mode)
+{
+    replay_mode = mode;
+    replay_state = REPLAY_WAIT_SYNC0;
+    replay_sequence_valid = false;
+    replay_resync = false;
+    replay_head = 0UL;
+    replay_tail = 0UL;
+    replay_index = 0UL;
+    replay_anchor_index = 0UL;
+    replay_anchor_time = 0ULL;
+    replay_interval = 0UL;
+    (void)memset(&replay_stats, 0, sizeof(replay_stats));
+    replay_receiving = true;
+}
+
+/*******************************************************************************
+* Function Name: replay_is_receiving
+********************************************************************************
+* Summary:
+* This function returns whether the received bytes belong to the trace.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true until REPLAY_EXIT is received
+*
+*******************************************************************************/
+bool replay_is_receiving(void)
+{
+    return replay_receiving;
+}
+
+/*******************************************************************************
+* Function Name: replay_is_active
+********************************************************************************
+* Summary:
+* This function returns whether the main loop processes replayed sample pairs
+* instead of acquired ones. The replay stays active after REPLAY_EXIT until
+* the received pairs are processed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true while the replay is active
+*
+*******************************************************************************/
+bool replay_is_active(void)
+{
+    return replay_receiving || (replay_head != replay_tail);
+}
+
+/*******************************************************************************
+* Function Name: replay_feed
+********************************************************************************
+* Summary:
+* This function parses one byte of the trace. Bytes outside a frame are
+* skipped until the sync word, so a trace can start anywhere in a stream.
+*
+* Parameters:
+*  byte: Received byte
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void replay_feed(uint8_t byte)
+{
+    uint32_t count;
+
+    switch (replay_state)
+    {
+        case REPLAY_WAIT_SYNC0:
+            if (STREAM_SYNC0 == byte)
+            {
+                replay_frame[0] = byte;
+                replay_state = REPLAY_WAIT_SYNC1;
+            }
+            else if (REPLAY_EXIT == byte)
+            {
+                replay_receiving = false;
+            }
+            else
+            {
+                /* Not in a frame */
+            }
+            break;
+
+        case REPLAY_WAIT_SYNC1:
+            if (STREAM_SYNC1 == byte)
+            {
+                replay_frame[1] = byte;
+                replay_position = 2UL;
+                replay_length = REPLAY_MAX_FRAME;
+                replay_state = REPLAY_RECEIVE;
+            }
+            else if (STREAM_SYNC0 != byte)
+            {
+                replay_state = REPLAY_WAIT_SYNC0;
+            }
+            else
+            {
+                /* Repeated first sync byte */
+            }
+            break;
+
+        default:
+            replay_frame[replay_position] = byte;
+            replay_position++;
+
+            /* The count field gives the length of the frame */
+            if (STREAM_HEADER_SIZE == replay_position)
+            {
+                count = replay_frame[REPLAY_COUNT_OFFSET];
+                if (STREAM_FRAME_SAMPLES == replay_frame[REPLAY_TYPE_OFFSET])
+                {
+                    count *= STREAM_PAIR_SIZE;
+                }
+                replay_length = STREAM_HEADER_SIZE + count + STREAM_CRC_SIZE;
+            }
+
+            if (replay_position == replay_length)
+            {
+                replay_take_frame();
+                replay_state = REPLAY_WAIT_SYNC0;
+            }
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_get_block
+********************************************************************************
+* Summary:
+* This function returns the next block of replayed sample pairs and their
+* trigger times. At full speed, the block holds all received pairs, up to
+* REPLAY_BLOCK_PAIRS. In real time, it holds as many pairs as the block the
+* acquisition just returned, so the trace is replayed at the trigger rate;
+* the trigger period should then be set to the period of the trace.
+*
+* Parameters:
+*  pairs: Location to store the address of the first sample pair
+*  timestamps: Location to store the address of the first trigger time
+*  first_index: Location to store the index of the first sample pair in
+*               the pairs received since the start of the trace
+*  live_count: Number of sample pairs of the block of the acquisition
+*
+* Return:
+*  uint32_t: Number of sample pairs in the block, 0 if none is ready
+*
+*******************************************************************************/
+uint32_t replay_get_block(const sample_pair_t **pairs, const uint64_t **timestamps, uint32_t *first_index,
+                          uint32_t live_count)
+{
+    uint32_t count = replay_head - replay_tail;
+    uint32_t limit = (REPLAY_REAL_TIME == replay_mode) ? live_count : REPLAY_BLOCK_PAIRS;
+    uint32_t index;
+
+    if (limit > REPLAY_BLOCK_PAIRS)
+    {
+        limit = REPLAY_BLOCK_PAIRS;
+    }
+    if (count > limit)
+    {
+        count = limit;
+    }
+
+    *first_index = replay_tail;
+    for (index = 0UL; index < count; index++)
+    {
+        replay_block[index] = replay_ring[replay_tail & (REPLAY_RING_PAIRS - 1UL)];
+        replay_block_times[index] = replay_ring_times[replay_tail & (REPLAY_RING_PAIRS - 1UL)];
+        replay_tail++;
+    }
+
+    replay_stats.pairs += count;
+    *pairs = replay_block;
+    *timestamps = replay_block_times;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: replay_get_stats
+********************************************************************************
+* Summary:
+* This function returns the counters of the current or last replay.
+*
+* Parameters:
+*  stats: Location to store the counters
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void replay_get_stats(replay_stats_t *stats)
+{
+    *stats = replay_stats;
+}
+
+/*******************************************************************************
+* Function Name: replay_take_frame
+********************************************************************************
+* Summary:
+* This function checks the CRC and the sequence number of a complete frame.
+* The sample pairs of a valid frame are added to the ring with their trigger
+* times, derived from the last time record; a time record replaces it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void replay_take_frame(void)
+{
+    uint32_t payload = replay_length - STREAM_CRC_SIZE;
+    uint16_t crc = crc16_update(CRC16_INIT, &replay_frame[REPLAY_TYPE_OFFSET],
+                                       payload - REPLAY_TYPE_OFFSET);
+    uint16_t sequence;
+    uint32_t count;
+    uint32_t index;
+    const uint8_t *record = &replay_frame[STREAM_HEADER_SIZE];
+
+    if (crc != (uint16_t)replay_get_le(&replay_frame[payload], STREAM_CRC_SIZE))
+    {
+        replay_stats.crc_errors++;
+        return;
+    }
+    replay_stats.frames++;
+
+    /* Frames of all types share the sequence number */
+    sequence = (uint16_t)replay_get_le(&replay_frame[REPLAY_SEQUENCE_OFFSET], 2UL);
+    if (replay_sequence_valid && (sequence != replay_sequence))
+    {
+        replay_stats.sequence_gaps += (uint16_t)(sequence - replay_sequence);
+        replay_resync = true;
+    }
+    replay_sequence = sequence + 1U;
+    replay_sequence_valid = true;
+
+    count = replay_frame[REPLAY_COUNT_OFFSET];
+
+    if (STREAM_FRAME_SAMPLES == replay_frame[REPLAY_TYPE_OFFSET])
+    {
+        for (index = 0UL; index < count; index++)
+        {
+            if ((replay_head - replay_tail) < REPLAY_RING_PAIRS)
+            {
+                sample_stream_unpack(record, 1UL, &replay_ring[replay_head & (REPLAY_RING_PAIRS - 1UL)]);
+                replay_ring_times[replay_head & (REPLAY_RING_PAIRS - 1UL)] = replay_anchor_time +
+                    (uint64_t)((int64_t)(int32_t)(replay_index - replay_anchor_index) * (int64_t)replay_interval);
+                replay_head++;
+            }
+            else
+            {
+                replay_stats.overflows++;
+            }
+            replay_index++;
+            record += STREAM_PAIR_SIZE;
+        }
+    }
+    else if ((STREAM_FRAME_TIME == replay_frame[REPLAY_TYPE_OFFSET]) && (STREAM_TIME_RECORD_SIZE == count))
+    {
+        /* The record refers to a pair by its index in the trace. The frame
+           with the pairs before it may still follow, so the index of the
+           received pairs is only replaced after lost frames. */
+        replay_anchor_index = (uint32_t)replay_get_le(&record[0], 4UL);
+        replay_anchor_time = replay_get_le(&record[4], 8UL);
+        replay_interval = (uint32_t)replay_get_le(&record[12], 4UL);
+        if (replay_resync)
+        {
+            replay_index = replay_anchor_index;
+            replay_resync = false;
+        }
+    }
+    else
+    {
+        /* Other records are not replayed */
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_get_le
+********************************************************************************
+* Summary:
+* This function reads a little endian value of up to 8 bytes.
+*
+* Parameters:
+*  buffer: First byte of the value
+*  size: Number of bytes
+*
+* Return:
+*  uint64_t: Value
+*
+*******************************************************************************/
+static uint64_t replay_get_le(const uint8_t *buffer, uint32_t size)
+{
+    uint64_t value = 0ULL;
+    uint32_t index;
+
+    for (index = size; index > 0UL; index--)
+    {
+        value = (value << 8U) | buffer[index - 1UL];
+    }
+
+    return value;
+}
+
+/* [] END OF FILE */
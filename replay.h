@@ -0,0 +1,108 @@
+/******************************************************************************
+* File Name:   replay.h
+*
+* Description: This file contains the declarations of the replay of
+*              binary traces of sample pairs received on the debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Sample pairs buffered between the UART and the main loop, a power of two */
+#ifndef REPLAY_RING_PAIRS
+#define REPLAY_RING_PAIRS           (512UL)
+#endif
+
+/* Largest block returned, the largest block of the acquisition */
+#define REPLAY_BLOCK_PAIRS          (ACQ_CHANNEL_BLOCK_SCANS)
+
+/* Character that ends the replay when received outside a frame */
+#define REPLAY_EXIT                 (0x1BU)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Pacing of the replayed sample pairs */
+typedef enum
+{
+    REPLAY_FULL_SPEED = 0,      /* As fast as the main loop processes them */
+    REPLAY_REAL_TIME = 1        /* One pair per trigger of the acquisition */
+} replay_mode_t;
+
+/* Counters of a replay */
+typedef struct
+{
+    uint32_t frames;            /* Frames received with a valid CRC */
+    uint32_t pairs;             /* Sample pairs passed to the main loop */
+    uint32_t crc_errors;        /* Frames dropped because of their CRC */
+    uint32_t sequence_gaps;     /* Frames missing from the sequence numbers */
+    uint32_t overflows;         /* Sample pairs dropped because the ring was full */
+} replay_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts receiving a trace */
+void replay_start(replay_mode_t mode);
+
+/* true until REPLAY_EXIT is received */
+bool replay_is_receiving(void);
+
+/* true until REPLAY_EXIT is received and all sample pairs are processed */
+bool replay_is_active(void);
+
+/* Parses one received byte of the trace */
+void replay_feed(uint8_t byte);
+
+/* Returns the next block of replayed sample pairs */
+uint32_t replay_get_block(const sample_pair_t **pairs, const uint64_t **timestamps, uint32_t *first_index,
+                          uint32_t live_count);
+
+/* Returns the counters of the current or last replay */
+void replay_get_stats(replay_stats_t *stats);
+
+#endif /* REPLAY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,165 @@
+/******************************************************************************
+* File Name:   sample_queue.c
+*
+* Description: This file contains the lock-free single-producer
+*              single-consumer queue that hands sample pairs over from the
+*              SAR interrupt to the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "sample_queue.h"
+
+/*******************************************************************************
+* Function Name: sample_queue_init
+********************************************************************************
+* Summary:
+* This function initializes an empty queue that uses the given storage.
+*
+* Parameters:
+*  queue: Queue to initialize
+*  storage: Array of entries used by the queue
+*  size: Number of entries in storage. Must be a power of two.
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_queue_init(sample_queue_t *queue, sample_entry_t *storage, uint32_t size)
+{
+    CY_ASSERT((0UL != size) && (0UL == (size & (size - 1UL))));
+
+    queue->entries = storage;
+    queue->mask = size - 1UL;
+    queue->head = 0UL;
+    queue->tail = 0UL;
+    queue->overruns = 0UL;
+}
+
+/*******************************************************************************
+* Function Name: sample_queue_push
+********************************************************************************
+* Summary:
+* This function adds an entry to the queue. It must only be called by the
+* producer. If the queue is full, the entry is dropped and counted as an
+* overrun.
+*
+* Parameters:
+*  queue: Queue to add the entry to
+*  entry: Entry to add
+*
+* Return:
+*  bool: true if the entry was added, false if the queue was full
+*
+*******************************************************************************/
+bool sample_queue_push(sample_queue_t *queue, const sample_entry_t *entry)
+{
+    uint32_t head = queue->head;
+
+    if ((head - queue->tail) > queue->mask)
+    {
+        queue->overruns++;
+        return false;
+    }
+
+    queue->entries[head & queue->mask] = *entry;
+
+    /* Publish the entry only after it is completely written */
+    __DMB();
+    queue->head = head + 1UL;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: sample_queue_pop
+********************************************************************************
+* Summary:
+* This function removes up to max_count entries from the queue, oldest first.
+* It must only be called by the consumer.
+*
+* Parameters:
+*  queue: Queue to remove the entries from
+*  entries: Location to store the removed entries
+*  max_count: Maximum number of entries to remove
+*
+* Return:
+*  uint32_t: Number of entries removed
+*
+*******************************************************************************/
+uint32_t sample_queue_pop(sample_queue_t *queue, sample_entry_t *entries, uint32_t max_count)
+{
+    uint32_t tail = queue->tail;
+    uint32_t count = queue->head - tail;
+    uint32_t index;
+
+    if (count > max_count)
+    {
+        count = max_count;
+    }
+
+    for (index = 0UL; index < count; index++)
+    {
+        entries[index] = queue->entries[(tail + index) & queue->mask];
+    }
+
+    /* Release the entries only after they are completely read */
+    __DMB();
+    queue->tail = tail + count;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: sample_queue_count
+********************************************************************************
+* Summary:
+* This function returns the number of entries waiting in the queue.
+*
+* Parameters:
+*  queue: Queue to check
+*
+* Return:
+*  uint32_t: Number of entries in the queue
+*
+*******************************************************************************/
+uint32_t sample_queue_count(const sample_queue_t *queue)
+{
+    return (queue->head - queue->tail);
+}
+
+/* [] END OF FILE */
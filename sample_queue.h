@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name:   sample_queue.h
+*
+* Description: This file contains the declarations of the lock-free
+*              single-producer single-consumer queue of sample pairs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLE_QUEUE_H_
+#define SAMPLE_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Sample pairs of all channels of one scan, with the index and the trigger
+ * time of the scan
+ */
+typedef struct
+{
+    sample_pair_t pairs[ACQ_NUM_CHANNELS];
+    uint32_t scan;
+    uint64_t timestamp;
+} sample_entry_t;
+
+/* Queue of sample entries. The producer only writes head and the consumer
+ * only writes tail, so one interrupt handler and the main loop can use the
+ * queue without disabling interrupts.
+ */
+typedef struct
+{
+    sample_entry_t *entries;        /* Storage, size is a power of two */
+    uint32_t mask;                  /* Size of the storage minus one */
+    volatile uint32_t head;         /* Free running write index */
+    volatile uint32_t tail;         /* Free running read index */
+    volatile uint32_t overruns;     /* Entries lost because the queue was full */
+} sample_queue_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Initializes an empty queue on the given storage */
+void sample_queue_init(sample_queue_t *queue, sample_entry_t *storage, uint32_t size);
+
+/* Adds an entry, or counts an overrun if the queue is full (producer) */
+bool sample_queue_push(sample_queue_t *queue, const sample_entry_t *entry);
+
+/* Removes up to max_count entries (consumer) */
+uint32_t sample_queue_pop(sample_queue_t *queue, sample_entry_t *entries, uint32_t max_count);
+
+/* Number of entries waiting in the queue */
+uint32_t sample_queue_count(const sample_queue_t *queue);
+
+#endif /* SAMPLE_QUEUE_H_ */
+
+/* [] END OF FILE */
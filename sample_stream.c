@@ -0,0 +1,361 @@
+/******************************************************************************
+* File Name:   sample_stream.c
+*
+* Description: This file contains the binary stream of SAR0 and SAR1 sample
+*              pairs. Raw 12-bit results are packed two per 3 bytes into
+*              frames with a sequence number and a CRC, and queued on the
+*              telemetry output.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "sample_stream.h"
+#include "crc16.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Mask of a 12-bit result */
+#define STREAM_RESULT_MASK          (0x0FFFU)
+
+/* Sign bit of a 12-bit result */
+#define STREAM_RESULT_SIGN          (0x0800U)
+
+#if (STREAM_FRAME_PAIRS > 255UL)
+#error "STREAM_FRAME_PAIRS must fit in the 8-bit count field"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Packs sample pairs into the current frame */
+static void stream_pack(const sample_pair_t *pairs, uint32_t count);
+
+/* Completes the header and the CRC of a frame and queues it */
+static void stream_send_frame(uint8_t *frame, uint8_t type, uint8_t count, uint32_t length);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Frame being filled */
+static uint8_t stream_frame[STREAM_FRAME_SIZE];
+
+/* Frame of a record, separate from the frame of sample pairs being filled */
+static uint8_t stream_record_frame[STREAM_HEADER_SIZE + STREAM_MAX_RECORD + STREAM_CRC_SIZE];
+
+/* Number of sample pairs in stream_frame */
+static uint32_t stream_pairs = 0UL;
+
+/* Index of the next sample pair added to the stream */
+static uint32_t stream_pair_index = 0UL;
+
+/* Sequence number of the next frame */
+static uint16_t stream_sequence = 0U;
+
+/* Trigger time and interval of the next sample pair, valid while every
+   pair and frame since the last time record was timed and sent */
+static bool stream_timed = false;
+static uint64_t stream_next_time = 0ULL;
+static uint32_t stream_interval = 0UL;
+
+/*******************************************************************************
+* Function Name: sample_stream_put
+********************************************************************************
+* Summary:
+* This function adds sample pairs without a trigger time, such as a capture
+* around an event, to the stream. The next timed pairs are preceded by a
+* time record.
+*
+* Parameters:
+*  pairs: Sample pairs to add
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_put(const sample_pair_t *pairs, uint32_t count)
+{
+    stream_timed = false;
+    stream_pack(pairs, count);
+}
+
+/*******************************************************************************
+* Function Name: sample_stream_put_timed
+********************************************************************************
+* Summary:
+* This function adds sample pairs spaced by a fixed interval to the stream.
+* A time record is sent first if they do not continue the pairs timed by the
+* last record: at the start of the stream, after a missed trigger, a change
+* of the interval, or a dropped frame. The caller splits blocks at missed
+* triggers.
+*
+* Parameters:
+*  pairs: Sample pairs to add
+*  count: Number of sample pairs
+*  timestamp: Trigger time of the first sample pair
+*  interval: Trigger clocks between two sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_put_timed(const sample_pair_t *pairs, uint32_t count, uint64_t timestamp, uint32_t interval)
+{
+    if ((!stream_timed) || (interval != stream_interval) || (timestamp != stream_next_time))
+    {
+        sample_stream_send_time(timestamp, interval);
+    }
+
+    stream_pack(pairs, count);
+    stream_next_time = timestamp + ((uint64_t)count * interval);
+}
+
+/*******************************************************************************
+* Function Name: stream_pack
+********************************************************************************
+* Summary:
+* This function packs sample pairs into the current frame. Every time the
+* frame holds STREAM_FRAME_PAIRS pairs, it is sent.
+*
+* Parameters:
+*  pairs: Sample pairs to add
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void stream_pack(const sample_pair_t *pairs, uint32_t count)
+{
+    uint32_t index;
+    uint32_t sar0;
+    uint32_t sar1;
+    uint8_t *packed;
+
+    for (index = 0UL; index < count; index++)
+    {
+        sar0 = (uint16_t)pairs[index].sar0 & STREAM_RESULT_MASK;
+        sar1 = (uint16_t)pairs[index].sar1 & STREAM_RESULT_MASK;
+
+        packed = &stream_frame[STREAM_HEADER_SIZE + (stream_pairs * STREAM_PAIR_SIZE)];
+        packed[0] = (uint8_t)sar0;
+        packed[1] = (uint8_t)((sar1 << 4U) | (sar0 >> 8U));
+        packed[2] = (uint8_t)(sar1 >> 4U);
+
+        stream_pairs++;
+        stream_pair_index++;
+        if (STREAM_FRAME_PAIRS == stream_pairs)
+        {
+            sample_stream_flush();
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sample_stream_unpack
+********************************************************************************
+* Summary:
+* This function unpacks the sample pairs of a frame, the inverse of the
+* packing done by stream_pack().
+*
+* Parameters:
+*  packed: Sample pairs of a frame, STREAM_PAIR_SIZE bytes each
+*  count: Number of sample pairs
+*  pairs: Location to store the sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_unpack(const uint8_t *packed, uint32_t count, sample_pair_t *pairs)
+{
+    uint32_t index;
+    uint32_t sar0;
+    uint32_t sar1;
+
+    for (index = 0UL; index < count; index++)
+    {
+        sar0 = (uint32_t)packed[0] | (((uint32_t)packed[1] & 0x0FUL) << 8U);
+        sar1 = ((uint32_t)packed[1] >> 4U) | ((uint32_t)packed[2] << 4U);
+
+        /* Sign extend the 12-bit two's complement results */
+        pairs[index].sar0 = (int16_t)((sar0 ^ STREAM_RESULT_SIGN) - STREAM_RESULT_SIGN);
+        pairs[index].sar1 = (int16_t)((sar1 ^ STREAM_RESULT_SIGN) - STREAM_RESULT_SIGN);
+        packed += STREAM_PAIR_SIZE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sample_stream_flush
+********************************************************************************
+* Summary:
+* This function sends the sample pairs collected in the current frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_flush(void)
+{
+    if (0UL == stream_pairs)
+    {
+        return;
+    }
+
+    stream_send_frame(stream_frame, STREAM_FRAME_SAMPLES, (uint8_t)stream_pairs,
+                      STREAM_HEADER_SIZE + (stream_pairs * STREAM_PAIR_SIZE));
+    stream_pairs = 0UL;
+}
+
+/*******************************************************************************
+* Function Name: sample_stream_send
+********************************************************************************
+* Summary:
+* This function sends a frame carrying a record, such as a power meter
+* result. The sample pairs collected in the current frame are not affected.
+*
+* Parameters:
+*  type: Frame type
+*  record: Record to send
+*  length: Length of the record, at most STREAM_MAX_RECORD bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_send(uint8_t type, const uint8_t *record, uint32_t length)
+{
+    if (length > STREAM_MAX_RECORD)
+    {
+        return;
+    }
+
+    (void)memcpy(&stream_record_frame[STREAM_HEADER_SIZE], record, length);
+    stream_send_frame(stream_record_frame, type, (uint8_t)length, STREAM_HEADER_SIZE + length);
+}
+
+/*******************************************************************************
+* Function Name: sample_stream_send_time
+********************************************************************************
+* Summary:
+* This function sends a time record for the next sample pair added to the
+* stream. The pairs collected so far are sent first, so that the record
+* refers to the first pair of the next frame of samples, and a receiver that
+* missed frames resynchronizes on it.
+*
+* Parameters:
+*  timestamp: Trigger time of the next sample pair
+*  interval: Trigger clocks between two sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sample_stream_send_time(uint64_t timestamp, uint32_t interval)
+{
+    uint8_t record[STREAM_TIME_RECORD_SIZE];
+    uint32_t index;
+
+    sample_stream_flush();
+
+    /* The pairs that follow are timed from this record, unless it is dropped */
+    stream_timed = true;
+    stream_next_time = timestamp;
+    stream_interval = interval;
+
+    for (index = 0UL; index < 4UL; index++)
+    {
+        record[index] = (uint8_t)(stream_pair_index >> (8UL * index));
+        record[12UL + index] = (uint8_t)(interval >> (8UL * index));
+    }
+    for (index = 0UL; index < 8UL; index++)
+    {
+        record[4UL + index] = (uint8_t)(timestamp >> (8UL * index));
+    }
+
+    sample_stream_send(STREAM_FRAME_TIME, record, STREAM_TIME_RECORD_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: stream_send_frame
+********************************************************************************
+* Summary:
+* This function completes the header and CRC of a frame and queues it on the
+* telemetry output. The sequence number is incremented even if the frame is
+* dropped, so that the receiver can detect the loss, and the next timed
+* sample pairs are preceded by a time record, so that it can resynchronize.
+*
+* Parameters:
+*  frame: Frame with its payload from byte STREAM_HEADER_SIZE
+*  type: Frame type
+*  count: Number of sample pairs or length of the record
+*  length: Length of the frame without the CRC
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void stream_send_frame(uint8_t *frame, uint8_t type, uint8_t count, uint32_t length)
+{
+    uint16_t crc;
+
+    frame[0] = STREAM_SYNC0;
+    frame[1] = STREAM_SYNC1;
+    frame[2] = type;
+    frame[3] = (uint8_t)stream_sequence;
+    frame[4] = (uint8_t)(stream_sequence >> 8U);
+    frame[5] = count;
+
+    /* The sync bytes are not covered by the CRC */
+    crc = crc16_update(CRC16_INIT, &frame[2], length - 2UL);
+    frame[length] = (uint8_t)crc;
+    frame[length + 1UL] = (uint8_t)(crc >> 8U);
+
+    if (!telemetry_write(frame, length + STREAM_CRC_SIZE))
+    {
+        stream_timed = false;
+    }
+
+    stream_sequence++;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name:   sample_stream.h
+*
+* Description: This file contains the declarations of the binary stream of
+*              SAR0 and SAR1 sample pairs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLE_STREAM_H_
+#define SAMPLE_STREAM_H_
+
+#include <stdint.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Frame layout. Multi-byte fields are little endian.
+ *
+ *  Offset  Size     Field
+ *  0       2        Sync, STREAM_SYNC0 followed by STREAM_SYNC1
+ *  2       1        Frame type
+ *  3       2        Frame sequence number, incremented for every frame
+ *  5       1        Number of sample pairs N
+ *  6       3 * N    Sample pairs, see below
+ *  6 + 3N  2        CRC-16/CCITT-FALSE of bytes 2 to 5 + 3N
+ *
+ * Frames of other types carry a record instead of sample pairs: byte 5 is
+ * the length L of the record, which follows in bytes 6 to 5 + L, and the
+ * CRC covers bytes 2 to 5 + L. All frame types share the sequence number.
+ *
+ * Each sample pair is packed as two 12-bit two's complement results:
+ *  byte 0 = sar0[7:0]
+ *  byte 1 = sar1[3:0] << 4 | sar0[11:8]
+ *  byte 2 = sar1[11:4]
+ */
+#define STREAM_SYNC0                (0xA5U)
+#define STREAM_SYNC1                (0x5AU)
+
+/* Frame types */
+#define STREAM_FRAME_SAMPLES        (0x01U)
+#define STREAM_FRAME_METER          (0x02U)     /* Power meter result, see meter.h */
+#define STREAM_FRAME_SPECTRUM       (0x03U)     /* Spectrum bins, see spectrum.h */
+#define STREAM_FRAME_EVENT          (0x04U)     /* Monitor event, see monitor.h */
+#define STREAM_FRAME_TIME           (0x05U)     /* Time record, see below */
+#define STREAM_FRAME_STATS          (0x06U)     /* Loss statistics, see stats.h */
+
+/* Time record, sent before the sample pairs it timestamps when they do not
+ * follow the pairs of the previous record:
+ *
+ *  Offset  Size     Field
+ *  0       4        Index of the next sample pair in the stream
+ *  4       8        Trigger time of that pair, in trigger clocks
+ *  12      4        Trigger clocks between two sample pairs
+ *
+ * The pairs collected before the record are sent first, so the index is
+ * that of the first pair of the next frame of samples. A record is sent
+ * when the stream starts, when a trigger is missed, when the interval
+ * changes, after sample pairs without a time, and after a frame is dropped.
+ * The receiver timestamps the following pairs from the record, counts the
+ * pairs of missed frames from the index, and detects missing triggers where
+ * the time of a record disagrees with the previous one.
+ */
+#define STREAM_TIME_RECORD_SIZE     (16UL)
+
+/* Longest record of the other frame types */
+#define STREAM_MAX_RECORD           (64UL)
+
+/* Size of the frame fields around the sample pairs */
+#define STREAM_HEADER_SIZE          (6UL)
+#define STREAM_CRC_SIZE             (2UL)
+
+/* Size of a packed sample pair */
+#define STREAM_PAIR_SIZE            (3UL)
+
+/* Number of sample pairs collected before a frame is sent */
+#ifndef STREAM_FRAME_PAIRS
+#define STREAM_FRAME_PAIRS          (32UL)
+#endif
+
+/* Size of a complete frame of STREAM_FRAME_PAIRS */
+#define STREAM_FRAME_SIZE           (STREAM_HEADER_SIZE + (STREAM_FRAME_PAIRS * STREAM_PAIR_SIZE) + STREAM_CRC_SIZE)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Adds sample pairs to the stream, sending every complete frame */
+void sample_stream_put(const sample_pair_t *pairs, uint32_t count);
+
+/* Adds evenly spaced sample pairs, after a time record if they do not follow the previous ones */
+void sample_stream_put_timed(const sample_pair_t *pairs, uint32_t count, uint64_t timestamp, uint32_t interval);
+
+/* Unpacks the sample pairs of a frame */
+void sample_stream_unpack(const uint8_t *packed, uint32_t count, sample_pair_t *pairs);
+
+/* Sends the sample pairs collected so far as a shorter frame */
+void sample_stream_flush(void);
+
+/* Sends a frame carrying a record */
+void sample_stream_send(uint8_t type, const uint8_t *record, uint32_t length);
+
+/* Sends a time record for the next sample pair added to the stream */
+void sample_stream_send_time(uint64_t timestamp, uint32_t interval);
+
+#endif /* SAMPLE_STREAM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,482 @@
+/******************************************************************************
+* File Name:   sar_dma.c
+*
+* Description: This file contains the DMA engine that moves the SAR0 and
+*              SAR1 results into an interleaved ping-pong buffer of sample
+*              pairs. The CPU is interrupted once per half of the buffer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "sar_dma.h"
+#include "profiler.h"
+
+#if (ACQUISITION_MODE == ACQ_MODE_DMA)
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of halves of the ping-pong buffer */
+#define DMA_BUFFER_HALVES       (2UL)
+
+/* Destination increment, in 16-bit elements, from one sample pair to the next */
+#define DMA_PAIR_INCREMENT      ((int32_t)(sizeof(sample_pair_t) / sizeof(int16_t)))
+
+/* Value returned by sar_dma_get_block() until a half is complete */
+#define DMA_NO_BLOCK            (0xFFUL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* DMA Interrupt Handler */
+static void sar_dma_interrupt(void);
+
+/* Initializes one DMA channel with its two ping-pong descriptors */
+static void sar_dma_init_channel(uint32_t channel, cy_stc_dma_descriptor_t *descriptors,
+                                 volatile const void *source, int16_t *destination0,
+                                 int16_t *destination1, uint32_t priority);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* DMA interrupt configuration structure */
+/* Source is set to the SAR1 DMA channel and Priority as 7 */
+const cy_stc_sysint_t DMA_IRQ_cfg = {
+    .intrSrc = (IRQn_Type) cpuss_interrupts_dw0_1_IRQn,
+    .intrPriority = 7UL
+};
+
+/* Ping-pong buffer of interleaved {sar0, sar1} sample pairs */
+static sample_pair_t dma_buffer[DMA_BUFFER_HALVES][ACQ_DMA_BLOCK_PAIRS];
+
+/* Two descriptors per channel, each one filling a half of dma_buffer */
+static cy_stc_dma_descriptor_t sar0_descriptors[DMA_BUFFER_HALVES];
+static cy_stc_dma_descriptor_t sar1_descriptors[DMA_BUFFER_HALVES];
+
+/* Half of dma_buffer the DMA is writing to */
+static volatile uint32_t active_half = 0UL;
+
+/* Half of dma_buffer completed and not yet returned by sar_dma_get_block() */
+static volatile uint32_t ready_half = DMA_NO_BLOCK;
+
+/* Trigger time of the last sample pair of each half, and of the half returned last */
+static volatile uint64_t half_time[DMA_BUFFER_HALVES];
+
+/* Halves completed while the previous half was still waiting to be read,
+ * and halves overwritten while the main loop was processing them
+ */
+static volatile uint32_t dma_collapses = 0UL;
+static uint64_t block_time = 0ULL;
+
+/* Halves completed since startup, and when the last half was returned */
+static volatile uint32_t dma_completions = 0UL;
+static uint32_t returned_completions = 0UL;
+
+/* Whether the half returned last has not been checked for an overrun */
+static bool block_held = false;
+
+/* Whether the completion interrupt is masked by sar_dma_hold() */
+static bool dma_holding = false;
+
+/*******************************************************************************
+* Function Name: sar_dma_init
+********************************************************************************
+* Summary:
+* This function routes the FIFO trigger outputs of both SARs to their DMA
+* channels, initializes the ping-pong descriptors and enables the channels.
+* The completion interrupt is enabled on the SAR1 channel only, so the CPU is
+* interrupted once per half of the buffer.
+*
+* Parameters:
+*  sar0_base: Base address of SAR0
+*  sar1_base: Base address of SAR1
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sar_dma_init(SAR_Type *sar0_base, SAR_Type *sar1_base)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+
+    /* Route the FIFO level triggers of the SARs to the DMA channels */
+    result = Cy_TrigMux_Connect(SAR0_DMA_TRIG_IN, SAR0_DMA_TRIG_OUT, false, TRIGGER_TYPE_LEVEL);
+    if (CY_TRIGMUX_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_TrigMux_Connect(SAR1_DMA_TRIG_IN, SAR1_DMA_TRIG_OUT, false, TRIGGER_TYPE_LEVEL);
+    if (CY_TRIGMUX_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Both SARs are triggered at the same time. SAR0 channel has the higher
+       priority so that its result is in memory when the SAR1 channel
+       completes a half of the buffer. */
+    sar_dma_init_channel(SAR0_DMA_CHANNEL, sar0_descriptors, &sar0_base->FIFO_RD_DATA,
+                         &dma_buffer[0][0].sar0, &dma_buffer[1][0].sar0, 0UL);
+    sar_dma_init_channel(SAR1_DMA_CHANNEL, sar1_descriptors, &sar1_base->FIFO_RD_DATA,
+                         &dma_buffer[0][0].sar1, &dma_buffer[1][0].sar1, 1UL);
+
+    /* Interrupt on completion of each descriptor of the SAR1 channel */
+    Cy_DMA_Channel_SetInterruptMask(DW0, SAR1_DMA_CHANNEL, CY_DMA_INTR_MASK);
+
+    (void)Cy_SysInt_Init(&DMA_IRQ_cfg, sar_dma_interrupt);
+    NVIC_EnableIRQ(DMA_IRQ_cfg.intrSrc);
+
+    /* Enable DMA block and channels */
+    Cy_DMA_Channel_Enable(DW0, SAR0_DMA_CHANNEL);
+    Cy_DMA_Channel_Enable(DW0, SAR1_DMA_CHANNEL);
+    Cy_DMA_Enable(DW0);
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_get_block
+********************************************************************************
+* Summary:
+* This function returns the half of the ping-pong buffer that was completed
+* since the previous call. The DMA keeps filling the other half, so the
+* returned block must be processed before the other half is complete. The
+* main loop calls this function again as soon as it has processed a block:
+* if a half was completed meanwhile, the DMA has been writing into the block
+* while it was processed, which is counted as a collapse. When more than one
+* half was completed, the interrupt has already counted the collapse, and it
+* is not counted again.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  const sample_pair_t*: First sample pair of the block, NULL if none is ready
+*
+*******************************************************************************/
+const sample_pair_t *sar_dma_get_block(void)
+{
+    uint32_t interrupt_state;
+    uint32_t half;
+
+    /* The completion interrupt must not mark another half ready between
+       the read and the clear, or that half would be lost uncounted */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    if (block_held && ((dma_completions - returned_completions) == 1UL))
+    {
+        dma_collapses++;
+    }
+    block_held = false;
+
+    half = ready_half;
+    ready_half = DMA_NO_BLOCK;
+    if (DMA_NO_BLOCK != half)
+    {
+        block_time = half_time[half];
+        returned_completions = dma_completions;
+        block_held = true;
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    if (DMA_NO_BLOCK == half)
+    {
+        return NULL;
+    }
+
+    return dma_buffer[half];
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_hold
+********************************************************************************
+* Summary:
+* This function masks the completion interrupt of the SAR1 channel, so that
+* the acquisition no longer wakes up the CPU. The DMA keeps filling the two
+* halves in turn, so the buffer always holds the latest
+* 2 * ACQ_DMA_BLOCK_PAIRS sample pairs. A half not yet returned by
+* sar_dma_get_block() is discarded. sar_dma_resume() returns to the
+* ping-pong operation.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sar_dma_hold(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    Cy_DMA_Channel_SetInterruptMask(DW0, SAR1_DMA_CHANNEL, 0UL);
+    Cy_DMA_Channel_ClearInterrupt(DW0, SAR1_DMA_CHANNEL);
+    ready_half = DMA_NO_BLOCK;
+    block_held = false;
+    dma_holding = true;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_resume
+********************************************************************************
+* Summary:
+* This function ends sar_dma_hold(). The half the DMA is writing to is found
+* from the current descriptor of the SAR1 channel. If the DMA completed a
+* half since the hold, the other half holds the sample pairs that precede
+* those of the current half and was never returned, so it is marked ready at
+* once; it must then be read before the DMA completes the current half.
+* Otherwise, the other half was returned before the hold, and the next
+* completion returns the current half as usual. The completion interrupt is
+* unmasked. It may be called from an interrupt handler of the same priority
+* as the DMA interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sar_dma_resume(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    const cy_stc_dma_descriptor_t *descriptor;
+    uint32_t written;
+    bool completed;
+
+    if (dma_holding)
+    {
+        /* The cause of the interrupt is set by every completion, even masked */
+        completed = (0UL != Cy_DMA_Channel_GetInterruptStatus(DW0, SAR1_DMA_CHANNEL));
+        for (;;)
+        {
+            Cy_DMA_Channel_ClearInterrupt(DW0, SAR1_DMA_CHANNEL);
+            descriptor = Cy_DMA_Channel_GetCurrentDescriptor(DW0, SAR1_DMA_CHANNEL);
+            written = Cy_DMA_Channel_GetCurrentXloopIndex(DW0, SAR1_DMA_CHANNEL);
+
+            /* Read again if a half was completed meanwhile */
+            if (0UL == Cy_DMA_Channel_GetInterruptStatus(DW0, SAR1_DMA_CHANNEL))
+            {
+                break;
+            }
+            completed = true;
+        }
+
+        active_half = (descriptor == &sar1_descriptors[1]) ? 1UL : 0UL;
+        if (completed)
+        {
+            /* The last pair of the other half was triggered before the
+               pairs already written into the current half */
+            ready_half = active_half ^ 1UL;
+            half_time[ready_half] = acquisition_get_trigger_time() -
+                                    ((uint64_t)written * acquisition_get_interval());
+        }
+        returned_completions = dma_completions;
+        dma_holding = false;
+
+        Cy_DMA_Channel_SetInterruptMask(DW0, SAR1_DMA_CHANNEL, CY_DMA_INTR_MASK);
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_get_block_time
+********************************************************************************
+* Summary:
+* This function returns the trigger time of the last sample pair of the half
+* returned by sar_dma_get_block(), taken by the completion interrupt. The
+* other pairs of the half follow the trigger period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Trigger time in trigger clocks
+*
+*******************************************************************************/
+uint64_t sar_dma_get_block_time(void)
+{
+    return block_time;
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_init_channel
+********************************************************************************
+* Summary:
+* This function initializes a DMA channel with two chained descriptors. Each
+* descriptor moves one 16-bit result per trigger from the SAR FIFO into every
+* other element of a half of the ping-pong buffer, and then hands over to the
+* descriptor of the other half.
+*
+* Parameters:
+*  channel: DW0 channel number
+*  descriptors: The two descriptors of the channel
+*  source: Address of the SAR FIFO read register
+*  destination0: First element of the channel in the first half
+*  destination1: First element of the channel in the second half
+*  priority: Channel priority, 0 is the highest
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sar_dma_init_channel(uint32_t channel, cy_stc_dma_descriptor_t *descriptors,
+                                 volatile const void *source, int16_t *destination0,
+                                 int16_t *destination1, uint32_t priority)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+
+    cy_stc_dma_descriptor_config_t descriptor_config = {
+        .retrigger = CY_DMA_RETRIG_4CYC,
+        .interruptType = CY_DMA_DESCR,
+        .triggerOutType = CY_DMA_DESCR,
+        .channelState = CY_DMA_CHANNEL_ENABLED,
+        .triggerInType = CY_DMA_1ELEMENT,
+        .dataSize = CY_DMA_HALFWORD,
+        .srcTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+        .dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+        .descriptorType = CY_DMA_1D_TRANSFER,
+        .srcAddress = (void *)source,
+        .dstAddress = destination0,
+        .srcXincr = 0L,
+        .dstXincr = DMA_PAIR_INCREMENT,
+        .xCount = ACQ_DMA_BLOCK_PAIRS,
+        .srcYincr = 0L,
+        .dstYincr = 0L,
+        .yCount = 1UL,
+        .nextDescriptor = &descriptors[1]
+    };
+
+    cy_stc_dma_channel_config_t channel_config = {
+        .descriptor = &descriptors[0],
+        .preemptable = false,
+        .priority = priority,
+        .enable = false,
+        .bufferable = false
+    };
+
+    /* First half, chained to the second half */
+    result = Cy_DMA_Descriptor_Init(&descriptors[0], &descriptor_config);
+    if (CY_DMA_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Second half, chained back to the first half */
+    descriptor_config.dstAddress = destination1;
+    descriptor_config.nextDescriptor = &descriptors[0];
+    result = Cy_DMA_Descriptor_Init(&descriptors[1], &descriptor_config);
+    if (CY_DMA_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_DMA_Channel_Init(DW0, channel, &channel_config);
+    if (CY_DMA_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_get_collapses
+********************************************************************************
+* Summary:
+* This function returns the number of halves of the buffer completed while
+* the previous half had not been read, and of halves overwritten by the DMA
+* while the main loop was processing them. In the first case the main loop
+* gets only the newest half; in the second, part of the processed block
+* already belongs to the next pass of the DMA. A late main loop that causes
+* both is counted once.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of lost or overwritten halves
+*
+*******************************************************************************/
+uint32_t sar_dma_get_collapses(void)
+{
+    return dma_collapses;
+}
+
+/*******************************************************************************
+* Function Name: sar_dma_interrupt
+********************************************************************************
+* Summary:
+* This function is the handler for the completion interrupt of the SAR1 DMA
+* channel. It marks the half of the buffer that was just completed as ready
+* and records the trigger time of its last sample pair.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sar_dma_interrupt(void)
+{
+    uint32_t entry_time = profiler_now();
+
+    if (CY_DMA_INTR_CAUSE_COMPLETION == Cy_DMA_Channel_GetStatus(DW0, SAR1_DMA_CHANNEL))
+    {
+        /* The last scan of the half was triggered by the latest trigger */
+        half_time[active_half] = acquisition_get_trigger_time();
+
+        /* The half waiting to be read is being overwritten by the DMA */
+        if (DMA_NO_BLOCK != ready_half)
+        {
+            dma_collapses++;
+        }
+        ready_half = active_half;
+        active_half ^= 1UL;
+        dma_completions++;
+    }
+
+    /* Clear the interrupt */
+    Cy_DMA_Channel_ClearInterrupt(DW0, SAR1_DMA_CHANNEL);
+
+    profiler_mark_eos(entry_time);
+    profiler_record(PROFILER_ISR, profiler_now() - entry_time);
+}
+
+#endif /* (ACQUISITION_MODE == ACQ_MODE_DMA) */
+
+/* [] END OF FILE */
@@ -0,0 +1,85 @@
+/******************************************************************************
+* File Name:   sar_dma.h
+*
+* Description: This file contains the declarations of the DMA engine that
+*              moves the SAR0 and SAR1 results into a ping-pong buffer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAR_DMA_H_
+#define SAR_DMA_H_
+
+#include "cy_pdl.h"
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* DMA (DW0) channels that move the SAR0 and SAR1 results */
+#define SAR0_DMA_CHANNEL        (0UL)
+#define SAR1_DMA_CHANNEL        (1UL)
+
+/* Trigger lines from the SAR FIFO trigger outputs to the DMA channels */
+#define SAR0_DMA_TRIG_IN        (TRIG_IN_MUX_0_PASS_TR_SAR_OUT0)
+#define SAR1_DMA_TRIG_IN        (TRIG_IN_MUX_0_PASS_TR_SAR_OUT1)
+#define SAR0_DMA_TRIG_OUT       (TRIG_OUT_MUX_0_PDMA0_TR_IN0)
+#define SAR1_DMA_TRIG_OUT       (TRIG_OUT_MUX_0_PDMA0_TR_IN1)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Configures and enables the DMA channels of both SARs */
+void sar_dma_init(SAR_Type *sar0_base, SAR_Type *sar1_base);
+
+/* Returns the half of the ping-pong buffer completed last, or NULL */
+const sample_pair_t *sar_dma_get_block(void);
+
+/* Trigger time of the last sample pair of the half returned by sar_dma_get_block() */
+uint64_t sar_dma_get_block_time(void);
+
+/* Stops the completion interrupts, the DMA keeps filling the buffer in turn */
+void sar_dma_hold(void);
+
+/* Restarts the completion interrupts, returning the half before the current one */
+void sar_dma_resume(void);
+
+/* Number of halves completed before the previous half was read, or overwritten while processed */
+uint32_t sar_dma_get_collapses(void);
+
+#endif /* SAR_DMA_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,621 @@
+/******************************************************************************
+* File Name:   spectrum.c
+*
+* Description: This file contains the spectrum analysis of SAR0 and SAR1. A
+*              block of sample pairs is captured in the FFT work buffer,
+*              weighted by a Blackman-Harris window, and transformed by one
+*              complex FFT with SAR0 as the real and SAR1 as the imaginary
+*              part. The magnitude of each bin of both inputs is kept in the
+*              work buffer, and the THD and the SNR are derived from it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <math.h>
+#include "spectrum.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Left shift of the SAR results in the FFT input */
+#define SPECTRUM_INPUT_SHIFT        (16U)
+
+/* Coefficients of the 4-term Blackman-Harris window, Q31. Its side lobes are
+   below -92 dB, under the noise floor of the SARs. */
+#define SPECTRUM_Q31                (2147483648.0)
+#define SPECTRUM_WINDOW_A0          ((int64_t)(0.35875 * SPECTRUM_Q31))
+#define SPECTRUM_WINDOW_A1          ((int64_t)(0.48829 * SPECTRUM_Q31))
+#define SPECTRUM_WINDOW_A2          ((int64_t)(0.14128 * SPECTRUM_Q31))
+#define SPECTRUM_WINDOW_A3          ((int64_t)(0.01168 * SPECTRUM_Q31))
+
+/* Amplitude of a full scale sine wave in counts */
+#define SPECTRUM_FULL_SCALE         (2048.0)
+
+/* Scale of the packed magnitudes */
+#define SPECTRUM_RECORD_SCALE       (100.0f)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Windows, transforms, and analyzes the captured block */
+static void spectrum_run(void);
+
+/* Derives the fundamental, the THD, and the SNR of one input */
+static void spectrum_analyze(uint32_t sar, spectrum_input_t *input);
+
+/* Adds the power of the free bins around a tone and marks them as used */
+static double spectrum_take_lobe(uint32_t sar, uint32_t center, double *moment);
+
+/* Power of one bin */
+static double spectrum_power(uint32_t sar, uint32_t bin);
+
+/* Square root of a 64-bit integer, rounded down */
+static uint32_t spectrum_sqrt(uint64_t value);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Capture in progress */
+static bool spectrum_active = false;
+static uint32_t spectrum_points = 0UL;
+static uint32_t spectrum_count = 0UL;
+
+/* Number of valid bins in fft_buffer, 0 if none */
+static uint32_t spectrum_bins = 0UL;
+
+/* Mean and mean square of the window */
+static double spectrum_window_gain;
+static double spectrum_window_power;
+
+/* Bins already assigned to a tone */
+static uint32_t spectrum_used[SPECTRUM_MAX_POINTS / 64UL];
+
+/* Result of the last analysis */
+static spectrum_result_t spectrum_result;
+static bool spectrum_result_ready = false;
+
+/*******************************************************************************
+* Function Name: spectrum_start
+********************************************************************************
+* Summary:
+* This function starts the capture of a block of sample pairs in
+* fft_buffer. The capture in progress, if any, is restarted.
+*
+* Parameters:
+*  points: Number of sample pairs, a power of two from SPECTRUM_MIN_POINTS
+*          to SPECTRUM_MAX_POINTS
+*
+* Return:
+*  bool: true if the capture started, false if the number is invalid
+*
+*******************************************************************************/
+bool spectrum_start(uint32_t points)
+{
+    if ((points < SPECTRUM_MIN_POINTS) || (points > SPECTRUM_MAX_POINTS) ||
+        (0UL != (points & (points - 1UL))))
+    {
+        return false;
+    }
+
+    spectrum_points = points;
+    spectrum_count = 0UL;
+    spectrum_bins = 0UL;
+    spectrum_result_ready = false;
+    spectrum_active = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_stop
+********************************************************************************
+* Summary:
+* This function stops the capture in progress and invalidates the bins of
+* the last analysis, releasing fft_buffer.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void spectrum_stop(void)
+{
+    spectrum_active = false;
+    spectrum_bins = 0UL;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_process
+********************************************************************************
+* Summary:
+* This function adds sample pairs to the capture. When the block is
+* complete, it is analyzed in the caller's context and the capture stops.
+*
+* Parameters:
+*  pairs: Sample pairs
+*  count: Number of sample pairs
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void spectrum_process(const sample_pair_t *pairs, uint32_t count)
+{
+    uint32_t index;
+
+    if (!spectrum_active)
+    {
+        return;
+    }
+
+    for (index = 0UL; (index < count) && (spectrum_count < spectrum_points); index++)
+    {
+        fft_buffer[spectrum_count].re = pairs[index].sar0;
+        fft_buffer[spectrum_count].im = pairs[index].sar1;
+        spectrum_count++;
+    }
+
+    if (spectrum_count == spectrum_points)
+    {
+        spectrum_active = false;
+        spectrum_run();
+    }
+}
+
+/*******************************************************************************
+* Function Name: spectrum_get_result
+********************************************************************************
+* Summary:
+* This function returns the result of the last analysis, once.
+*
+* Parameters:
+*  result: Result to fill
+*
+* Return:
+*  bool: true if an analysis completed since the previous call
+*
+*******************************************************************************/
+bool spectrum_get_result(spectrum_result_t *result)
+{
+    if (!spectrum_result_ready)
+    {
+        return false;
+    }
+
+    *result = spectrum_result;
+    spectrum_result_ready = false;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_get_bins
+********************************************************************************
+* Summary:
+* This function returns the number of bins of the last analysis, from DC to
+* one bin below half the sample rate.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: N / 2, or 0 if no analysis is available
+*
+*******************************************************************************/
+uint32_t spectrum_get_bins(void)
+{
+    return spectrum_bins;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_get_magnitude
+********************************************************************************
+* Summary:
+* This function returns the magnitude of one bin of the last analysis,
+* corrected for the gain of the window, so that a tone centered on the bin
+* reads its amplitude.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  bin: Bin, less than spectrum_get_bins()
+*
+* Return:
+*  float: Magnitude in dBFS, SPECTRUM_FLOOR_DBFS if the bin is empty
+*
+*******************************************************************************/
+float spectrum_get_magnitude(uint32_t sar, uint32_t bin)
+{
+    int32_t magnitude;
+    double amplitude;
+
+    if (bin >= spectrum_bins)
+    {
+        return SPECTRUM_FLOOR_DBFS;
+    }
+
+    magnitude = (0UL == sar) ? fft_buffer[bin].re : fft_buffer[bin].im;
+    if (magnitude <= 0)
+    {
+        return SPECTRUM_FLOOR_DBFS;
+    }
+
+    amplitude = (2.0 * (double)magnitude) / spectrum_window_gain;
+
+    return (float)(20.0 * log10(amplitude / (SPECTRUM_FULL_SCALE * (double)(1UL << SPECTRUM_INPUT_SHIFT))));
+}
+
+/*******************************************************************************
+* Function Name: spectrum_pack_bins
+********************************************************************************
+* Summary:
+* This function packs up to SPECTRUM_RECORD_BINS bins of both inputs into a
+* record, see spectrum.h for the layout.
+*
+* Parameters:
+*  first: First bin to pack
+*  record: Buffer of SPECTRUM_RECORD_SIZE bytes
+*
+* Return:
+*  uint32_t: Length of the record in bytes, 0 if first is past the last bin
+*
+*******************************************************************************/
+uint32_t spectrum_pack_bins(uint32_t first, uint8_t *record)
+{
+    uint32_t bin;
+    uint32_t length = 4UL;
+    uint32_t sar;
+    int16_t value;
+
+    if (first >= spectrum_bins)
+    {
+        return 0UL;
+    }
+
+    record[0] = (uint8_t)spectrum_points;
+    record[1] = (uint8_t)(spectrum_points >> 8U);
+    record[2] = (uint8_t)first;
+    record[3] = (uint8_t)(first >> 8U);
+
+    for (bin = first; (bin < spectrum_bins) && (bin < (first + SPECTRUM_RECORD_BINS)); bin++)
+    {
+        for (sar = 0UL; sar < 2UL; sar++)
+        {
+            value = (int16_t)lroundf(spectrum_get_magnitude(sar, bin) * SPECTRUM_RECORD_SCALE);
+            record[length] = (uint8_t)value;
+            record[length + 1UL] = (uint8_t)((uint16_t)value >> 8U);
+            length += 2UL;
+        }
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_run
+********************************************************************************
+* Summary:
+* This function removes the mean of both inputs, applies the window, and
+* transforms them together. Since both inputs are real, their spectra X and
+* Y are separated from the symmetry of the result Z:
+* X[k] = (Z[k] + conj(Z[N - k])) / 2 and Y[k] = (Z[k] - conj(Z[N - k])) / 2j.
+* The magnitudes of X and Y replace Z[k] for the bins below N / 2, which
+* only reads Z[N - k] above them, and are then analyzed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void spectrum_run(void)
+{
+    uint32_t log2_size = 0UL;
+    uint32_t step = SPECTRUM_MAX_POINTS / spectrum_points;
+    uint32_t index;
+    uint32_t mirror;
+    int64_t sum0 = 0;
+    int64_t sum1 = 0;
+    int64_t mean0;
+    int64_t mean1;
+    int64_t window;
+    int64_t x_re;
+    int64_t x_im;
+    int64_t y_re;
+    int64_t y_im;
+    double gain = 0.0;
+    double power = 0.0;
+
+    while ((1UL << log2_size) < spectrum_points)
+    {
+        log2_size++;
+    }
+
+    for (index = 0UL; index < spectrum_points; index++)
+    {
+        sum0 += fft_buffer[index].re;
+        sum1 += fft_buffer[index].im;
+    }
+
+    /* Means with the fractional bits of the shifted input, so that no DC
+       remains in the bins next to it */
+    mean0 = (sum0 * (1LL << SPECTRUM_INPUT_SHIFT)) / (int64_t)spectrum_points;
+    mean1 = (sum1 * (1LL << SPECTRUM_INPUT_SHIFT)) / (int64_t)spectrum_points;
+
+    for (index = 0UL; index < spectrum_points; index++)
+    {
+        /* Periodic window, Q31 */
+        window = ((SPECTRUM_WINDOW_A0 << 31U)
+                  - (SPECTRUM_WINDOW_A1 * fft_cos(index * step))
+                  + (SPECTRUM_WINDOW_A2 * fft_cos(2UL * index * step))
+                  - (SPECTRUM_WINDOW_A3 * fft_cos(3UL * index * step))) >> 31U;
+        gain += (double)window;
+        power += (double)window * (double)window;
+
+        fft_buffer[index].re = (int32_t)(((((int64_t)fft_buffer[index].re * (1LL << SPECTRUM_INPUT_SHIFT)) - mean0) * window) >> 31U);
+        fft_buffer[index].im = (int32_t)(((((int64_t)fft_buffer[index].im * (1LL << SPECTRUM_INPUT_SHIFT)) - mean1) * window) >> 31U);
+    }
+
+    spectrum_window_gain = gain / (SPECTRUM_Q31 * (double)spectrum_points);
+    spectrum_window_power = power / (SPECTRUM_Q31 * SPECTRUM_Q31 * (double)spectrum_points);
+
+    (void)fft_forward(fft_buffer, log2_size);
+
+    for (index = 0UL; index < (spectrum_points / 2UL); index++)
+    {
+        mirror = (spectrum_points - index) & (spectrum_points - 1UL);
+
+        x_re = ((int64_t)fft_buffer[index].re + fft_buffer[mirror].re) / 2;
+        x_im = ((int64_t)fft_buffer[index].im - fft_buffer[mirror].im) / 2;
+        y_re = ((int64_t)fft_buffer[index].im + fft_buffer[mirror].im) / 2;
+        y_im = ((int64_t)fft_buffer[mirror].re - fft_buffer[index].re) / 2;
+
+        fft_buffer[index].re = (int32_t)spectrum_sqrt((uint64_t)((x_re * x_re) + (x_im * x_im)));
+        fft_buffer[index].im = (int32_t)spectrum_sqrt((uint64_t)((y_re * y_re) + (y_im * y_im)));
+    }
+
+    spectrum_bins = spectrum_points / 2UL;
+    spectrum_result.points = spectrum_points;
+    spectrum_analyze(0UL, &spectrum_result.sar[0]);
+    spectrum_analyze(1UL, &spectrum_result.sar[1]);
+    spectrum_result_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_analyze
+********************************************************************************
+* Summary:
+* This function locates the fundamental as the strongest bin above DC and
+* adds the power of the bins of its main lobe. The harmonics are located
+* from the interpolated fundamental, folded back below half the sample
+* rate. The remaining bins above DC are noise; their power is extended to
+* the bins taken by the tones, so that the SNR does not depend on the
+* number of harmonics.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  input: Analysis to fill
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void spectrum_analyze(uint32_t sar, spectrum_input_t *input)
+{
+    uint32_t bin;
+    uint32_t peak_bin = SPECTRUM_DC_BINS;
+    uint32_t harmonic;
+    uint32_t noise_bins = 0UL;
+    double peak = -1.0;
+    double power;
+    double moment = 0.0;
+    double signal;
+    double distortion = 0.0;
+    double noise = 0.0;
+    double frequency;
+    double folded;
+
+    input->frequency = 0.0f;
+    input->amplitude = SPECTRUM_FLOOR_DBFS;
+    input->thd = 0.0f;
+    input->snr = 0.0f;
+    input->sinad = 0.0f;
+    input->enob = 0.0f;
+
+    for (bin = 0UL; bin < (sizeof(spectrum_used) / sizeof(spectrum_used[0])); bin++)
+    {
+        spectrum_used[bin] = 0UL;
+    }
+
+    for (bin = SPECTRUM_DC_BINS; bin < spectrum_bins; bin++)
+    {
+        power = spectrum_power(sar, bin);
+        if (power > peak)
+        {
+            peak = power;
+            peak_bin = bin;
+        }
+    }
+
+    signal = spectrum_take_lobe(sar, peak_bin, &moment);
+    if (signal <= 0.0)
+    {
+        return;
+    }
+    frequency = moment / signal;
+
+    for (harmonic = 2UL; harmonic <= SPECTRUM_HARMONICS; harmonic++)
+    {
+        folded = fmod(frequency * (double)harmonic, (double)spectrum_points);
+        if (folded > (double)spectrum_bins)
+        {
+            folded = (double)spectrum_points - folded;
+        }
+        distortion += spectrum_take_lobe(sar, (uint32_t)lround(folded), NULL);
+    }
+
+    for (bin = SPECTRUM_DC_BINS; bin < spectrum_bins; bin++)
+    {
+        if (0UL == (spectrum_used[bin / 32UL] & (1UL << (bin % 32UL))))
+        {
+            noise += spectrum_power(sar, bin);
+            noise_bins++;
+        }
+    }
+    if (0UL != noise_bins)
+    {
+        noise *= (double)(spectrum_bins - SPECTRUM_DC_BINS) / (double)noise_bins;
+    }
+
+    /* The one-sided power of a sine wave of amplitude A is A^2 / 4 times the
+       mean square of the window */
+    input->frequency = (float)frequency;
+    input->amplitude = (float)(10.0 * log10((4.0 * signal) / spectrum_window_power)
+                               - (20.0 * log10(SPECTRUM_FULL_SCALE * (double)(1UL << SPECTRUM_INPUT_SHIFT))));
+    input->thd = (distortion > 0.0) ? (float)(10.0 * log10(distortion / signal)) : SPECTRUM_FLOOR_DBFS;
+    input->snr = (noise > 0.0) ? (float)(10.0 * log10(signal / noise)) : -SPECTRUM_FLOOR_DBFS;
+    input->sinad = ((noise + distortion) > 0.0)
+                   ? (float)(10.0 * log10(signal / (noise + distortion))) : -SPECTRUM_FLOOR_DBFS;
+    input->enob = (input->sinad - 1.76f) / 6.02f;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_take_lobe
+********************************************************************************
+* Summary:
+* This function adds the power of the bins within SPECTRUM_LOBE_BINS of a
+* tone that are above DC and not yet taken by another tone, and marks them.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  center: Bin of the tone
+*  moment: If not NULL, receives the sum of the bin times its power
+*
+* Return:
+*  double: Power of the tone
+*
+*******************************************************************************/
+static double spectrum_take_lobe(uint32_t sar, uint32_t center, double *moment)
+{
+    uint32_t first = (center > (SPECTRUM_DC_BINS + SPECTRUM_LOBE_BINS)) ? (center - SPECTRUM_LOBE_BINS) : SPECTRUM_DC_BINS;
+    uint32_t last = center + SPECTRUM_LOBE_BINS;
+    uint32_t bin;
+    double power;
+    double sum = 0.0;
+
+    for (bin = first; (bin <= last) && (bin < spectrum_bins); bin++)
+    {
+        if (0UL == (spectrum_used[bin / 32UL] & (1UL << (bin % 32UL))))
+        {
+            spectrum_used[bin / 32UL] |= 1UL << (bin % 32UL);
+            power = spectrum_power(sar, bin);
+            sum += power;
+            if (NULL != moment)
+            {
+                *moment += (double)bin * power;
+            }
+        }
+    }
+
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_power
+********************************************************************************
+* Summary:
+* This function returns the power of one bin from its magnitude.
+*
+* Parameters:
+*  sar: 0 for SAR0, 1 for SAR1
+*  bin: Bin, less than spectrum_bins
+*
+* Return:
+*  double: Square of the magnitude
+*
+*******************************************************************************/
+static double spectrum_power(uint32_t sar, uint32_t bin)
+{
+    double magnitude = (double)((0UL == sar) ? fft_buffer[bin].re : fft_buffer[bin].im);
+
+    return magnitude * magnitude;
+}
+
+/*******************************************************************************
+* Function Name: spectrum_sqrt
+********************************************************************************
+* Summary:
+* This function calculates the integer square root bit by bit, without
+* floating point.
+*
+* Parameters:
+*  value: Value, less than 2^62
+*
+* Return:
+*  uint32_t: Largest integer whose square does not exceed value
+*
+*******************************************************************************/
+static uint32_t spectrum_sqrt(uint64_t value)
+{
+    uint64_t root = 0ULL;
+    uint64_t bit = 1ULL << 62U;
+
+    while (bit > value)
+    {
+        bit >>= 2U;
+    }
+
+    while (0ULL != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1U) + bit;
+        }
+        else
+        {
+            root >>= 1U;
+        }
+        bit >>= 2U;
+    }
+
+    return (uint32_t)root;
+}
+
+/* [] END OF FILE */
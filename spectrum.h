@@ -0,0 +1,134 @@
+/******************************************************************************
+* File Name:   spectrum.h
+*
+* Description: This file contains the declarations of the spectrum analysis
+*              of SAR0 and SAR1, which reports the magnitude of each
+*              frequency bin, the THD, and the SNR of both inputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "processing.h"
+#include "fft.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Range of the number of points, a power of two */
+#define SPECTRUM_MIN_POINTS         (256UL)
+#define SPECTRUM_MAX_POINTS         (FFT_MAX_SIZE)
+
+/* Number of harmonics included in the THD, including the fundamental */
+#ifndef SPECTRUM_HARMONICS
+#define SPECTRUM_HARMONICS          (6UL)
+#endif
+
+/* Bins on each side of a tone that belong to it. The main lobe of the
+ * Blackman-Harris window is 4 bins wide on each side.
+ */
+#define SPECTRUM_LOBE_BINS          (5UL)
+
+/* Bins excluded at DC */
+#define SPECTRUM_DC_BINS            (SPECTRUM_LOBE_BINS)
+
+/* Magnitude of a bin without signal, in dBFS */
+#define SPECTRUM_FLOOR_DBFS         (-200.0f)
+
+/* Size of a packed record of bins. Fields are little endian:
+ *
+ *  Offset  Size  Field
+ *  0       2     Number of points N
+ *  2       2     First bin k, the bins are k to k + SPECTRUM_RECORD_BINS - 1
+ *  4       2     Magnitude of SAR0 at bin k, dBFS x 100, signed
+ *  6       2     Magnitude of SAR1 at bin k, dBFS x 100, signed
+ *  ...           Repeated for the following bins, up to N / 2 - 1
+ */
+#define SPECTRUM_RECORD_BINS        (15UL)
+#define SPECTRUM_RECORD_SIZE        (4UL + (SPECTRUM_RECORD_BINS * 4UL))
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Analysis of one input. The ratios are in dB relative to the fundamental. */
+typedef struct
+{
+    float frequency;        /* Fundamental in bins, interpolated */
+    float amplitude;        /* Amplitude of the fundamental in dBFS */
+    float thd;              /* Total harmonic distortion in dB */
+    float snr;              /* Signal to noise ratio in dB, harmonics excluded */
+    float sinad;            /* Signal to noise and distortion ratio in dB */
+    float enob;             /* Effective number of bits from the SINAD */
+} spectrum_input_t;
+
+/* Analysis of both inputs, sampled by the same triggers */
+typedef struct
+{
+    uint32_t points;        /* Number of points N */
+    spectrum_input_t sar[2];
+} spectrum_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the capture of a block of sample pairs */
+bool spectrum_start(uint32_t points);
+
+/* Stops the capture in progress and releases the bins */
+void spectrum_stop(void);
+
+/* Adds sample pairs to the capture and analyzes the complete block */
+void spectrum_process(const sample_pair_t *pairs, uint32_t count);
+
+/* Returns the result of the last analysis, once */
+bool spectrum_get_result(spectrum_result_t *result);
+
+/* Number of bins of the last analysis, 0 if none is available */
+uint32_t spectrum_get_bins(void);
+
+/* Magnitude of one bin of the last analysis in dBFS */
+float spectrum_get_magnitude(uint32_t sar, uint32_t bin);
+
+/* Packs the bins from first into a record, returns the record length */
+uint32_t spectrum_pack_bins(uint32_t first, uint8_t *record);
+
+#endif /* SPECTRUM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,285 @@
+/******************************************************************************
+* File Name:   stats.c
+*
+* Description: This file collects the counters of every stage of the
+*              acquisition pipeline where sample pairs can be lost, and
+*              reports them on request and periodically in the telemetry.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "stats.h"
+#include "telemetry.h"
+#include "sample_stream.h"
+#include "dac_dma.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Stores a 32-bit value in little endian order */
+static void stats_put_u32(uint8_t *buffer, uint32_t value);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Trigger time of the next periodic report */
+static uint64_t stats_next_report = 0ULL;
+
+#if (TELEMETRY_FORMAT != TELEMETRY_FORMAT_BINARY)
+/* Sum of the loss counters at the last periodic report */
+static uint32_t stats_reported_losses = 0UL;
+#endif
+
+/*******************************************************************************
+* Function Name: stats_get
+********************************************************************************
+* Summary:
+* This function collects the counters of the acquisition, the telemetry, and
+* the CTDAC ring buffer.
+*
+* Parameters:
+*  stats: Location to store the counters
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void stats_get(stats_t *stats)
+{
+    stats->scans = acquisition_get_scans();
+    stats->time = acquisition_get_trigger_time();
+    acquisition_get_losses(&stats->acquisition);
+    stats->telemetry_drops = telemetry_get_dropped();
+    stats->telemetry_truncations = telemetry_get_truncated();
+
+#if (DAC_OUTPUT_MODE == DAC_MODE_DMA)
+    stats->dac_underruns = dac_dma_get_underruns();
+    stats->dac_overflows = dac_dma_get_overflows();
+#else
+    stats->dac_underruns = 0UL;
+    stats->dac_overflows = 0UL;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: stats_get_losses
+********************************************************************************
+* Summary:
+* This function returns the sum of the loss counters. The counters do not
+* share a unit, so the sum only tells whether anything was lost.
+*
+* Parameters:
+*  stats: Counters returned by stats_get()
+*
+* Return:
+*  uint32_t: Sum of the loss counters
+*
+*******************************************************************************/
+uint32_t stats_get_losses(const stats_t *stats)
+{
+    return stats->acquisition.result_overwrites + stats->acquisition.fifo_overflows +
+           stats->acquisition.flag_collapses + stats->acquisition.queue_overruns +
+           stats->acquisition.trigger_gaps + stats->acquisition.eos_timeouts + stats->telemetry_drops +
+           stats->telemetry_truncations + stats->dac_underruns + stats->dac_overflows;
+}
+
+/*******************************************************************************
+* Function Name: stats_process
+********************************************************************************
+* Summary:
+* This function is called by the main loop with the trigger time of every
+* block. Once every STATS_REPORT_PERIOD trigger clocks, the binary telemetry
+* sends a STREAM_FRAME_STATS record, and the text and capture telemetry
+* report the loss counters as a line of text if they changed since the last
+* report. A report that does not fit in the telemetry buffer is retried with
+* the next block.
+*
+* Parameters:
+*  time: Trigger time of the current block
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void stats_process(uint64_t time)
+{
+    stats_t stats;
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    uint8_t record[STATS_RECORD_SIZE];
+#endif
+
+    if (time < stats_next_report)
+    {
+        return;
+    }
+
+    stats_get(&stats);
+    stats.time = time;
+
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    if (telemetry_get_free() < (STREAM_HEADER_SIZE + STATS_RECORD_SIZE + STREAM_CRC_SIZE))
+    {
+        return;
+    }
+
+    stats_pack(&stats, record);
+    sample_stream_send(STREAM_FRAME_STATS, record, STATS_RECORD_SIZE);
+#else
+    if (stats_get_losses(&stats) != stats_reported_losses)
+    {
+        /* Both lines fit in TELEMETRY_MAX_MESSAGE; they are queued together
+           so that a full buffer does not repeat the first one */
+        if (telemetry_get_free() < (2UL * TELEMETRY_MAX_MESSAGE))
+        {
+            return;
+        }
+        (void)telemetry_printf("Losses: overwrites %lu, FIFO overflows %lu, collapses %lu, queue %lu\r\n",
+                               (unsigned long)stats.acquisition.result_overwrites,
+                               (unsigned long)stats.acquisition.fifo_overflows,
+                               (unsigned long)stats.acquisition.flag_collapses,
+                               (unsigned long)stats.acquisition.queue_overruns);
+        (void)telemetry_printf("Losses: gaps %lu, timeouts %lu, telemetry %lu/%lu, CTDAC %lu/%lu\r\n",
+                               (unsigned long)stats.acquisition.trigger_gaps,
+                               (unsigned long)stats.acquisition.eos_timeouts,
+                               (unsigned long)stats.telemetry_drops,
+                               (unsigned long)stats.telemetry_truncations,
+                               (unsigned long)stats.dac_underruns, (unsigned long)stats.dac_overflows);
+        stats_reported_losses = stats_get_losses(&stats);
+    }
+#endif
+
+    stats_next_report = time + STATS_REPORT_PERIOD;
+}
+
+/*******************************************************************************
+* Function Name: stats_report
+********************************************************************************
+* Summary:
+* This function reports all counters, with the scan rate achieved since
+* startup next to the nominal rate of the trigger.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void stats_report(void)
+{
+    stats_t stats;
+    uint32_t rate_x10 = 0UL;
+
+    stats_get(&stats);
+
+    if (0ULL != stats.time)
+    {
+        rate_x10 = (uint32_t)(((uint64_t)stats.scans * ACQ_TRIGGER_CLOCK_HZ * 10ULL) / stats.time);
+    }
+
+    (void)telemetry_printf("Scans: %lu in %lu ms, %lu.%lu Hz (nominal %lu Hz)\r\n",
+                           (unsigned long)stats.scans,
+                           (unsigned long)((stats.time * 1000ULL) / ACQ_TRIGGER_CLOCK_HZ),
+                           (unsigned long)(rate_x10 / 10UL), (unsigned long)(rate_x10 % 10UL),
+                           (unsigned long)(ACQ_TRIGGER_CLOCK_HZ / acquisition_get_interval()));
+    (void)telemetry_printf("SAR result overwrites: %lu  FIFO overflows: %lu  Flag collapses: %lu\r\n",
+                           (unsigned long)stats.acquisition.result_overwrites,
+                           (unsigned long)stats.acquisition.fifo_overflows,
+                           (unsigned long)stats.acquisition.flag_collapses);
+    (void)telemetry_printf("Queue overruns: %lu  Trigger gaps: %lu  SAR1 timeouts: %lu\r\n",
+                           (unsigned long)stats.acquisition.queue_overruns,
+                           (unsigned long)stats.acquisition.trigger_gaps,
+                           (unsigned long)stats.acquisition.eos_timeouts);
+    (void)telemetry_printf("Telemetry drops: %lu  truncations: %lu  CTDAC underruns: %lu  CTDAC overflows: %lu\r\n",
+                           (unsigned long)stats.telemetry_drops, (unsigned long)stats.telemetry_truncations,
+                           (unsigned long)stats.dac_underruns, (unsigned long)stats.dac_overflows);
+}
+
+/*******************************************************************************
+* Function Name: stats_pack
+********************************************************************************
+* Summary:
+* This function packs the counters into a record of STATS_RECORD_SIZE bytes,
+* laid out as described in stats.h.
+*
+* Parameters:
+*  stats: Counters to pack
+*  record: Location of the STATS_RECORD_SIZE bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void stats_pack(const stats_t *stats, uint8_t *record)
+{
+    stats_put_u32(&record[0], stats->scans);
+    stats_put_u32(&record[4], (uint32_t)stats->time);
+    stats_put_u32(&record[8], (uint32_t)(stats->time >> 32U));
+    stats_put_u32(&record[12], stats->acquisition.result_overwrites);
+    stats_put_u32(&record[16], stats->acquisition.fifo_overflows);
+    stats_put_u32(&record[20], stats->acquisition.flag_collapses);
+    stats_put_u32(&record[24], stats->acquisition.queue_overruns);
+    stats_put_u32(&record[28], stats->acquisition.trigger_gaps);
+    stats_put_u32(&record[32], stats->telemetry_drops);
+    stats_put_u32(&record[36], stats->dac_underruns);
+    stats_put_u32(&record[40], stats->dac_overflows);
+    stats_put_u32(&record[44], stats->acquisition.eos_timeouts);
+    stats_put_u32(&record[48], stats->telemetry_truncations);
+}
+
+/*******************************************************************************
+* Function Name: stats_put_u32
+********************************************************************************
+* Summary:
+* This function stores a 32-bit value in little endian order.
+*
+* Parameters:
+*  buffer: Location of the 4 bytes
+*  value: Value to store
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void stats_put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8U);
+    buffer[2] = (uint8_t)(value >> 16U);
+    buffer[3] = (uint8_t)(value >> 24U);
+}
+
+/* [] END OF FILE */
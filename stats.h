@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name:   stats.h
+*
+* Description: This file contains the declarations of the sample loss
+*              statistics of the acquisition pipeline.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Trigger clocks between two periodic reports of the statistics, 1 second */
+#ifndef STATS_REPORT_PERIOD
+#define STATS_REPORT_PERIOD         (ACQ_TRIGGER_CLOCK_HZ)
+#endif
+
+/* Size of a packed statistics record. Fields are little endian:
+ *
+ *  Offset  Size     Field
+ *  0       4        Scans read by the main loop
+ *  4       8        Trigger time of the report, in trigger clocks
+ *  12      4        SAR result overwrites
+ *  16      4        SAR FIFO overflows
+ *  20      4        Interrupt flag collapses
+ *  24      4        Queue overruns
+ *  28      4        Trigger gaps
+ *  32      4        Dropped telemetry messages
+ *  36      4        CTDAC ring underruns
+ *  40      4        CTDAC ring overflows
+ *  44      4        End-Of-Scan timeouts of SAR1
+ *  48      4        Telemetry messages truncated to fit the buffer
+ */
+#define STATS_RECORD_SIZE           (52UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Counters of every stage of the pipeline where sample pairs can be lost */
+typedef struct
+{
+    uint32_t scans;             /* Scans read by the main loop */
+    uint64_t time;              /* Trigger time of the counters */
+    acq_losses_t acquisition;   /* Losses between the SARs and the main loop */
+    uint32_t telemetry_drops;   /* Messages or frames dropped by the telemetry */
+    uint32_t telemetry_truncations; /* Messages truncated by the telemetry */
+    uint32_t dac_underruns;     /* Codes repeated by the CTDAC ring (CTDAC DMA mode) */
+    uint32_t dac_overflows;     /* Codes dropped by the CTDAC ring (CTDAC DMA mode) */
+} stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Collects the counters of all stages */
+void stats_get(stats_t *stats);
+
+/* Sum of the loss counters, 0 if no sample pair was lost */
+uint32_t stats_get_losses(const stats_t *stats);
+
+/* Sends the statistics to the telemetry every STATS_REPORT_PERIOD */
+void stats_process(uint64_t time);
+
+/* Reports all counters as text */
+void stats_report(void);
+
+/* Packs the statistics into STATS_RECORD_SIZE bytes */
+void stats_pack(const stats_t *stats, uint8_t *record);
+
+#endif /* STATS_H_ */
+
+/* [] END OF FILE */
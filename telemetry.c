@@ -0,0 +1,383 @@
+/******************************************************************************
+* File Name:   telemetry.c
+*
+* Description: This file contains the non-blocking telemetry output. Messages
+*              are queued in a lock-free single-producer single-consumer ring
+*              buffer and moved to the debug UART only when its FIFO has room,
+*              so the acquisition never waits for the UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Mask to wrap the ring buffer indices */
+#define TELEMETRY_INDEX_MASK        (TELEMETRY_BUFFER_SIZE - 1UL)
+
+/* Priority of the UART event that wakes up the CPU, that of the acquisition */
+#define TELEMETRY_INTR_PRIORITY     (7U)
+
+#if ((TELEMETRY_BUFFER_SIZE & TELEMETRY_INDEX_MASK) != 0UL)
+#error "TELEMETRY_BUFFER_SIZE must be a power of two"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Handler of the empty TX FIFO event of the UART */
+static void telemetry_uart_event(void *callback_arg, cyhal_uart_event_t event);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Telemetry ring buffer */
+static uint8_t telemetry_buffer[TELEMETRY_BUFFER_SIZE];
+
+/* Free running write and read indices. The writer only updates head and the
+ * reader only updates tail, so no lock is needed between them.
+ */
+static volatile uint32_t telemetry_head = 0UL;
+static volatile uint32_t telemetry_tail = 0UL;
+
+/* Number of messages dropped because the buffer was full */
+static volatile uint32_t telemetry_dropped = 0UL;
+
+/* Number of messages cut to TELEMETRY_MAX_MESSAGE by telemetry_printf() */
+static uint32_t telemetry_truncated = 0UL;
+
+/* Whether the empty TX FIFO event is enabled */
+static volatile bool telemetry_waiting = false;
+
+/*******************************************************************************
+* Function Name: telemetry_init
+********************************************************************************
+* Summary:
+* This function registers the handler of the UART events. The main loop only
+* moves queued bytes to the UART when it wakes up, and the UART FIFO is much
+* shorter than the ring buffer, so the CPU must also wake up when the FIFO
+* is empty. Otherwise, with one wakeup per block of samples, the ring
+* buffer fills up and binary frames are dropped.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void telemetry_init(void)
+{
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, telemetry_uart_event, NULL);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_uart_event
+********************************************************************************
+* Summary:
+* This function handles the empty TX FIFO and the received byte events of the
+* UART. It only wakes up the CPU: the TX event is disabled until
+* telemetry_service() refills the FIFO, so that the ring buffer keeps a single
+* reader, and the RX event until telemetry_wake_on_rx(), so that the byte is
+* left for the command handler.
+*
+* Parameters:
+*  callback_arg: Unused
+*  event: Events present
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void telemetry_uart_event(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)callback_arg;
+
+    if (0UL != ((uint32_t)event & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                                TELEMETRY_INTR_PRIORITY, false);
+    }
+
+    if (0UL != ((uint32_t)event & (uint32_t)CYHAL_UART_IRQ_TX_EMPTY))
+    {
+        cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_TX_EMPTY,
+                                TELEMETRY_INTR_PRIORITY, false);
+        telemetry_waiting = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: telemetry_write
+********************************************************************************
+* Summary:
+* This function queues a message for the UART. Messages are never split: if
+* the whole message does not fit, it is dropped and counted.
+*
+* Parameters:
+*  data: Message to queue
+*  length: Length of the message in bytes
+*
+* Return:
+*  bool: true if the message was queued, false if it was dropped
+*
+*******************************************************************************/
+bool telemetry_write(const uint8_t *data, uint32_t length)
+{
+    uint32_t head = telemetry_head;
+    uint32_t index;
+
+    if ((TELEMETRY_BUFFER_SIZE - (head - telemetry_tail)) < length)
+    {
+        telemetry_dropped++;
+        return false;
+    }
+
+    for (index = 0UL; index < length; index++)
+    {
+        telemetry_buffer[(head + index) & TELEMETRY_INDEX_MASK] = data[index];
+    }
+
+    /* Publish the message only after it is completely written */
+    telemetry_head = head + length;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_printf
+********************************************************************************
+* Summary:
+* This function formats a message and queues it for the UART. A message
+* longer than TELEMETRY_MAX_MESSAGE is cut, ends with TELEMETRY_TRUNCATED so
+* that the line still ends and the cut shows in the output, and is counted.
+*
+* Parameters:
+*  format: printf style format string, followed by its arguments
+*
+* Return:
+*  bool: true if the message was queued, false if it was dropped
+*
+*******************************************************************************/
+bool telemetry_printf(const char *format, ...)
+{
+    char message[TELEMETRY_MAX_MESSAGE];
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return false;
+    }
+
+    if ((uint32_t)length >= sizeof(message))
+    {
+        length = (int)sizeof(message) - 1;
+        (void)memcpy(&message[(uint32_t)length - (sizeof(TELEMETRY_TRUNCATED) - 1UL)],
+                     TELEMETRY_TRUNCATED, sizeof(TELEMETRY_TRUNCATED) - 1UL);
+        telemetry_truncated++;
+    }
+
+    return telemetry_write((const uint8_t *)message, (uint32_t)length);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_service
+********************************************************************************
+* Summary:
+* This function moves queued bytes into the UART transmit FIFO until either
+* the FIFO is full or the ring buffer is empty. It never waits for the UART.
+* While bytes remain queued, the empty TX FIFO event wakes up the CPU.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void telemetry_service(void)
+{
+    uint32_t tail = telemetry_tail;
+    uint32_t head = telemetry_head;
+    uint32_t space = cyhal_uart_writable(&cy_retarget_io_uart_obj);
+
+    while ((tail != head) && (space > 0UL))
+    {
+        (void)cyhal_uart_putc(&cy_retarget_io_uart_obj,
+                              telemetry_buffer[tail & TELEMETRY_INDEX_MASK]);
+        tail++;
+        space--;
+    }
+
+    telemetry_tail = tail;
+
+    if ((tail != head) && !telemetry_waiting)
+    {
+        telemetry_waiting = true;
+        cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_TX_EMPTY,
+                                TELEMETRY_INTR_PRIORITY, true);
+    }
+}
+
+/*******************************************************************************
+* Function Name: telemetry_wake_on_rx
+********************************************************************************
+* Summary:
+* This function enables the received byte event of the UART, so that the
+* next command wakes up the CPU even if nothing else does. The event is
+* disabled again by the first byte.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void telemetry_wake_on_rx(void)
+{
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            TELEMETRY_INTR_PRIORITY, true);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_is_pending
+********************************************************************************
+* Summary:
+* This function checks whether queued bytes are waiting for the UART.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool: true if the ring buffer is not empty
+*
+*******************************************************************************/
+bool telemetry_is_pending(void)
+{
+    return (telemetry_head != telemetry_tail);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_dropped
+********************************************************************************
+* Summary:
+* This function returns the number of messages dropped since startup because
+* the UART could not keep up.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of dropped messages
+*
+*******************************************************************************/
+uint32_t telemetry_get_dropped(void)
+{
+    return telemetry_dropped;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_truncated
+********************************************************************************
+* Summary:
+* This function returns the number of messages cut by telemetry_printf()
+* since startup because they were longer than TELEMETRY_MAX_MESSAGE.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of truncated messages
+*
+*******************************************************************************/
+uint32_t telemetry_get_truncated(void)
+{
+    return telemetry_truncated;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_free
+********************************************************************************
+* Summary:
+* This function returns the free space of the ring buffer, so that long
+* reports can be queued piece by piece without dropping messages.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Number of free bytes
+*
+*******************************************************************************/
+uint32_t telemetry_get_free(void)
+{
+    return TELEMETRY_BUFFER_SIZE - (telemetry_head - telemetry_tail);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_offset
+********************************************************************************
+* Summary:
+* This function returns the offset, modulo 2^32, of the next message queued
+* in the UART output after the banner printed at startup: the number of
+* bytes queued since then. Dropped messages do not count.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t: Offset of the next message
+*
+*******************************************************************************/
+uint32_t telemetry_get_offset(void)
+{
+    return telemetry_head;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name:   telemetry.h
+*
+* Description: This file contains the declarations of the non-blocking
+*              telemetry output over the debug UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Telemetry formats */
+/* One line of text with the input voltages per block of sample pairs */
+#define TELEMETRY_FORMAT_TEXT       (0U)
+/* Every sample pair in binary frames, see sample_stream.h */
+#define TELEMETRY_FORMAT_BINARY     (1U)
+/* Every sample pair in chunks of columns for long captures, see capture.h */
+#define TELEMETRY_FORMAT_CAPTURE    (2U)
+
+/* Telemetry format used by the application. Can be overridden in the
+ * DEFINES variable of the Makefile.
+ */
+#ifndef TELEMETRY_FORMAT
+#define TELEMETRY_FORMAT            (TELEMETRY_FORMAT_TEXT)
+#endif
+
+/* Size of the telemetry ring buffer in bytes. Must be a power of two. */
+#ifndef TELEMETRY_BUFFER_SIZE
+#define TELEMETRY_BUFFER_SIZE       (1024UL)
+#endif
+
+/* Longest message accepted by telemetry_printf() */
+#define TELEMETRY_MAX_MESSAGE       (128UL)
+
+/* End of a message cut by telemetry_printf() */
+#define TELEMETRY_TRUNCATED         "~\r\n"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Wakes up the CPU whenever the UART has sent all bytes handed to it */
+void telemetry_init(void);
+
+/* Queues a message, or drops it entirely if the buffer is full */
+bool telemetry_write(const uint8_t *data, uint32_t length);
+
+/* Formats and queues a message, or drops it if the buffer is full */
+bool telemetry_printf(const char *format, ...);
+
+/* Moves queued bytes to the UART without waiting */
+void telemetry_service(void);
+
+/* Returns true if bytes are waiting to be sent */
+bool telemetry_is_pending(void);
+
+/* Number of messages dropped because the buffer was full */
+uint32_t telemetry_get_dropped(void);
+
+/* Number of messages cut to TELEMETRY_MAX_MESSAGE */
+uint32_t telemetry_get_truncated(void);
+
+/* Wakes up the CPU on the next received byte */
+void telemetry_wake_on_rx(void);
+
+/* Number of bytes that can be queued without dropping */
+uint32_t telemetry_get_free(void);
+
+/* Offset of the next message queued in the UART output after the banner */
+uint32_t telemetry_get_offset(void);
+
+#endif /* TELEMETRY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,133 @@
+/******************************************************************************
+* File Name:   timebase.c
+*
+* Description: This file contains the 64-bit time base of the sample
+*              timestamps: a free-running TCPWM counter extended by a software
+*              epoch.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "timebase.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Upper 32 bits of the time, incremented when the counter wraps */
+static uint32_t timebase_epoch = 0UL;
+
+/* Counter value of the previous reading */
+static uint32_t timebase_last = 0UL;
+
+/*******************************************************************************
+* Function Name: timebase_init
+********************************************************************************
+* Summary:
+* This function starts the time base counter with the clock and settings of
+* the counter that triggers the SARs and a 32-bit period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timebase_init(void)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+    cy_stc_tcpwm_counter_config_t counter_config = tcpwm_0_group_0_cnt_0_config;
+
+    counter_config.period = 0xFFFFFFFFUL;
+
+    result = Cy_SysClk_PeriphAssignDivider(TIMEBASE_CLOCK, TIMEBASE_DIVIDER_TYPE, TIMEBASE_DIVIDER_NUM);
+    if (CY_SYSCLK_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = Cy_TCPWM_Counter_Init(TCPWM0, TIMEBASE_TCPWM_CNT_NUM, &counter_config);
+    if (CY_TCPWM_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
+
+    timebase_epoch = 0UL;
+    timebase_last = 0UL;
+
+    Cy_TCPWM_Counter_Enable(TCPWM0, TIMEBASE_TCPWM_CNT_NUM);
+    Cy_TCPWM_TriggerStart_Single(TCPWM0, TIMEBASE_TCPWM_CNT_NUM);
+}
+
+/*******************************************************************************
+* Function Name: timebase_now
+********************************************************************************
+* Summary:
+* This function returns the time since timebase_init() in trigger clocks. The
+* 32-bit counter is extended in software: a reading below the previous one
+* means that the counter wrapped. The counter wraps after 2^32 clocks, about
+* 71 minutes at 1 MHz, so this function must be called more often, which
+* every block of sample pairs does. It can be called from interrupts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t: Current time
+*
+*******************************************************************************/
+uint64_t timebase_now(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t count = Cy_TCPWM_Counter_GetCounter(TCPWM0, TIMEBASE_TCPWM_CNT_NUM);
+    uint64_t now;
+
+    if (count < timebase_last)
+    {
+        timebase_epoch++;
+    }
+    timebase_last = count;
+    now = ((uint64_t)timebase_epoch << 32U) | count;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return now;
+}
+
+/* [] END OF FILE */
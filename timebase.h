@@ -0,0 +1,72 @@
+/******************************************************************************
+* File Name:   timebase.h
+*
+* Description: This file contains the declarations of the 64-bit time base of
+*              the sample timestamps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Free-running 32-bit TCPWM counter of the time base. It is clocked by the
+ * same divider as the counter that triggers the SARs, so its ticks are the
+ * trigger clocks.
+ */
+#define TIMEBASE_TCPWM_CNT_NUM      (2UL)
+#define TIMEBASE_CLOCK              (PCLK_TCPWM0_CLOCKS2)
+#define TIMEBASE_DIVIDER_TYPE       (CY_SYSCLK_DIV_8_BIT)
+#define TIMEBASE_DIVIDER_NUM        (2UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the time base counter from zero */
+void timebase_init(void);
+
+/* Current time in trigger clocks since timebase_init() */
+uint64_t timebase_now(void);
+
+#endif /* TIMEBASE_H_ */
+
+/* [] END OF FILE */